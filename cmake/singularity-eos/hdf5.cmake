@@ -91,4 +91,16 @@ macro(singularity_enable_hdf5 target)
 
   target_compile_definitions(${target} INTERFACE SINGULARITY_USE_HDF5)
 
+  # Compressed sp5 files are inflated on a pool of threads with zlib
+  # when it is available. Otherwise HDF5 decompresses them serially.
+  find_package(ZLIB)
+  if(ZLIB_FOUND)
+    find_package(Threads REQUIRED)
+    target_link_libraries(${target} INTERFACE ZLIB::ZLIB Threads::Threads)
+    target_compile_definitions(${target} INTERFACE SINGULARITY_USE_ZLIB)
+    set(SINGULARITY_USE_ZLIB
+        ON
+        CACHE BOOL "" FORCE)
+  endif()
+
 endmacro()
@@ -0,0 +1,368 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+// clang-format off
+#include "module.hpp"
+#include <singularity-eos/closure/mixed_cell_models.hpp>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using RealArray = py::array_t<Real, py::array::c_style | py::array::forcecast>;
+using IntArray = py::array_t<int, py::array::c_style | py::array::forcecast>;
+
+enum class PTEMethod { RhoT, RhoU, FixedT };
+
+// Cells are handed out to the worker threads in blocks of this size, since the
+// cost of a PTE solve varies a lot from cell to cell
+constexpr int CELL_BLOCK = 16;
+
+template <typename T>
+bool cast_to_variant(py::handle obj, EOS &eos) {
+  if (!py::isinstance<T>(obj)) return false;
+  eos = obj.cast<T>();
+  return true;
+}
+
+// Converts a bound EOS object into the variant type the solvers work with
+template <typename... Ts>
+EOS to_variant(py::handle obj, tl<Ts...>) {
+  EOS eos;
+  bool found = false;
+  // C++14 workaround, since we don't have C++17 fold expressions
+  auto l = {(found = found || cast_to_variant<Ts>(obj, eos))...};
+  if (!found) {
+    throw py::type_error("Material " + py::str(obj).cast<std::string>() +
+                         " is not a supported EOS type");
+  }
+  return eos;
+}
+
+// Maps the materials present in a cell to the user's material table
+struct MaterialAccessor {
+  const EOS &operator[](const int m) const { return eos[mats[m]]; }
+  const EOS *eos;
+  const int *mats;
+};
+
+// Raw views of the numpy buffers, so the solves can run without the GIL.
+// Material arrays are ncell x nslots, cell arrays have length ncell, and
+// lambdas is ncell x nslots x nlambda, or null if none were passed.
+struct PTEBuffers {
+  int ncell, nslots, nlambda;
+  const int *matids;
+  const Real *rho_in, *vfrac_in, *sie_in, *temp_in;
+  Real *rho, *vfrac, *sie, *temp, *press;
+  Real *cell_press, *cell_temp, *cell_sie;
+  bool *converged;
+  int *niter;
+  Real *lambdas;
+};
+
+int required_scratch(const PTEMethod method, const int nmat) {
+  switch (method) {
+  case PTEMethod::RhoU:
+    return PTESolverRhoURequiredScratch(nmat);
+  case PTEMethod::FixedT:
+    return PTESolverFixedTRequiredScratch(nmat);
+  default:
+    return PTESolverRhoTRequiredScratch(nmat);
+  }
+}
+
+// Per-thread work arrays, sized for the largest possible cell
+struct CellScratch {
+  explicit CellScratch(const PTEMethod method, const int nslots)
+    : mats(nslots), slots(nslots), rho(nslots), vfrac(nslots), sie(nslots),
+      temp(nslots), press(nslots), lambda(nslots, nullptr),
+      solver(required_scratch(method, nslots)) {}
+  std::vector<int> mats, slots;
+  std::vector<Real> rho, vfrac, sie, temp, press;
+  std::vector<Real *> lambda;
+  std::vector<Real> solver;
+};
+
+void solve_cell(const PTEMethod method, const std::vector<EOS> &eos,
+                const PTEBuffers &b, const int i, CellScratch &s) {
+  const int row = i * b.nslots;
+  // gather the materials present in this cell
+  int npte = 0;
+  Real vsum = 0.0;
+  Real mass = 0.0;
+  Real esum = 0.0;
+  for (int j = 0; j < b.nslots; ++j) {
+    const Real rho = b.rho_in[row + j];
+    const Real vfrac = b.vfrac_in[row + j];
+    if (b.matids[row + j] < 0 || rho <= 0.0 || vfrac <= 0.0) continue;
+    s.mats[npte] = b.matids[row + j];
+    s.slots[npte] = j;
+    s.rho[npte] = rho;
+    s.vfrac[npte] = vfrac;
+    s.sie[npte] = (method == PTEMethod::FixedT) ? 0.0 : b.sie_in[row + j];
+    s.lambda[npte] = b.lambdas ? b.lambdas + (row + j) * b.nlambda : nullptr;
+    vsum += vfrac;
+    mass += rho * vfrac;
+    esum += rho * vfrac * s.sie[npte];
+    npte++;
+  }
+  b.converged[i] = true;
+  b.niter[i] = 0;
+  if (npte == 0) return;
+
+  const Real T_true = (method == PTEMethod::FixedT) ? b.temp_in[i] : 0.0;
+  const Real sie_tot = robust::ratio(esum, mass);
+  MaterialAccessor mat_eos{eos.data(), s.mats.data()};
+  if (npte == 1) {
+    // pure cell, so the lookups are already in equilibrium
+    const EOS &e = mat_eos[0];
+    Real *lambda = s.lambda[0];
+    if (method == PTEMethod::FixedT) {
+      s.temp[0] = T_true;
+      s.sie[0] = e.InternalEnergyFromDensityTemperature(s.rho[0], T_true, lambda);
+    } else {
+      s.temp[0] = e.TemperatureFromDensityInternalEnergy(s.rho[0], s.sie[0], lambda);
+    }
+    s.press[0] = e.PressureFromDensityTemperature(s.rho[0], s.temp[0], lambda);
+  } else {
+    for (int m = 0; m < npte; ++m) {
+      if (method == PTEMethod::FixedT) {
+        s.temp[m] = T_true;
+      } else {
+        s.temp[m] = mat_eos[m].TemperatureFromDensityInternalEnergy(s.rho[m], s.sie[m],
+                                                                   s.lambda[m]);
+        s.press[m] = mat_eos[m].PressureFromDensityInternalEnergy(s.rho[m], s.sie[m],
+                                                                 s.lambda[m]);
+      }
+    }
+    Real *rho = s.rho.data();
+    Real *vfrac = s.vfrac.data();
+    Real *sie = s.sie.data();
+    Real *temp = s.temp.data();
+    Real *press = s.press.data();
+    Real **lambdas = s.lambda.data();
+    // the solvers expect zeroed scratch
+    std::fill(s.solver.begin(), s.solver.end(), 0.0);
+    if (method == PTEMethod::RhoU) {
+      PTESolverRhoU<MaterialAccessor, Real *, Real **> solver(
+          npte, mat_eos, vsum, sie_tot, rho, vfrac, sie, temp, press, lambdas,
+          s.solver.data());
+      b.converged[i] = PTESolver(solver);
+      b.niter[i] = solver.Niter();
+    } else if (method == PTEMethod::FixedT) {
+      PTESolverFixedT<MaterialAccessor, Real *, Real **> solver(
+          npte, mat_eos, vsum, T_true, rho, vfrac, sie, temp, press, lambdas,
+          s.solver.data());
+      b.converged[i] = PTESolver(solver);
+      b.niter[i] = solver.Niter();
+    } else {
+      PTESolverRhoT<MaterialAccessor, Real *, Real **> solver(
+          npte, mat_eos, vsum, sie_tot, rho, vfrac, sie, temp, press, lambdas,
+          s.solver.data());
+      b.converged[i] = PTESolver(solver);
+      b.niter[i] = solver.Niter();
+    }
+  }
+
+  // scatter back to the input slots and form the cell averages
+  Real cell_press = 0.0;
+  Real cell_temp = 0.0;
+  Real cell_sie = 0.0;
+  for (int m = 0; m < npte; ++m) {
+    const int j = row + s.slots[m];
+    b.rho[j] = s.rho[m];
+    b.vfrac[j] = s.vfrac[m];
+    b.sie[j] = s.sie[m];
+    b.temp[j] = s.temp[m];
+    b.press[j] = s.press[m];
+    const Real rhobar = s.rho[m] * s.vfrac[m];
+    cell_press += s.vfrac[m] * s.press[m];
+    cell_temp += rhobar * s.temp[m];
+    cell_sie += rhobar * s.sie[m];
+  }
+  b.cell_press[i] = robust::ratio(cell_press, vsum);
+  b.cell_temp[i] = robust::ratio(cell_temp, mass);
+  b.cell_sie[i] = robust::ratio(cell_sie, mass);
+}
+
+void solve_cells(const PTEMethod method, const std::vector<EOS> &eos,
+                 const PTEBuffers &b, int nthreads) {
+  if (nthreads <= 0) nthreads = static_cast<int>(std::thread::hardware_concurrency());
+  nthreads = std::max(1, std::min(nthreads, (b.ncell + CELL_BLOCK - 1) / CELL_BLOCK));
+
+  std::atomic<int> next(0);
+  std::vector<std::exception_ptr> errors(nthreads);
+  auto work = [&](const int t) {
+    try {
+      CellScratch scratch(method, b.nslots);
+      for (int start = next.fetch_add(CELL_BLOCK); start < b.ncell;
+           start = next.fetch_add(CELL_BLOCK)) {
+        const int stop = std::min(start + CELL_BLOCK, b.ncell);
+        for (int i = start; i < stop; ++i) {
+          solve_cell(method, eos, b, i, scratch);
+        }
+      }
+    } catch (...) {
+      errors[t] = std::current_exception();
+    }
+  };
+  if (nthreads == 1) {
+    work(0);
+  } else {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthreads; ++t) {
+      threads.emplace_back(work, t);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+  for (auto &error : errors) {
+    if (error) std::rethrow_exception(error);
+  }
+}
+
+void require_shape(const RealArray &a, const IntArray &matids, const std::string &name) {
+  if (a.ndim() != 2 || a.shape(0) != matids.shape(0) || a.shape(1) != matids.shape(1)) {
+    throw py::value_error(name + " must have the same shape as matids");
+  }
+}
+
+py::dict pte_solve(const PTEMethod method, py::list materials, IntArray matids,
+                   RealArray rho, RealArray vfrac, RealArray y, const int nthreads,
+                   py::object lambdas) {
+  if (matids.ndim() != 2) {
+    throw py::value_error("matids must be a two-dimensional (ncell, nmat) array");
+  }
+  require_shape(rho, matids, "rho");
+  require_shape(vfrac, matids, "vfrac");
+  if (method == PTEMethod::FixedT) {
+    if (y.ndim() != 1 || y.shape(0) != matids.shape(0)) {
+      throw py::value_error("temperature must have one entry per cell");
+    }
+  } else {
+    require_shape(y, matids, "sie");
+  }
+
+  std::vector<EOS> eos;
+  for (auto obj : materials) {
+    eos.push_back(to_variant(obj, singularity::combined_list));
+  }
+  const int nmaterials = static_cast<int>(eos.size());
+  const int *ids = matids.data();
+  for (py::ssize_t k = 0; k < matids.size(); ++k) {
+    if (ids[k] >= nmaterials) {
+      throw py::value_error("Material id " + std::to_string(ids[k]) +
+                            " is out of range for " + std::to_string(nmaterials) +
+                            " materials");
+    }
+  }
+
+  const int ncell = static_cast<int>(matids.shape(0));
+  const int nslots = static_cast<int>(matids.shape(1));
+
+  // Models such as StellarCollapse need per-material lambdas, so those are
+  // required whenever such a model is present.  They are updated in place by
+  // the solves and returned in the result.
+  int nlambda = 0;
+  for (const auto &e : eos) {
+    nlambda = std::max(nlambda, e.nlambda());
+  }
+  const bool has_lambdas = !lambdas.is_none();
+  RealArray lambda_out;
+  if (has_lambdas) {
+    RealArray lambda_in = lambdas.cast<RealArray>();
+    if (lambda_in.ndim() != 3 || lambda_in.shape(0) != ncell ||
+        lambda_in.shape(1) != nslots || lambda_in.shape(2) < nlambda) {
+      throw py::value_error("lambdas must be an (ncell, nmat, nlambda) array with "
+                            "nlambda of at least " + std::to_string(nlambda));
+    }
+    nlambda = static_cast<int>(lambda_in.shape(2));
+    lambda_out = RealArray(std::vector<py::ssize_t>{ncell, nslots, nlambda});
+    std::copy(lambda_in.data(), lambda_in.data() + lambda_in.size(),
+              lambda_out.mutable_data());
+  } else if (nlambda > 0) {
+    throw py::type_error("The materials require " + std::to_string(nlambda) +
+                         " lambdas per slot, which must be passed as lambdas");
+  }
+  const std::vector<py::ssize_t> mat_shape = {ncell, nslots};
+  const std::vector<py::ssize_t> cell_shape = {ncell};
+  RealArray rho_out(mat_shape), vfrac_out(mat_shape), sie_out(mat_shape),
+      temp_out(mat_shape), press_out(mat_shape);
+  RealArray cell_press(cell_shape), cell_temp(cell_shape), cell_sie(cell_shape);
+  py::array_t<bool> converged(cell_shape);
+  py::array_t<int> niter(cell_shape);
+  for (RealArray *a : {&rho_out, &vfrac_out, &sie_out, &temp_out, &press_out, &cell_press,
+                       &cell_temp, &cell_sie}) {
+    std::fill(a->mutable_data(), a->mutable_data() + a->size(), 0.0);
+  }
+
+  const bool fixed_t = (method == PTEMethod::FixedT);
+  PTEBuffers b{ncell,
+               nslots,
+               nlambda,
+               ids,
+               rho.data(),
+               vfrac.data(),
+               fixed_t ? nullptr : y.data(),
+               fixed_t ? y.data() : nullptr,
+               rho_out.mutable_data(),
+               vfrac_out.mutable_data(),
+               sie_out.mutable_data(),
+               temp_out.mutable_data(),
+               press_out.mutable_data(),
+               cell_press.mutable_data(),
+               cell_temp.mutable_data(),
+               cell_sie.mutable_data(),
+               converged.mutable_data(),
+               niter.mutable_data(),
+               has_lambdas ? lambda_out.mutable_data() : nullptr};
+  {
+    py::gil_scoped_release release;
+    solve_cells(method, eos, b, nthreads);
+  }
+
+  py::dict result;
+  result["density"] = rho_out;
+  result["volume_fraction"] = vfrac_out;
+  result["specific_internal_energy"] = sie_out;
+  result["temperature"] = temp_out;
+  result["pressure"] = press_out;
+  result["cell_pressure"] = cell_press;
+  result["cell_temperature"] = cell_temp;
+  result["cell_specific_internal_energy"] = cell_sie;
+  result["converged"] = converged;
+  result["iterations"] = niter;
+  if (has_lambdas) result["lambdas"] = lambda_out;
+  return result;
+}
+
+} // namespace
+
+void create_mixed_cell_functions(py::module_ &m) {
+  // Batched PTE solves over many cells.  Material arrays are (ncell, nmat), and
+  // matids index into the list of EOS objects, with negative ids marking empty slots.
+  py::module closure = m.def_submodule("closure");
+  closure.def("PTESolverRhoT", [](py::list eos, IntArray matids, RealArray rho, RealArray vfrac, RealArray sie, int nthreads, py::object lambdas) {
+    return pte_solve(PTEMethod::RhoT, eos, matids, rho, vfrac, sie, nthreads, lambdas);
+  }, py::arg("eos"), py::arg("matids"), py::arg("rho"), py::arg("vfrac"), py::arg("sie"), py::arg("nthreads")=0, py::arg("lambdas")=py::none());
+  closure.def("PTESolverRhoU", [](py::list eos, IntArray matids, RealArray rho, RealArray vfrac, RealArray sie, int nthreads, py::object lambdas) {
+    return pte_solve(PTEMethod::RhoU, eos, matids, rho, vfrac, sie, nthreads, lambdas);
+  }, py::arg("eos"), py::arg("matids"), py::arg("rho"), py::arg("vfrac"), py::arg("sie"), py::arg("nthreads")=0, py::arg("lambdas")=py::none());
+  closure.def("PTESolverFixedT", [](py::list eos, IntArray matids, RealArray rho, RealArray vfrac, RealArray temperature, int nthreads, py::object lambdas) {
+    return pte_solve(PTEMethod::FixedT, eos, matids, rho, vfrac, temperature, nthreads, lambdas);
+  }, py::arg("eos"), py::arg("matids"), py::arg("rho"), py::arg("vfrac"), py::arg("temperature"), py::arg("nthreads")=0, py::arg("lambdas")=py::none());
+}
@@ -133,6 +133,10 @@ PYBIND11_MODULE(singularity_eos, m) {
     return py::make_tuple(r0, a, b, c);
   }, py::arg("eos"), py::arg("alpha0"), py::arg("Pe"), py::arg("Pc"));
 
+#ifdef SINGULARITY_BUILD_CLOSURE
+  create_mixed_cell_functions(m);
+#endif
+
   py::module thermalqs = m.def_submodule("thermalqs");
   thermalqs.attr("none") = pybind11::int_(thermalqs::none);
   thermalqs.attr("density") = pybind11::int_(thermalqs::density);
@@ -144,6 +148,40 @@ PYBIND11_MODULE(singularity_eos, m) {
   thermalqs.attr("do_lambda") = pybind11::int_(thermalqs::do_lambda);
   thermalqs.attr("all_values") = pybind11::int_(thermalqs::all_values);
 
+#ifdef SINGULARITY_ENABLE_EOS_SERVICE
+  // Client of an EOS service run by another process on the node
+  py::module service = m.def_submodule("eos_service");
+  py::class_<eos_service::Client>(service, "Client")
+    .def(py::init())
+    .def(py::init<const std::string&>(), py::arg("name"))
+    .def("open", &eos_service::Client::Open, py::arg("name"))
+    .def("close", &eos_service::Client::Close)
+    .def_property_readonly("alive", &eos_service::Client::Alive)
+    .def_property_readonly("num_materials", &eos_service::Client::NumMaterials)
+    .def("evaluate", [](eos_service::Client &self, const std::string &query, const int material,
+                        py::array_t<Real, py::array::c_style | py::array::forcecast> x,
+                        py::array_t<Real, py::array::c_style | py::array::forcecast> y) {
+      using query_trace::Query;
+      int q = 0;
+      while (q < static_cast<int>(Query::NumQueries) &&
+             query != query_trace::QueryName(static_cast<Query>(q))) {
+        q++;
+      }
+      if (q == static_cast<int>(Query::NumQueries)) {
+        throw py::value_error("Unknown EOS query " + query);
+      }
+      if (x.size() != y.size()) {
+        throw py::value_error("Inputs must have the same size");
+      }
+      py::array_t<Real> out(x.size());
+      if (!self.Evaluate(static_cast<Query>(q), material, x.data(), y.data(),
+                         out.mutable_data(), x.size())) {
+        throw std::runtime_error("EOS service request failed");
+      }
+      return out;
+    }, py::arg("query"), py::arg("material"), py::arg("x"), py::arg("y"));
+#endif // SINGULARITY_ENABLE_EOS_SERVICE
+
   py::module eos_units = m.def_submodule("eos_units");
   py::class_<eos_units_init::ThermalUnitsInit>(eos_units, "_ThermalUnits");
   py::class_<eos_units_init::LengthTimeUnitsInit>(eos_units, "_LengthTimeUnits");
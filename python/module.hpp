@@ -14,6 +14,7 @@
 // clang-format off
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
+#include <singularity-eos/base/eos_service.hpp>
 #include <singularity-eos/base/variadic_utils.hpp>
 #include <singularity-eos/eos/eos.hpp>
 #include <map>
@@ -346,6 +347,8 @@ py::class_<T> eos_class(py::module_ & m, std::string name) {
 
     .def("MinimumDensity", &T::MinimumDensity)
     .def("MinimumTemperature", &T::MinimumTemperature)
+    .def("MaximumDensity", &T::MaximumDensity)
+    .def("MaximumTemperature", &T::MaximumTemperature)
     .def_property_readonly("nlambda", &T::nlambda)
     .def_property_readonly_static("PreferredInput", [](py::object) { return T::PreferredInput(); })
     .def("PrintParams", &T::PrintParams)
@@ -376,3 +379,6 @@ void create_scaled_eos_classes(py::module_ & m);
 void create_bilinear_ramp_eos_classes(py::module_ &m);
 void create_relativistic_eos_classes(py::module_ &m);
 void create_unit_system_eos_classes(py::module_ &m);
+#ifdef SINGULARITY_BUILD_CLOSURE
+void create_mixed_cell_functions(py::module_ &m);
+#endif
@@ -0,0 +1,375 @@
+//======================================================================
+// sesame2spiner-autotune: table resolution sweeps for sesame2spiner
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//======================================================================
+
+// For a single material input deck, tabulates the material at a range
+// of resolutions, and for each table measures
+//   - the interpolation error against eospac on random held-out points,
+//   - the size of the table on disk, and
+//   - the lookup throughput of the Spiner EOS classes.
+// Prints the Pareto front of these three and recommends the smallest
+// table that meets each requested error budget.
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <hdf5.h>
+#include <hdf5_hl.h>
+
+#ifndef SPINER_USE_HDF
+#error "HDF5 must be enabled"
+#endif
+
+#include <eospac-wrapper/eospac_wrapper.hpp>
+#include <ports-of-call/portability.hpp>
+#include <singularity-eos/eos/eos.hpp>
+
+#include "generate_files.hpp"
+#include "io_eospac.hpp"
+#include "parser.hpp"
+
+using namespace EospacWrapper;
+using singularity::SpinerEOSDependsRhoSie;
+using singularity::SpinerEOSDependsRhoT;
+
+using Clock = std::chrono::high_resolution_clock;
+
+constexpr int NREPS = 10;
+constexpr int NSAMPLES_DEFAULT = 10000;
+constexpr Real REL_FLOOR = 1e-6;
+constexpr char TMPFILE[] = "autotune_tmp.sp5";
+
+struct Setting {
+  int ppdRho, ppdT;
+  int numRho, numT, numSie;
+  std::size_t bytes = 0;
+  Real errP = 0, errE = 0, errT = 0;
+  Real err = 0;
+  Real lookupsPerSecond = 0;
+  bool pareto = false;
+};
+
+template <typename T>
+std::vector<T> parseList(const std::string &s) {
+  std::vector<T> out;
+  std::stringstream ss(s);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    std::stringstream is(item);
+    T val;
+    is >> val;
+    out.push_back(val);
+  }
+  return out;
+}
+
+// The input deck with the per-decade resolutions replaced. Explicit
+// point counts are dropped, since they would override them.
+std::string deckWithResolution(const std::string &filename, int ppdRho, int ppdT) {
+  std::ifstream deck(filename);
+  if (!deck.is_open()) {
+    std::cerr << "Couldn't open input deck " << filename << std::endl;
+    std::exit(1);
+  }
+  std::stringstream out;
+  std::string line;
+  while (std::getline(deck, line)) {
+    std::string key = line.substr(0, line.find('='));
+    key.erase(std::remove_if(key.begin(), key.end(), isspace), key.end());
+    if (key == "numrho" || key == "numT" || key == "numsie" || key == "numrho/decade" ||
+        key == "numT/decade" || key == "numSie/decade") {
+      continue;
+    }
+    out << line << "\n";
+  }
+  out << "numrho/decade = " << ppdRho << "\n"
+      << "numT/decade = " << ppdT << "\n"
+      << "numSie/decade = " << ppdT << "\n";
+  return out.str();
+}
+
+// 99th percentile of the relative errors
+Real errorPercentile(const std::vector<Real> &val, const std::vector<Real> &ref) {
+  Real scale = 0;
+  for (const Real r : ref) {
+    scale = std::max(scale, std::abs(r));
+  }
+  std::vector<Real> err(val.size());
+  for (std::size_t k = 0; k < val.size(); ++k) {
+    err[k] = std::abs(val[k] - ref[k]) / std::max(std::abs(ref[k]), REL_FLOOR * scale);
+  }
+  if (err.empty()) return 0;
+  const std::size_t n = static_cast<std::size_t>(0.99 * (err.size() - 1));
+  std::nth_element(err.begin(), err.begin() + n, err.end());
+  return err[n];
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<int> ppdRhos = {20, 30, 40, 50, 70, 100};
+  std::vector<int> ppdTs = {20, 30, 40, 50, 70, 100};
+  std::vector<Real> budgets = {1e-2, 1e-3, 1e-4};
+  int nSamples = NSAMPLES_DEFAULT;
+  std::string csvname = "autotune.csv";
+  std::string filename;
+  Verbosity eospacWarn = Verbosity::Quiet;
+
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "-r") == 0 && i < argc - 1) {
+      ppdRhos = parseList<int>(argv[++i]);
+    } else if (std::strcmp(argv[i], "-t") == 0 && i < argc - 1) {
+      ppdTs = parseList<int>(argv[++i]);
+    } else if (std::strcmp(argv[i], "-e") == 0 && i < argc - 1) {
+      budgets = parseList<Real>(argv[++i]);
+    } else if (std::strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      nSamples = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "-o") == 0 && i < argc - 1) {
+      csvname = argv[++i];
+    } else if (std::strcmp(argv[i], "-v") == 0) {
+      eospacWarn = Verbosity::Verbose;
+    } else if (std::strcmp(argv[i], "-h") == 0) {
+      filename = "";
+      break;
+    } else {
+      filename = argv[i];
+    }
+  }
+  if (filename.empty() || ppdRhos.empty() || ppdTs.empty()) {
+    std::cerr << "Usage: " << argv[0]
+              << " [-r <list>] [-t <list>] [-e <list>] [-n <samples>] [-o <csv>] [-v]"
+              << " <parameter file>\n\n"
+              << "\t<parameter file>: sesame2spiner input deck for one material\n"
+              << "\t-r <list>: comma separated numrho/decade values to sweep\n"
+              << "\t-t <list>: comma separated numT/decade values to sweep.\n"
+              << "\t           numSie/decade is set to the same value\n"
+              << "\t-e <list>: comma separated relative error budgets\n"
+              << "\t-n <samples>: number of held-out points. Defaults to "
+              << NSAMPLES_DEFAULT << "\n"
+              << "\t-o <csv>: file to write all results to. Defaults to autotune.csv\n"
+              << "\t-v: print eospac warnings\n"
+              << std::endl;
+    return 1;
+  }
+
+#ifdef PORTABILITY_STRATEGY_KOKKOS
+  Kokkos::initialize();
+#endif
+  {
+    Params deck(filename);
+    if (!deck.Contains("matid")) {
+      std::cerr << "Material file " << filename << " is missing matid." << std::endl;
+      std::exit(1);
+    }
+    const int matid = deck.Get<int>("matid");
+    SesameMetadata metadata;
+    eosGetMetadata(matid, metadata, eospacWarn);
+    const std::string name = deck.Get("name", metadata.name);
+
+    std::cout << "sesame2spiner-autotune\n"
+              << "-----------------------------------------\n"
+              << "Material " << matid << " (" << name << ")\n"
+              << std::endl;
+
+    // Resolve the bounds of every setting first, so the held-out
+    // points can be drawn from the region covered by all of them.
+    std::vector<Setting> settings;
+    std::vector<Bounds> lRhos, lTs, les;
+    for (const int ppdRho : ppdRhos) {
+      for (const int ppdT : ppdTs) {
+        std::stringstream ss(deckWithResolution(filename, ppdRho, ppdT));
+        Params params(ss);
+        Bounds lRho, lT, le;
+        getMatBounds(0, matid, metadata, params, lRho, lT, le);
+        Setting s;
+        s.ppdRho = ppdRho;
+        s.ppdT = ppdT;
+        s.numRho = lRho.grid.nPoints();
+        s.numT = lT.grid.nPoints();
+        s.numSie = le.grid.nPoints();
+        settings.push_back(s);
+        lRhos.push_back(lRho);
+        lTs.push_back(lT);
+        les.push_back(le);
+      }
+    }
+    Real lRhoLo = lRhos[0].grid.min(), lRhoHi = lRhos[0].grid.max();
+    Real lTLo = lTs[0].grid.min(), lTHi = lTs[0].grid.max();
+    for (std::size_t s = 0; s < settings.size(); ++s) {
+      lRhoLo = std::max(lRhoLo, lRhos[s].grid.min());
+      lRhoHi = std::min(lRhoHi, lRhos[s].grid.max());
+      lTLo = std::max(lTLo, lTs[s].grid.min());
+      lTHi = std::min(lTHi, lTs[s].grid.max());
+    }
+
+    // Held-out points, uniformly distributed in the log-space of the
+    // tables, and the eospac reference values there
+    std::vector<Real> rhos, Ts, Ps, sies;
+    {
+      std::mt19937 gen(matid);
+      std::uniform_real_distribution<Real> dRho(lRhoLo, lRhoHi), dT(lTLo, lTHi);
+
+      constexpr int NT = 2;
+      constexpr EOS_INTEGER nXYPairs = 1;
+      EOS_INTEGER tableHandle[NT];
+      EOS_INTEGER tableType[NT] = {EOS_Pt_DT, EOS_Ut_DT};
+      EOS_REAL var[1], dx[1], dy[1];
+      eosSafeLoad(NT, matid, tableType, tableHandle, {"EOS_Pt_DT", "EOS_Ut_DT"},
+                  eospacWarn);
+      for (int k = 0; k < nSamples; ++k) {
+        const Real rho = lRhos[0].log2lin(dRho(gen));
+        const Real T = lTs[0].log2lin(dT(gen));
+        EOS_REAL sesRho = densityToSesame(rho);
+        EOS_REAL sesT = temperatureToSesame(T);
+        bool no_errors = eosSafeInterpolate(&tableHandle[0], nXYPairs, &sesRho, &sesT,
+                                            var, dx, dy, "PofRT", eospacWarn);
+        const Real P = pressureFromSesame(var[0]);
+        no_errors = no_errors && eosSafeInterpolate(&tableHandle[1], nXYPairs, &sesRho,
+                                                    &sesT, var, dx, dy, "EofRT",
+                                                    eospacWarn);
+        const Real sie = sieFromSesame(var[0]);
+        if (!no_errors) continue;
+        rhos.push_back(rho);
+        Ts.push_back(T);
+        Ps.push_back(P);
+        sies.push_back(sie);
+      }
+      eosSafeDestroy(NT, tableHandle, eospacWarn);
+    }
+    const std::size_t n = rhos.size();
+    std::cout << "Using " << n << " held-out points" << std::endl;
+
+    for (std::size_t s = 0; s < settings.size(); ++s) {
+      Setting &set = settings[s];
+      std::cout << "...numrho/decade = " << set.ppdRho << ", numT/decade = " << set.ppdT
+                << std::endl;
+
+      hid_t file = H5Fcreate(TMPFILE, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+      herr_t status =
+          saveMaterial(file, metadata, lRhos[s], lTs[s], les[s], name, eospacWarn);
+      status += H5Fclose(file);
+      if (status != H5_SUCCESS) {
+        std::cerr << "WARNING: problem with HDf5" << std::endl;
+      }
+      set.bytes = static_cast<std::size_t>(
+          std::ifstream(TMPFILE, std::ios::binary | std::ios::ate).tellg());
+
+      SpinerEOSDependsRhoT eosRhoT(TMPFILE, matid);
+      SpinerEOSDependsRhoSie eosRhoSie(TMPFILE, matid);
+
+      std::vector<Real> P(n), sie(n), T(n);
+      for (std::size_t k = 0; k < n; ++k) {
+        P[k] = eosRhoT.PressureFromDensityTemperature(rhos[k], Ts[k]);
+        sie[k] = eosRhoT.InternalEnergyFromDensityTemperature(rhos[k], Ts[k]);
+        T[k] = eosRhoSie.TemperatureFromDensityInternalEnergy(rhos[k], sies[k]);
+      }
+      set.errP = errorPercentile(P, Ps);
+      set.errE = errorPercentile(sie, sies);
+      set.errT = errorPercentile(T, Ts);
+      set.err = std::max({set.errP, set.errE, set.errT});
+
+      // The lookups a hydro code does most: P(rho, T) and T(rho, sie)
+      Real sink = 0;
+      const auto start = Clock::now();
+      for (int rep = 0; rep < NREPS; ++rep) {
+        for (std::size_t k = 0; k < n; ++k) {
+          sink += eosRhoT.PressureFromDensityTemperature(rhos[k], Ts[k]);
+          sink += eosRhoSie.TemperatureFromDensityInternalEnergy(rhos[k], sies[k]);
+        }
+      }
+      const std::chrono::duration<Real> elapsed = Clock::now() - start;
+      set.lookupsPerSecond = (2.0 * NREPS * n) / std::max(elapsed.count(), 1e-12);
+      if (std::isnan(sink)) std::cout << "......NaN encountered in lookups" << std::endl;
+
+      eosRhoT.Finalize();
+      eosRhoSie.Finalize();
+      std::remove(TMPFILE);
+    }
+
+    // A setting is on the Pareto front if no other setting is at least
+    // as good in error, size and speed, and strictly better in one.
+    for (auto &a : settings) {
+      a.pareto = true;
+      for (const auto &b : settings) {
+        const bool asGood = (b.err <= a.err && b.bytes <= a.bytes &&
+                             b.lookupsPerSecond >= a.lookupsPerSecond);
+        const bool better = (b.err < a.err || b.bytes < a.bytes ||
+                             b.lookupsPerSecond > a.lookupsPerSecond);
+        if (asGood && better) {
+          a.pareto = false;
+          break;
+        }
+      }
+    }
+
+    std::ofstream csv(csvname);
+    csv << "numrho/decade,numT/decade,numrho,numT,numsie,bytes,"
+        << "err_P,err_sie,err_T,err,lookups_per_second,pareto\n";
+    for (const auto &set : settings) {
+      csv << set.ppdRho << "," << set.ppdT << "," << set.numRho << "," << set.numT << ","
+          << set.numSie << "," << set.bytes << "," << set.errP << "," << set.errE << ","
+          << set.errT << "," << set.err << "," << set.lookupsPerSecond << ","
+          << set.pareto << "\n";
+    }
+    std::cout << "\nWrote all results to " << csvname << std::endl;
+
+    std::cout << "\nPareto front (99th percentile relative error):\n"
+              << std::setw(14) << "numrho/decade" << std::setw(12) << "numT/decade"
+              << std::setw(12) << "MB" << std::setw(12) << "error" << std::setw(14)
+              << "Mlookups/s" << "\n";
+    for (const auto &set : settings) {
+      if (!set.pareto) continue;
+      std::cout << std::setw(14) << set.ppdRho << std::setw(12) << set.ppdT
+                << std::setw(12) << std::setprecision(4) << set.bytes / 1.0e6
+                << std::setw(12) << set.err << std::setw(14)
+                << set.lookupsPerSecond / 1.0e6 << "\n";
+    }
+
+    std::cout << "\nRecommended settings:\n";
+    for (const Real budget : budgets) {
+      const Setting *best = nullptr;
+      for (const auto &set : settings) {
+        if (set.err > budget) continue;
+        if (best == nullptr || set.bytes < best->bytes ||
+            (set.bytes == best->bytes && set.lookupsPerSecond > best->lookupsPerSecond)) {
+          best = &set;
+        }
+      }
+      std::cout << "...error <= " << budget << ": ";
+      if (best == nullptr) {
+        std::cout << "no setting in the sweep meets this budget\n";
+      } else {
+        std::cout << "numrho/decade = " << best->ppdRho
+                  << ", numT/decade = numSie/decade = " << best->ppdT << " ("
+                  << best->bytes / 1.0e6 << " MB)\n";
+      }
+    }
+    std::cout << std::endl;
+  }
+#ifdef PORTABILITY_STRATEGY_KOKKOS
+  Kokkos::finalize();
+#endif
+
+  return 0;
+}
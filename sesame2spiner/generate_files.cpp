@@ -14,9 +14,15 @@
 // publicly and display publicly, and to permit others to do so.
 //======================================================================
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
+#include <iomanip>
 #include <limits>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -31,7 +37,10 @@
 
 #include <eospac-wrapper/eospac_wrapper.hpp>
 #include <ports-of-call/portability.hpp>
+#include <singularity-eos/base/constants.hpp>
 #include <singularity-eos/base/sp5/singularity_eos_sp5.hpp>
+#include <singularity-eos/base/table_entropy.hpp>
+#include <singularity-eos/base/table_patches.hpp>
 #include <spiner/databox.hpp>
 #include <spiner/interpolation.hpp>
 #include <spiner/sp5.hpp>
@@ -42,10 +51,19 @@
 #include "parser.hpp"
 
 using namespace EospacWrapper;
+using singularity::TablePatches;
+namespace table_entropy = singularity::table_entropy;
+
+// Density-temperature fields refined by patches, in storage order
+static const std::vector<std::string> PATCH_FIELDS = {
+    SP5::Fields::P,    SP5::Fields::sie,    SP5::Fields::bMod,
+    SP5::Fields::dPdRho, SP5::Fields::dPdE, SP5::Fields::dTdRho,
+    SP5::Fields::dTdE, SP5::Fields::dEdRho, SP5::Fields::dEdT};
 
 herr_t saveMaterial(hid_t loc, const SesameMetadata &metadata, const Bounds &lRhoBounds,
                     const Bounds &lTBounds, const Bounds &leBounds,
-                    const std::string &name, Verbosity eospacWarn) {
+                    const std::string &name, Verbosity eospacWarn,
+                    const PatchOptions &patchOptions) {
 
   const int matid = metadata.matid;
   std::string sMatid = std::to_string(matid);
@@ -93,23 +111,11 @@ herr_t saveMaterial(hid_t loc, const SesameMetadata &metadata, const Bounds &lRh
   coldGroup =
       H5Gcreate(matGroup, SP5::Depends::coldCurve, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
 
+  // The density-temperature entropy and energy are kept to build the
+  // density-energy entropy from them.
+  DataBox sie, S;
   {
-    DataBox P, sie, T, bMod, dPdRho, dPdE, dTdRho, dTdE, dEdRho, mask;
-    eosDataOfRhoSie(matid, lRhoBounds, leBounds, P, T, bMod, dPdRho, dPdE, dTdRho, dTdE,
-                    dEdRho, mask, eospacWarn);
-    status += P.saveHDF(leGroup, SP5::Fields::P);
-    status += T.saveHDF(leGroup, SP5::Fields::T);
-    status += bMod.saveHDF(leGroup, SP5::Fields::bMod);
-    status += dPdRho.saveHDF(leGroup, SP5::Fields::dPdRho);
-    status += dPdE.saveHDF(leGroup, SP5::Fields::dPdE);
-    status += dTdRho.saveHDF(leGroup, SP5::Fields::dTdRho);
-    status += dTdE.saveHDF(leGroup, SP5::Fields::dTdE);
-    status += dEdRho.saveHDF(leGroup, SP5::Fields::dEdRho);
-    status += mask.saveHDF(leGroup, SP5::Fields::mask);
-  }
-
-  {
-    DataBox P, sie, T, bMod, dPdRho, dPdE, dTdRho, dTdE, dEdRho, dEdT, mask;
+    DataBox P, bMod, dPdRho, dPdE, dTdRho, dTdE, dEdRho, dEdT, mask;
     eosDataOfRhoT(matid, lRhoBounds, lTBounds, P, sie, bMod, dPdRho, dPdE, dTdRho, dTdE,
                   dEdRho, dEdT, mask, eospacWarn);
     status += P.saveHDF(lTGroup, SP5::Fields::P);
@@ -122,6 +128,35 @@ herr_t saveMaterial(hid_t loc, const SesameMetadata &metadata, const Bounds &lRh
     status += dEdRho.saveHDF(lTGroup, SP5::Fields::dEdRho);
     status += dEdT.saveHDF(lTGroup, SP5::Fields::dEdT);
     status += mask.saveHDF(lTGroup, SP5::Fields::mask);
+    table_entropy::EntropyOfRhoT(P, sie, lRhoBounds.offset, lTBounds.offset,
+                                 metadata.normalDensity, singularity::ROOM_TEMPERATURE,
+                                 S);
+    status += S.saveHDF(lTGroup, SP5::Fields::entropy);
+    if (patchOptions.Enabled()) {
+      status += savePatches(lTGroup, matid, lRhoBounds, lTBounds,
+                            {&P, &sie, &bMod, &dPdRho, &dPdE, &dTdRho, &dTdE, &dEdRho,
+                             &dEdT},
+                            patchOptions, eospacWarn);
+    }
+  }
+
+  // The density-energy tables are never patched. Tables with patches
+  // are rejected by SpinerEOSDependsRhoSie.
+  {
+    DataBox P, T, bMod, dPdRho, dPdE, dTdRho, dTdE, dEdRho, mask, SRhoSie;
+    eosDataOfRhoSie(matid, lRhoBounds, leBounds, P, T, bMod, dPdRho, dPdE, dTdRho, dTdE,
+                    dEdRho, mask, eospacWarn);
+    status += P.saveHDF(leGroup, SP5::Fields::P);
+    status += T.saveHDF(leGroup, SP5::Fields::T);
+    status += bMod.saveHDF(leGroup, SP5::Fields::bMod);
+    status += dPdRho.saveHDF(leGroup, SP5::Fields::dPdRho);
+    status += dPdE.saveHDF(leGroup, SP5::Fields::dPdE);
+    status += dTdRho.saveHDF(leGroup, SP5::Fields::dTdRho);
+    status += dTdE.saveHDF(leGroup, SP5::Fields::dTdE);
+    status += dEdRho.saveHDF(leGroup, SP5::Fields::dEdRho);
+    status += mask.saveHDF(leGroup, SP5::Fields::mask);
+    table_entropy::EntropyOfRhoSie(S, sie, lTBounds.offset, T, leBounds.offset, SRhoSie);
+    status += SRhoSie.saveHDF(leGroup, SP5::Fields::entropy);
   }
   {
     DataBox P, sie, dPdRho, dEdRho, bMod, mask, transitionMask;
@@ -146,15 +181,75 @@ herr_t saveMaterial(hid_t loc, const SesameMetadata &metadata, const Bounds &lRh
   return status;
 }
 
+herr_t savePatches(hid_t lTGroup, int matid, const Bounds &lRhoBounds,
+                   const Bounds &lTBounds, const std::vector<const DataBox *> &tables,
+                   const PatchOptions &options, Verbosity eospacWarn) {
+  // Flag the cells where the tables, sampled at twice their
+  // resolution, differ from the linear interpolant of the tables in
+  // pressure or energy. The refined nodes then come from eospac.
+  const int n1cells = lRhoBounds.grid.nPoints() - 1;
+  const int n0cells = lTBounds.grid.nPoints() - 1;
+  std::vector<int> flags;
+  {
+    const Bounds lRhoFine(lRhoBounds.grid.min(), lRhoBounds.grid.max(), 2 * n1cells + 1,
+                          lRhoBounds.offset);
+    const Bounds lTFine(lTBounds.grid.min(), lTBounds.grid.max(), 2 * n0cells + 1,
+                        lTBounds.offset);
+    DataBox P, sie, bMod, dPdRho, dPdE, dTdRho, dTdE, dEdRho, dEdT, mask;
+    eosDataOfRhoT(matid, lRhoFine, lTFine, P, sie, bMod, dPdRho, dPdE, dTdRho, dTdE,
+                  dEdRho, dEdT, mask, eospacWarn);
+    flags = TablePatches::FlagCells(*tables[0], P, options.tolerance);
+    const auto sieFlags = TablePatches::FlagCells(*tables[1], sie, options.tolerance);
+    for (std::size_t c = 0; c < flags.size(); ++c) {
+      flags[c] = flags[c] || sieFlags[c];
+    }
+  }
+  const auto layout = TablePatches::Cover(flags, n1cells, n0cells);
+  TablePatches patches(*tables[0], layout, options.refinement, PATCH_FIELDS.size());
+  for (int p = 0; p < patches.NumPatches(); ++p) {
+    Real lRhoLo, lRhoHi, lTLo, lTHi;
+    int n1, n0;
+    patches.PatchBounds(p, lRhoLo, lRhoHi, lTLo, lTHi);
+    patches.PatchShape(p, n1, n0);
+    DataBox P, sie, bMod, dPdRho, dPdE, dTdRho, dTdE, dEdRho, dEdT, mask;
+    eosDataOfRhoT(matid, Bounds(lRhoLo, lRhoHi, n1, lRhoBounds.offset),
+                  Bounds(lTLo, lTHi, n0, lTBounds.offset), P, sie, bMod, dPdRho, dPdE,
+                  dTdRho, dTdE, dEdRho, dEdT, mask, eospacWarn);
+    const DataBox *fine[] = {&P, &sie, &bMod, &dPdRho, &dPdE, &dTdRho, &dTdE, &dEdRho,
+                             &dEdT};
+    for (std::size_t field = 0; field < PATCH_FIELDS.size(); ++field) {
+      patches.SetPatchData(field, p, *fine[field]);
+    }
+  }
+  for (std::size_t field = 0; field < PATCH_FIELDS.size(); ++field) {
+    patches.Conform(field, *tables[field]);
+  }
+  if (eospacWarn == Verbosity::Debug) {
+    std::cout << "patches: " << patches.NumPatches() << " covering "
+              << std::count(flags.begin(), flags.end(), 1) << " of "
+              << n1cells * n0cells << " cells with " << patches.NumNodes()
+              << " nodes" << std::endl;
+  }
+  herr_t status = patches.saveHDF(lTGroup, PATCH_FIELDS);
+  patches.Finalize();
+  return status;
+}
+
 herr_t saveAllMaterials(const std::string &savename,
                         const std::vector<std::string> &filenames, bool printMetadata,
-                        Verbosity eospacWarn) {
+                        bool sharedGrid, bool incremental,
+                        SP5::Compression::Options compression, Verbosity eospacWarn) {
   std::vector<Params> params;
   std::vector<int> matids;
   std::unordered_map<std::string, int> used_names;
   std::unordered_set<int> used_matids;
+  std::vector<SesameMetadata> metadatas;
+  std::vector<std::string> names;
+  std::vector<Bounds> lRhoBounds, lTBounds, leBounds;
+  std::vector<PatchOptions> patchOptions;
   SesameMetadata metadata;
   hid_t file;
+  hid_t prevFile = -1;
   herr_t status = H5_SUCCESS;
 
   for (auto const &filename : filenames) {
@@ -169,9 +264,6 @@ herr_t saveAllMaterials(const std::string &savename,
     params.push_back(p);
   }
 
-  std::cout << "Saving to file " << savename << std::endl;
-  file = H5Fcreate(savename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
-
   std::cout << "Processing " << matids.size() << " materials..." << std::endl;
 
   for (size_t i = 0; i < matids.size(); i++) {
@@ -204,16 +296,77 @@ herr_t saveAllMaterials(const std::string &savename,
       used_names[name] = 1;
     }
 
-    Bounds lRhoBounds, lTBounds, leBounds;
-    getMatBounds(i, matid, metadata, params[i], lRhoBounds, lTBounds, leBounds);
+    Bounds lRho, lT, le;
+    getMatBounds(i, matid, metadata, params[i], lRho, lT, le);
 
-    if (eospacWarn == Verbosity::Debug) {
-      std::cout << "bounds for log(rho), log(T), log(sie) are:\n"
-                << lRhoBounds << lTBounds << leBounds << std::endl;
+    metadatas.push_back(metadata);
+    names.push_back(name);
+    lRhoBounds.push_back(lRho);
+    lTBounds.push_back(lT);
+    leBounds.push_back(le);
+    patchOptions.push_back(getPatchOptions(matid, params[i]));
+  }
+
+  if (sharedGrid) {
+    std::cout << "Placing all materials on a shared density-temperature grid."
+              << std::endl;
+    const Bounds lRhoShared = getSharedBounds("log(rho)", lRhoBounds);
+    const Bounds lTShared = getSharedBounds("log(T)", lTBounds);
+    for (size_t i = 0; i < metadatas.size(); i++) {
+      lRhoBounds[i] = lRhoShared;
+      lTBounds[i] = lTShared;
     }
+  }
+
+  // Lossy compression applies to the derivative fields. This is
+  // decided up front since it enters the input hash.
+  if (compression.Enabled() && compression.lossyBits > 0) {
+    compression.lossyFields = {SP5::Fields::dPdRho, SP5::Fields::dPdE,
+                               SP5::Fields::dTdRho, SP5::Fields::dTdE,
+                               SP5::Fields::dEdRho, SP5::Fields::dEdT};
+  }
+
+  // In incremental mode, the previous output is read while a new file
+  // is written next to it. When compressing, the new file is repacked
+  // into the final one. Otherwise it replaces the old one at the end.
+  const std::string tmpname = savename + ".tmp";
+  std::string outname = compression.Enabled() ? tmpname : savename;
+  if (incremental) {
+    if (std::ifstream(savename).good() && H5Fis_hdf5(savename.c_str()) > 0) {
+      std::cout << "Reusing unchanged materials from " << savename << std::endl;
+      prevFile = H5Fopen(savename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+      outname = tmpname;
+    } else {
+      std::cout << "No previous file " << savename << " found. "
+                << "Generating all materials." << std::endl;
+    }
+  }
+
+  std::cout << "Saving to file " << savename << std::endl;
+  file = H5Fcreate(outname.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
 
-    status +=
-        saveMaterial(file, metadata, lRhoBounds, lTBounds, leBounds, name, eospacWarn);
+  for (size_t i = 0; i < metadatas.size(); i++) {
+    const int matid = metadatas[i].matid;
+    const std::string hash =
+        hashMaterial(metadatas[i], lRhoBounds[i], lTBounds[i], leBounds[i], names[i],
+                     patchOptions[i], compression);
+
+    if (prevFile >= 0 && getMaterialHash(prevFile, matid) == hash) {
+      std::cout << "...reusing " << matid << std::endl;
+      status += copyMaterial(prevFile, file, matid, names[i]);
+    } else {
+      std::cout << "...saving " << matid << std::endl;
+
+      if (eospacWarn == Verbosity::Debug) {
+        std::cout << "bounds for log(rho), log(T), log(sie) are:\n"
+                  << lRhoBounds[i] << lTBounds[i] << leBounds[i] << std::endl;
+      }
+
+      status += saveMaterial(file, metadatas[i], lRhoBounds[i], lTBounds[i], leBounds[i],
+                             names[i], eospacWarn, patchOptions[i]);
+      status += H5LTset_attribute_string(file, std::to_string(matid).c_str(),
+                                         SP5::Material::inputHash, hash.c_str());
+    }
     if (status != H5_SUCCESS) {
       std::cerr << "WARNING: problem with HDf5" << std::endl;
     }
@@ -221,12 +374,157 @@ herr_t saveAllMaterials(const std::string &savename,
 
   std::cout << "Cleaning up." << std::endl;
   status += H5Fclose(file);
+  if (prevFile >= 0) status += H5Fclose(prevFile);
+  if (compression.Enabled()) {
+    std::cout << "Compressing with deflate level " << compression.level << std::endl;
+    if (compression.lossyBits > 0) {
+      std::cout << "Keeping " << compression.lossyBits
+                << " mantissa bits in derivative fields" << std::endl;
+    }
+    status += SP5::Compression::Repack(outname, savename, compression);
+    std::remove(outname.c_str());
+  } else if (outname != savename) {
+    if (std::rename(outname.c_str(), savename.c_str()) != 0) {
+      std::cerr << "WARNING: could not move " << outname << " to " << savename
+                << std::endl;
+      status += 1;
+    }
+  }
   if (status != H5_SUCCESS) {
     std::cerr << "WARNING: problem with HDf5" << std::endl;
   }
   return status;
 }
 
+herr_t copyMaterial(hid_t src, hid_t dst, int matid, const std::string &name) {
+  // Copies the material group, including its attributes and the input
+  // hash, and recreates the link from the material name.
+  const std::string sMatid = std::to_string(matid);
+  herr_t status = H5Ocopy(src, sMatid.c_str(), dst, sMatid.c_str(), H5P_DEFAULT,
+                          H5P_DEFAULT);
+  status += H5Lcreate_soft(sMatid.c_str(), dst, name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+  return status;
+}
+
+std::string hashMaterial(const SesameMetadata &metadata, const Bounds &lRhoBounds,
+                         const Bounds &lTBounds, const Bounds &leBounds,
+                         const std::string &name, const PatchOptions &patchOptions,
+                         const SP5::Compression::Options &compression) {
+  // The resolved bounds already fold in the input deck, the defaults
+  // pulled from the sesame metadata, and the shared grid option. The
+  // metadata stands in for the source table. Bump the version string
+  // when the table format or sampling changes.
+  constexpr char version[] = "sesame2spiner-2";
+  std::stringstream ss;
+  ss << std::setprecision(std::numeric_limits<Real>::max_digits10);
+  ss << version << "\n"
+     << metadata.matid << "\n"
+     << name << "\n"
+     << metadata.name << "\n"
+     << metadata.comments << "\n"
+     << metadata.exchangeCoefficient << " " << metadata.meanAtomicMass << " "
+     << metadata.meanAtomicNumber << " " << metadata.solidBulkModulus << " "
+     << metadata.normalDensity << "\n"
+     << metadata.rhoMin << " " << metadata.rhoMax << " " << metadata.TMin << " "
+     << metadata.TMax << " " << metadata.sieMin << " " << metadata.sieMax << "\n"
+     << metadata.rhoConversionFactor << " " << metadata.TConversionFactor << " "
+     << metadata.sieConversionFactor << " " << metadata.numRho << " "
+     << metadata.numT << "\n";
+  for (const Bounds *b : {&lRhoBounds, &lTBounds, &leBounds}) {
+    ss << b->grid.min() << " " << b->grid.max() << " " << b->grid.nPoints() << " "
+       << b->offset << "\n";
+  }
+  // Only tables with patches depend on the patch options, so existing
+  // hashes stay valid.
+  if (patchOptions.Enabled()) {
+    ss << "patches " << patchOptions.tolerance << " " << patchOptions.refinement << "\n";
+  }
+  // Likewise for compression. A material reused from a previous file
+  // is repacked again, so lossy rounding must match for it to be
+  // reused.
+  if (compression.Enabled()) {
+    ss << "compression " << compression.level << " " << compression.lossyBits;
+    if (compression.lossyBits > 0) {
+      for (const auto &field : compression.lossyFields) {
+        ss << " " << field;
+      }
+    }
+    ss << "\n";
+  }
+
+  // 64-bit FNV-1a
+  const std::string data = ss.str();
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (const char c : data) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  std::stringstream hex;
+  hex << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return hex.str();
+}
+
+std::string getMaterialHash(hid_t loc, int matid) {
+  // Returns an empty string if the material or its hash is missing
+  const std::string sMatid = std::to_string(matid);
+  if (H5Lexists(loc, sMatid.c_str(), H5P_DEFAULT) <= 0) return "";
+  if (H5Aexists_by_name(loc, sMatid.c_str(), SP5::Material::inputHash, H5P_DEFAULT) <=
+      0) {
+    return "";
+  }
+  hsize_t dims;
+  H5T_class_t typeClass;
+  size_t typeSize;
+  herr_t status = H5LTget_attribute_info(loc, sMatid.c_str(), SP5::Material::inputHash,
+                                         &dims, &typeClass, &typeSize);
+  if (status != H5_SUCCESS || typeClass != H5T_STRING) return "";
+  std::vector<char> buffer(typeSize + 1, '\0');
+  status = H5LTget_attribute_string(loc, sMatid.c_str(), SP5::Material::inputHash,
+                                    buffer.data());
+  if (status != H5_SUCCESS) return "";
+  return std::string(buffer.data());
+}
+
+Bounds getSharedBounds(const std::string &name, const std::vector<Bounds> &bounds) {
+  // The shared grid covers the region where all tables overlap, at
+  // the finest resolution requested for any material. Material
+  // specific anchor points are not preserved.
+  Real min = -std::numeric_limits<Real>::infinity();
+  Real max = std::numeric_limits<Real>::infinity();
+  Real dx = std::numeric_limits<Real>::infinity();
+  const Real offset = bounds.empty() ? 0 : bounds[0].offset;
+  for (auto const &b : bounds) {
+    if (b.offset != offset) {
+      std::cerr << "ERROR: materials require different offsets in " << name
+                << " and cannot share a grid." << std::endl;
+      std::exit(1);
+    }
+    min = std::max(min, b.grid.min());
+    max = std::min(max, b.grid.max());
+    dx = std::min(dx, b.grid.dx());
+  }
+  if (!(min < max)) {
+    std::cerr << "ERROR: material tables do not overlap in " << name
+              << " and cannot share a grid." << std::endl;
+    std::exit(1);
+  }
+  const int N = static_cast<int>(std::ceil((max - min) / dx)) + 1;
+  return Bounds(min, max, N, offset);
+}
+
+PatchOptions getPatchOptions(int matid, const Params &params) {
+  PatchOptions options;
+  options.tolerance = params.Get("patchTolerance", 0.0);
+  options.refinement = params.Get("patchRefinement", PATCH_REFINEMENT_DEFAULT);
+  if (options.tolerance < 0 || options.refinement < 1) {
+    std::cerr << "WARNING [" << matid << "]: "
+              << "patchTolerance < 0 or patchRefinement < 1. Patches disabled."
+              << std::endl;
+    options.tolerance = 0;
+  }
+  return options;
+}
+
 void getMatBounds(int i, int matid, const SesameMetadata &metadata, const Params &params,
                   Bounds &lRhoBounds, Bounds &lTBounds, Bounds &leBounds) {
 
@@ -24,6 +24,7 @@
 #include <hdf5_hl.h>
 
 #include <eospac-wrapper/eospac_wrapper.hpp>
+#include <singularity-eos/base/sp5/sp5_compression.hpp>
 
 #include "io_eospac.hpp"
 #include "parser.hpp"
@@ -32,14 +33,42 @@ using namespace EospacWrapper;
 
 constexpr int PPD_DEFAULT = 50;
 constexpr Real STRICTLY_POS_MIN = 1e-9;
+constexpr int PATCH_REFINEMENT_DEFAULT = 4;
+
+// Refined patches of the density-temperature tables, placed where
+// linear interpolation misses the data by more than tolerance
+struct PatchOptions {
+  Real tolerance = 0; // zero disables patches
+  int refinement = PATCH_REFINEMENT_DEFAULT;
+  bool Enabled() const { return tolerance > 0 && refinement > 1; }
+};
 
 herr_t saveMaterial(hid_t loc, const SesameMetadata &metadata, const Bounds &lRhoBounds,
                     const Bounds &lTBounds, const Bounds &leBounds,
-                    const std::string &name, Verbosity eospacWarn = Verbosity::Quiet);
+                    const std::string &name, Verbosity eospacWarn = Verbosity::Quiet,
+                    const PatchOptions &patchOptions = PatchOptions());
+
+herr_t savePatches(hid_t lTGroup, int matid, const Bounds &lRhoBounds,
+                   const Bounds &lTBounds, const std::vector<const DataBox *> &tables,
+                   const PatchOptions &options, Verbosity eospacWarn);
 
 herr_t saveAllMaterials(const std::string &savename,
                         const std::vector<std::string> &filenames, bool printMetadata,
-                        Verbosity eospacWarn);
+                        bool sharedGrid, bool incremental,
+                        SP5::Compression::Options compression, Verbosity eospacWarn);
+
+herr_t copyMaterial(hid_t src, hid_t dst, int matid, const std::string &name);
+
+std::string hashMaterial(const SesameMetadata &metadata, const Bounds &lRhoBounds,
+                         const Bounds &lTBounds, const Bounds &leBounds,
+                         const std::string &name, const PatchOptions &patchOptions,
+                         const SP5::Compression::Options &compression);
+
+std::string getMaterialHash(hid_t loc, int matid);
+
+Bounds getSharedBounds(const std::string &name, const std::vector<Bounds> &bounds);
+
+PatchOptions getPatchOptions(int matid, const Params &params);
 
 void getMatBounds(int i, int matid, const SesameMetadata &metadata, const Params &params,
                   Bounds &lRhoBounds, Bounds &lTBounds, Bounds &leBounds);
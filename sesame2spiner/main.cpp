@@ -42,9 +42,13 @@ int main(int argc, char *argv[]) {
   std::string savename, helpMessage;
   Verbosity eospacWarn = Verbosity::Quiet;
   bool printMetadata = false;
+  bool sharedGrid = false;
+  bool incremental = false;
+  SP5::Compression::Options compression;
   herr_t status = H5_SUCCESS;
 
-  parseCLI(argc, argv, savename, filenames, printMetadata, eospacWarn, helpMessage);
+  parseCLI(argc, argv, savename, filenames, printMetadata, sharedGrid, incremental,
+           compression, eospacWarn, helpMessage);
 
   std::cout << "sesame2spiner                            \n"
             << "-----------------------------------------\n"
@@ -52,7 +56,8 @@ int main(int argc, char *argv[]) {
             << "-----------------------------------------\n"
             << std::endl;
 
-  status = saveAllMaterials(savename, filenames, printMetadata, eospacWarn);
+  status = saveAllMaterials(savename, filenames, printMetadata, sharedGrid, incremental,
+                            compression, eospacWarn);
 
   std::cout << "Done." << std::endl;
 
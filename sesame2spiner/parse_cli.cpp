@@ -25,20 +25,44 @@
 #include "io_eospac.hpp"
 #include "parse_cli.hpp"
 
+// Reads the integer value of the option at argv[i] into value. Returns
+// false if the value is missing, not an integer, or outside [lo, hi].
+static bool parseIntOption(int argc, char *argv[], int &i, int lo, int hi, int &value) {
+  if (i + 1 >= argc) return false;
+  const char *arg = argv[++i];
+  char *end;
+  const long v = std::strtol(arg, &end, 10);
+  if (end == arg || *end != '\0' || v < lo || v > hi) return false;
+  value = static_cast<int>(v);
+  return true;
+}
+
 void parseCLI(int argc, char *argv[], std::string &savename,
               std::vector<std::string> &filenames, bool &printMetadata,
-              Verbosity &eospacWarn, std::string &helpMessage) {
+              bool &sharedGrid, bool &incremental,
+              SP5::Compression::Options &compression, Verbosity &eospacWarn,
+              std::string &helpMessage) {
 
   filenames.clear();
 
   std::stringstream helpStream;
   helpStream << "Usage: " << argv[0]
-             << "[-p] [-w] [-h] [-v] [-vv] [-d] [-s <savename>] <parameter files>\n\n"
+             << "[-p] [-g] [-i] [-z <level>] [-l <bits>] [-w] [-h] [-v] [-vv] [-d] "
+             << "[-s <savename>] "
+             << "<parameter files>\n\n"
              << "\t <parameter files>: input files, one per material\n"
              << "\t-s <savename>: filename to save to. Defaults to " << DEFAULT_SAVENAME
              << "\n"
              << "\t-p:  print metadata associated with materials "
              << "in parameter files\n"
+             << "\t-g:  tabulate all materials on a shared density-temperature grid\n"
+             << "\t-i:  incremental. Only regenerate materials whose inputs changed\n"
+             << "\t     since <savename> was written. Others are copied.\n"
+             << "\t-z <level>: write chunked datasets compressed with deflate level\n"
+             << "\t     <level> in [1, 9]\n"
+             << "\t-l <bits>: with -z, keep only <bits> mantissa bits in derivative\n"
+             << "\t     fields, <bits> in [1, 51]. Lossy, with relative error\n"
+             << "\t     below 2^-(bits+1)\n"
              << "\t-v:  print eospac warnings\n"
              << "\t-vv: print debug information\n"
              << "\t-w:  same as -v\n"
@@ -60,12 +84,28 @@ void parseCLI(int argc, char *argv[], std::string &savename,
     std::cout << helpMessage << std::endl;
     std::exit(0);
   }
+  auto badOption = [&](const char *msg) {
+    std::cerr << msg << "\n\n" << helpMessage << std::endl;
+    std::exit(1);
+  };
   for (int i = 1; i < argc; i++) {
     if (std::strcmp(argv[i], "-h") == 0) {
       std::cout << helpMessage << std::endl;
       std::exit(0);
     } else if (std::strcmp(argv[i], "-p") == 0) {
       printMetadata = true;
+    } else if (std::strcmp(argv[i], "-g") == 0) {
+      sharedGrid = true;
+    } else if (std::strcmp(argv[i], "-i") == 0) {
+      incremental = true;
+    } else if (std::strcmp(argv[i], "-z") == 0) {
+      if (!parseIntOption(argc, argv, i, 1, 9, compression.level)) {
+        badOption("-z requires a deflate level in [1, 9]");
+      }
+    } else if (std::strcmp(argv[i], "-l") == 0) {
+      if (!parseIntOption(argc, argv, i, 1, 51, compression.lossyBits)) {
+        badOption("-l requires a number of mantissa bits in [1, 51]");
+      }
     } else if ((std::strcmp(argv[i], "-w") == 0 || std::strcmp(argv[i], "-v") == 0) &&
                eospacWarn == Verbosity::Quiet) {
       eospacWarn = Verbosity::Verbose;
@@ -73,6 +113,7 @@ void parseCLI(int argc, char *argv[], std::string &savename,
                eospacWarn != Verbosity::Debug) {
       eospacWarn = Verbosity::Debug;
     } else if (std::strcmp(argv[i], "-s") == 0) {
+      if (i + 1 >= argc) badOption("-s requires a file name");
       savename = argv[++i];
     } else {
       filenames.push_back(std::string(argv[i]));
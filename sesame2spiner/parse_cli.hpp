@@ -21,6 +21,8 @@
 #include <string>
 #include <vector>
 
+#include <singularity-eos/base/sp5/sp5_compression.hpp>
+
 const std::string DEFAULT_SAVENAME = "materials.sp5";
 const std::string EXAMPLESTRING = R"(
 # air.dat
@@ -62,10 +64,18 @@ Tmin = 1
 shrinklRhoBounds = 0.15
 shrinklTBounds = 0.15
 shrinkleBounds = 0.5
+# Refine the density-temperature tables with patches wherever
+# linear interpolation misses pressure or energy by a relative
+# error above patchTolerance. Patches have patchRefinement times
+# the resolution of the table. Off by default.
+patchTolerance = 1e-3
+patchRefinement = 4
 )";
 
 void parseCLI(int argc, char *argv[], std::string &savename,
               std::vector<std::string> &filenames, bool &printMetadata,
-              Verbosity &eospacWarn, std::string &helpMessage);
+              bool &sharedGrid, bool &incremental,
+              SP5::Compression::Options &compression, Verbosity &eospacWarn,
+              std::string &helpMessage);
 
 #endif // _SESAME2SPINER_PARSER_HPP_
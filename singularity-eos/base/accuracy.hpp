@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#ifndef SINGULARITY_EOS_BASE_ACCURACY_HPP_
+#define SINGULARITY_EOS_BASE_ACCURACY_HPP_
+
+#include <ports-of-call/portability.hpp>
+#include <singularity-eos/base/root-finding-1d/root_finding.hpp>
+
+namespace singularity {
+
+// Named presets for AccuracyParams. Default reproduces the compile-time
+// constants the library has always used.
+enum class AccuracyTier { Fast = 0, Default = 1, Strict = 2 };
+
+// Tolerances and iteration limits for table inversions and PTE solves.  Tabulated
+// EOS models hold a copy, set with SetAccuracy, and the PTE solvers take one as an
+// optional constructor argument.  The individual fields may be adjusted after a
+// tier is chosen.
+struct AccuracyParams {
+  // Table inversions
+  Real root_thresh = 1.e-14;
+  int root_max_iter = RootFinding1D::SECANT_NITER_MAX;
+  int newton_max_iter = RootFinding1D::NEWTON_RAPHSON_NITER_MAX;
+  // PTE convergence
+  Real pte_rel_tolerance_p = 1.e-6;
+  Real pte_rel_tolerance_e = 1.e-6;
+  Real pte_rel_tolerance_t = 1.e-4;
+  Real pte_abs_tolerance_p = 0.0;
+  Real pte_abs_tolerance_e = 1.e-4;
+  Real pte_abs_tolerance_t = 0.0;
+  Real pte_residual_tolerance = 1.e-8;
+  int pte_max_iter_per_mat = 128;
+  // PTE line search
+  Real line_search_alpha = 1.e-2;
+  int line_search_max_iter = 6;
+  Real line_search_fac = 0.5;
+  // PTE mixed precision.  If positive, Newton steps taken while the residual
+  // norm is above this value are solved in single precision.
+  Real pte_mixed_precision_residual = 0.0;
+
+  constexpr AccuracyParams() = default;
+  PORTABLE_INLINE_FUNCTION
+  constexpr explicit AccuracyParams(const AccuracyTier tier) {
+    if (tier == AccuracyTier::Fast) {
+      root_thresh = 1.e-8;
+      root_max_iter = 100;
+      newton_max_iter = 20;
+      pte_rel_tolerance_p = 1.e-4;
+      pte_rel_tolerance_e = 1.e-4;
+      pte_rel_tolerance_t = 1.e-3;
+      pte_abs_tolerance_e = 1.e-3;
+      pte_residual_tolerance = 1.e-6;
+      pte_max_iter_per_mat = 32;
+      line_search_max_iter = 3;
+    } else if (tier == AccuracyTier::Strict) {
+      root_thresh = 1.e-15;
+      root_max_iter = 2 * RootFinding1D::SECANT_NITER_MAX;
+      newton_max_iter = 2 * RootFinding1D::NEWTON_RAPHSON_NITER_MAX;
+      pte_rel_tolerance_p = 1.e-8;
+      pte_rel_tolerance_e = 1.e-8;
+      pte_rel_tolerance_t = 1.e-6;
+      pte_abs_tolerance_e = 1.e-6;
+      pte_residual_tolerance = 1.e-10;
+      pte_max_iter_per_mat = 256;
+      line_search_max_iter = 10;
+    }
+  }
+};
+
+} // namespace singularity
+
+#endif // SINGULARITY_EOS_BASE_ACCURACY_HPP_
@@ -34,6 +34,13 @@ constexpr unsigned long all_values = (1 << 7) - 1;
 constexpr size_t MAX_NUM_LAMBDAS = 3;
 enum class DataStatus { Deallocated = 0, OnDevice = 1, OnHost = 2 };
 enum class TableStatus { OnTable = 0, OffBottom = 1, OffTop = 2 };
+// The pairs of known quantities accepted by InvertState
+enum class InputPair {
+  DensityPressure = 0,
+  PressureTemperature = 1,
+  PressureEnergy = 2,
+  DensityEntropy = 3
+};
 constexpr Real ROOM_TEMPERATURE = 293; // K
 constexpr Real ATMOSPHERIC_PRESSURE = 1e6;
 
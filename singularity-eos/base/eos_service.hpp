@@ -0,0 +1,551 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#ifndef SINGULARITY_EOS_BASE_EOS_SERVICE_HPP_
+#define SINGULARITY_EOS_BASE_EOS_SERVICE_HPP_
+
+// A node-local EOS evaluation service over POSIX shared memory.
+//
+// One process, the server, owns a list of equations of state, its
+// materials, and a named shared memory segment holding a ring of
+// request slots. Other processes on the node, the clients, open the
+// segment by name and submit two-input queries (the vector functions
+// enumerated by query_trace::Query) into free slots. Each call to
+// Server::Poll gathers the ready slots, groups them by material and
+// query, and evaluates every group with one call to the vector
+// function of that material, so that many small client requests
+// become a few large vector calls. Tables are loaded once, by the
+// server.
+//
+// Requests larger than a slot are split by the client. Lambdas travel
+// with the request and are handed to the EOS in place, so values
+// cached in them by the EOS are returned to the client.
+//
+// The server evaluates on host memory, so the service is only
+// available when the default execution space can access it. A client
+// that dies while holding a slot leaks that slot until the server is
+// restarted.
+
+#ifdef SINGULARITY_ENABLE_EOS_SERVICE
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <ports-of-call/portability.hpp>
+#include <singularity-eos/base/constants.hpp>
+#include <singularity-eos/base/query_trace.hpp>
+
+namespace singularity {
+namespace eos_service {
+
+using query_trace::Query;
+
+constexpr std::uint64_t MAGIC = 0x3130565253454753; // "SGESRV01"
+
+enum class SlotState : std::uint32_t {
+  Free = 0,
+  // a client is filling the slot
+  Claimed = 1,
+  // waiting for the server
+  Ready = 2,
+  // results are in the slot
+  Done = 3,
+  // the server rejected the request
+  Failed = 4
+};
+
+struct Options {
+  // number of request slots in the ring
+  int nslots = 64;
+  // maximum number of points per slot
+  int slot_capacity = 4096;
+  // after finding a ready request, Serve waits up to this long for
+  // more to arrive before evaluating, trading latency for batch size
+  int batch_window_us = 0;
+};
+
+struct Stats {
+  std::uint64_t nrequests = 0;
+  std::uint64_t nbatches = 0;
+  std::uint64_t npoints = 0;
+  // mean number of points per vector call
+  double PointsPerBatch() const {
+    return (nbatches > 0) ? static_cast<double>(npoints) / nbatches : 0;
+  }
+};
+
+namespace impl {
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free &&
+                  std::atomic<std::uint64_t>::is_always_lock_free,
+              "The EOS service needs lock-free atomics in shared memory");
+
+constexpr std::size_t ALIGN = 64;
+constexpr std::size_t RoundUp(const std::size_t n) {
+  return (n + ALIGN - 1) / ALIGN * ALIGN;
+}
+
+struct SegmentHeader {
+  std::uint64_t magic;
+  std::uint32_t nslots;
+  std::uint32_t capacity;
+  std::uint32_t nmaterials;
+  std::uint32_t slot_bytes;
+  std::atomic<std::uint32_t> alive;
+  std::atomic<std::uint64_t> cursor;
+  std::atomic<std::uint64_t> nrequests;
+  std::atomic<std::uint64_t> nbatches;
+  std::atomic<std::uint64_t> npoints;
+};
+
+struct SlotHeader {
+  std::atomic<std::uint32_t> state;
+  std::uint32_t query;
+  std::int32_t material;
+  std::uint32_t num;
+  std::uint32_t nlambda;
+};
+
+// A slot is a SlotHeader followed by capacity values each of x, y,
+// and out, and capacity * MAX_NUM_LAMBDAS lambda values. Point i owns
+// lambdas [i * MAX_NUM_LAMBDAS, (i + 1) * MAX_NUM_LAMBDAS).
+inline std::size_t SlotBytes(const std::size_t capacity) {
+  return RoundUp(RoundUp(sizeof(SlotHeader)) +
+                 sizeof(Real) * capacity * (3 + MAX_NUM_LAMBDAS));
+}
+
+// A mapped segment, shared by Server and Client
+class Segment {
+ public:
+  Segment() = default;
+  Segment(const Segment &) = delete;
+  Segment &operator=(const Segment &) = delete;
+  ~Segment() { Unmap(); }
+
+  static std::string ShmName(const std::string &name) {
+    return (!name.empty() && name[0] == '/') ? name : "/" + name;
+  }
+  bool Create(const std::string &name, const std::size_t bytes) {
+    const int fd = shm_open(ShmName(name).c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) return false;
+    if (ftruncate(fd, bytes) != 0) {
+      close(fd);
+      shm_unlink(ShmName(name).c_str());
+      return false;
+    }
+    return Map_(fd, bytes);
+  }
+  bool Open(const std::string &name) {
+    const int fd = shm_open(ShmName(name).c_str(), O_RDWR, 0600);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        static_cast<std::size_t>(st.st_size) < sizeof(SegmentHeader)) {
+      close(fd);
+      return false;
+    }
+    if (!Map_(fd, st.st_size)) return false;
+    if (Header()->magic != MAGIC) {
+      Unmap();
+      return false;
+    }
+    return true;
+  }
+  void Unmap() {
+    if (base_ != nullptr) munmap(base_, bytes_);
+    base_ = nullptr;
+    bytes_ = 0;
+  }
+  bool Mapped() const { return base_ != nullptr; }
+
+  SegmentHeader *Header() const { return static_cast<SegmentHeader *>(base_); }
+  SlotHeader *Slot(const std::size_t s) const {
+    return reinterpret_cast<SlotHeader *>(static_cast<char *>(base_) +
+                                          RoundUp(sizeof(SegmentHeader)) +
+                                          s * Header()->slot_bytes);
+  }
+  Real *X(const std::size_t s) const {
+    return reinterpret_cast<Real *>(reinterpret_cast<char *>(Slot(s)) +
+                                    RoundUp(sizeof(SlotHeader)));
+  }
+  Real *Y(const std::size_t s) const { return X(s) + Header()->capacity; }
+  Real *Out(const std::size_t s) const { return X(s) + 2 * Header()->capacity; }
+  Real *Lambdas(const std::size_t s) const { return X(s) + 3 * Header()->capacity; }
+
+ private:
+  bool Map_(const int fd, const std::size_t bytes) {
+    void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return false;
+    base_ = p;
+    bytes_ = bytes;
+    return true;
+  }
+  void *base_ = nullptr;
+  std::size_t bytes_ = 0;
+};
+
+} // namespace impl
+
+// Owns the segment and evaluates requests against materials, which
+// are indexed by their position in the vector passed to the
+// constructor. EOS is the EOS variant, or any type with the vector
+// functions.
+template <typename EOS>
+class Server {
+ public:
+  explicit Server(std::vector<EOS> materials) : materials_(std::move(materials)) {}
+  Server(const Server &) = delete;
+  Server &operator=(const Server &) = delete;
+  ~Server() { Stop(); }
+
+  // Creates the segment called name. Returns false if it exists
+  // already or cannot be created.
+  bool Start(const std::string &name, const Options &options = Options()) {
+    Stop();
+    options_ = options;
+    const std::size_t nslots = std::max(options.nslots, 1);
+    const std::size_t capacity = std::max(options.slot_capacity, 1);
+    const std::size_t slot_bytes = impl::SlotBytes(capacity);
+    const std::size_t bytes =
+        impl::RoundUp(sizeof(impl::SegmentHeader)) + nslots * slot_bytes;
+    if (!segment_.Create(name, bytes)) return false;
+    name_ = name;
+    auto *h = new (segment_.Header()) impl::SegmentHeader;
+    h->nslots = nslots;
+    h->capacity = capacity;
+    h->nmaterials = materials_.size();
+    h->slot_bytes = slot_bytes;
+    h->cursor.store(0);
+    h->nrequests.store(0);
+    h->nbatches.store(0);
+    h->npoints.store(0);
+    for (std::size_t s = 0; s < nslots; ++s) {
+      auto *slot = new (segment_.Slot(s)) impl::SlotHeader;
+      slot->state.store(static_cast<std::uint32_t>(SlotState::Free));
+    }
+    h->magic = MAGIC;
+    h->alive.store(1, std::memory_order_release);
+    return true;
+  }
+  // Removes the segment. Clients waiting on it give up.
+  void Stop() {
+    if (!segment_.Mapped()) return;
+    segment_.Header()->alive.store(0, std::memory_order_release);
+    segment_.Unmap();
+    shm_unlink(impl::Segment::ShmName(name_).c_str());
+  }
+  bool Active() const { return segment_.Mapped(); }
+
+  // Evaluates every ready request. Returns the number of requests
+  // served.
+  int Poll() {
+    if (!segment_.Mapped()) return 0;
+    const auto *h = segment_.Header();
+    ready_.clear();
+    for (std::size_t s = 0; s < h->nslots; ++s) {
+      auto *slot = segment_.Slot(s);
+      if (slot->state.load(std::memory_order_acquire) ==
+          static_cast<std::uint32_t>(SlotState::Ready)) {
+        ready_.push_back(s);
+      }
+    }
+    if (ready_.empty()) return 0;
+    // group by material and query
+    std::sort(ready_.begin(), ready_.end(),
+              [this](const std::size_t a, const std::size_t b) {
+                const auto *sa = segment_.Slot(a);
+                const auto *sb = segment_.Slot(b);
+                return std::make_pair(sa->material, sa->query) <
+                       std::make_pair(sb->material, sb->query);
+              });
+    std::size_t begin = 0;
+    while (begin < ready_.size()) {
+      std::size_t end = begin + 1;
+      const auto *first = segment_.Slot(ready_[begin]);
+      while (end < ready_.size() &&
+             segment_.Slot(ready_[end])->material == first->material &&
+             segment_.Slot(ready_[end])->query == first->query) {
+        end++;
+      }
+      EvaluateGroup_(begin, end);
+      begin = end;
+    }
+    return ready_.size();
+  }
+
+  // Polls until stop is set, backing off while idle
+  void Serve(const std::atomic<bool> &stop) {
+    using clock = std::chrono::steady_clock;
+    int idle = 0;
+    while (!stop.load(std::memory_order_acquire)) {
+      if (options_.batch_window_us > 0 && NumPending() > 0) {
+        const auto deadline =
+            clock::now() + std::chrono::microseconds(options_.batch_window_us);
+        while (clock::now() < deadline && !AllReady_()) {
+          std::this_thread::yield();
+        }
+      }
+      if (Poll() > 0) {
+        idle = 0;
+      } else if (++idle < 64) {
+        std::this_thread::yield();
+      } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+      }
+    }
+  }
+
+  // Number of requests waiting to be served
+  int NumPending() const {
+    if (!segment_.Mapped()) return 0;
+    int n = 0;
+    for (std::size_t s = 0; s < segment_.Header()->nslots; ++s) {
+      n += (segment_.Slot(s)->state.load(std::memory_order_relaxed) ==
+            static_cast<std::uint32_t>(SlotState::Ready));
+    }
+    return n;
+  }
+
+  Stats GetStats() const {
+    Stats stats;
+    if (!segment_.Mapped()) return stats;
+    const auto *h = segment_.Header();
+    stats.nrequests = h->nrequests.load();
+    stats.nbatches = h->nbatches.load();
+    stats.npoints = h->npoints.load();
+    return stats;
+  }
+
+ private:
+  // whether no slot is being filled by a client
+  bool AllReady_() const {
+    const auto *h = segment_.Header();
+    for (std::size_t s = 0; s < h->nslots; ++s) {
+      if (segment_.Slot(s)->state.load(std::memory_order_relaxed) ==
+          static_cast<std::uint32_t>(SlotState::Claimed)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Evaluates the requests ready_[begin, end), which share a
+  // material and a query, in one vector call. Requests that do not
+  // fit in their slot are refused on their own.
+  void EvaluateGroup_(const std::size_t begin, const std::size_t end) {
+    auto *h = segment_.Header();
+    const auto *first = segment_.Slot(ready_[begin]);
+    const int material = first->material;
+    const auto query = static_cast<Query>(first->query);
+    const bool valid = (material >= 0 && material < static_cast<int>(materials_.size()) &&
+                        first->query < static_cast<std::uint32_t>(Query::NumQueries));
+    group_.clear();
+    std::size_t num = 0;
+    for (std::size_t r = begin; r < end; ++r) {
+      const std::size_t s = ready_[r];
+      auto *slot = segment_.Slot(s);
+      if (valid && slot->num <= h->capacity && slot->nlambda <= MAX_NUM_LAMBDAS) {
+        group_.push_back(s);
+        num += slot->num;
+      } else {
+        slot->state.store(static_cast<std::uint32_t>(SlotState::Failed),
+                          std::memory_order_release);
+      }
+    }
+    bool ok = true;
+    if (num > 0) {
+      x_.resize(num);
+      y_.resize(num);
+      out_.resize(num);
+      lambdas_.resize(num);
+      std::size_t offset = 0;
+      for (const std::size_t s : group_) {
+        const auto *slot = segment_.Slot(s);
+        std::copy_n(segment_.X(s), slot->num, &x_[offset]);
+        std::copy_n(segment_.Y(s), slot->num, &y_[offset]);
+        // Every point owns MAX_NUM_LAMBDAS values, whatever the client
+        // sent, so an EOS using more lambdas than the client does
+        // stays within the point
+        Real *lambda = segment_.Lambdas(s);
+        for (std::size_t i = 0; i < slot->num; ++i) {
+          lambdas_[offset + i] =
+              (slot->nlambda > 0) ? &lambda[i * MAX_NUM_LAMBDAS] : nullptr;
+        }
+        offset += slot->num;
+      }
+      ok = query_trace::EvaluateVector(materials_[material], query, x_.data(),
+                                       y_.data(), out_.data(), static_cast<int>(num),
+                                       lambdas_.data());
+      offset = 0;
+      for (std::size_t g = 0; g < group_.size() && ok; ++g) {
+        const std::size_t s = group_[g];
+        const auto n = segment_.Slot(s)->num;
+        std::copy_n(&out_[offset], n, segment_.Out(s));
+        offset += n;
+      }
+    }
+    const auto state =
+        static_cast<std::uint32_t>(ok ? SlotState::Done : SlotState::Failed);
+    for (const std::size_t s : group_) {
+      segment_.Slot(s)->state.store(state, std::memory_order_release);
+    }
+    h->nrequests.fetch_add(end - begin, std::memory_order_relaxed);
+    if (ok && num > 0) {
+      h->nbatches.fetch_add(1, std::memory_order_relaxed);
+      h->npoints.fetch_add(num, std::memory_order_relaxed);
+    }
+  }
+
+  std::vector<EOS> materials_;
+  Options options_;
+  impl::Segment segment_;
+  std::string name_;
+  // scratch, reused between polls
+  std::vector<std::size_t> ready_, group_;
+  std::vector<Real> x_, y_, out_;
+  std::vector<Real *> lambdas_;
+};
+
+// Submits requests to a server on the same node
+class Client {
+ public:
+  Client() = default;
+  explicit Client(const std::string &name) { Open(name); }
+
+  // Opens the segment of the server called name. Returns false if
+  // there is no such server.
+  bool Open(const std::string &name) {
+    segment_.Unmap();
+    return segment_.Open(name) && Alive();
+  }
+  void Close() { segment_.Unmap(); }
+  bool Alive() const {
+    return segment_.Mapped() && segment_.Header()->alive.load(std::memory_order_acquire);
+  }
+  int NumMaterials() const {
+    return segment_.Mapped() ? segment_.Header()->nmaterials : 0;
+  }
+  int SlotCapacity() const { return segment_.Mapped() ? segment_.Header()->capacity : 0; }
+
+  // Evaluates query q of material at num points, blocking until the
+  // server is done. lambdas, if not null, holds nlambda values per
+  // point, and is updated with the values the EOS leaves in them.
+  // Returns false if the server rejected the request or went away.
+  bool Evaluate(const Query q, const int material, const Real *x, const Real *y,
+                Real *out, const int num, Real *lambdas = nullptr,
+                const int nlambda = 0) {
+    if (!Alive() || material < 0 || material >= NumMaterials() || nlambda < 0 ||
+        nlambda > static_cast<int>(MAX_NUM_LAMBDAS)) {
+      return false;
+    }
+    const int nl = (lambdas == nullptr) ? 0 : nlambda;
+    const int capacity = SlotCapacity();
+    for (int offset = 0; offset < num; offset += capacity) {
+      const int n = std::min(capacity, num - offset);
+      Real *l = (nl > 0) ? &lambdas[offset * nl] : nullptr;
+      if (!EvaluateChunk_(q, material, &x[offset], &y[offset], &out[offset], n, l, nl)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  bool EvaluateChunk_(const Query q, const int material, const Real *x, const Real *y,
+                      Real *out, const int num, Real *lambdas, const int nlambda) {
+    const std::size_t s = Claim_();
+    if (s == NO_SLOT) return false;
+    auto *slot = segment_.Slot(s);
+    slot->query = static_cast<std::uint32_t>(q);
+    slot->material = material;
+    slot->num = num;
+    slot->nlambda = nlambda;
+    std::copy_n(x, num, segment_.X(s));
+    std::copy_n(y, num, segment_.Y(s));
+    for (int i = 0; i < num && nlambda > 0; ++i) {
+      std::copy_n(&lambdas[i * nlambda], nlambda,
+                  &segment_.Lambdas(s)[i * MAX_NUM_LAMBDAS]);
+    }
+    slot->state.store(static_cast<std::uint32_t>(SlotState::Ready),
+                      std::memory_order_release);
+    std::uint32_t state;
+    int spins = 0;
+    while ((state = slot->state.load(std::memory_order_acquire)) ==
+           static_cast<std::uint32_t>(SlotState::Ready)) {
+      if (!Alive()) return false;
+      Backoff_(spins);
+    }
+    const bool ok = (state == static_cast<std::uint32_t>(SlotState::Done));
+    if (ok) {
+      std::copy_n(segment_.Out(s), num, out);
+      for (int i = 0; i < num && nlambda > 0; ++i) {
+        std::copy_n(&segment_.Lambdas(s)[i * MAX_NUM_LAMBDAS], nlambda,
+                    &lambdas[i * nlambda]);
+      }
+    }
+    slot->state.store(static_cast<std::uint32_t>(SlotState::Free),
+                      std::memory_order_release);
+    return ok;
+  }
+
+  // Claims a free slot, starting from the shared cursor so that
+  // clients spread over the ring
+  std::size_t Claim_() {
+    auto *h = segment_.Header();
+    int spins = 0;
+    while (Alive()) {
+      const std::size_t start = h->cursor.fetch_add(1, std::memory_order_relaxed);
+      for (std::size_t i = 0; i < h->nslots; ++i) {
+        const std::size_t s = (start + i) % h->nslots;
+        auto expected = static_cast<std::uint32_t>(SlotState::Free);
+        if (segment_.Slot(s)->state.compare_exchange_strong(
+                expected, static_cast<std::uint32_t>(SlotState::Claimed),
+                std::memory_order_acquire)) {
+          return s;
+        }
+      }
+      Backoff_(spins);
+    }
+    return NO_SLOT;
+  }
+
+  static void Backoff_(int &spins) {
+    if (++spins < 64) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+  }
+
+  static constexpr std::size_t NO_SLOT = static_cast<std::size_t>(-1);
+  impl::Segment segment_;
+};
+
+} // namespace eos_service
+} // namespace singularity
+
+#endif // SINGULARITY_ENABLE_EOS_SERVICE
+#endif // SINGULARITY_EOS_BASE_EOS_SERVICE_HPP_
@@ -0,0 +1,566 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#ifndef SINGULARITY_EOS_BASE_QUERY_TRACE_HPP_
+#define SINGULARITY_EOS_BASE_QUERY_TRACE_HPP_
+
+// Capture and replay of EOS query streams.
+//
+// When built with SINGULARITY_ENABLE_QUERY_CAPTURE, the two-input
+// vector functions of Variant (e.g., PressureFromDensityTemperature)
+// hand their inputs and lambdas to the global trace writer before
+// every call and their outputs after it. Nothing is recorded until the host calls
+// query_trace::Start. Replay reads a trace back and reruns it against
+// a user-supplied set of equations of state.
+//
+// A trace is a binary file: an 8 byte magic number, followed by
+// records. Each record is a RecordHeader followed by num values of
+// each input, num values of output, and num * nlambda lambda values,
+// all as Real.
+//
+// get_sg_eos records its per-cell inputs as GetSgEos records, for
+// which material holds the input condition, model the number of
+// materials nmat, num the number of cells and nlambda is zero. The
+// header is followed by the nmat eos offsets, the mass fraction
+// cutoff, num values each of spvol, sie, press and temp, and then
+// num * nmat values each of frac_mass, frac_vol and frac_ie, laid out
+// as get_sg_eos takes them with a cell_dim of num. All are stored as
+// Real.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <ports-of-call/portability.hpp>
+#include <singularity-eos/base/robust_utils.hpp>
+
+namespace singularity {
+namespace query_trace {
+
+constexpr char MAGIC[8] = {'S', 'G', 'Q', 'T', 'R', 'C', '0', '1'};
+
+// The vector functions that can be captured. The values are part of
+// the file format, so new entries go at the end.
+enum class Query : std::uint8_t {
+  TemperatureFromDensityInternalEnergy = 0,
+  InternalEnergyFromDensityTemperature = 1,
+  PressureFromDensityTemperature = 2,
+  PressureFromDensityInternalEnergy = 3,
+  EntropyFromDensityTemperature = 4,
+  EntropyFromDensityInternalEnergy = 5,
+  SpecificHeatFromDensityTemperature = 6,
+  SpecificHeatFromDensityInternalEnergy = 7,
+  BulkModulusFromDensityTemperature = 8,
+  BulkModulusFromDensityInternalEnergy = 9,
+  GruneisenParamFromDensityTemperature = 10,
+  GruneisenParamFromDensityInternalEnergy = 11,
+  GetSgEos = 12,
+  NumQueries = 13
+};
+
+inline const char *QueryName(const Query q) {
+  constexpr const char *names[] = {"TemperatureFromDensityInternalEnergy",
+                                   "InternalEnergyFromDensityTemperature",
+                                   "PressureFromDensityTemperature",
+                                   "PressureFromDensityInternalEnergy",
+                                   "EntropyFromDensityTemperature",
+                                   "EntropyFromDensityInternalEnergy",
+                                   "SpecificHeatFromDensityTemperature",
+                                   "SpecificHeatFromDensityInternalEnergy",
+                                   "BulkModulusFromDensityTemperature",
+                                   "BulkModulusFromDensityInternalEnergy",
+                                   "GruneisenParamFromDensityTemperature",
+                                   "GruneisenParamFromDensityInternalEnergy",
+                                   "get_sg_eos"};
+  const auto i = static_cast<std::size_t>(q);
+  return (i < static_cast<std::size_t>(Query::NumQueries)) ? names[i] : "Unknown";
+}
+
+struct RecordHeader {
+  std::uint8_t query;
+  std::uint8_t pad[3];
+  // set by the host with SetMaterial, -1 if never set
+  std::int32_t material;
+  // index of the alternative held by the variant
+  std::int32_t model;
+  std::uint32_t num;
+  std::uint32_t nlambda;
+};
+
+// A call snapshotted by Writer::Begin and not yet written
+struct Pending {
+  bool active = false;
+  int stride = 1;
+  RecordHeader header;
+  // x, then y, then out, then lambdas, as in a record
+  std::vector<Real> buf;
+};
+
+struct Record {
+  Query query;
+  int material;
+  int model;
+  int num;
+  int nlambda;
+  std::vector<Real> x, y, out, lambdas;
+  // GetSgEos records only, see above. The cell arrays can be passed
+  // back to get_sg_eos with ncell and cell_dim set to num and offsets
+  // 1, ..., num.
+  Real mass_frac_cutoff = 0;
+  std::vector<int> eos_offsets;
+  std::vector<Real> spvol, sie, press, temp;
+  std::vector<Real> frac_mass, frac_vol, frac_ie;
+};
+
+// Whether an indexer can be read on the host. Views know their
+// memory space. Anything else is assumed to live in the default
+// memory space.
+#ifdef PORTABILITY_STRATEGY_KOKKOS
+template <typename T, typename = void>
+struct IsHostAccessible
+    : std::integral_constant<
+          bool, Kokkos::SpaceAccessibility<
+                    Kokkos::HostSpace,
+                    Kokkos::DefaultExecutionSpace::memory_space>::accessible> {};
+template <typename T>
+struct IsHostAccessible<T, decltype(void(std::declval<typename T::memory_space>()))>
+    : std::integral_constant<bool, Kokkos::SpaceAccessibility<
+                                       Kokkos::HostSpace,
+                                       typename T::memory_space>::accessible> {};
+#else
+template <typename T, typename = void>
+struct IsHostAccessible : std::true_type {};
+#endif // PORTABILITY_STRATEGY_KOKKOS
+
+class Writer {
+ public:
+  // Start recording to filename. Only every sample_every-th call is
+  // recorded, at most max_points points of each recorded call are
+  // kept, evenly strided, and recording stops once the file would
+  // exceed max_bytes. Returns false if the file cannot be opened.
+  bool Start(const std::string &filename, const int sample_every = 1,
+             const int max_points = 1024, const std::size_t max_bytes = 1 << 30) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    StopUnlocked_();
+    file_ = std::fopen(filename.c_str(), "wb");
+    if (file_ == nullptr) return false;
+    std::fwrite(MAGIC, 1, sizeof(MAGIC), file_);
+    sample_every_ = std::max(sample_every, 1);
+    max_points_ = std::max(max_points, 1);
+    max_bytes_ = max_bytes;
+    bytes_ = sizeof(MAGIC);
+    ncalls_ = 0;
+    nrecords_ = 0;
+    active_.store(true, std::memory_order_release);
+    return true;
+  }
+  void Stop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    StopUnlocked_();
+  }
+  // Safe to call from any thread while another starts or stops
+  bool Active() const { return active_.load(std::memory_order_acquire); }
+  std::size_t NumRecords() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return nrecords_;
+  }
+  std::size_t NumBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+  }
+
+  // Snapshots the sampled inputs and lambdas of a vector call before
+  // it runs, so that the record holds the lambdas the call started
+  // from rather than the ones it left behind. The returned Pending is
+  // written by Finish once the outputs are available.
+  template <typename ConstRealIndexer, typename RealIndexer, typename LambdaIndexer>
+  Pending Begin(const Query query, const int model, ConstRealIndexer &&x,
+                ConstRealIndexer &&y, RealIndexer &&out, const int num,
+                LambdaIndexer &&lambdas, const int nlambda) {
+    using CRI = typename std::decay<ConstRealIndexer>::type;
+    using RI = typename std::decay<RealIndexer>::type;
+    using LI = typename std::decay<LambdaIndexer>::type;
+    Pending p;
+    if (!(IsHostAccessible<CRI>::value && IsHostAccessible<RI>::value &&
+          IsHostAccessible<LI>::value)) {
+      return p;
+    }
+    if (!Active() || num <= 0) return p;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (file_ == nullptr) return p;
+      if ((ncalls_++ % sample_every_) != 0) return p;
+      p.stride = (num + max_points_ - 1) / max_points_;
+    }
+    const int stride = p.stride;
+    const int n = (num + stride - 1) / stride;
+    // lambdas are only kept if every point has them
+    int nl = nlambda;
+    for (int i = 0; i < n && nl > 0; ++i) {
+      if (lambdas[i * stride] == nullptr) nl = 0;
+    }
+    std::memset(&p.header, 0, sizeof(p.header));
+    p.header.query = static_cast<std::uint8_t>(query);
+    p.header.material = Material();
+    p.header.model = model;
+    p.header.num = n;
+    p.header.nlambda = nl;
+    p.buf.resize(static_cast<std::size_t>(n) * (3 + nl));
+    for (int i = 0; i < n; ++i) {
+      const int j = i * stride;
+      p.buf[i] = x[j];
+      p.buf[n + i] = y[j];
+      for (int l = 0; l < nl; ++l) {
+        p.buf[3 * n + i * nl + l] = lambdas[j][l];
+      }
+    }
+    p.active = true;
+    return p;
+  }
+
+  // Fills in the outputs of a call started with Begin and writes it
+  template <typename RealIndexer>
+  void Finish(Pending &p, RealIndexer &&out) {
+    if (!p.active) return;
+    p.active = false;
+    const int n = p.header.num;
+    for (int i = 0; i < n; ++i) {
+      p.buf[2 * n + i] = out[i * p.stride];
+    }
+    const std::size_t size = sizeof(RecordHeader) + sizeof(Real) * p.buf.size();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_ == nullptr) return;
+    if (bytes_ + size > max_bytes_) {
+      StopUnlocked_();
+      return;
+    }
+    std::fwrite(&p.header, sizeof(p.header), 1, file_);
+    std::fwrite(p.buf.data(), sizeof(Real), p.buf.size(), file_);
+    bytes_ += size;
+    nrecords_++;
+  }
+
+  // Records a call that has already completed. The lambdas recorded
+  // are their current values.
+  template <typename ConstRealIndexer, typename RealIndexer, typename LambdaIndexer>
+  void Capture(const Query query, const int model, ConstRealIndexer &&x,
+               ConstRealIndexer &&y, RealIndexer &&out, const int num,
+               LambdaIndexer &&lambdas, const int nlambda) {
+    Pending p = Begin(query, model, x, y, out, num, lambdas, nlambda);
+    Finish(p, out);
+  }
+
+  // Records the per-cell inputs of a get_sg_eos call before it runs.
+  // offsets are the 1-based cells to compute and the per-material
+  // arrays are indexed as frac[(cell - 1) + m * cell_dim]. Calls are
+  // sampled like vector calls, with at most max_points cells kept.
+  void CaptureGetSgEos(const int input, const int nmat, const int ncell,
+                       const int cell_dim, const int *eos_offsets, const int *offsets,
+                       const Real *spvol, const Real *sie, const Real *press,
+                       const Real *temp, const Real *frac_mass, const Real *frac_vol,
+                       const Real *frac_ie, const Real mass_frac_cutoff) {
+    if (!Active() || ncell <= 0 || nmat <= 0) return;
+    int stride;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (file_ == nullptr) return;
+      if ((ncalls_++ % sample_every_) != 0) return;
+      stride = (ncell + max_points_ - 1) / max_points_;
+    }
+    const int n = (ncell + stride - 1) / stride;
+    RecordHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.query = static_cast<std::uint8_t>(Query::GetSgEos);
+    header.material = input;
+    header.model = nmat;
+    header.num = n;
+    header.nlambda = 0;
+    std::vector<Real> buf(nmat + 1 + static_cast<std::size_t>(n) * (4 + 3 * nmat));
+    for (int m = 0; m < nmat; ++m) {
+      buf[m] = eos_offsets[m];
+    }
+    buf[nmat] = mass_frac_cutoff;
+    Real *cells = buf.data() + nmat + 1;
+    Real *fracs = cells + 4 * n;
+    const std::size_t nfrac = static_cast<std::size_t>(n) * nmat;
+    for (int i = 0; i < n; ++i) {
+      const int j = offsets[i * stride] - 1;
+      cells[i] = spvol[j];
+      cells[n + i] = sie[j];
+      cells[2 * n + i] = press[j];
+      cells[3 * n + i] = temp[j];
+      for (int m = 0; m < nmat; ++m) {
+        const std::size_t jm = j + static_cast<std::size_t>(m) * cell_dim;
+        fracs[i + m * n] = frac_mass[jm];
+        fracs[nfrac + i + m * n] = frac_vol[jm];
+        fracs[2 * nfrac + i + m * n] = frac_ie[jm];
+      }
+    }
+    const std::size_t size = sizeof(RecordHeader) + sizeof(Real) * buf.size();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_ == nullptr) return;
+    if (bytes_ + size > max_bytes_) {
+      StopUnlocked_();
+      return;
+    }
+    std::fwrite(&header, sizeof(header), 1, file_);
+    std::fwrite(buf.data(), sizeof(Real), buf.size(), file_);
+    bytes_ += size;
+    nrecords_++;
+  }
+
+  // Tag subsequent records from this thread with a material id
+  static int &Material() {
+    static thread_local int material = -1;
+    return material;
+  }
+
+  ~Writer() { Stop(); }
+
+ private:
+  void StopUnlocked_() {
+    active_.store(false, std::memory_order_release);
+    if (file_ != nullptr) std::fclose(file_);
+    file_ = nullptr;
+  }
+  mutable std::mutex mutex_;
+  // file_ is only touched with mutex_ held. active_ mirrors whether it
+  // is open, so that calls can skip the lock when nothing is recorded.
+  std::FILE *file_ = nullptr;
+  std::atomic<bool> active_{false};
+  int sample_every_ = 1;
+  int max_points_ = 1;
+  std::size_t max_bytes_ = 0;
+  std::size_t bytes_ = 0;
+  std::size_t ncalls_ = 0;
+  std::size_t nrecords_ = 0;
+};
+
+inline Writer &GlobalWriter() {
+  static Writer writer;
+  return writer;
+}
+
+inline bool Start(const std::string &filename, const int sample_every = 1,
+                  const int max_points = 1024, const std::size_t max_bytes = 1 << 30) {
+  return GlobalWriter().Start(filename, sample_every, max_points, max_bytes);
+}
+inline void Stop() { GlobalWriter().Stop(); }
+inline void SetMaterial(const int material) { Writer::Material() = material; }
+inline void CaptureGetSgEos(const int input, const int nmat, const int ncell,
+                            const int cell_dim, const int *eos_offsets,
+                            const int *offsets, const Real *spvol, const Real *sie,
+                            const Real *press, const Real *temp, const Real *frac_mass,
+                            const Real *frac_vol, const Real *frac_ie,
+                            const Real mass_frac_cutoff) {
+  GlobalWriter().CaptureGetSgEos(input, nmat, ncell, cell_dim, eos_offsets, offsets,
+                                 spvol, sie, press, temp, frac_mass, frac_vol, frac_ie,
+                                 mass_frac_cutoff);
+}
+
+class Reader {
+ public:
+  Reader() = default;
+  explicit Reader(const std::string &filename) { Open(filename); }
+  Reader(const Reader &) = delete;
+  Reader &operator=(const Reader &) = delete;
+  ~Reader() { Close(); }
+
+  bool Open(const std::string &filename) {
+    Close();
+    file_ = std::fopen(filename.c_str(), "rb");
+    if (file_ == nullptr) return false;
+    char magic[sizeof(MAGIC)];
+    if (std::fread(magic, 1, sizeof(magic), file_) != sizeof(magic) ||
+        std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+      Close();
+      return false;
+    }
+    return true;
+  }
+  void Close() {
+    if (file_ != nullptr) std::fclose(file_);
+    file_ = nullptr;
+  }
+  bool IsOpen() const { return file_ != nullptr; }
+
+  // Reads the next record. Returns false at the end of the trace or
+  // on a truncated record.
+  bool Next(Record &r) {
+    if (file_ == nullptr) return false;
+    RecordHeader h;
+    if (std::fread(&h, sizeof(h), 1, file_) != 1) return false;
+    if (h.query >= static_cast<std::uint8_t>(Query::NumQueries)) return false;
+    r.query = static_cast<Query>(h.query);
+    r.material = h.material;
+    r.model = h.model;
+    r.num = h.num;
+    r.nlambda = h.nlambda;
+    if (r.query == Query::GetSgEos) return NextGetSgEos_(r);
+    r.x.resize(r.num);
+    r.y.resize(r.num);
+    r.out.resize(r.num);
+    r.lambdas.resize(static_cast<std::size_t>(r.num) * r.nlambda);
+    return Read_(r.x) && Read_(r.y) && Read_(r.out) && Read_(r.lambdas);
+  }
+
+ private:
+  bool NextGetSgEos_(Record &r) {
+    const int nmat = r.model;
+    if (nmat <= 0) return false;
+    r.x.clear();
+    r.y.clear();
+    r.out.clear();
+    r.lambdas.clear();
+    std::vector<Real> head(nmat + 1);
+    if (!Read_(head)) return false;
+    r.eos_offsets.resize(nmat);
+    for (int m = 0; m < nmat; ++m) {
+      r.eos_offsets[m] = static_cast<int>(head[m]);
+    }
+    r.mass_frac_cutoff = head[nmat];
+    const std::size_t nfrac = static_cast<std::size_t>(r.num) * nmat;
+    r.spvol.resize(r.num);
+    r.sie.resize(r.num);
+    r.press.resize(r.num);
+    r.temp.resize(r.num);
+    r.frac_mass.resize(nfrac);
+    r.frac_vol.resize(nfrac);
+    r.frac_ie.resize(nfrac);
+    return Read_(r.spvol) && Read_(r.sie) && Read_(r.press) && Read_(r.temp) &&
+           Read_(r.frac_mass) && Read_(r.frac_vol) && Read_(r.frac_ie);
+  }
+  bool Read_(std::vector<Real> &v) {
+    return std::fread(v.data(), sizeof(Real), v.size(), file_) == v.size();
+  }
+  std::FILE *file_ = nullptr;
+};
+
+// Calls the vector version of query q on host arrays
+template <typename EOS>
+inline bool EvaluateVector(const EOS &eos, const Query q, const Real *x, const Real *y,
+                           Real *out, const int num, Real **lambdas) {
+  switch (q) {
+  case Query::TemperatureFromDensityInternalEnergy:
+    eos.TemperatureFromDensityInternalEnergy(x, y, out, num, lambdas);
+    return true;
+  case Query::InternalEnergyFromDensityTemperature:
+    eos.InternalEnergyFromDensityTemperature(x, y, out, num, lambdas);
+    return true;
+  case Query::PressureFromDensityTemperature:
+    eos.PressureFromDensityTemperature(x, y, out, num, lambdas);
+    return true;
+  case Query::PressureFromDensityInternalEnergy:
+    eos.PressureFromDensityInternalEnergy(x, y, out, num, lambdas);
+    return true;
+  case Query::EntropyFromDensityTemperature:
+    eos.EntropyFromDensityTemperature(x, y, out, num, lambdas);
+    return true;
+  case Query::EntropyFromDensityInternalEnergy:
+    eos.EntropyFromDensityInternalEnergy(x, y, out, num, lambdas);
+    return true;
+  case Query::SpecificHeatFromDensityTemperature:
+    eos.SpecificHeatFromDensityTemperature(x, y, out, num, lambdas);
+    return true;
+  case Query::SpecificHeatFromDensityInternalEnergy:
+    eos.SpecificHeatFromDensityInternalEnergy(x, y, out, num, lambdas);
+    return true;
+  case Query::BulkModulusFromDensityTemperature:
+    eos.BulkModulusFromDensityTemperature(x, y, out, num, lambdas);
+    return true;
+  case Query::BulkModulusFromDensityInternalEnergy:
+    eos.BulkModulusFromDensityInternalEnergy(x, y, out, num, lambdas);
+    return true;
+  case Query::GruneisenParamFromDensityTemperature:
+    eos.GruneisenParamFromDensityTemperature(x, y, out, num, lambdas);
+    return true;
+  case Query::GruneisenParamFromDensityInternalEnergy:
+    eos.GruneisenParamFromDensityInternalEnergy(x, y, out, num, lambdas);
+    return true;
+  default:
+    return false;
+  }
+}
+
+struct ReplayStats {
+  std::size_t nrecords = 0;
+  std::size_t nskipped = 0;
+  std::size_t npoints = 0;
+  // points whose relative difference from the trace exceeds the
+  // tolerance
+  std::size_t nmismatch = 0;
+  Real max_rel_diff = 0;
+  double seconds = 0;
+  double Throughput() const { return (seconds > 0) ? npoints / seconds : 0; }
+};
+
+// Reruns every EOS record of a trace on the host. get_eos(material,
+// model) must return a pointer to the EOS to replay that record
+// against, or nullptr to skip it. GetSgEos records are skipped, since
+// they must be replayed through get_sg_eos. Each record is evaluated
+// with one call to the vector function it was captured from, over all
+// of its points, so the timings follow the vector code path. Every point
+// starts from the lambdas recorded for it. Variant records them before
+// each call, so lambda-caching EOS models see the same starting guesses
+// as in the captured run. Only EOS evaluation is timed.
+template <typename GetEOS>
+inline ReplayStats Replay(Reader &reader, GetEOS &&get_eos, const Real rel_tol = 1e-12) {
+  using clock = std::chrono::steady_clock;
+  ReplayStats stats;
+  Record r;
+  std::vector<Real> out;
+  std::vector<Real *> lambdas;
+  while (reader.Next(r)) {
+    if (r.query == Query::GetSgEos) {
+      stats.nskipped++;
+      continue;
+    }
+    const auto *eos = get_eos(r.material, r.model);
+    if (eos == nullptr) {
+      stats.nskipped++;
+      continue;
+    }
+    out.resize(r.num);
+    lambdas.resize(r.num);
+    for (int i = 0; i < r.num; ++i) {
+      lambdas[i] = (r.nlambda > 0) ? &r.lambdas[i * r.nlambda] : nullptr;
+    }
+    const auto start = clock::now();
+    EvaluateVector(*eos, r.query, r.x.data(), r.y.data(), out.data(), r.num,
+                   lambdas.data());
+    stats.seconds += std::chrono::duration<double>(clock::now() - start).count();
+    for (int i = 0; i < r.num; ++i) {
+      const Real diff = robust::ratio(std::abs(out[i] - r.out[i]), std::abs(r.out[i]));
+      stats.max_rel_diff = std::max(stats.max_rel_diff, diff);
+      if (diff > rel_tol) stats.nmismatch++;
+    }
+    stats.nrecords++;
+    stats.npoints += r.num;
+  }
+  return stats;
+}
+
+} // namespace query_trace
+} // namespace singularity
+
+#endif // SINGULARITY_EOS_BASE_QUERY_TRACE_HPP_
@@ -155,8 +155,8 @@ PORTABLE_INLINE_FUNCTION Status regula_falsi(const T &f, const Real ytarget,
                                              const Real xtol, const Real ytol,
                                              Real &xroot,
                                              const RootCounts *counts = nullptr,
-                                             const bool &verbose = false) {
-  constexpr int max_iter = SECANT_NITER_MAX;
+                                             const bool &verbose = false,
+                                             const int max_iter = SECANT_NITER_MAX) {
   auto func = [&](const Real x) { return f(x) - ytarget; };
   Real ya = func(a);
   Real yg = func(guess);
@@ -242,14 +242,13 @@ PORTABLE_INLINE_FUNCTION Status regula_falsi(const T &f, const Real ytarget,
 // root finding methods. f should return a tuple of (f(x), f'(x)) where f'(x)
 // is the derivative of f with respect to x.
 template <typename T>
-PORTABLE_INLINE_FUNCTION Status newton_raphson(const T &f, const Real ytarget,
-                                               const Real guess, const Real a,
-                                               const Real b, const Real ytol, Real &xroot,
-                                               const RootCounts *counts = nullptr,
-                                               const bool &verbose = false,
-                                               const bool &fail_on_bound_root = true) {
-
-  constexpr int max_iter = NEWTON_RAPHSON_NITER_MAX;
+PORTABLE_INLINE_FUNCTION Status
+newton_raphson(const T &f, const Real ytarget, const Real guess, const Real a,
+               const Real b, const Real ytol, Real &xroot,
+               const RootCounts *counts = nullptr, const bool &verbose = false,
+               const bool &fail_on_bound_root = true,
+               const int max_iter = NEWTON_RAPHSON_NITER_MAX) {
+
   Real _x = guess;
   Real _xold = 0.0;
   auto status = Status::SUCCESS;
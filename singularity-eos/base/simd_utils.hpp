@@ -0,0 +1,161 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#ifndef SINGULARITY_EOS_BASE_SIMD_UTILS_HPP_
+#define SINGULARITY_EOS_BASE_SIMD_UTILS_HPP_
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include <ports-of-call/portability.hpp>
+#include <singularity-eos/base/math_utils.hpp>
+#include <singularity-eos/base/robust_utils.hpp>
+
+namespace singularity {
+namespace simd_utils {
+
+/*
+ * Helpers for EOS models whose scalar calls are templated on the
+ * value type. Anything convertible to Real, such as arithmetic types
+ * or the references returned by indexers, is promoted to Real, so
+ * existing scalar calls are unchanged. Any other type is assumed to be a SIMD
+ * pack, such as Kokkos::Experimental::simd<double> or
+ * std::experimental::simd<double>, which provides elementwise
+ * arithmetic, comparisons that return a mask, and a where(mask, v)
+ * expression found by argument-dependent lookup.
+ *
+ * For Real, every function below forwards to the existing scalar
+ * implementation, so results and floating point exceptions are
+ * unchanged. For packs, branches are replaced by masked selects.
+ * Models whose scalar code branches overload on enable_if_real_t and
+ * enable_if_pack_t, so scalar calls never evaluate both branches.
+ */
+
+template <typename T>
+struct is_pack {
+  static constexpr bool value =
+      !std::is_convertible<typename std::decay<T>::type, Real>::value;
+};
+
+template <typename T>
+using value_t = typename std::conditional<is_pack<T>::value,
+                                          typename std::decay<T>::type, Real>::type;
+
+template <typename T, typename R = void>
+using enable_if_real_t = typename std::enable_if<!is_pack<T>::value, R>::type;
+template <typename T, typename R = void>
+using enable_if_pack_t = typename std::enable_if<is_pack<T>::value, R>::type;
+
+// a where mask is true, b otherwise
+template <typename T>
+PORTABLE_FORCEINLINE_FUNCTION T select(const bool mask, const T &a, const T &b) {
+  return mask ? a : b;
+}
+template <typename Mask, typename T>
+PORTABLE_FORCEINLINE_FUNCTION T select(const Mask &mask, const T &a, const T &b) {
+  T out = b;
+  where(mask, out) = a;
+  return out;
+}
+
+// Same semantics as std::max and std::min
+template <typename T>
+PORTABLE_FORCEINLINE_FUNCTION T max(const T &a, const T &b) {
+  return select(a < b, b, a);
+}
+template <typename T>
+PORTABLE_FORCEINLINE_FUNCTION T min(const T &a, const T &b) {
+  return select(b < a, b, a);
+}
+
+template <typename T>
+PORTABLE_FORCEINLINE_FUNCTION enable_if_real_t<T, Real> ratio(const T &a, const T &b) {
+  return robust::ratio(a, b);
+}
+template <typename T>
+PORTABLE_FORCEINLINE_FUNCTION enable_if_pack_t<T, T> ratio(const T &a, const T &b) {
+  constexpr Real small = robust::SMALL();
+  return a / (b + select(b < T(0.0), T(-small), T(small)));
+}
+
+template <typename T>
+PORTABLE_FORCEINLINE_FUNCTION enable_if_real_t<T, Real> safe_arg_exp(const T &x) {
+  return robust::safe_arg_exp(x);
+}
+template <typename T>
+PORTABLE_FORCEINLINE_FUNCTION enable_if_pack_t<T, T> safe_arg_exp(const T &x) {
+  using std::exp;
+  const T xc = max(min(x, T(robust::max_exp_arg())), T(robust::min_exp_arg()));
+  T out = select(x < T(robust::min_exp_arg()), T(0.0), exp(xc));
+  return select(x > T(robust::max_exp_arg()),
+                T(std::numeric_limits<Real>::infinity()), out);
+}
+
+// True if mask is true in every lane, e.g., for PORTABLE_REQUIRE
+PORTABLE_FORCEINLINE_FUNCTION bool all(const bool mask) { return mask; }
+template <typename Mask>
+PORTABLE_FORCEINLINE_FUNCTION bool all(const Mask &mask) {
+  return all_of(mask);
+}
+
+template <typename T>
+PORTABLE_FORCEINLINE_FUNCTION T log(const T &x) {
+  using std::log;
+  return log(x);
+}
+template <typename T>
+PORTABLE_FORCEINLINE_FUNCTION T exp(const T &x) {
+  using std::exp;
+  return exp(x);
+}
+template <typename T>
+PORTABLE_FORCEINLINE_FUNCTION T sqrt(const T &x) {
+  using std::sqrt;
+  return sqrt(x);
+}
+template <typename T>
+PORTABLE_FORCEINLINE_FUNCTION T cbrt(const T &x) {
+  using std::cbrt;
+  return cbrt(x);
+}
+template <typename T>
+PORTABLE_FORCEINLINE_FUNCTION enable_if_real_t<T, Real> pow(const T &x, const Real p) {
+  return std::pow(x, p);
+}
+template <typename T>
+PORTABLE_FORCEINLINE_FUNCTION enable_if_pack_t<T, T> pow(const T &x, const Real p) {
+  using std::pow;
+  return pow(x, T(p));
+}
+
+// Integer powers, as math_utils::pow
+template <int P, typename T>
+PORTABLE_FORCEINLINE_FUNCTION enable_if_real_t<T, Real> pow(const T &x) {
+  return math_utils::pow<P>(x);
+}
+template <int P, typename T>
+PORTABLE_FORCEINLINE_FUNCTION enable_if_pack_t<T, T> pow(const T &x) {
+  constexpr int Ppos = (P < 0) ? -P : P;
+  T out(1.0);
+  for (int i = 0; i < Ppos; ++i) {
+    out *= x;
+  }
+  return (P < 0) ? T(1.0) / out : out;
+}
+
+} // namespace simd_utils
+} // namespace singularity
+
+#endif // SINGULARITY_EOS_BASE_SIMD_UTILS_HPP_
@@ -47,6 +47,7 @@ constexpr char normalDensity[] = "normalDensity";
 constexpr char comments[] = "comments";
 constexpr char matid[] = "matid";
 constexpr char name[] = "name";
+constexpr char inputHash[] = "inputHash";
 } // namespace Material
 
 namespace Fields {
@@ -60,10 +61,18 @@ constexpr char dTdRho[] = "dTdRho";
 constexpr char dTdE[] = "dTdE";
 constexpr char dEdRho[] = "dEdRho";
 constexpr char dEdT[] = "dEdT";
+constexpr char entropy[] = "entropy";
 constexpr char mask[] = "mask";
 constexpr char transitionMask[] = "transition mask";
 } // namespace Fields
 
+namespace Patches {
+constexpr char group[] = "patches";
+constexpr char refinement[] = "refinement";
+constexpr char cellPatch[] = "cell patch";
+constexpr char bounds[] = "patch bounds";
+} // namespace Patches
+
 } // namespace SP5
 
 #endif // _SINGULARITY_EOS_UTILS_SP5_SINGULARITY_EOS_SP5_HPP_
@@ -0,0 +1,664 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#ifndef _SINGULARITY_EOS_UTILS_SP5_SP5_COMPRESSION_HPP_
+#define _SINGULARITY_EOS_UTILS_SP5_SP5_COMPRESSION_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <hdf5.h>
+#include <hdf5_hl.h>
+
+#ifdef SINGULARITY_USE_ZLIB
+#include <zlib.h>
+#endif
+
+// Repacks an sp5 file into chunked, compressed datasets. The layout
+// (groups, datasets, attributes, and soft links) is preserved, so the
+// existing readers load the result unchanged. HDF5 decompresses the
+// chunks transparently on read, one at a time. Open instead inflates
+// them on a pool of threads into an in-memory copy of the file.
+namespace SP5 {
+namespace Compression {
+
+struct Options {
+  // deflate level in [1, 9]. 0 disables compression.
+  int level = 0;
+  // target number of elements per chunk
+  std::size_t chunkElements = 1 << 16;
+  // If positive, datasets whose path contains one of lossyFields
+  // keep only this many explicit mantissa bits, rounded to nearest,
+  // before compression. The relative error is at most 2^-(bits + 1).
+  int lossyBits = 0;
+  std::vector<std::string> lossyFields;
+
+  bool Enabled() const { return level > 0; }
+};
+
+namespace impl {
+
+inline bool IsLossy(const std::string &path, const Options &opts) {
+  if (opts.lossyBits <= 0) return false;
+  std::size_t start = 0;
+  while (start <= path.size()) {
+    std::size_t end = path.find('/', start);
+    if (end == std::string::npos) end = path.size();
+    const std::string component = path.substr(start, end - start);
+    for (const auto &field : opts.lossyFields) {
+      if (component == field) return true;
+    }
+    start = end + 1;
+  }
+  return false;
+}
+
+inline void TruncateMantissa(std::vector<double> &data, const int bits) {
+  constexpr int mantissa_bits = 52;
+  const int drop = mantissa_bits - bits;
+  if (drop <= 0) return;
+  const std::uint64_t half = std::uint64_t(1) << (drop - 1);
+  const std::uint64_t mask = ~((std::uint64_t(1) << drop) - 1);
+  for (auto &x : data) {
+    if (!std::isfinite(x)) continue;
+    std::uint64_t u;
+    std::memcpy(&u, &x, sizeof(u));
+    u = (u + half) & mask;
+    double y;
+    std::memcpy(&y, &u, sizeof(y));
+    if (std::isfinite(y)) x = y;
+  }
+}
+
+inline herr_t CopyAttribute(hid_t src, const char *name, const H5A_info_t *,
+                            void *op_data) {
+  const hid_t dst = *static_cast<hid_t *>(op_data);
+  herr_t status = 0;
+  hid_t attr = H5Aopen(src, name, H5P_DEFAULT);
+  hid_t type = H5Aget_type(attr);
+  hid_t space = H5Aget_space(attr);
+  const hssize_t npoints = H5Sget_simple_extent_npoints(space);
+  std::vector<unsigned char> buffer(H5Tget_size(type) * std::max<hssize_t>(npoints, 1));
+  status += H5Aread(attr, type, buffer.data());
+  hid_t out = H5Acreate(dst, name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+  status += H5Awrite(out, type, buffer.data());
+  if (H5Tis_variable_str(type) > 0 || H5Tdetect_class(type, H5T_VLEN) > 0) {
+#if H5_VERSION_GE(1, 12, 0)
+    status += H5Treclaim(type, space, H5P_DEFAULT, buffer.data());
+#else
+    status += H5Dvlen_reclaim(type, space, H5P_DEFAULT, buffer.data());
+#endif
+  }
+  status += H5Aclose(out);
+  status += H5Sclose(space);
+  status += H5Tclose(type);
+  status += H5Aclose(attr);
+  return status;
+}
+
+inline herr_t CopyAttributes(hid_t src, hid_t dst) {
+  hsize_t idx = 0;
+  return H5Aiterate2(src, H5_INDEX_NAME, H5_ITER_NATIVE, &idx, CopyAttribute, &dst);
+}
+
+inline herr_t RepackDataset(hid_t src, hid_t dst, const std::string &name,
+                            const std::string &path, const Options &opts) {
+  herr_t status = 0;
+  hid_t dset = H5Dopen(src, name.c_str(), H5P_DEFAULT);
+  hid_t type = H5Dget_type(dset);
+  hid_t space = H5Dget_space(dset);
+  const int rank = H5Sget_simple_extent_ndims(space);
+  const hssize_t npoints = H5Sget_simple_extent_npoints(space);
+  const bool is_double =
+      (H5Tget_class(type) == H5T_FLOAT && H5Tget_size(type) == sizeof(double));
+
+  if (!is_double || rank < 1 || npoints < 2) {
+    // Scalars and non-floating point data are copied as is
+    status += H5Sclose(space);
+    status += H5Tclose(type);
+    status += H5Dclose(dset);
+    return status +
+           H5Ocopy(src, name.c_str(), dst, name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+  }
+
+  std::vector<double> data(npoints);
+  status += H5Dread(dset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data());
+  if (IsLossy(path, opts)) TruncateMantissa(data, opts.lossyBits);
+
+  // Chunks span the fastest moving dimensions and as many of the
+  // slower ones as fit in the target chunk size.
+  std::vector<hsize_t> dims(rank), chunk(rank);
+  H5Sget_simple_extent_dims(space, dims.data(), nullptr);
+  hsize_t nchunk = 1;
+  for (int d = rank - 1; d >= 0; --d) {
+    const hsize_t target = std::max<hsize_t>(opts.chunkElements / nchunk, 1);
+    chunk[d] = std::max<hsize_t>(std::min(dims[d], target), 1);
+    nchunk *= chunk[d];
+  }
+
+  hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+  status += H5Pset_chunk(dcpl, rank, chunk.data());
+  status += H5Pset_shuffle(dcpl);
+  if (H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0) {
+    status += H5Pset_deflate(dcpl, std::min(std::max(opts.level, 1), 9));
+  } else {
+    std::cerr << "WARNING: deflate filter not available in HDF5. "
+              << "Writing " << path << " uncompressed." << std::endl;
+  }
+  hid_t out = H5Dcreate(dst, name.c_str(), H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, dcpl,
+                        H5P_DEFAULT);
+  status += H5Dwrite(out, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data());
+  status += CopyAttributes(dset, out);
+
+  status += H5Dclose(out);
+  status += H5Pclose(dcpl);
+  status += H5Sclose(space);
+  status += H5Tclose(type);
+  status += H5Dclose(dset);
+  return status;
+}
+
+inline herr_t RepackGroup(hid_t src, hid_t dst, const std::string &path,
+                          const Options &opts) {
+  herr_t status = CopyAttributes(src, dst);
+
+  H5G_info_t ginfo;
+  status += H5Gget_info(src, &ginfo);
+  for (hsize_t i = 0; i < ginfo.nlinks; ++i) {
+    const ssize_t len = H5Lget_name_by_idx(src, ".", H5_INDEX_NAME, H5_ITER_INC, i,
+                                           nullptr, 0, H5P_DEFAULT);
+    std::vector<char> cname(len + 1, '\0');
+    H5Lget_name_by_idx(src, ".", H5_INDEX_NAME, H5_ITER_INC, i, cname.data(), len + 1,
+                       H5P_DEFAULT);
+    const std::string name(cname.data());
+    const std::string child = path + "/" + name;
+
+    H5L_info_t linfo;
+    status += H5Lget_info(src, name.c_str(), &linfo, H5P_DEFAULT);
+    if (linfo.type == H5L_TYPE_SOFT) {
+      std::vector<char> target(linfo.u.val_size + 1, '\0');
+      status += H5Lget_val(src, name.c_str(), target.data(), target.size(), H5P_DEFAULT);
+      status +=
+          H5Lcreate_soft(target.data(), dst, name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+      continue;
+    }
+    if (linfo.type != H5L_TYPE_HARD) {
+      status += H5Ocopy(src, name.c_str(), dst, name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+      continue;
+    }
+
+    hid_t obj = H5Oopen(src, name.c_str(), H5P_DEFAULT);
+    const H5I_type_t otype = H5Iget_type(obj);
+    status += H5Oclose(obj);
+    if (otype == H5I_GROUP) {
+      hid_t gsrc = H5Gopen(src, name.c_str(), H5P_DEFAULT);
+      hid_t gdst = H5Gcreate(dst, name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      status += RepackGroup(gsrc, gdst, child, opts);
+      status += H5Gclose(gdst);
+      status += H5Gclose(gsrc);
+    } else if (otype == H5I_DATASET) {
+      status += RepackDataset(src, dst, name, child, opts);
+    } else {
+      status += H5Ocopy(src, name.c_str(), dst, name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+    }
+  }
+  return status;
+}
+
+} // namespace impl
+
+// Writes a compressed copy of the sp5 file src to dst
+inline herr_t Repack(const std::string &src, const std::string &dst,
+                     const Options &opts) {
+  herr_t status = 0;
+  hid_t fsrc = H5Fopen(src.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  if (fsrc < 0) return -1;
+  hid_t fdst = H5Fcreate(dst.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  if (fdst < 0) {
+    H5Fclose(fsrc);
+    return -1;
+  }
+  hid_t gsrc = H5Gopen(fsrc, "/", H5P_DEFAULT);
+  hid_t gdst = H5Gopen(fdst, "/", H5P_DEFAULT);
+  status += impl::RepackGroup(gsrc, gdst, "", opts);
+  status += H5Gclose(gdst);
+  status += H5Gclose(gsrc);
+  status += H5Fclose(fdst);
+  status += H5Fclose(fsrc);
+  return status;
+}
+
+namespace impl {
+
+// The parallel path reads chunks raw and inflates them with zlib,
+// which needs the chunk query API of HDF5 1.10.5.
+#if defined(SINGULARITY_USE_ZLIB) && H5_VERSION_GE(1, 10, 5)
+constexpr bool canInflateChunks = true;
+#else
+constexpr bool canInflateChunks = false;
+#endif
+
+// A dataset of the in-memory copy and the data to write to it
+struct PendingDataset {
+  hid_t src;
+  hid_t dst;
+  std::vector<hsize_t> dims;
+  std::vector<double> data;
+};
+
+// A chunk as stored in the file, and where it goes once inflated
+struct PendingChunk {
+  std::size_t dataset;
+  std::vector<hsize_t> offset;
+  std::vector<hsize_t> chunk;
+  bool shuffled;
+  std::vector<unsigned char> raw;
+};
+
+// True if dset is chunked with the filters Repack applies, deflate
+// optionally preceded by shuffle
+inline bool InflatableChunks(hid_t dset, std::vector<hsize_t> &chunk, bool &shuffled) {
+  bool inflatable = false;
+  shuffled = false;
+  hid_t dcpl = H5Dget_create_plist(dset);
+  if (H5Pget_layout(dcpl) == H5D_CHUNKED) {
+    const int nfilters = H5Pget_nfilters(dcpl);
+    bool deflated = false;
+    bool other = false;
+    for (int i = 0; i < nfilters; ++i) {
+      unsigned int flags;
+      std::size_t nelmts = 0;
+      unsigned int filter_config;
+      const H5Z_filter_t filter =
+          H5Pget_filter2(dcpl, i, &flags, &nelmts, nullptr, 0, nullptr, &filter_config);
+      if (filter == H5Z_FILTER_SHUFFLE && i == 0) {
+        shuffled = true;
+      } else if (filter == H5Z_FILTER_DEFLATE && i == nfilters - 1) {
+        deflated = true;
+      } else {
+        other = true;
+      }
+    }
+    inflatable = deflated && !other;
+    if (inflatable) {
+      H5Pget_chunk(dcpl, static_cast<int>(chunk.size()), chunk.data());
+    }
+  }
+  H5Pclose(dcpl);
+  return inflatable;
+}
+
+inline std::string LinkName(hid_t group, hsize_t i) {
+  const ssize_t len = H5Lget_name_by_idx(group, ".", H5_INDEX_NAME, H5_ITER_INC, i,
+                                         nullptr, 0, H5P_DEFAULT);
+  std::vector<char> cname(len + 1, '\0');
+  H5Lget_name_by_idx(group, ".", H5_INDEX_NAME, H5_ITER_INC, i, cname.data(), len + 1,
+                     H5P_DEFAULT);
+  return cname.data();
+}
+
+inline bool LinksToInflatableChunks(hid_t src, const std::string &name);
+
+// True if obj is, or is a group that holds, a floating point dataset
+// with inflatable chunks
+inline bool HasInflatableChunks(hid_t obj) {
+  bool found = false;
+  const H5I_type_t otype = H5Iget_type(obj);
+  if (otype == H5I_GROUP) {
+    H5G_info_t ginfo;
+    if (H5Gget_info(obj, &ginfo) >= 0) {
+      for (hsize_t i = 0; i < ginfo.nlinks && !found; ++i) {
+        found = LinksToInflatableChunks(obj, LinkName(obj, i));
+      }
+    }
+  } else if (otype == H5I_DATASET) {
+    hid_t type = H5Dget_type(obj);
+    hid_t space = H5Dget_space(obj);
+    const int rank = H5Sget_simple_extent_ndims(space);
+    if (H5Tget_class(type) == H5T_FLOAT && H5Tget_size(type) == sizeof(double) &&
+        rank >= 1) {
+      std::vector<hsize_t> chunk(rank);
+      bool shuffled;
+      found = InflatableChunks(obj, chunk, shuffled);
+    }
+    H5Sclose(space);
+    H5Tclose(type);
+  }
+  return found;
+}
+
+// As HasInflatableChunks, for the object name links to in src. Like
+// CopyLink, soft links are not followed.
+inline bool LinksToInflatableChunks(hid_t src, const std::string &name) {
+  H5L_info_t linfo;
+  if (H5Lget_info(src, name.c_str(), &linfo, H5P_DEFAULT) < 0 ||
+      linfo.type != H5L_TYPE_HARD) {
+    return false;
+  }
+  hid_t obj = H5Oopen(src, name.c_str(), H5P_DEFAULT);
+  const bool found = HasInflatableChunks(obj);
+  H5Oclose(obj);
+  return found;
+}
+
+// Reads every chunk of dset as stored in the file
+inline herr_t ReadRawChunks(hid_t dset, std::size_t dataset,
+                            const std::vector<hsize_t> &chunk, bool shuffled,
+                            std::vector<PendingChunk> &chunks) {
+  herr_t status = 0;
+#if H5_VERSION_GE(1, 10, 5)
+  hid_t space = H5Dget_space(dset);
+  hsize_t nchunks = 0;
+  status += H5Dget_num_chunks(dset, space, &nchunks);
+  for (hsize_t c = 0; c < nchunks; ++c) {
+    PendingChunk pending{dataset, std::vector<hsize_t>(chunk.size()), chunk, shuffled,
+                         {}};
+    unsigned int filter_mask = 0;
+    haddr_t addr;
+    hsize_t size = 0;
+    status += H5Dget_chunk_info(dset, space, c, pending.offset.data(), &filter_mask,
+                                &addr, &size);
+    pending.raw.resize(size);
+    status += H5Dread_chunk(dset, H5P_DEFAULT, pending.offset.data(), &filter_mask,
+                            pending.raw.data());
+    // A chunk that skipped a filter is left to HDF5
+    if (filter_mask != 0) status = -1;
+    if (status < 0) break;
+    chunks.push_back(std::move(pending));
+  }
+  status += H5Sclose(space);
+#endif // H5_VERSION_GE(1, 10, 5)
+  return status;
+}
+
+// Inflates a chunk and copies the part inside the dataset into place
+inline bool InflateChunk(const PendingChunk &pending, PendingDataset &dataset) {
+#ifdef SINGULARITY_USE_ZLIB
+  const int rank = static_cast<int>(pending.chunk.size());
+  std::size_t nelements = 1;
+  for (const auto c : pending.chunk)
+    nelements *= c;
+  const std::size_t nbytes = nelements * sizeof(double);
+  std::vector<unsigned char> bytes(nbytes);
+  uLongf length = nbytes;
+  if (uncompress(bytes.data(), &length, pending.raw.data(), pending.raw.size()) !=
+          Z_OK ||
+      length != nbytes) {
+    return false;
+  }
+  std::vector<double> values(nelements);
+  if (pending.shuffled) {
+    // shuffle stores byte k of every element contiguously
+    unsigned char *out = reinterpret_cast<unsigned char *>(values.data());
+    for (std::size_t k = 0; k < sizeof(double); ++k) {
+      for (std::size_t e = 0; e < nelements; ++e) {
+        out[e * sizeof(double) + k] = bytes[k * nelements + e];
+      }
+    }
+  } else {
+    std::memcpy(values.data(), bytes.data(), nbytes);
+  }
+  // Chunks at the upper edges extend past the dataset. Copy each row
+  // along the fastest dimension that lies inside it.
+  const hsize_t rowLength = std::min(pending.chunk[rank - 1],
+                                     dataset.dims[rank - 1] - pending.offset[rank - 1]);
+  const std::size_t nrows = nelements / pending.chunk[rank - 1];
+  for (std::size_t row = 0; row < nrows; ++row) {
+    std::size_t remainder = row;
+    std::size_t dst = pending.offset[rank - 1];
+    std::size_t stride = dataset.dims[rank - 1];
+    bool inside = true;
+    for (int d = rank - 2; d >= 0; --d) {
+      const hsize_t i = pending.offset[d] + remainder % pending.chunk[d];
+      remainder /= pending.chunk[d];
+      inside = inside && (i < dataset.dims[d]);
+      dst += i * stride;
+      stride *= dataset.dims[d];
+    }
+    if (!inside) continue;
+    std::memcpy(dataset.data.data() + dst,
+                values.data() + row * pending.chunk[rank - 1],
+                rowLength * sizeof(double));
+  }
+  return true;
+#else
+  return false;
+#endif // SINGULARITY_USE_ZLIB
+}
+
+// Recreates the layout of src in dst. Floating point datasets are
+// created uncompressed and queued in datasets to be filled later.
+inline herr_t CopyLayout(hid_t src, hid_t dst, std::vector<PendingDataset> &datasets);
+
+inline herr_t CopyLink(hid_t src, hid_t dst, const std::string &name,
+                       std::vector<PendingDataset> &datasets) {
+  herr_t status = 0;
+  H5L_info_t linfo;
+  status += H5Lget_info(src, name.c_str(), &linfo, H5P_DEFAULT);
+  if (linfo.type == H5L_TYPE_SOFT) {
+    std::vector<char> target(linfo.u.val_size + 1, '\0');
+    status += H5Lget_val(src, name.c_str(), target.data(), target.size(), H5P_DEFAULT);
+    return status +
+           H5Lcreate_soft(target.data(), dst, name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+  }
+  if (linfo.type != H5L_TYPE_HARD) {
+    return status +
+           H5Ocopy(src, name.c_str(), dst, name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+  }
+
+  hid_t obj = H5Oopen(src, name.c_str(), H5P_DEFAULT);
+  const H5I_type_t otype = H5Iget_type(obj);
+  status += H5Oclose(obj);
+  if (otype == H5I_GROUP) {
+    hid_t gsrc = H5Gopen(src, name.c_str(), H5P_DEFAULT);
+    hid_t gdst = H5Gcreate(dst, name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    status += CopyLayout(gsrc, gdst, datasets);
+    status += H5Gclose(gdst);
+    status += H5Gclose(gsrc);
+    return status;
+  }
+  if (otype != H5I_DATASET) {
+    return status +
+           H5Ocopy(src, name.c_str(), dst, name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+  }
+
+  hid_t dset = H5Dopen(src, name.c_str(), H5P_DEFAULT);
+  hid_t type = H5Dget_type(dset);
+  hid_t space = H5Dget_space(dset);
+  const int rank = H5Sget_simple_extent_ndims(space);
+  const bool is_double =
+      (H5Tget_class(type) == H5T_FLOAT && H5Tget_size(type) == sizeof(double));
+  status += H5Tclose(type);
+  if (!is_double || rank < 1) {
+    status += H5Sclose(space);
+    status += H5Dclose(dset);
+    return status +
+           H5Ocopy(src, name.c_str(), dst, name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+  }
+  PendingDataset pending{dset, -1, std::vector<hsize_t>(rank), {}};
+  H5Sget_simple_extent_dims(space, pending.dims.data(), nullptr);
+  pending.dst = H5Dcreate(dst, name.c_str(), H5T_NATIVE_DOUBLE, space, H5P_DEFAULT,
+                          H5P_DEFAULT, H5P_DEFAULT);
+  status += CopyAttributes(dset, pending.dst);
+  status += H5Sclose(space);
+  datasets.push_back(std::move(pending));
+  return status;
+}
+
+inline herr_t CopyLayout(hid_t src, hid_t dst, std::vector<PendingDataset> &datasets) {
+  herr_t status = CopyAttributes(src, dst);
+  H5G_info_t ginfo;
+  status += H5Gget_info(src, &ginfo);
+  for (hsize_t i = 0; i < ginfo.nlinks; ++i) {
+    status += CopyLink(src, dst, LinkName(src, i), datasets);
+  }
+  return status;
+}
+
+} // namespace impl
+
+// Opens the sp5 file filename for reading. If it holds datasets
+// compressed by Repack, their chunks are inflated on nthreads threads
+// (by default one per core) into an in-memory copy of the file, which
+// is returned instead. If group is not empty, only that group, or the
+// one a soft link of that name points to, is copied. The result is
+// closed with H5Fclose either way.
+inline hid_t Open(const std::string &filename, const std::string &group = "",
+                  int nthreads = 0) {
+  hid_t fsrc = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  if (fsrc < 0 || !impl::canInflateChunks) return fsrc;
+
+  // A missing group is left for the caller to report
+  if (!group.empty() && H5Lexists(fsrc, group.c_str(), H5P_DEFAULT) <= 0) {
+    return fsrc;
+  }
+
+  // Most files are not compressed, so look for a compressed dataset
+  // before making a copy
+  bool compressed = false;
+  if (group.empty()) {
+    hid_t root = H5Gopen(fsrc, "/", H5P_DEFAULT);
+    compressed = impl::HasInflatableChunks(root);
+    H5Gclose(root);
+  } else {
+    std::string name = group;
+    H5L_info_t linfo;
+    if (H5Lget_info(fsrc, group.c_str(), &linfo, H5P_DEFAULT) >= 0 &&
+        linfo.type == H5L_TYPE_SOFT) {
+      std::vector<char> target(linfo.u.val_size + 1, '\0');
+      H5Lget_val(fsrc, group.c_str(), target.data(), target.size(), H5P_DEFAULT);
+      name = target.data();
+    }
+    compressed = impl::LinksToInflatableChunks(fsrc, name);
+  }
+  if (!compressed) return fsrc;
+
+  // Each in-memory copy needs a distinct name while it is open
+  static std::atomic<int> ncopies(0);
+  const std::string memname = filename + ".inflated." + std::to_string(ncopies++);
+  hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+  herr_t status = H5Pset_fapl_core(fapl, 1 << 20, 0);
+  hid_t fdst = H5Fcreate(memname.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+  status += H5Pclose(fapl);
+  if (fdst < 0) return fsrc;
+
+  std::vector<impl::PendingDataset> datasets;
+  hid_t gsrc = H5Gopen(fsrc, "/", H5P_DEFAULT);
+  hid_t gdst = H5Gopen(fdst, "/", H5P_DEFAULT);
+  if (group.empty()) {
+    status += impl::CopyLayout(gsrc, gdst, datasets);
+  } else {
+    status += impl::CopyAttributes(gsrc, gdst);
+    H5L_info_t linfo;
+    status += H5Lget_info(gsrc, group.c_str(), &linfo, H5P_DEFAULT);
+    if (linfo.type == H5L_TYPE_SOFT) {
+      std::vector<char> target(linfo.u.val_size + 1, '\0');
+      status +=
+          H5Lget_val(gsrc, group.c_str(), target.data(), target.size(), H5P_DEFAULT);
+      status += impl::CopyLink(gsrc, gdst, group, datasets);
+      std::string name(target.data());
+      if (!name.empty() && name[0] == '/') name.erase(0, 1);
+      status += impl::CopyLink(gsrc, gdst, name, datasets);
+    } else {
+      status += impl::CopyLink(gsrc, gdst, group, datasets);
+    }
+  }
+  status += H5Gclose(gdst);
+  status += H5Gclose(gsrc);
+
+  std::vector<std::vector<hsize_t>> chunkDims;
+  std::vector<char> inflatable, shuffled;
+  for (const auto &dataset : datasets) {
+    chunkDims.emplace_back(dataset.dims.size());
+    bool shuffle;
+    inflatable.push_back(impl::InflatableChunks(dataset.src, chunkDims.back(), shuffle));
+    shuffled.push_back(shuffle);
+  }
+  if (status < 0 || std::none_of(inflatable.begin(), inflatable.end(),
+                                 [](const char c) { return c; })) {
+    for (auto &dataset : datasets) {
+      H5Dclose(dataset.dst);
+      H5Dclose(dataset.src);
+    }
+    H5Fclose(fdst);
+    return fsrc;
+  }
+
+  // Raw chunks are read serially, since HDF5 is not thread safe, and
+  // other datasets are read as usual
+  std::vector<impl::PendingChunk> chunks;
+  for (std::size_t i = 0; i < datasets.size(); ++i) {
+    std::size_t npoints = 1;
+    for (const auto d : datasets[i].dims)
+      npoints *= d;
+    datasets[i].data.resize(npoints);
+    const std::size_t first = chunks.size();
+    if (!inflatable[i] ||
+        impl::ReadRawChunks(datasets[i].src, i, chunkDims[i], shuffled[i], chunks) < 0) {
+      chunks.resize(first);
+      status += H5Dread(datasets[i].src, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL,
+                        H5P_DEFAULT, datasets[i].data.data());
+    }
+  }
+
+  // Inflate the chunks in parallel
+  std::atomic<std::size_t> next(0);
+  std::atomic<bool> inflated(true);
+  auto worker = [&]() {
+    for (std::size_t c = next++; c < chunks.size(); c = next++) {
+      if (!impl::InflateChunk(chunks[c], datasets[chunks[c].dataset])) {
+        inflated = false;
+      }
+    }
+  };
+  if (nthreads <= 0) {
+    nthreads = std::max<int>(std::thread::hardware_concurrency(), 1);
+  }
+  nthreads = std::max<int>(std::min<std::size_t>(nthreads, chunks.size()), 1);
+  std::vector<std::thread> threads;
+  for (int t = 1; t < nthreads; ++t) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (auto &dataset : datasets) {
+    status += H5Dwrite(dataset.dst, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                       dataset.data.data());
+    status += H5Dclose(dataset.dst);
+    status += H5Dclose(dataset.src);
+  }
+
+  // If something went wrong, read the file directly
+  if (!inflated || status < 0) {
+    H5Fclose(fdst);
+    return fsrc;
+  }
+  H5Fclose(fsrc);
+  return fdst;
+}
+
+} // namespace Compression
+} // namespace SP5
+
+#endif // _SINGULARITY_EOS_UTILS_SP5_SP5_COMPRESSION_HPP_
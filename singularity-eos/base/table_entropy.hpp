@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#ifndef SINGULARITY_EOS_BASE_TABLE_ENTROPY_HPP_
+#define SINGULARITY_EOS_BASE_TABLE_ENTROPY_HPP_
+
+#ifdef SINGULARITY_USE_SPINER
+#include <algorithm>
+#include <cmath>
+
+#include <ports-of-call/portability.hpp>
+#include <singularity-eos/base/fast-math/logs.hpp>
+#include <singularity-eos/base/robust_utils.hpp>
+#include <spiner/databox.hpp>
+
+namespace singularity {
+namespace table_entropy {
+
+using DataBox = Spiner::DataBox<Real>;
+
+// Entropy tables consistent with tabulated pressure and energy, for
+// tables on log(rho + offset) and log(y + offset) grids indexed (rho, y)
+// like those written by sesame2spiner. The entropy is the integral of
+//     T dS = de + P dV = de - (P / rho) d ln(rho)
+// over the table, so it is only defined up to a constant, which is
+// fixed by a reference state. All functions are host only.
+
+// Entropy change from (T0, e0) to (T1, e1) at fixed density. Exact
+// when the specific heat is constant across the interval.
+inline Real DeltaSAlongT(const Real T0, const Real T1, const Real e0, const Real e1) {
+  const Real dT = T1 - T0;
+  if (std::abs(dT) <= 1e-12 * std::abs(T0)) return (e1 - e0) / T0;
+  return (e1 - e0) * std::log(T1 / T0) / dT;
+}
+
+// Entropy change from rho0 to rho1 at fixed temperature T, with the
+// pressure integrated by the trapezoid rule in ln(rho). Exact for an
+// ideal gas.
+inline Real DeltaSAlongRho(const Real T, const Real rho0, const Real rho1, const Real e0,
+                           const Real e1, const Real P0, const Real P1) {
+  const Real work = 0.5 * (P0 / rho0 + P1 / rho1) * std::log(rho1 / rho0);
+  return (e1 - e0 - work) / T;
+}
+
+// Fills S, on the grid of P, from the pressure P(rho, T) and specific
+// internal energy sie(rho, T). The entropy vanishes at (rhoRef, TRef),
+// which is moved onto the table if it lies outside of it. Densities
+// and temperatures must be positive on the grid.
+inline void EntropyOfRhoT(const DataBox &P, const DataBox &sie, const Real lRhoOffset,
+                          const Real lTOffset, const Real rhoRef, const Real TRef,
+                          DataBox &S) {
+  const auto &lRhoGrid = P.range(1);
+  const auto &lTGrid = P.range(0);
+  const int nRho = lRhoGrid.nPoints();
+  const int nT = lTGrid.nPoints();
+  auto rho = [&](const int j) { return FastMath::pow10(lRhoGrid.x(j)) - lRhoOffset; };
+  auto T = [&](const int i) { return FastMath::pow10(lTGrid.x(i)) - lTOffset; };
+  auto nearest = [](const auto &grid, const Real x) {
+    const int n = grid.nPoints();
+    const Real dx = (grid.max() - grid.min()) / (n - 1);
+    const int i = static_cast<int>(std::round((x - grid.min()) / dx));
+    return std::min(std::max(i, 0), n - 1);
+  };
+  const Real lRhoRef =
+      std::min(std::max(FastMath::log10(rhoRef + lRhoOffset), lRhoGrid.min()),
+               lRhoGrid.max());
+  const Real lTRef = std::min(
+      std::max(FastMath::log10(TRef + lTOffset), lTGrid.min()), lTGrid.max());
+  const int jRef = nearest(lRhoGrid, lRhoRef);
+  const int iRef = nearest(lTGrid, lTRef);
+
+  S.copyMetadata(P);
+  // Along density on the reference isotherm
+  S(jRef, iRef) = 0;
+  for (int j = jRef + 1; j < nRho; ++j) {
+    S(j, iRef) = S(j - 1, iRef) + DeltaSAlongRho(T(iRef), rho(j - 1), rho(j),
+                                                 sie(j - 1, iRef), sie(j, iRef),
+                                                 P(j - 1, iRef), P(j, iRef));
+  }
+  for (int j = jRef - 1; j >= 0; --j) {
+    S(j, iRef) = S(j + 1, iRef) - DeltaSAlongRho(T(iRef), rho(j), rho(j + 1),
+                                                 sie(j, iRef), sie(j + 1, iRef),
+                                                 P(j, iRef), P(j + 1, iRef));
+  }
+  // Then along each isochore
+  for (int j = 0; j < nRho; ++j) {
+    for (int i = iRef + 1; i < nT; ++i) {
+      S(j, i) = S(j, i - 1) + DeltaSAlongT(T(i - 1), T(i), sie(j, i - 1), sie(j, i));
+    }
+    for (int i = iRef - 1; i >= 0; --i) {
+      S(j, i) = S(j, i + 1) - DeltaSAlongT(T(i), T(i + 1), sie(j, i), sie(j, i + 1));
+    }
+  }
+  // Anchor exactly at the reference state rather than the nearest node
+  const Real SRef = S.interpToReal(lRhoRef, lTRef);
+  for (int j = 0; j < nRho; ++j) {
+    for (int i = 0; i < nT; ++i) {
+      S(j, i) -= SRef;
+    }
+  }
+}
+
+// Fills S, on the grid of T, which holds T(rho, sie), by evaluating
+// SRhoT, from EntropyOfRhoT, at each temperature. Between the
+// temperatures of SRhoT, the entropy is interpolated in ln(T), which is
+// exact for a constant specific heat. Above them, the specific heat at
+// the top of the table is assumed constant. Below them, the entropy at
+// the bottom is used.
+inline void EntropyOfRhoSie(const DataBox &SRhoT, const DataBox &sieRhoT,
+                            const Real lTOffset, const DataBox &T, const Real lEOffset,
+                            DataBox &S) {
+  const auto &lRhoGrid = T.range(1);
+  const auto &lEGrid = T.range(0);
+  const auto &lTGrid = SRhoT.range(0);
+  auto TOf = [&](const Real lT) { return FastMath::pow10(lT) - lTOffset; };
+  const Real TMax = TOf(lTGrid.max());
+  S.copyMetadata(T);
+  for (int j = 0; j < lRhoGrid.nPoints(); ++j) {
+    const Real lRho = lRhoGrid.x(j);
+    const Real STop = SRhoT.interpToReal(lRho, lTGrid.max());
+    const Real eTop = sieRhoT.interpToReal(lRho, lTGrid.max());
+    for (int i = 0; i < lEGrid.nPoints(); ++i) {
+      const Real temp = T(j, i);
+      const Real lT = FastMath::log10(std::max(temp + lTOffset, 0.0) + robust::EPS());
+      if (lT >= lTGrid.max()) {
+        const Real sie = FastMath::pow10(lEGrid.x(i)) - lEOffset;
+        S(j, i) = STop + DeltaSAlongT(TMax, temp, eTop, sie);
+      } else if (lT <= lTGrid.min()) {
+        S(j, i) = SRhoT.interpToReal(lRho, lTGrid.min());
+      } else {
+        const int k = lTGrid.index(lT);
+        const Real T0 = TOf(lTGrid.x(k));
+        const Real T1 = TOf(lTGrid.x(k + 1));
+        const Real w = (T0 > 0) ? std::log(temp / T0) / std::log(T1 / T0)
+                                : (temp - T0) / (T1 - T0);
+        const Real S0 = SRhoT.interpToReal(lRho, lTGrid.x(k));
+        const Real S1 = SRhoT.interpToReal(lRho, lTGrid.x(k + 1));
+        S(j, i) = (1 - w) * S0 + w * S1;
+      }
+    }
+  }
+}
+
+} // namespace table_entropy
+} // namespace singularity
+
+#endif // SINGULARITY_USE_SPINER
+#endif // SINGULARITY_EOS_BASE_TABLE_ENTROPY_HPP_
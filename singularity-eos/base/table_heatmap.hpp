@@ -0,0 +1,346 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#ifndef SINGULARITY_EOS_BASE_TABLE_HEATMAP_HPP_
+#define SINGULARITY_EOS_BASE_TABLE_HEATMAP_HPP_
+
+// Visitation counts for tabulated equations of state.
+//
+// A TableHeatmap holds one or more 2D grids, each matching the nodes
+// of a table. Tabulated EOS models built with
+// SINGULARITY_ENABLE_TABLE_HEATMAP record every lookup into the
+// heatmap attached with SetHeatmap: lookups that land on the table
+// increment the count of the table cell they fall in, and every lookup
+// increments the count of its TableStatus, so that one can see how
+// often the off-table branches, such as the cold curve or the ideal
+// gas extrapolation, are taken. VisitedBounds gives the part of a
+// table a run used, which the tabulated models turn into a
+// TableWindow to crop their tables to.
+//
+// Each thread writes to its own set of counters, so recording takes
+// no locks after a thread's first lookup. The counters are merged when
+// read. Read the heatmap only after lookups have finished. Recording
+// is host-only.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef SINGULARITY_USE_SPINER_WITH_HDF5
+#include <hdf5.h>
+#include <hdf5_hl.h>
+#endif // SINGULARITY_USE_SPINER_WITH_HDF5
+
+#include <ports-of-call/portability.hpp>
+#include <singularity-eos/base/constants.hpp>
+
+namespace singularity {
+
+class TableHeatmap {
+ public:
+  using Count = std::uint64_t;
+  static constexpr int NUM_STATUSES = 3;
+
+  struct Axis {
+    std::string label;
+    Real min, max;
+    int ncells;
+  };
+  struct Grid {
+    std::string name;
+    Axis x, y;
+  };
+
+  explicit TableHeatmap(const std::string &name = "") : name_(name), id_(NextId_()) {}
+  TableHeatmap(const TableHeatmap &) = delete;
+  TableHeatmap &operator=(const TableHeatmap &) = delete;
+
+  const std::string &Name() const { return name_; }
+  int NumGrids() const { return static_cast<int>(grids_.size()); }
+  const Grid &GetGrid(const int grid) const { return grids_[grid]; }
+  // Index of the grid with the given name, or -1
+  int FindGrid(const std::string &name) const {
+    for (int g = 0; g < NumGrids(); ++g) {
+      if (grids_[g].name == name) return g;
+    }
+    return -1;
+  }
+
+  // Adds a grid spanning [xmin, xmax] x [ymin, ymax], with nx and ny
+  // nodes, and returns its index. If a grid with the same name
+  // exists, its index is returned instead. Add grids before recording.
+  int AddGrid(const std::string &name, const std::string &xlabel, const Real xmin,
+              const Real xmax, const int nx, const std::string &ylabel, const Real ymin,
+              const Real ymax, const int ny) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int g = 0; g < NumGrids(); ++g) {
+      if (grids_[g].name == name) return g;
+    }
+    grids_.push_back(
+        Grid{name, Axis{xlabel, xmin, xmax, std::max(nx - 1, 1)},
+             Axis{ylabel, ymin, ymax, std::max(ny - 1, 1)}});
+    for (auto &shard : shards_) {
+      AddGridToShard_(*shard, grids_.back());
+    }
+    return NumGrids() - 1;
+  }
+
+  // Counts a lookup at (x, y) with the given table status. Points
+  // outside the grid are clamped to the nearest cell and also counted
+  // as outside.
+  void Record(const int grid, const Real x, const Real y, const TableStatus status) {
+    Shard_ &shard = GetShard_();
+    const Grid &g = grids_[grid];
+    shard.statuses[grid][static_cast<int>(status)]++;
+    if (status != TableStatus::OnTable) {
+      shard.offx[grid][0] = std::min(shard.offx[grid][0], x);
+      shard.offx[grid][1] = std::max(shard.offx[grid][1], x);
+      return;
+    }
+    bool outside = false;
+    const int ix = CellIndex_(g.x, x, outside);
+    const int iy = CellIndex_(g.y, y, outside);
+    shard.counts[grid][ix * g.y.ncells + iy]++;
+    if (outside) shard.outside[grid]++;
+  }
+
+  // Merged cell counts, indexed by ix * ny + iy, where ny is the
+  // number of cells on the y axis
+  std::vector<Count> Counts(const int grid) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Count> counts(NumCells_(grids_[grid]), 0);
+    for (const auto &shard : shards_) {
+      const auto &c = shard->counts[grid];
+      for (std::size_t i = 0; i < counts.size(); ++i) {
+        counts[i] += c[i];
+      }
+    }
+    return counts;
+  }
+  // Merged number of lookups with each TableStatus
+  std::array<Count, NUM_STATUSES> StatusCounts(const int grid) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::array<Count, NUM_STATUSES> counts{};
+    for (const auto &shard : shards_) {
+      for (int s = 0; s < NUM_STATUSES; ++s) {
+        counts[s] += shard->statuses[grid][s];
+      }
+    }
+    return counts;
+  }
+  // Merged number of on-table lookups outside the bounds of the grid
+  Count OutsideCount(const int grid) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Count outside = 0;
+    for (const auto &shard : shards_) {
+      outside += shard->outside[grid];
+    }
+    return outside;
+  }
+  // Bounds of the cells visited on the grid. Off-table lookups extend
+  // the bounds to the edge of the grid they left through, at their x
+  // clamped to the grid. Returns false if nothing has been recorded.
+  bool VisitedBounds(const int grid, Real &xmin, Real &xmax, Real &ymin,
+                     Real &ymax) const {
+    const Grid &g = grids_[grid];
+    const auto counts = Counts(grid);
+    const auto statuses = StatusCounts(grid);
+    int ixlo = g.x.ncells, ixhi = -1, iylo = g.y.ncells, iyhi = -1;
+    for (int ix = 0; ix < g.x.ncells; ++ix) {
+      for (int iy = 0; iy < g.y.ncells; ++iy) {
+        if (counts[ix * g.y.ncells + iy] > 0) {
+          ixlo = std::min(ixlo, ix);
+          ixhi = std::max(ixhi, ix);
+          iylo = std::min(iylo, iy);
+          iyhi = std::max(iyhi, iy);
+        }
+      }
+    }
+    const Real dx = (g.x.max - g.x.min) / g.x.ncells;
+    const Real dy = (g.y.max - g.y.min) / g.y.ncells;
+    xmin = ymin = std::numeric_limits<Real>::max();
+    xmax = ymax = std::numeric_limits<Real>::lowest();
+    if (ixhi >= 0) {
+      xmin = g.x.min + ixlo * dx;
+      xmax = g.x.min + (ixhi + 1) * dx;
+      ymin = g.y.min + iylo * dy;
+      ymax = g.y.min + (iyhi + 1) * dy;
+    }
+    const Count nbottom = statuses[static_cast<int>(TableStatus::OffBottom)];
+    const Count ntop = statuses[static_cast<int>(TableStatus::OffTop)];
+    if (nbottom + ntop > 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const auto &shard : shards_) {
+        xmin = std::min(xmin, std::max(shard->offx[grid][0], g.x.min));
+        xmax = std::max(xmax, std::min(shard->offx[grid][1], g.x.max));
+      }
+    }
+    if (nbottom > 0) {
+      ymin = g.y.min;
+      ymax = std::max(ymax, g.y.min);
+    }
+    if (ntop > 0) {
+      ymin = std::min(ymin, g.y.max);
+      ymax = g.y.max;
+    }
+    return (ixhi >= 0) || (nbottom + ntop > 0);
+  }
+
+  void Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &shard : shards_) {
+      for (int g = 0; g < NumGrids(); ++g) {
+        std::fill(shard->counts[g].begin(), shard->counts[g].end(), 0);
+        shard->statuses[g].fill(0);
+        shard->outside[g] = 0;
+        shard->offx[g] = EmptyRange_();
+      }
+    }
+  }
+
+  void WriteJSON(std::ostream &os) const {
+    os << "{\"name\": \"" << name_ << "\", \"grids\": [";
+    for (int g = 0; g < NumGrids(); ++g) {
+      const Grid &grid = grids_[g];
+      const auto counts = Counts(g);
+      const auto statuses = StatusCounts(g);
+      os << (g > 0 ? ", " : "") << "{\"name\": \"" << grid.name << "\", ";
+      WriteAxisJSON_(os, "x", grid.x);
+      WriteAxisJSON_(os, "y", grid.y);
+      os << "\"on_table\": " << statuses[static_cast<int>(TableStatus::OnTable)]
+         << ", \"off_bottom\": " << statuses[static_cast<int>(TableStatus::OffBottom)]
+         << ", \"off_top\": " << statuses[static_cast<int>(TableStatus::OffTop)]
+         << ", \"outside\": " << OutsideCount(g) << ", \"counts\": [";
+      for (int ix = 0; ix < grid.x.ncells; ++ix) {
+        os << (ix > 0 ? ", [" : "[");
+        for (int iy = 0; iy < grid.y.ncells; ++iy) {
+          os << (iy > 0 ? ", " : "") << counts[ix * grid.y.ncells + iy];
+        }
+        os << "]";
+      }
+      os << "]}";
+    }
+    os << "]}";
+  }
+
+#ifdef SINGULARITY_USE_SPINER_WITH_HDF5
+  // Writes a group named after the heatmap, containing one 2D dataset
+  // per grid. Axis bounds and status counts are attributes of the
+  // datasets.
+  herr_t WriteHDF5(hid_t loc) const {
+    herr_t status = 0;
+    const std::string group_name = name_.empty() ? "heatmap" : name_;
+    hid_t group =
+        H5Gcreate(loc, group_name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if (group < 0) return group;
+    for (int g = 0; g < NumGrids(); ++g) {
+      const Grid &grid = grids_[g];
+      const char *dset = grid.name.c_str();
+      const auto counts = Counts(g);
+      const auto statuses = StatusCounts(g);
+      const hsize_t dims[2] = {static_cast<hsize_t>(grid.x.ncells),
+                               static_cast<hsize_t>(grid.y.ncells)};
+      const unsigned long outside = OutsideCount(g);
+      std::array<unsigned long, NUM_STATUSES> status_counts;
+      std::copy(statuses.begin(), statuses.end(), status_counts.begin());
+      const double bounds[4] = {grid.x.min, grid.x.max, grid.y.min, grid.y.max};
+      status += H5LTmake_dataset(group, dset, 2, dims, H5T_NATIVE_ULLONG, counts.data());
+      status += H5LTset_attribute_string(group, dset, "x", grid.x.label.c_str());
+      status += H5LTset_attribute_string(group, dset, "y", grid.y.label.c_str());
+      status += H5LTset_attribute_double(group, dset, "bounds", bounds, 4);
+      status += H5LTset_attribute_ulong(group, dset, "status counts (on, bottom, top)",
+                                        status_counts.data(), NUM_STATUSES);
+      status += H5LTset_attribute_ulong(group, dset, "outside", &outside, 1);
+    }
+    status += H5Gclose(group);
+    return status;
+  }
+#endif // SINGULARITY_USE_SPINER_WITH_HDF5
+
+ private:
+  struct Shard_ {
+    std::vector<std::vector<Count>> counts;
+    std::vector<std::array<Count, NUM_STATUSES>> statuses;
+    std::vector<Count> outside;
+    // range of x over off-table lookups
+    std::vector<std::array<Real, 2>> offx;
+  };
+
+  static std::uint64_t NextId_() {
+    static std::atomic<std::uint64_t> next{0};
+    return next++;
+  }
+  static std::size_t NumCells_(const Grid &g) {
+    return static_cast<std::size_t>(g.x.ncells) * g.y.ncells;
+  }
+  static int CellIndex_(const Axis &a, const Real x, bool &outside) {
+    const Real dx = (a.max - a.min) / a.ncells;
+    const int i = (dx > 0) ? static_cast<int>(std::floor((x - a.min) / dx)) : 0;
+    if (i < 0 || i >= a.ncells) {
+      // the top node belongs to the last cell
+      outside = outside || (x > a.max) || (x < a.min);
+      return std::min(std::max(i, 0), a.ncells - 1);
+    }
+    return i;
+  }
+  static void AddGridToShard_(Shard_ &shard, const Grid &g) {
+    shard.counts.emplace_back(NumCells_(g), 0);
+    shard.statuses.emplace_back();
+    shard.statuses.back().fill(0);
+    shard.outside.push_back(0);
+    shard.offx.push_back(EmptyRange_());
+  }
+  static std::array<Real, 2> EmptyRange_() {
+    return {std::numeric_limits<Real>::max(), std::numeric_limits<Real>::lowest()};
+  }
+  static void WriteAxisJSON_(std::ostream &os, const char *name, const Axis &a) {
+    os << "\"" << name << "\": {\"label\": \"" << a.label << "\", \"min\": " << a.min
+       << ", \"max\": " << a.max << ", \"ncells\": " << a.ncells << "}, ";
+  }
+
+  // Threads find their shard through a thread-local cache keyed by
+  // the id of the heatmap, so only their first lookup locks.
+  Shard_ &GetShard_() {
+    thread_local std::unordered_map<std::uint64_t, Shard_ *> cache;
+    auto it = cache.find(id_);
+    if (it != cache.end()) return *(it->second);
+    std::lock_guard<std::mutex> lock(mutex_);
+    shards_.emplace_back(new Shard_);
+    Shard_ *shard = shards_.back().get();
+    for (const auto &g : grids_) {
+      AddGridToShard_(*shard, g);
+    }
+    cache[id_] = shard;
+    return *shard;
+  }
+
+  std::string name_;
+  std::uint64_t id_;
+  std::vector<Grid> grids_;
+  std::vector<std::unique_ptr<Shard_>> shards_;
+  mutable std::mutex mutex_;
+};
+
+} // namespace singularity
+
+#endif // SINGULARITY_EOS_BASE_TABLE_HEATMAP_HPP_
@@ -0,0 +1,509 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#ifndef SINGULARITY_EOS_BASE_TABLE_PATCHES_HPP_
+#define SINGULARITY_EOS_BASE_TABLE_PATCHES_HPP_
+
+#ifdef SINGULARITY_USE_SPINER
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <ports-of-call/portability.hpp>
+#include <ports-of-call/portable_errors.hpp>
+#include <spiner/databox.hpp>
+
+#ifdef SINGULARITY_USE_SPINER_WITH_HDF5
+#include <hdf5.h>
+#include <hdf5_hl.h>
+
+#include <singularity-eos/base/sp5/singularity_eos_sp5.hpp>
+#endif // SINGULARITY_USE_SPINER_WITH_HDF5
+
+namespace singularity {
+
+// Refined rectangular patches over the cells of a 2D base table.
+//
+// Each patch covers a rectangle of nj x ni base cells and stores its
+// own nodes at refine times the base resolution. A cell-to-patch
+// index gives the patch covering a point in O(1), so lookups cost one
+// extra load over the base table. Points in cells without a patch
+// use the base table, which is left untouched. All fields share one
+// patch layout, and the same (x1, x0) ordering as the base table,
+// which is indexed (j, i) with range(1) along j and range(0) along i.
+class TablePatches {
+ public:
+  using DataBox = Spiner::DataBox<Real>;
+  struct Patch {
+    int j0, i0; // first base cell covered
+    int nj, ni; // number of base cells covered
+  };
+
+  TablePatches() = default;
+  // Allocates storage for nfields fields on the given patches of the
+  // cells of base. Patches must not overlap. Host only.
+  inline TablePatches(const DataBox &base, const std::vector<Patch> &patches,
+                      const int refine, const int nfields);
+
+  PORTABLE_FORCEINLINE_FUNCTION int NumPatches() const { return numPatches_; }
+  PORTABLE_FORCEINLINE_FUNCTION int NumFields() const { return numFields_; }
+  PORTABLE_FORCEINLINE_FUNCTION int NumNodes() const { return numNodes_; }
+  PORTABLE_FORCEINLINE_FUNCTION int Refinement() const { return refine_; }
+
+  // True if (x1, x0) lies in a patched cell
+  PORTABLE_INLINE_FUNCTION bool Covers(const Real x1, const Real x0) const {
+    Real f1, f0;
+    return patchAt_(x1, x0, f1, f0) >= 0;
+  }
+  // Bilinear interpolation of field at (x1, x0) on the finest data
+  // available there. Falls back to base outside of the patches.
+  PORTABLE_INLINE_FUNCTION Real Interp(const int field, const DataBox &base,
+                                       const Real x1, const Real x0) const {
+    Real f1, f0;
+    const int p = patchAt_(x1, x0, f1, f0);
+    if (p < 0) return base.interpToReal(x1, x0);
+    const int nj = refine_ * static_cast<int>(patches_(p, NJ));
+    const int ni = refine_ * static_cast<int>(patches_(p, NI));
+    const Real g1 = (f1 - patches_(p, J0)) * refine_;
+    const Real g0 = (f0 - patches_(p, I0)) * refine_;
+    const int jj = std::min(std::max(static_cast<int>(g1), 0), nj - 1);
+    const int ii = std::min(std::max(static_cast<int>(g0), 0), ni - 1);
+    const Real w1 = g1 - jj;
+    const Real w0 = g0 - ii;
+    const int row = ni + 1;
+    const int k = static_cast<int>(patches_(p, OFFSET)) + jj * row + ii;
+    return ((1 - w1) * ((1 - w0) * data_(field, k) + w0 * data_(field, k + 1)) +
+            w1 * ((1 - w0) * data_(field, k + row) + w0 * data_(field, k + row + 1)));
+  }
+
+  // Host-side construction and access
+  // ----------------------------------------------------------------------
+  // Flags the cells of coarse where linear interpolation misses the
+  // data in fine, sampled at twice the resolution of coarse, by more
+  // than a relative error of tol. Returns one flag per cell, row major.
+  static inline std::vector<int> FlagCells(const DataBox &coarse, const DataBox &fine,
+                                           const Real tol);
+  // Covers the flagged cells with disjoint rectangles of at most
+  // maxCells cells per side. Every flagged cell ends up in exactly
+  // one patch. No unflagged cell is covered.
+  static inline std::vector<Patch> Cover(const std::vector<int> &flags, const int n1cells,
+                                         const int n0cells, const int maxCells = 32);
+
+  Patch GetPatch(const int p) const {
+    return {static_cast<int>(patches_(p, J0)), static_cast<int>(patches_(p, I0)),
+            static_cast<int>(patches_(p, NJ)), static_cast<int>(patches_(p, NI))};
+  }
+  // Number of nodes along each axis of patch p
+  void PatchShape(const int p, int &n1, int &n0) const {
+    n1 = refine_ * static_cast<int>(patches_(p, NJ)) + 1;
+    n0 = refine_ * static_cast<int>(patches_(p, NI)) + 1;
+  }
+  // Bounds of patch p along each axis
+  void PatchBounds(const int p, Real &x1lo, Real &x1hi, Real &x0lo, Real &x0hi) const {
+    const Patch patch = GetPatch(p);
+    x1lo = x1min_ + patch.j0 * dx1_;
+    x1hi = x1min_ + (patch.j0 + patch.nj) * dx1_;
+    x0lo = x0min_ + patch.i0 * dx0_;
+    x0hi = x0min_ + (patch.i0 + patch.ni) * dx0_;
+  }
+  // Sets the nodes of field on patch p from fine, which has the shape
+  // and bounds of PatchShape and PatchBounds.
+  inline void SetPatchData(const int field, const int p, const DataBox &fine);
+  // Overwrites the nodes of field on patch edges that border cells
+  // without a patch by the interpolant of base, so the interpolant is
+  // continuous across the edge.
+  inline void Conform(const int field, const DataBox &base);
+  // Calls f(k, x1, x0) for every patch node, where k indexes Value
+  template <typename Function_t>
+  inline void ForEachNode(Function_t &&f) const;
+  Real &Value(const int field, const int k) { return data_(field, k); }
+  Real Value(const int field, const int k) const { return data_(field, k); }
+  // Restricts the patches to the base nodes [lo[i], hi[i]] on each
+  // axis i, matching table_window::Crop.
+  inline void Crop(const int *lo, const int *hi);
+
+#ifdef SINGULARITY_USE_SPINER_WITH_HDF5
+  // Writes the patches to a subgroup of loc. Fields are named by names.
+  inline herr_t saveHDF(hid_t loc, const std::vector<std::string> &names) const;
+  // Reads the patches of the base table base from a subgroup of loc
+  inline herr_t loadHDF(hid_t loc, const DataBox &base,
+                        const std::vector<std::string> &names);
+  static bool Exists(hid_t loc) {
+    return H5Lexists(loc, SP5::Patches::group, H5P_DEFAULT) > 0;
+  }
+#endif // SINGULARITY_USE_SPINER_WITH_HDF5
+
+  inline TablePatches GetOnDevice() const;
+  inline void Finalize();
+
+ private:
+  // columns of patches_
+  enum { J0 = 0, I0 = 1, NJ = 2, NI = 3, OFFSET = 4, NCOLS = 5 };
+
+  // Returns the patch containing (x1, x0), or -1. Also returns the
+  // position of the point in units of base cells.
+  PORTABLE_FORCEINLINE_FUNCTION
+  int patchAt_(const Real x1, const Real x0, Real &f1, Real &f0) const {
+    if (numPatches_ == 0) return -1;
+    f1 = (x1 - x1min_) / dx1_;
+    f0 = (x0 - x0min_) / dx0_;
+    // written so that NaNs land outside
+    if (!(f1 >= 0 && f1 <= n1cells_ && f0 >= 0 && f0 <= n0cells_)) return -1;
+    const int j = std::min(static_cast<int>(f1), n1cells_ - 1);
+    const int i = std::min(static_cast<int>(f0), n0cells_ - 1);
+    return static_cast<int>(cellPatch_(j, i));
+  }
+  inline void setGrid_(const DataBox &base);
+  inline void layout_(const std::vector<Patch> &patches);
+
+  DataBox cellPatch_; // (n1cells, n0cells), patch index or -1
+  DataBox patches_;   // (numPatches, NCOLS)
+  DataBox data_;      // (numFields, numNodes)
+  int numPatches_ = 0;
+  int numFields_ = 0;
+  int numNodes_ = 0;
+  int refine_ = 1;
+  int n1cells_ = 0, n0cells_ = 0;
+  Real x1min_ = 0, dx1_ = 1;
+  Real x0min_ = 0, dx0_ = 1;
+};
+
+inline TablePatches::TablePatches(const DataBox &base, const std::vector<Patch> &patches,
+                                  const int refine, const int nfields)
+    : numFields_(nfields), refine_(refine) {
+  setGrid_(base);
+  layout_(patches);
+}
+
+inline void TablePatches::setGrid_(const DataBox &base) {
+  const auto &g1 = base.range(1);
+  const auto &g0 = base.range(0);
+  n1cells_ = g1.nPoints() - 1;
+  n0cells_ = g0.nPoints() - 1;
+  x1min_ = g1.min();
+  x0min_ = g0.min();
+  dx1_ = (g1.max() - g1.min()) / n1cells_;
+  dx0_ = (g0.max() - g0.min()) / n0cells_;
+}
+
+inline void TablePatches::layout_(const std::vector<Patch> &patches) {
+  numPatches_ = patches.size();
+  numNodes_ = 0;
+  if (numPatches_ == 0) return;
+  cellPatch_.resize(n1cells_, n0cells_);
+  for (int j = 0; j < n1cells_; ++j) {
+    for (int i = 0; i < n0cells_; ++i) {
+      cellPatch_(j, i) = -1;
+    }
+  }
+  patches_.resize(numPatches_, static_cast<int>(NCOLS));
+  for (int p = 0; p < numPatches_; ++p) {
+    const Patch &patch = patches[p];
+    if (patch.nj < 1 || patch.ni < 1 || patch.j0 < 0 || patch.i0 < 0 ||
+        patch.j0 + patch.nj > n1cells_ || patch.i0 + patch.ni > n0cells_) {
+      PORTABLE_ALWAYS_THROW_OR_ABORT("TablePatches: patch outside of the base table");
+    }
+    patches_(p, J0) = patch.j0;
+    patches_(p, I0) = patch.i0;
+    patches_(p, NJ) = patch.nj;
+    patches_(p, NI) = patch.ni;
+    patches_(p, OFFSET) = numNodes_;
+    numNodes_ += (refine_ * patch.nj + 1) * (refine_ * patch.ni + 1);
+    for (int j = patch.j0; j < patch.j0 + patch.nj; ++j) {
+      for (int i = patch.i0; i < patch.i0 + patch.ni; ++i) {
+        if (cellPatch_(j, i) >= 0) {
+          PORTABLE_ALWAYS_THROW_OR_ABORT("TablePatches: patches overlap");
+        }
+        cellPatch_(j, i) = p;
+      }
+    }
+  }
+  data_.resize(numFields_, numNodes_);
+}
+
+inline std::vector<int> TablePatches::FlagCells(const DataBox &coarse,
+                                                const DataBox &fine, const Real tol) {
+  const int n1 = coarse.range(1).nPoints();
+  const int n0 = coarse.range(0).nPoints();
+  std::vector<int> flags((n1 - 1) * (n0 - 1), 0);
+  // Relative errors are measured against a floor set by the scale of
+  // the data, so that zero crossings are not flagged everywhere.
+  Real scale = 0;
+  for (int j = 0; j < 2 * n1 - 1; ++j) {
+    for (int i = 0; i < 2 * n0 - 1; ++i) {
+      scale = std::max(scale, std::abs(fine(j, i)));
+    }
+  }
+  const Real floor = std::max(1e-8 * scale, std::numeric_limits<Real>::min());
+  for (int j = 0; j < n1 - 1; ++j) {
+    for (int i = 0; i < n0 - 1; ++i) {
+      // edge midpoints and the center of the cell
+      constexpr int nsamples = 5;
+      constexpr int dj[nsamples] = {0, 1, 1, 1, 2};
+      constexpr int di[nsamples] = {1, 0, 1, 2, 1};
+      for (int s = 0; s < nsamples; ++s) {
+        const Real w1 = 0.5 * dj[s];
+        const Real w0 = 0.5 * di[s];
+        const Real linear =
+            ((1 - w1) * ((1 - w0) * coarse(j, i) + w0 * coarse(j, i + 1)) +
+             w1 * ((1 - w0) * coarse(j + 1, i) + w0 * coarse(j + 1, i + 1)));
+        const Real exact = fine(2 * j + dj[s], 2 * i + di[s]);
+        if (std::abs(linear - exact) > tol * std::max(std::abs(exact), floor)) {
+          flags[j * (n0 - 1) + i] = 1;
+          break;
+        }
+      }
+    }
+  }
+  return flags;
+}
+
+inline std::vector<TablePatches::Patch>
+TablePatches::Cover(const std::vector<int> &flags, const int n1cells, const int n0cells,
+                    const int maxCells) {
+  // Greedy: grow a run of flagged cells along i from the first
+  // open flagged cell, then extend the run along j while the whole row
+  // is flagged and open.
+  std::vector<int> open(flags);
+  std::vector<Patch> patches;
+  auto isFree = [&](const int j, const int i) { return open[j * n0cells + i] != 0; };
+  for (int j = 0; j < n1cells; ++j) {
+    for (int i = 0; i < n0cells; ++i) {
+      if (!isFree(j, i)) continue;
+      Patch patch{j, i, 1, 1};
+      while (patch.ni < maxCells && i + patch.ni < n0cells && isFree(j, i + patch.ni)) {
+        patch.ni++;
+      }
+      while (patch.nj < maxCells && j + patch.nj < n1cells) {
+        bool rowFree = true;
+        for (int ii = i; ii < i + patch.ni; ++ii) {
+          rowFree = rowFree && isFree(j + patch.nj, ii);
+        }
+        if (!rowFree) break;
+        patch.nj++;
+      }
+      for (int jj = j; jj < j + patch.nj; ++jj) {
+        for (int ii = i; ii < i + patch.ni; ++ii) {
+          open[jj * n0cells + ii] = 0;
+        }
+      }
+      patches.push_back(patch);
+    }
+  }
+  return patches;
+}
+
+inline void TablePatches::SetPatchData(const int field, const int p,
+                                       const DataBox &fine) {
+  int n1, n0;
+  PatchShape(p, n1, n0);
+  const int offset = static_cast<int>(patches_(p, OFFSET));
+  for (int jj = 0; jj < n1; ++jj) {
+    for (int ii = 0; ii < n0; ++ii) {
+      data_(field, offset + jj * n0 + ii) = fine(jj, ii);
+    }
+  }
+}
+
+inline void TablePatches::Conform(const int field, const DataBox &base) {
+  const Real h1 = dx1_ / refine_;
+  const Real h0 = dx0_ / refine_;
+  // Base cells touching fine node g along one axis
+  auto cells = [&](const int g, const int ncells, int &lo, int &hi) {
+    lo = (g % refine_ == 0) ? g / refine_ - 1 : g / refine_;
+    hi = g / refine_;
+    lo = std::max(lo, 0);
+    hi = std::min(hi, ncells - 1);
+  };
+  for (int p = 0; p < numPatches_; ++p) {
+    const Patch patch = GetPatch(p);
+    int n1, n0;
+    PatchShape(p, n1, n0);
+    const int offset = static_cast<int>(patches_(p, OFFSET));
+    for (int jj = 0; jj < n1; ++jj) {
+      for (int ii = 0; ii < n0; ++ii) {
+        if (jj != 0 && jj != n1 - 1 && ii != 0 && ii != n0 - 1) continue;
+        const int g1 = patch.j0 * refine_ + jj;
+        const int g0 = patch.i0 * refine_ + ii;
+        int jlo, jhi, ilo, ihi;
+        cells(g1, n1cells_, jlo, jhi);
+        cells(g0, n0cells_, ilo, ihi);
+        bool coarse = false;
+        for (int j = jlo; j <= jhi; ++j) {
+          for (int i = ilo; i <= ihi; ++i) {
+            coarse = coarse || (cellPatch_(j, i) < 0);
+          }
+        }
+        if (coarse) {
+          data_(field, offset + jj * n0 + ii) =
+              base.interpToReal(x1min_ + g1 * h1, x0min_ + g0 * h0);
+        }
+      }
+    }
+  }
+}
+
+template <typename Function_t>
+inline void TablePatches::ForEachNode(Function_t &&f) const {
+  const Real h1 = dx1_ / refine_;
+  const Real h0 = dx0_ / refine_;
+  for (int p = 0; p < numPatches_; ++p) {
+    const Patch patch = GetPatch(p);
+    int n1, n0;
+    PatchShape(p, n1, n0);
+    const int offset = static_cast<int>(patches_(p, OFFSET));
+    for (int jj = 0; jj < n1; ++jj) {
+      for (int ii = 0; ii < n0; ++ii) {
+        f(offset + jj * n0 + ii, x1min_ + (patch.j0 * refine_ + jj) * h1,
+          x0min_ + (patch.i0 * refine_ + ii) * h0);
+      }
+    }
+  }
+}
+
+inline void TablePatches::Crop(const int *lo, const int *hi) {
+  if (numPatches_ == 0) return;
+  // New cells are [lo, hi) in old cell indices
+  std::vector<Patch> cropped;
+  std::vector<int> source;
+  for (int p = 0; p < numPatches_; ++p) {
+    const Patch patch = GetPatch(p);
+    const int j0 = std::max(patch.j0, lo[1]);
+    const int j1 = std::min(patch.j0 + patch.nj, hi[1]);
+    const int i0 = std::max(patch.i0, lo[0]);
+    const int i1 = std::min(patch.i0 + patch.ni, hi[0]);
+    if (j0 < j1 && i0 < i1) {
+      cropped.push_back({j0 - lo[1], i0 - lo[0], j1 - j0, i1 - i0});
+      source.push_back(p);
+    }
+  }
+
+  TablePatches out;
+  out.numFields_ = numFields_;
+  out.refine_ = refine_;
+  out.n1cells_ = hi[1] - lo[1];
+  out.n0cells_ = hi[0] - lo[0];
+  out.x1min_ = x1min_ + lo[1] * dx1_;
+  out.x0min_ = x0min_ + lo[0] * dx0_;
+  out.dx1_ = dx1_;
+  out.dx0_ = dx0_;
+  out.layout_(cropped);
+  for (int q = 0; q < out.numPatches_; ++q) {
+    const int p = source[q];
+    const Patch patch = GetPatch(p);
+    int n1, n0, m1, m0;
+    PatchShape(p, n1, n0);
+    out.PatchShape(q, m1, m0);
+    const int dj = (cropped[q].j0 + lo[1] - patch.j0) * refine_;
+    const int di = (cropped[q].i0 + lo[0] - patch.i0) * refine_;
+    const int offset = static_cast<int>(patches_(p, OFFSET));
+    const int outOffset = static_cast<int>(out.patches_(q, OFFSET));
+    for (int field = 0; field < numFields_; ++field) {
+      for (int jj = 0; jj < m1; ++jj) {
+        for (int ii = 0; ii < m0; ++ii) {
+          out.data_(field, outOffset + jj * m0 + ii) =
+              data_(field, offset + (jj + dj) * n0 + ii + di);
+        }
+      }
+    }
+  }
+  Finalize();
+  *this = out;
+}
+
+#ifdef SINGULARITY_USE_SPINER_WITH_HDF5
+inline herr_t TablePatches::saveHDF(hid_t loc,
+                                    const std::vector<std::string> &names) const {
+  herr_t status = H5_SUCCESS;
+  if (numPatches_ == 0) return status;
+  hid_t group =
+      H5Gcreate(loc, SP5::Patches::group, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  status += H5LTset_attribute_int(loc, SP5::Patches::group, SP5::Patches::refinement,
+                                  &refine_, 1);
+  status += cellPatch_.saveHDF(group, SP5::Patches::cellPatch);
+  status += patches_.saveHDF(group, SP5::Patches::bounds);
+  DataBox values(numNodes_);
+  for (int field = 0; field < numFields_; ++field) {
+    for (int k = 0; k < numNodes_; ++k) {
+      values(k) = data_(field, k);
+    }
+    status += values.saveHDF(group, names[field]);
+  }
+  values.finalize();
+  status += H5Gclose(group);
+  return status;
+}
+
+inline herr_t TablePatches::loadHDF(hid_t loc, const DataBox &base,
+                                    const std::vector<std::string> &names) {
+  herr_t status = H5_SUCCESS;
+  Finalize();
+  setGrid_(base);
+  numFields_ = names.size();
+  status += H5LTget_attribute_int(loc, SP5::Patches::group, SP5::Patches::refinement,
+                                  &refine_);
+  hid_t group = H5Gopen(loc, SP5::Patches::group, H5P_DEFAULT);
+  DataBox cellPatch, patches;
+  status += cellPatch.loadHDF(group, SP5::Patches::cellPatch);
+  status += patches.loadHDF(group, SP5::Patches::bounds);
+  if (cellPatch.dim(2) != n1cells_ || cellPatch.dim(1) != n0cells_) {
+    PORTABLE_ALWAYS_THROW_OR_ABORT("TablePatches: patches do not match the base table");
+  }
+  std::vector<Patch> layout(patches.dim(2));
+  for (std::size_t p = 0; p < layout.size(); ++p) {
+    layout[p] = {static_cast<int>(patches(p, J0)), static_cast<int>(patches(p, I0)),
+                 static_cast<int>(patches(p, NJ)), static_cast<int>(patches(p, NI))};
+  }
+  cellPatch.finalize();
+  patches.finalize();
+  layout_(layout);
+  DataBox values;
+  for (int field = 0; field < numFields_; ++field) {
+    status += values.loadHDF(group, names[field]);
+    for (int k = 0; k < numNodes_; ++k) {
+      data_(field, k) = values(k);
+    }
+    values.finalize();
+  }
+  status += H5Gclose(group);
+  return status;
+}
+#endif // SINGULARITY_USE_SPINER_WITH_HDF5
+
+inline TablePatches TablePatches::GetOnDevice() const {
+  TablePatches other = *this;
+  if (numPatches_ > 0) {
+    other.cellPatch_ = Spiner::getOnDeviceDataBox<Real>(cellPatch_);
+    other.patches_ = Spiner::getOnDeviceDataBox<Real>(patches_);
+    other.data_ = Spiner::getOnDeviceDataBox<Real>(data_);
+  }
+  return other;
+}
+
+inline void TablePatches::Finalize() {
+  if (numPatches_ > 0) {
+    cellPatch_.finalize();
+    patches_.finalize();
+    data_.finalize();
+  }
+  numPatches_ = 0;
+  numNodes_ = 0;
+}
+
+} // namespace singularity
+
+#endif // SINGULARITY_USE_SPINER
+#endif // SINGULARITY_EOS_BASE_TABLE_PATCHES_HPP_
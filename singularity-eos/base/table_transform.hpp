@@ -0,0 +1,201 @@
+//------------------------------------------------------------------------------
+// © 2021-2023. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#ifndef SINGULARITY_EOS_BASE_TABLE_TRANSFORM_HPP_
+#define SINGULARITY_EOS_BASE_TABLE_TRANSFORM_HPP_
+
+#include <ports-of-call/portability.hpp>
+
+#ifdef SINGULARITY_USE_SPINER
+#include <singularity-eos/base/fast-math/logs.hpp>
+#include <spiner/databox.hpp>
+#endif // SINGULARITY_USE_SPINER
+
+namespace singularity {
+
+// The map a stack of ScaledEOS, ShiftedEOS, and UnitSystem modifiers
+// applies between the caller and the EOS it wraps. Inputs are mapped
+// from the caller to the wrapped EOS as
+//   rho_in = rho * rho
+//   T_in   = temp * T
+//   e_in   = sie * e + sie_shift
+// and outputs are mapped back as
+//   P = press * P_in
+//   S = entropy * S_in
+// Every other quantity follows from these by the chain rule. A
+// tabulated EOS can absorb this map into its tables, which removes
+// the modifier from the lookup path entirely.
+struct TableTransform {
+  Real rho = 1;
+  Real temp = 1;
+  Real sie = 1;
+  Real sie_shift = 0;
+  Real press = 1;
+  Real entropy = 1;
+
+  // Composition. *this is applied first, i.e., closest to the
+  // caller, and inner second.
+  PORTABLE_INLINE_FUNCTION
+  TableTransform Then(const TableTransform &inner) const {
+    TableTransform out;
+    out.rho = inner.rho * rho;
+    out.temp = inner.temp * temp;
+    out.sie = inner.sie * sie;
+    out.sie_shift = inner.sie * sie_shift + inner.sie_shift;
+    out.press = press * inner.press;
+    out.entropy = entropy * inner.entropy;
+    return out;
+  }
+  PORTABLE_INLINE_FUNCTION
+  bool IsValid() const {
+    return (rho > 0) && (temp > 0) && (sie > 0) && (press > 0) && (entropy > 0);
+  }
+  PORTABLE_INLINE_FUNCTION
+  bool IsIdentity() const {
+    return (rho == 1) && (temp == 1) && (sie == 1) && (sie_shift == 0) &&
+           (press == 1) && (entropy == 1);
+  }
+
+  // Values stored in the wrapped EOS's units, mapped to caller units
+  PORTABLE_FORCEINLINE_FUNCTION Real RhoFromTable(const Real rho_t) const {
+    return rho_t / rho;
+  }
+  PORTABLE_FORCEINLINE_FUNCTION Real TFromTable(const Real T_t) const {
+    return T_t / temp;
+  }
+  PORTABLE_FORCEINLINE_FUNCTION Real SieFromTable(const Real sie_t) const {
+    return (sie_t - sie_shift) / sie;
+  }
+  PORTABLE_FORCEINLINE_FUNCTION Real PFromTable(const Real P_t) const {
+    return press * P_t;
+  }
+  PORTABLE_FORCEINLINE_FUNCTION Real SFromTable(const Real S_t) const {
+    return entropy * S_t;
+  }
+
+  // Factors that take derivatives from the wrapped EOS's units to
+  // caller units
+  PORTABLE_FORCEINLINE_FUNCTION Real dPdRho() const { return press * rho; }
+  PORTABLE_FORCEINLINE_FUNCTION Real dPdE() const { return press * sie; }
+  PORTABLE_FORCEINLINE_FUNCTION Real dTdRho() const { return rho / temp; }
+  PORTABLE_FORCEINLINE_FUNCTION Real dTdE() const { return sie / temp; }
+  PORTABLE_FORCEINLINE_FUNCTION Real dEdRho() const { return rho / sie; }
+  PORTABLE_FORCEINLINE_FUNCTION Real dEdT() const { return temp / sie; }
+  PORTABLE_FORCEINLINE_FUNCTION Real dVdT() const { return rho * temp; }
+
+  // Tables are gridded in log10(x + offset). These are the offsets
+  // that put the caller-unit grid on top of the table grid, i.e.,
+  // x_t + offset_t = scale * (x + offset).
+  PORTABLE_FORCEINLINE_FUNCTION Real RhoOffset(const Real offset_t) const {
+    return offset_t / rho;
+  }
+  PORTABLE_FORCEINLINE_FUNCTION Real TOffset(const Real offset_t) const {
+    return offset_t / temp;
+  }
+  PORTABLE_FORCEINLINE_FUNCTION Real SieOffset(const Real offset_t) const {
+    return (offset_t + sie_shift) / sie;
+  }
+
+  // Maps a tabulated EOS's reference state to caller units
+  PORTABLE_INLINE_FUNCTION
+  void ReferenceStateFromTable(Real &rho_n, Real &T_n, Real &sie_n, Real &P_n, Real &cv_n,
+                               Real &bmod_n, Real &dpde_n, Real &dvdt_n) const {
+    rho_n = RhoFromTable(rho_n);
+    T_n = TFromTable(T_n);
+    sie_n = SieFromTable(sie_n);
+    P_n = PFromTable(P_n);
+    cv_n *= dEdT();
+    bmod_n = PFromTable(bmod_n);
+    dpde_n *= dPdE();
+    dvdt_n *= dVdT();
+  }
+};
+
+#ifdef SINGULARITY_USE_SPINER
+namespace table_transform {
+
+// log10(scale * 10^lx), in whatever flavor of log the tables use
+PORTABLE_FORCEINLINE_FUNCTION Real ScaleLog(const Real lx, const Real scale) {
+  return FastMath::log10(scale * FastMath::pow10(lx));
+}
+
+struct Multiply {
+  Real factor;
+  PORTABLE_FORCEINLINE_FUNCTION Real operator()(const Real v) const {
+    return factor * v;
+  }
+};
+
+// Re-grids the databox db, which is gridded in log10(x + offset) on
+// every axis, so that axis i is in caller units when the caller and
+// the table are related by x_t = axis_scales[i] * x, and the offsets
+// have been rescaled consistently. Values are mapped through
+// f. Axes beyond the rank of db are ignored. Axes with unit scale
+// keep their grid and are not interpolated.
+//
+// With true log gridding, the new nodes land exactly on the images
+// of the old nodes and the result agrees with the old table to
+// round-off. The same holds with fast logs if every scale is a power
+// of two. Otherwise the fast-log grid is not shift-invariant and the
+// re-gridded table carries an additional interpolation error.
+template <typename F>
+inline void Retabulate(Spiner::DataBox<Real> &db, const Real *axis_scales, F &&f) {
+  using DataBox = Spiner::DataBox<Real>;
+  const int rank = db.rank();
+  DataBox out;
+  out.copyMetadata(db);
+  for (int i = 0; i < rank; ++i) {
+    if (axis_scales[i] != 1) {
+      const auto &g = db.range(i);
+      const Real inv = 1. / axis_scales[i];
+      out.setRange(i, ScaleLog(g.min(), inv), ScaleLog(g.max(), inv), g.nPoints());
+    }
+  }
+  // Coordinate of node n on axis i of the new table, on the old grid
+  auto x = [&](const int i, const int n) {
+    const Real lx = out.range(i).x(n);
+    return (axis_scales[i] != 1) ? ScaleLog(lx, axis_scales[i]) : lx;
+  };
+  if (rank == 1) {
+    for (int i = 0; i < out.dim(1); ++i) {
+      out(i) = f(db.interpToReal(x(0, i)));
+    }
+  } else if (rank == 2) {
+    for (int j = 0; j < out.dim(2); ++j) {
+      const Real x1 = x(1, j);
+      for (int i = 0; i < out.dim(1); ++i) {
+        out(j, i) = f(db.interpToReal(x1, x(0, i)));
+      }
+    }
+  } else {
+    for (int k = 0; k < out.dim(3); ++k) {
+      const Real x2 = x(2, k);
+      for (int j = 0; j < out.dim(2); ++j) {
+        const Real x1 = x(1, j);
+        for (int i = 0; i < out.dim(1); ++i) {
+          out(k, j, i) = f(db.interpToReal(x2, x1, x(0, i)));
+        }
+      }
+    }
+  }
+  db.finalize();
+  db = out;
+}
+
+} // namespace table_transform
+#endif // SINGULARITY_USE_SPINER
+
+} // namespace singularity
+
+#endif // SINGULARITY_EOS_BASE_TABLE_TRANSFORM_HPP_
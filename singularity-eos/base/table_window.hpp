@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#ifndef SINGULARITY_EOS_BASE_TABLE_WINDOW_HPP_
+#define SINGULARITY_EOS_BASE_TABLE_WINDOW_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <ports-of-call/portability.hpp>
+#include <ports-of-call/portable_errors.hpp>
+
+#ifdef SINGULARITY_USE_SPINER
+#include <spiner/databox.hpp>
+#endif // SINGULARITY_USE_SPINER
+
+namespace singularity {
+
+// The part of a tabulated EOS's domain a problem visits, in caller
+// units. A table cropped to a window keeps every node inside it plus
+// margin nodes on each side, so lookups inside the window see the
+// same node values as the full table.
+struct TableWindow {
+  Real rhoMin = 0;
+  Real rhoMax = std::numeric_limits<Real>::max();
+  Real TMin = 0;
+  Real TMax = std::numeric_limits<Real>::max();
+  int margin = 2;
+
+  bool IsValid() const { return (rhoMin <= rhoMax) && (TMin <= TMax) && (margin >= 0); }
+};
+
+#ifdef SINGULARITY_USE_SPINER
+namespace table_window {
+
+// Finds the nodes [lo, hi] of grid bracketing [xlo, xhi], widened by
+// margin nodes on each side. At least two nodes are kept.
+template <typename Grid_t>
+inline void NodeRange(const Grid_t &grid, Real xlo, Real xhi, const int margin, int &lo,
+                      int &hi) {
+  const int n = grid.nPoints();
+  const Real dx = (grid.max() - grid.min()) / (n - 1);
+  xlo = std::min(std::max(xlo, grid.min()), grid.max());
+  xhi = std::min(std::max(xhi, grid.min()), grid.max());
+  lo = static_cast<int>(std::floor((xlo - grid.min()) / dx)) - margin;
+  hi = static_cast<int>(std::ceil((xhi - grid.min()) / dx)) + margin;
+  lo = std::max(0, std::min(lo, n - 2));
+  hi = std::min(n - 1, std::max(hi, lo + 1));
+}
+
+// Replaces db with the nodes [lo[i], hi[i]] on each axis i. Axes
+// beyond the rank of db are ignored. Only rank 1 and 2 tables can be
+// cropped.
+inline void Crop(Spiner::DataBox<Real> &db, const int *lo, const int *hi) {
+  using DataBox = Spiner::DataBox<Real>;
+  const int rank = db.rank();
+  PORTABLE_ALWAYS_REQUIRE(rank >= 1 && rank <= 2, "Only 1D and 2D tables can be cropped");
+  int n[2] = {1, 1};
+  for (int i = 0; i < rank; ++i) {
+    n[i] = hi[i] - lo[i] + 1;
+  }
+  DataBox out = (rank == 1) ? DataBox(n[0]) : DataBox(n[1], n[0]);
+  for (int i = 0; i < rank; ++i) {
+    const auto &g = db.range(i);
+    out.setRange(i, g.x(lo[i]), g.x(hi[i]), n[i]);
+  }
+  if (rank == 1) {
+    for (int i = 0; i < n[0]; ++i) {
+      out(i) = db(i + lo[0]);
+    }
+  } else {
+    for (int j = 0; j < n[1]; ++j) {
+      for (int i = 0; i < n[0]; ++i) {
+        out(j, i) = db(j + lo[1], i + lo[0]);
+      }
+    }
+  }
+  db.finalize();
+  db = out;
+}
+
+} // namespace table_window
+#endif // SINGULARITY_USE_SPINER
+
+} // namespace singularity
+
+#endif // SINGULARITY_EOS_BASE_TABLE_WINDOW_HPP_
@@ -17,11 +17,15 @@
 
 #include <ports-of-call/portability.hpp>
 #include <ports-of-call/portable_errors.hpp>
+#include <singularity-eos/base/accuracy.hpp>
 #include <singularity-eos/base/fast-math/logs.hpp>
 #include <singularity-eos/base/robust_utils.hpp>
 #include <singularity-eos/eos/eos.hpp>
 
+#include <array>
 #include <cmath>
+#include <limits>
+#include <type_traits>
 
 #ifdef SINGULARITY_USE_KOKKOSKERNELS
 #include <KokkosBatched_ApplyQ_Decl.hpp>
@@ -37,6 +41,9 @@ namespace singularity {
 // Implementation details below
 // ======================================================================
 
+// The tolerances, iteration limits, and line search parameters here are the defaults
+// of AccuracyParams.  The solvers read them from the AccuracyParams passed to their
+// constructors.
 // TODO(JCD): some of these should be exposed to consumers to allow changes to defaults
 namespace mix_params {
 constexpr Real derivative_eps = 3.0e-6;
@@ -83,8 +90,121 @@ bool check_nans(Real const *const a, const int n, const bool verbose = false) {
   return retval;
 }
 
+// LU factorization with partial pivoting for systems whose size is
+// known at compile time. All trip counts are constant, so the loops
+// can be fully unrolled and the system held in local storage. A
+// singular system produces non-finite values, caught by check_nans.
+template <int N, typename T = Real>
+PORTABLE_FORCEINLINE_FUNCTION void lu_factor_small(T A[N][N], int piv[N]) {
+  for (int k = 0; k < N; ++k) {
+    int p = k;
+    for (int i = k + 1; i < N; ++i)
+      if (std::abs(A[i][k]) > std::abs(A[p][k])) p = i;
+    piv[k] = p;
+    if (p != k) {
+      for (int j = 0; j < N; ++j) {
+        const T tmp = A[k][j];
+        A[k][j] = A[p][j];
+        A[p][j] = tmp;
+      }
+    }
+    const T pivinv = T(1) / A[k][k];
+    for (int i = k + 1; i < N; ++i) {
+      A[i][k] *= pivinv;
+      for (int j = k + 1; j < N; ++j)
+        A[i][j] -= A[i][k] * A[k][j];
+    }
+  }
+}
+
+// Solves LU x = b. x holds b on input.
+template <int N, typename T = Real>
+PORTABLE_FORCEINLINE_FUNCTION void lu_solve_small(const T A[N][N], const int piv[N],
+                                                  T x[N]) {
+  for (int k = 0; k < N; ++k) {
+    const T tmp = x[k];
+    x[k] = x[piv[k]];
+    x[piv[k]] = tmp;
+  }
+  for (int i = 1; i < N; ++i)
+    for (int j = 0; j < i; ++j)
+      x[i] -= A[i][j] * x[j];
+  for (int i = N - 1; i >= 0; --i) {
+    for (int j = i + 1; j < N; ++j)
+      x[i] -= A[i][j] * x[j];
+    x[i] /= A[i][i];
+  }
+}
+
+// Solves a x = b for a row-major N x N matrix a, overwriting b with x.
+// The factorization and solve are done in the precision T. a is left
+// unchanged.
+template <int N, typename T = Real>
+PORTABLE_FORCEINLINE_FUNCTION void solve_Ax_b_small(const Real *a, Real *b) {
+  T LU[N][N], x[N];
+  int piv[N];
+  for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j)
+      LU[i][j] = static_cast<T>(a[i * N + j]);
+    x[i] = static_cast<T>(b[i]);
+  }
+  lu_factor_small<N, T>(LU, piv);
+  lu_solve_small<N, T>(LU, piv, x);
+  for (int i = 0; i < N; ++i)
+    b[i] = static_cast<Real>(x[i]);
+}
+
+// True if every nonzero entry of a is a normal single precision number,
+// so that casting the system to float neither overflows nor flushes
+// entries to zero
+PORTABLE_FORCEINLINE_FUNCTION
+bool fits_in_float(Real const *const a, const int n) {
+  for (int i = 0; i < n; ++i) {
+    const Real x = std::abs(a[i]);
+    if (x != 0 && !(x >= std::numeric_limits<float>::min() &&
+                    x <= std::numeric_limits<float>::max())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <int N>
+PORTABLE_FORCEINLINE_FUNCTION void solve_Ax_b_small(const Real *a, Real *b,
+                                                    const bool single) {
+  if (single && fits_in_float(a, N * N) && fits_in_float(b, N)) {
+    solve_Ax_b_small<N, float>(a, b);
+  } else {
+    solve_Ax_b_small<N>(a, b);
+  }
+}
+
+// If single is true, systems of up to five unknowns whose entries fit in
+// float are factored and solved in single precision. Other systems are
+// solved in Real.
 PORTABLE_INLINE_FUNCTION
-bool solve_Ax_b_wscr(const int n, Real *a, Real *b, Real *scr) {
+bool solve_Ax_b_wscr(const int n, Real *a, Real *b, Real *scr,
+                     const bool single = false) {
+  // Systems from cells with up to four materials are solved directly.
+  switch (n) {
+  case 1:
+    b[0] /= a[0];
+    return check_nans(b, n);
+  case 2:
+    solve_Ax_b_small<2>(a, b, single);
+    return check_nans(b, n);
+  case 3:
+    solve_Ax_b_small<3>(a, b, single);
+    return check_nans(b, n);
+  case 4:
+    solve_Ax_b_small<4>(a, b, single);
+    return check_nans(b, n);
+  case 5:
+    solve_Ax_b_small<5>(a, b, single);
+    return check_nans(b, n);
+  default:
+    break;
+  }
 #ifdef SINGULARITY_USE_KOKKOSKERNELS
 #ifndef PORTABILITY_STRATEGY_KOKKOS
 #error "Kokkos Kernels requires Kokkos."
@@ -158,12 +278,47 @@ class CacheAccessor {
   Real *cache_;
 };
 
-template <typename EOSIndexer, typename RealIndexer>
+// Number of materials or equations of a solver specialized on the
+// material count. Converts to the compile-time value, so loops over it
+// have constant trip counts.
+template <int N>
+struct FixedExtent {
+  PORTABLE_FORCEINLINE_FUNCTION
+  FixedExtent(const int n) {
+    PORTABLE_REQUIRE(n == N, "Material count does not match the solver specialization");
+  }
+  PORTABLE_FORCEINLINE_FUNCTION
+  constexpr operator int() const { return N; }
+};
+
+// N = 0 means the size is only known at run time.
+template <int N>
+using Extent_t = typename std::conditional<(N > 0), FixedExtent<N>, int>::type;
+
+// Solver state of N elements. Fixed-size state lives in the solver
+// itself, where it can be kept in registers; run-time sized state
+// points into the scratch passed to the solver.
+template <int N>
+using SolverArray_t =
+    typename std::conditional<(N > 0), std::array<Real, N>, Real *>::type;
+
+PORTABLE_FORCEINLINE_FUNCTION
+Real *ArrayData(Real *a) { return a; }
+template <std::size_t N>
+PORTABLE_FORCEINLINE_FUNCTION Real *ArrayData(std::array<Real, N> &a) {
+  return a.data();
+}
+
+template <typename EOSIndexer, typename RealIndexer, int NMAT = 0, int NEQ = 0>
 class PTESolverBase {
  public:
   PTESolverBase() = delete;
   PORTABLE_INLINE_FUNCTION int Nmat() const { return nmat; }
   PORTABLE_INLINE_FUNCTION int &Niter() { return niter; }
+  // residual evaluations by line search backtracking, beyond the one
+  // full step tried per iteration
+  PORTABLE_INLINE_FUNCTION int &Nbacktrack() { return nbacktrack; }
+  PORTABLE_INLINE_FUNCTION const AccuracyParams &Accuracy() const { return accuracy; }
   // Fixup is meant to be a hook for derived classes to provide arbitrary manipulations
   // after each iteration of the Newton solver.  This version just renormalizes the
   // volume fractions, which is useful to deal with roundoff error.
@@ -187,12 +342,24 @@ class PTESolverBase {
       press[m] *= uscale;
     }
   }
-  // Solve the linear system for the update dx
+  // Solve the linear system for the update dx, in single precision if
+  // single is true. A single precision solve that fails, for instance
+  // because the Jacobian is singular to float precision, is repeated in
+  // double precision.
   PORTABLE_INLINE_FUNCTION
-  bool Solve() const {
+  bool Solve(const bool single = false) const {
     for (int m = 0; m < neq; m++)
       dx[m] = residual[m];
-    return solve_Ax_b_wscr(neq, jacobian, dx, sol_scratch);
+    if (single) {
+      if (solve_Ax_b_wscr(neq, ArrayData(jacobian), ArrayData(dx),
+                          ArrayData(sol_scratch), true)) {
+        return true;
+      }
+      for (int m = 0; m < neq; m++)
+        dx[m] = residual[m];
+    }
+    return solve_Ax_b_wscr(neq, ArrayData(jacobian), ArrayData(dx),
+                           ArrayData(sol_scratch));
   }
 
  protected:
@@ -200,16 +367,17 @@ class PTESolverBase {
   PTESolverBase(int nmats, int neqs, const EOSIndexer &eos_, const Real vfrac_tot,
                 const Real sie_tot, const RealIndexer &rho_, const RealIndexer &vfrac_,
                 const RealIndexer &sie_, const RealIndexer &temp_,
-                const RealIndexer &press_, Real *&scratch, Real Tguess)
-      : nmat(nmats), neq(neqs), niter(0), eos(eos_), vfrac_total(vfrac_tot),
-        sie_total(sie_tot), rho(rho_), vfrac(vfrac_), sie(sie_), temp(temp_),
-        press(press_), Tnorm(Tguess) {
-    jacobian = AssignIncrement(scratch, neq * neq);
-    dx = AssignIncrement(scratch, neq);
-    sol_scratch = AssignIncrement(scratch, 2 * neq);
-    residual = AssignIncrement(scratch, neq);
-    u = AssignIncrement(scratch, nmat);
-    rhobar = AssignIncrement(scratch, nmat);
+                const RealIndexer &press_, Real *&scratch, Real Tguess,
+                const AccuracyParams &params)
+      : nmat(nmats), neq(neqs), niter(0), nbacktrack(0), eos(eos_),
+        vfrac_total(vfrac_tot), sie_total(sie_tot), rho(rho_), vfrac(vfrac_), sie(sie_),
+        temp(temp_), press(press_), Tnorm(Tguess), accuracy(params) {
+    AssignIncrement(jacobian, scratch, neq * neq);
+    AssignIncrement(dx, scratch, neq);
+    AssignIncrement(sol_scratch, scratch, 2 * neq);
+    AssignIncrement(residual, scratch, neq);
+    AssignIncrement(u, scratch, nmat);
+    AssignIncrement(rhobar, scratch, nmat);
     Cache = CacheAccessor(AssignIncrement(scratch, nmat * MAX_NUM_LAMBDAS));
   }
 
@@ -299,6 +467,36 @@ class PTESolverBase {
     }
     return P;
   }
+  // Same as above at a temperature located with GetTemperatureIndex
+  template <typename EOS_t>
+  PORTABLE_FORCEINLINE_FUNCTION static Real
+  GetPressureFromPreferred(const EOS_t &eos, const Real rho, const TemperatureIndex &tidx,
+                           Real sie, Real *lambda, const bool do_e_lookup) {
+    Real P{};
+    if (eos.PreferredInput() ==
+        (thermalqs::density | thermalqs::specific_internal_energy)) {
+      if (do_e_lookup) {
+        sie = eos.InternalEnergyFromDensityTemperatureIndex(rho, tidx, lambda);
+      }
+      P = eos.PressureFromDensityInternalEnergy(rho, sie, lambda);
+    } else if (eos.PreferredInput() == (thermalqs::density | thermalqs::temperature)) {
+      P = eos.PressureFromDensityTemperatureIndex(rho, tidx, lambda);
+    }
+    return P;
+  }
+
+  // Location of the common temperature T on the temperature grid of
+  // the first tabulated material. Every material whose table shares
+  // that grid reuses it in the *Index lookups, and the others fall
+  // back to regular lookups at T.
+  PORTABLE_INLINE_FUNCTION
+  TemperatureIndex GetTemperatureIndex(const Real T) const {
+    TemperatureIndex tidx = eos[0].GetTemperatureIndex(T);
+    for (int m = 1; m < nmat && tidx.nT == 0; ++m) {
+      tidx = eos[m].GetTemperatureIndex(T);
+    }
+    return tidx;
+  }
 
   // Initialize the volume fractions, avg densities, temperatures, energies, and
   // pressures of the materials.  Compute the total density and internal energy.
@@ -370,11 +568,14 @@ class PTESolverBase {
     GetIdealPTE(Pideal, Tideal);
 
     // temporarily hijack some of the scratch space
-    Real *etemp = jacobian;
-    Real *ptemp = jacobian + nmat;
-    Real *vtemp = jacobian + 2 * nmat;
-    Real *rtemp = jacobian + 3 * nmat;
-    Real *res = jacobian + 4 * nmat;
+    SolverArray_t<NMAT> etemp, ptemp, vtemp, rtemp;
+    SolverArray_t<NEQ> res;
+    Real *tmp_scratch = ArrayData(jacobian);
+    AssignIncrement(etemp, tmp_scratch, nmat);
+    AssignIncrement(ptemp, tmp_scratch, nmat);
+    AssignIncrement(vtemp, tmp_scratch, nmat);
+    AssignIncrement(rtemp, tmp_scratch, nmat);
+    AssignIncrement(res, tmp_scratch, neq);
     // copy out the initial guess
     for (int m = 0; m < nmat; ++m) {
       etemp[m] = u[m];
@@ -442,9 +643,22 @@ class PTESolverBase {
     scratch += size;
     return p;
   }
+  // Points a run-time sized array into the scratch
+  PORTABLE_INLINE_FUNCTION
+  void AssignIncrement(Real *&a, Real *&scratch, const int size) const {
+    a = AssignIncrement(scratch, size);
+  }
+  // Fixed-size arrays still take their share of the scratch, so the
+  // layout of the scratch does not depend on the specialization
+  template <std::size_t N>
+  PORTABLE_INLINE_FUNCTION void AssignIncrement(std::array<Real, N> &a, Real *&scratch,
+                                                const int size) const {
+    scratch += size;
+  }
 
-  const int nmat, neq;
-  int niter;
+  const Extent_t<NMAT> nmat;
+  const Extent_t<NEQ> neq;
+  int niter, nbacktrack;
   const Real vfrac_total, sie_total;
   const EOSIndexer &eos;
   const RealIndexer &rho;
@@ -452,9 +666,13 @@ class PTESolverBase {
   const RealIndexer &sie;
   const RealIndexer &temp;
   const RealIndexer &press;
-  Real *jacobian, *dx, *sol_scratch, *residual, *u, *rhobar;
+  mutable SolverArray_t<NEQ * NEQ> jacobian;
+  mutable SolverArray_t<NEQ> dx, residual;
+  mutable SolverArray_t<2 * NEQ> sol_scratch;
+  mutable SolverArray_t<NMAT> u, rhobar;
   CacheAccessor Cache;
   Real rho_total, uscale, Tnorm;
+  const AccuracyParams accuracy;
 };
 
 } // namespace mix_impl
@@ -524,32 +742,36 @@ inline size_t PTESolverRhoTRequiredScratchInBytes(const int nmat) {
   return PTESolverRhoTRequiredScratch(nmat) * sizeof(Real);
 }
 
-template <typename EOSIndexer, typename RealIndexer, typename LambdaIndexer>
-class PTESolverRhoT : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer> {
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::InitBase;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::AssignIncrement;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::nmat;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::neq;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::ResidualNorm;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::vfrac_total;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::sie_total;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::eos;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::rho;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::vfrac;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::sie;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::temp;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::press;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::rho_total;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::uscale;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::MatIndex;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::TryIdealPTE;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::jacobian;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::residual;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::dx;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::u;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::rhobar;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::Cache;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::Tnorm;
+template <typename EOSIndexer, typename RealIndexer, typename LambdaIndexer, int NMAT = 0>
+class PTESolverRhoT : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer, NMAT,
+                                                     (NMAT > 0 ? NMAT + 1 : 0)> {
+  using Base_t =
+      mix_impl::PTESolverBase<EOSIndexer, RealIndexer, NMAT, (NMAT > 0 ? NMAT + 1 : 0)>;
+  using Base_t::InitBase;
+  using Base_t::AssignIncrement;
+  using Base_t::nmat;
+  using Base_t::neq;
+  using Base_t::ResidualNorm;
+  using Base_t::vfrac_total;
+  using Base_t::sie_total;
+  using Base_t::eos;
+  using Base_t::rho;
+  using Base_t::vfrac;
+  using Base_t::sie;
+  using Base_t::temp;
+  using Base_t::press;
+  using Base_t::rho_total;
+  using Base_t::uscale;
+  using Base_t::MatIndex;
+  using Base_t::TryIdealPTE;
+  using Base_t::jacobian;
+  using Base_t::residual;
+  using Base_t::dx;
+  using Base_t::u;
+  using Base_t::rhobar;
+  using Base_t::Cache;
+  using Base_t::Tnorm;
+  using Base_t::accuracy;
 
  public:
   // template the ctor to get type deduction/universal references prior to c++17
@@ -557,14 +779,14 @@ class PTESolverRhoT : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer> {
   PORTABLE_INLINE_FUNCTION
   PTESolverRhoT(const int nmat, EOS_t &&eos, const Real vfrac_tot, const Real sie_tot,
                 Real_t &&rho, Real_t &&vfrac, Real_t &&sie, Real_t &&temp, Real_t &&press,
-                Lambda_t &&lambda, Real *scratch, const Real Tguess = 0.0)
-      : mix_impl::PTESolverBase<EOSIndexer, RealIndexer>(nmat, nmat + 1, eos, vfrac_tot,
-                                                         sie_tot, rho, vfrac, sie, temp,
-                                                         press, scratch, Tguess) {
-    dpdv = AssignIncrement(scratch, nmat);
-    dedv = AssignIncrement(scratch, nmat);
-    dpdT = AssignIncrement(scratch, nmat);
-    vtemp = AssignIncrement(scratch, nmat);
+                Lambda_t &&lambda, Real *scratch, const Real Tguess = 0.0,
+                const AccuracyParams &params = AccuracyParams())
+      : Base_t(nmat, nmat + 1, eos, vfrac_tot, sie_tot, rho, vfrac, sie, temp, press,
+               scratch, Tguess, params) {
+    AssignIncrement(dpdv, scratch, nmat);
+    AssignIncrement(dedv, scratch, nmat);
+    AssignIncrement(dpdT, scratch, nmat);
+    AssignIncrement(vtemp, scratch, nmat);
     // TODO(JCD): use whatever lambdas are passed in
     /*for (int m = 0; m < nmat; m++) {
       if (!variadic_utils::is_nullptr(lambda[m])) Cache[m] = lambda[m];
@@ -601,7 +823,6 @@ class PTESolverRhoT : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer> {
 
   PORTABLE_INLINE_FUNCTION
   bool CheckPTE() const {
-    using namespace mix_params;
     Real mean_p = vfrac[0] * press[0];
     Real error_p = 0.0;
     for (int m = 1; m < nmat; ++m) {
@@ -611,9 +832,10 @@ class PTESolverRhoT : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer> {
     error_p = std::sqrt(error_p);
     Real error_u = std::abs(residual[1]);
     // Check for convergence
-    bool converged_p = (error_p < pte_rel_tolerance_p * std::abs(mean_p) ||
-                        error_p < pte_abs_tolerance_p);
-    bool converged_u = (error_u < pte_rel_tolerance_e || error_u < pte_abs_tolerance_e);
+    bool converged_p = (error_p < accuracy.pte_rel_tolerance_p * std::abs(mean_p) ||
+                        error_p < accuracy.pte_abs_tolerance_p);
+    bool converged_u = (error_u < accuracy.pte_rel_tolerance_e ||
+                        error_u < accuracy.pte_abs_tolerance_e);
     return converged_p && converged_u;
   }
 
@@ -621,6 +843,9 @@ class PTESolverRhoT : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer> {
   void Jacobian() const {
     using namespace mix_params;
     Real dedT_sum = 0.0;
+    const Real dT = Tequil * derivative_eps;
+    const TemperatureIndex tidx = this->GetTemperatureIndex(Tnorm * Tequil);
+    const TemperatureIndex tidx_pert = this->GetTemperatureIndex(Tnorm * (Tequil + dT));
     for (int m = 0; m < nmat; m++) {
       //////////////////////////////
       // perturb volume fractions
@@ -631,22 +856,19 @@ class PTESolverRhoT : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer> {
 
       Real p_pert{};
       Real e_pert =
-          eos[m].InternalEnergyFromDensityTemperature(rho_pert, Tnorm * Tequil, Cache[m]);
-      p_pert =
-          robust::ratio(this->GetPressureFromPreferred(eos[m], rho_pert, Tnorm * Tequil,
-                                                       e_pert, Cache[m], false),
-                        uscale);
+          eos[m].InternalEnergyFromDensityTemperatureIndex(rho_pert, tidx, Cache[m]);
+      p_pert = robust::ratio(this->GetPressureFromPreferred(eos[m], rho_pert, tidx,
+                                                            e_pert, Cache[m], false),
+                             uscale);
       dpdv[m] = robust::ratio((p_pert - press[m]), dv);
       dedv[m] = robust::ratio(rhobar[m] * robust::ratio(e_pert, uscale) - u[m], dv);
       //////////////////////////////
       // perturb temperature
       //////////////////////////////
-      Real dT = Tequil * derivative_eps;
-      e_pert = eos[m].InternalEnergyFromDensityTemperature(rho[m], Tnorm * (Tequil + dT),
-                                                           Cache[m]);
-      p_pert = robust::ratio(this->GetPressureFromPreferred(eos[m], rho[m],
-                                                            Tnorm * (Tequil + dT), e_pert,
-                                                            Cache[m], false),
+      e_pert = eos[m].InternalEnergyFromDensityTemperatureIndex(rho[m], tidx_pert,
+                                                                Cache[m]);
+      p_pert = robust::ratio(this->GetPressureFromPreferred(eos[m], rho[m], tidx_pert,
+                                                            e_pert, Cache[m], false),
                              uscale);
       dpdT[m] = robust::ratio((p_pert - press[m]), dT);
       dedT_sum += robust::ratio(rhobar[m] * robust::ratio(e_pert, uscale) - u[m], dT);
@@ -708,25 +930,25 @@ class PTESolverRhoT : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer> {
         vtemp[m] = vfrac[m];
     }
     Tequil = Ttemp + scale * dx[nmat];
+    const TemperatureIndex tidx = this->GetTemperatureIndex(Tnorm * Tequil);
     for (int m = 0; m < nmat; ++m) {
       vfrac[m] = vtemp[m] + scale * dx[m];
       rho[m] = robust::ratio(rhobar[m], vfrac[m]);
-      u[m] = rhobar[m] * eos[m].InternalEnergyFromDensityTemperature(
-                             rho[m], Tnorm * Tequil, Cache[m]);
+      u[m] = rhobar[m] *
+             eos[m].InternalEnergyFromDensityTemperatureIndex(rho[m], tidx, Cache[m]);
       sie[m] = robust::ratio(u[m], rhobar[m]);
       u[m] = robust::ratio(u[m], uscale);
       temp[m] = Tequil;
-      press[m] =
-          robust::ratio(this->GetPressureFromPreferred(eos[m], rho[m], Tnorm * Tequil,
-                                                       sie[m], Cache[m], false),
-                        uscale);
+      press[m] = robust::ratio(this->GetPressureFromPreferred(eos[m], rho[m], tidx,
+                                                              sie[m], Cache[m], false),
+                               uscale);
     }
     Residual();
     return ResidualNorm();
   }
 
  private:
-  Real *dpdv, *dedv, *dpdT, *vtemp;
+  mutable mix_impl::SolverArray_t<NMAT> dpdv, dedv, dpdT, vtemp;
   Real Tequil, Ttemp;
 };
 
@@ -743,29 +965,32 @@ inline size_t PTESolverFixedTRequiredScratchInBytes(const int nmat) {
   return PTESolverFixedTRequiredScratch(nmat) * sizeof(Real);
 }
 
-template <typename EOSIndexer, typename RealIndexer, typename LambdaIndexer>
-class PTESolverFixedT : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer> {
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::AssignIncrement;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::nmat;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::neq;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::ResidualNorm;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::vfrac_total;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::eos;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::rho;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::vfrac;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::sie;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::temp;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::press;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::rho_total;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::uscale;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::MatIndex;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::jacobian;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::residual;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::dx;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::u;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::rhobar;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::Cache;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::Tnorm;
+template <typename EOSIndexer, typename RealIndexer, typename LambdaIndexer, int NMAT = 0>
+class PTESolverFixedT : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer, NMAT,
+                                                       NMAT> {
+  using Base_t = mix_impl::PTESolverBase<EOSIndexer, RealIndexer, NMAT, NMAT>;
+  using Base_t::AssignIncrement;
+  using Base_t::nmat;
+  using Base_t::neq;
+  using Base_t::ResidualNorm;
+  using Base_t::vfrac_total;
+  using Base_t::eos;
+  using Base_t::rho;
+  using Base_t::vfrac;
+  using Base_t::sie;
+  using Base_t::temp;
+  using Base_t::press;
+  using Base_t::rho_total;
+  using Base_t::uscale;
+  using Base_t::MatIndex;
+  using Base_t::jacobian;
+  using Base_t::residual;
+  using Base_t::dx;
+  using Base_t::u;
+  using Base_t::rhobar;
+  using Base_t::Cache;
+  using Base_t::Tnorm;
+  using Base_t::accuracy;
 
  public:
   // template the ctor to get type deduction/universal references prior to c++17
@@ -774,12 +999,12 @@ class PTESolverFixedT : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer>
   PORTABLE_INLINE_FUNCTION
   PTESolverFixedT(const int nmat, EOS_t &&eos, const Real vfrac_tot, const Real T_true,
                   Real_t &&rho, Real_t &&vfrac, Real_t &&sie, CReal_t &&temp,
-                  Real_t &&press, Lambda_t &&lambda, Real *scratch)
-      : mix_impl::PTESolverBase<EOSIndexer, RealIndexer>(nmat, nmat, eos, vfrac_tot, 1.0,
-                                                         rho, vfrac, sie, temp, press,
-                                                         scratch, T_true) {
-    dpdv = AssignIncrement(scratch, nmat);
-    vtemp = AssignIncrement(scratch, nmat);
+                  Real_t &&press, Lambda_t &&lambda, Real *scratch,
+                  const AccuracyParams &params = AccuracyParams())
+      : Base_t(nmat, nmat, eos, vfrac_tot, 1.0, rho, vfrac, sie, temp, press, scratch,
+               T_true, params) {
+    AssignIncrement(dpdv, scratch, nmat);
+    AssignIncrement(vtemp, scratch, nmat);
     Tequil = T_true;
     Ttemp = T_true;
     Tnorm = 1.0;
@@ -798,16 +1023,18 @@ class PTESolverFixedT : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer>
     Tnorm = 1.0;
     this->InitRhoBarandRho();
     this->SetVfracFromT(Tequil);
+    // the temperature is fixed, so it is located on the tables once
+    Tindex = this->GetTemperatureIndex(Tequil);
     uscale = 0.0;
     for (int m = 0; m < nmat; m++) {
       // volume fractions have been potentially reset to ensure densitites are
       // larger than rho(Pmin(Tequil)); set the physical density to reflect
       // this change in volume fraction
       rho[m] = robust::ratio(rhobar[m], vfrac[m]);
-      sie[m] = eos[m].InternalEnergyFromDensityTemperature(rho[m], Tequil, Cache[m]);
+      sie[m] = eos[m].InternalEnergyFromDensityTemperatureIndex(rho[m], Tindex, Cache[m]);
       uscale += sie[m] * rho[m];
       // note the scaling of pressure
-      press[m] = eos[m].PressureFromDensityTemperature(rho[m], Tequil, Cache[m]);
+      press[m] = eos[m].PressureFromDensityTemperatureIndex(rho[m], Tindex, Cache[m]);
     }
     for (int m = 0; m < nmat; ++m) {
       press[m] = robust::ratio(press[m], uscale);
@@ -832,19 +1059,19 @@ class PTESolverFixedT : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer>
 
   PORTABLE_INLINE_FUNCTION
   bool CheckPTE() const {
-    using namespace mix_params;
     Real mean_p = vfrac[0] * press[0];
     Real error_p = 0;
     for (int m = 1; m < nmat; ++m) {
       mean_p += vfrac[m] * press[m];
-      error_p += residual[m + 1] * residual[m + 1];
+      error_p += residual[m] * residual[m];
     }
     error_p = std::sqrt(error_p);
     Real error_v = std::abs(residual[0]);
     // Check for convergence
-    bool converged_p = (error_p < pte_rel_tolerance_p * std::abs(mean_p) ||
-                        error_p < pte_abs_tolerance_p);
-    bool converged_v = (error_v < pte_rel_tolerance_e || error_v < pte_abs_tolerance_e);
+    bool converged_p = (error_p < accuracy.pte_rel_tolerance_p * std::abs(mean_p) ||
+                        error_p < accuracy.pte_abs_tolerance_p);
+    bool converged_v = (error_v < accuracy.pte_rel_tolerance_e ||
+                        error_v < accuracy.pte_abs_tolerance_e);
     return converged_p && converged_v;
   }
 
@@ -860,7 +1087,7 @@ class PTESolverFixedT : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer>
       const Real rho_pert = robust::ratio(rhobar[m], vf_pert);
 
       Real p_pert = robust::ratio(
-          eos[m].PressureFromDensityTemperature(rho_pert, Tequil, Cache[m]), uscale);
+          eos[m].PressureFromDensityTemperatureIndex(rho_pert, Tindex, Cache[m]), uscale);
       dpdv[m] = robust::ratio((p_pert - press[m]), dv);
     }
 
@@ -912,19 +1139,213 @@ class PTESolverFixedT : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer>
       vfrac[m] = vtemp[m] + scale * dx[m];
       rho[m] = robust::ratio(rhobar[m], vfrac[m]);
       u[m] = rhobar[m] *
-             eos[m].InternalEnergyFromDensityTemperature(rho[m], Tequil, Cache[m]);
+             eos[m].InternalEnergyFromDensityTemperatureIndex(rho[m], Tindex, Cache[m]);
       sie[m] = robust::ratio(u[m], rhobar[m]);
       u[m] = robust::ratio(u[m], uscale);
       press[m] = robust::ratio(
-          eos[m].PressureFromDensityTemperature(rho[m], Tequil, Cache[m]), uscale);
+          eos[m].PressureFromDensityTemperatureIndex(rho[m], Tindex, Cache[m]), uscale);
     }
     Residual();
     return ResidualNorm();
   }
 
  private:
-  Real *dpdv, *vtemp;
+  mutable mix_impl::SolverArray_t<NMAT> dpdv, vtemp;
   Real Tequil, Ttemp;
+  TemperatureIndex Tindex;
+};
+
+// pressure equilibrium only solver. Each material keeps its own
+// specific internal energy.
+inline int PTESolverFixedSieRequiredScratch(const int nmat) {
+  int neq = nmat;
+  return neq * neq                 // jacobian
+         + 4 * neq                 // dx, residual, and sol_scratch
+         + 2 * nmat                // rhobar and u in base
+         + 2 * nmat                // nmat sized arrays in fixed sie solver
+         + MAX_NUM_LAMBDAS * nmat; // the cache
+}
+inline size_t PTESolverFixedSieRequiredScratchInBytes(const int nmat) {
+  return PTESolverFixedSieRequiredScratch(nmat) * sizeof(Real);
+}
+
+template <typename EOSIndexer, typename RealIndexer, typename LambdaIndexer, int NMAT = 0>
+class PTESolverFixedSie : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer, NMAT,
+                                                         NMAT> {
+  using Base_t = mix_impl::PTESolverBase<EOSIndexer, RealIndexer, NMAT, NMAT>;
+  using Base_t::AssignIncrement;
+  using Base_t::nmat;
+  using Base_t::neq;
+  using Base_t::ResidualNorm;
+  using Base_t::vfrac_total;
+  using Base_t::eos;
+  using Base_t::rho;
+  using Base_t::vfrac;
+  using Base_t::sie;
+  using Base_t::temp;
+  using Base_t::press;
+  using Base_t::rho_total;
+  using Base_t::uscale;
+  using Base_t::MatIndex;
+  using Base_t::jacobian;
+  using Base_t::residual;
+  using Base_t::dx;
+  using Base_t::u;
+  using Base_t::rhobar;
+  using Base_t::Cache;
+  using Base_t::Tnorm;
+  using Base_t::accuracy;
+
+ public:
+  // template the ctor to get type deduction/universal references prior to c++17
+  template <typename EOS_t, typename Real_t, typename Lambda_t>
+  PORTABLE_INLINE_FUNCTION
+  PTESolverFixedSie(const int nmat, EOS_t &&eos, const Real vfrac_tot, Real_t &&rho,
+                    Real_t &&vfrac, Real_t &&sie, Real_t &&temp, Real_t &&press,
+                    Lambda_t &&lambda, Real *scratch,
+                    const AccuracyParams &params = AccuracyParams())
+      : Base_t(nmat, nmat, eos, vfrac_tot, 1.0, rho, vfrac, sie, temp, press, scratch,
+               1.0, params) {
+    AssignIncrement(dpdv, scratch, nmat);
+    AssignIncrement(vtemp, scratch, nmat);
+    Tnorm = 1.0;
+  }
+
+  PORTABLE_INLINE_FUNCTION
+  Real Init() {
+    // rhobar is a fixed quantity: the average density of
+    // material m averaged over the full PTE volume
+    Tnorm = 1.0;
+    this->InitRhoBarandRho();
+    uscale = 0.0;
+    for (int m = 0; m < nmat; m++) {
+      uscale += rhobar[m] * std::abs(sie[m]);
+    }
+    if (!(uscale > 0.0)) uscale = 1.0;
+    for (int m = 0; m < nmat; m++) {
+      // the temperature is only used to limit steps toward rho(Pmin)
+      temp[m] = eos[m].TemperatureFromDensityInternalEnergy(rho[m], sie[m], Cache[m]);
+      // note the scaling of pressure
+      press[m] = robust::ratio(
+          eos[m].PressureFromDensityInternalEnergy(rho[m], sie[m], Cache[m]), uscale);
+      u[m] = sie[m] * robust::ratio(rhobar[m], uscale);
+    }
+    Residual();
+    return ResidualNorm();
+  }
+
+  PORTABLE_INLINE_FUNCTION
+  void Residual() const {
+    Real vsum = 0.0;
+    for (int m = 0; m < nmat; ++m) {
+      vsum += vfrac[m];
+    }
+    residual[0] = vfrac_total - vsum;
+    for (int m = 0; m < nmat - 1; ++m) {
+      residual[1 + m] = press[m] - press[m + 1];
+    }
+  }
+
+  PORTABLE_INLINE_FUNCTION
+  bool CheckPTE() const {
+    Real mean_p = vfrac[0] * press[0];
+    Real error_p = 0;
+    for (int m = 1; m < nmat; ++m) {
+      mean_p += vfrac[m] * press[m];
+      error_p += residual[m] * residual[m];
+    }
+    error_p = std::sqrt(error_p);
+    Real error_v = std::abs(residual[0]);
+    // Check for convergence
+    bool converged_p = (error_p < accuracy.pte_rel_tolerance_p * std::abs(mean_p) ||
+                        error_p < accuracy.pte_abs_tolerance_p);
+    bool converged_v = (error_v < accuracy.pte_rel_tolerance_e ||
+                        error_v < accuracy.pte_abs_tolerance_e);
+    return converged_p && converged_v;
+  }
+
+  PORTABLE_INLINE_FUNCTION
+  void Jacobian() const {
+    using namespace mix_params;
+    for (int m = 0; m < nmat; m++) {
+      //////////////////////////////
+      // perturb volume fractions
+      //////////////////////////////
+      Real dv = (vfrac[m] < 0.5 ? 1.0 : -1.0) * vfrac[m] * derivative_eps;
+      const Real vf_pert = vfrac[m] + dv;
+      const Real rho_pert = robust::ratio(rhobar[m], vf_pert);
+
+      Real p_pert = robust::ratio(
+          eos[m].PressureFromDensityInternalEnergy(rho_pert, sie[m], Cache[m]), uscale);
+      dpdv[m] = robust::ratio((p_pert - press[m]), dv);
+    }
+
+    // Fill in the Jacobian
+    for (int i = 0; i < neq * neq; ++i)
+      jacobian[i] = 0.0;
+    for (int m = 0; m < nmat; ++m) {
+      jacobian[m] = 1.0;
+    }
+    for (int m = 0; m < nmat - 1; m++) {
+      jacobian[MatIndex(m + 1, m)] = -dpdv[m];
+      jacobian[MatIndex(m + 1, m + 1)] = dpdv[m + 1];
+    }
+  }
+
+  PORTABLE_INLINE_FUNCTION
+  Real ScaleDx() const {
+    using namespace mix_params;
+    Real scale = 1.0;
+    // control how big of a step toward vfrac = 0 is allowed
+    for (int m = 0; m < nmat; ++m) {
+      if (scale * dx[m] < -vfrac_safety_fac * vfrac[m]) {
+        scale = robust::ratio(-vfrac_safety_fac * vfrac[m], dx[m]);
+      }
+    }
+    // control how big of a step toward rho = rho(Pmin) is allowed
+    for (int m = 0; m < nmat; m++) {
+      const Real rho_min = eos[m].RhoPmin(temp[m]);
+      const Real alpha_max = robust::ratio(rhobar[m], rho_min);
+      if (scale * dx[m] > 0.5 * (alpha_max - vfrac[m])) {
+        scale = robust::ratio(0.5 * (alpha_max - vfrac[m]), dx[m]);
+      }
+    }
+    // Now apply the overall scaling
+    for (int i = 0; i < neq; ++i)
+      dx[i] *= scale;
+    return scale;
+  }
+
+  // Update the solution and return new residual.  Possibly called repeatedly with
+  // different scale factors as part of a line search
+  PORTABLE_INLINE_FUNCTION
+  Real TestUpdate(const Real scale) {
+    if (scale == 1.0) {
+      for (int m = 0; m < nmat; ++m)
+        vtemp[m] = vfrac[m];
+    }
+    for (int m = 0; m < nmat; ++m) {
+      vfrac[m] = vtemp[m] + scale * dx[m];
+      rho[m] = robust::ratio(rhobar[m], vfrac[m]);
+      press[m] = robust::ratio(
+          eos[m].PressureFromDensityInternalEnergy(rho[m], sie[m], Cache[m]), uscale);
+    }
+    Residual();
+    return ResidualNorm();
+  }
+
+  // Temperatures are not part of the solve, so only compute them for
+  // the final state
+  PORTABLE_INLINE_FUNCTION
+  void Finalize() {
+    for (int m = 0; m < nmat; ++m) {
+      temp[m] = eos[m].TemperatureFromDensityInternalEnergy(rho[m], sie[m], Cache[m]);
+    }
+    Base_t::Finalize();
+  }
+
+ private:
+  mutable mix_impl::SolverArray_t<NMAT> dpdv, vtemp;
 };
 
 // fixed P solver
@@ -940,32 +1361,36 @@ inline size_t PTESolverFixedPRequiredScratchInBytes(const int nmat) {
   return PTESolverFixedPRequiredScratch(nmat) * sizeof(Real);
 }
 
-template <typename EOSIndexer, typename RealIndexer, typename LambdaIndexer>
-class PTESolverFixedP : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer> {
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::InitBase;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::AssignIncrement;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::nmat;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::neq;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::ResidualNorm;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::vfrac_total;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::sie_total;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::eos;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::rho;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::vfrac;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::sie;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::temp;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::press;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::rho_total;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::uscale;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::MatIndex;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::TryIdealPTE;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::jacobian;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::residual;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::dx;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::u;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::rhobar;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::Cache;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::Tnorm;
+template <typename EOSIndexer, typename RealIndexer, typename LambdaIndexer, int NMAT = 0>
+class PTESolverFixedP : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer, NMAT,
+                                                       (NMAT > 0 ? NMAT + 1 : 0)> {
+  using Base_t =
+      mix_impl::PTESolverBase<EOSIndexer, RealIndexer, NMAT, (NMAT > 0 ? NMAT + 1 : 0)>;
+  using Base_t::InitBase;
+  using Base_t::AssignIncrement;
+  using Base_t::nmat;
+  using Base_t::neq;
+  using Base_t::ResidualNorm;
+  using Base_t::vfrac_total;
+  using Base_t::sie_total;
+  using Base_t::eos;
+  using Base_t::rho;
+  using Base_t::vfrac;
+  using Base_t::sie;
+  using Base_t::temp;
+  using Base_t::press;
+  using Base_t::rho_total;
+  using Base_t::uscale;
+  using Base_t::MatIndex;
+  using Base_t::TryIdealPTE;
+  using Base_t::jacobian;
+  using Base_t::residual;
+  using Base_t::dx;
+  using Base_t::u;
+  using Base_t::rhobar;
+  using Base_t::Cache;
+  using Base_t::Tnorm;
+  using Base_t::accuracy;
 
  public:
   // template the ctor to get type deduction/universal references prior to c++17
@@ -973,13 +1398,13 @@ class PTESolverFixedP : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer>
   PORTABLE_INLINE_FUNCTION
   PTESolverFixedP(const int nmat, EOS_t &&eos, const Real vfrac_tot, const Real P,
                   Real_t &&rho, Real_t &&vfrac, Real_t &&sie, Real_t &&temp,
-                  CReal_t &&press, Lambda_t &&lambda, Real *scratch)
-      : mix_impl::PTESolverBase<EOSIndexer, RealIndexer>(nmat, nmat + 1, eos, vfrac_tot,
-                                                         1.0, rho, vfrac, sie, temp,
-                                                         press, scratch, 0.0) {
-    dpdv = AssignIncrement(scratch, nmat);
-    dpdT = AssignIncrement(scratch, nmat);
-    vtemp = AssignIncrement(scratch, nmat);
+                  CReal_t &&press, Lambda_t &&lambda, Real *scratch,
+                  const AccuracyParams &params = AccuracyParams())
+      : Base_t(nmat, nmat + 1, eos, vfrac_tot, 1.0, rho, vfrac, sie, temp, press, scratch,
+               0.0, params) {
+    AssignIncrement(dpdv, scratch, nmat);
+    AssignIncrement(dpdT, scratch, nmat);
+    AssignIncrement(vtemp, scratch, nmat);
     Pequil = P;
     // TODO(JCD): use whatever lambdas are passed in
     /*for (int m = 0; m < nmat; m++) {
@@ -1034,7 +1459,6 @@ class PTESolverFixedP : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer>
 
   PORTABLE_INLINE_FUNCTION
   bool CheckPTE() const {
-    using namespace mix_params;
     Real error_p = 0;
     for (int m = 0; m < nmat; ++m) {
       error_p += residual[m] * residual[m];
@@ -1043,14 +1467,19 @@ class PTESolverFixedP : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer>
     error_p *= uscale;
     Real error_v = std::abs(residual[neq - 1]);
     // Check for convergence
-    bool converged_p = (error_p < pte_rel_tolerance_p || error_p < pte_abs_tolerance_p);
-    bool converged_v = (error_v < pte_rel_tolerance_e || error_v < pte_abs_tolerance_e);
+    bool converged_p = (error_p < accuracy.pte_rel_tolerance_p ||
+                        error_p < accuracy.pte_abs_tolerance_p);
+    bool converged_v = (error_v < accuracy.pte_rel_tolerance_e ||
+                        error_v < accuracy.pte_abs_tolerance_e);
     return converged_p && converged_v;
   }
 
   PORTABLE_INLINE_FUNCTION
   void Jacobian() const {
     using namespace mix_params;
+    const Real dT = Tequil * derivative_eps;
+    const TemperatureIndex tidx = this->GetTemperatureIndex(Tnorm * Tequil);
+    const TemperatureIndex tidx_pert = this->GetTemperatureIndex(Tnorm * (Tequil + dT));
     for (int m = 0; m < nmat; m++) {
       //////////////////////////////
       // perturb volume fractions
@@ -1061,19 +1490,15 @@ class PTESolverFixedP : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer>
 
       Real p_pert{};
       Real e_pert{};
-      p_pert =
-          robust::ratio(this->GetPressureFromPreferred(eos[m], rho_pert, Tnorm * Tequil,
-                                                       e_pert, Cache[m], true),
-                        uscale);
+      p_pert = robust::ratio(this->GetPressureFromPreferred(eos[m], rho_pert, tidx,
+                                                            e_pert, Cache[m], true),
+                             uscale);
       dpdv[m] = robust::ratio((p_pert - press[m]), dv);
       //////////////////////////////
       // perturb temperature
       //////////////////////////////
-      Real dT = Tequil * derivative_eps;
-
-      p_pert = robust::ratio(this->GetPressureFromPreferred(eos[m], rho[m],
-                                                            Tnorm * (Tequil + dT), e_pert,
-                                                            Cache[m], true),
+      p_pert = robust::ratio(this->GetPressureFromPreferred(eos[m], rho[m], tidx_pert,
+                                                            e_pert, Cache[m], true),
                              uscale);
       dpdT[m] = robust::ratio((p_pert - press[m]), dT);
     }
@@ -1130,14 +1555,14 @@ class PTESolverFixedP : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer>
         vtemp[m] = vfrac[m];
     }
     Tequil = Ttemp + scale * dx[nmat];
+    const TemperatureIndex tidx = this->GetTemperatureIndex(Tnorm * Tequil);
     for (int m = 0; m < nmat; ++m) {
       vfrac[m] = vtemp[m] + scale * dx[m];
       rho[m] = robust::ratio(rhobar[m], vfrac[m]);
-      u[m] = rhobar[m] * eos[m].InternalEnergyFromDensityTemperature(
-                             rho[m], Tnorm * Tequil, Cache[m]);
+      u[m] = rhobar[m] *
+             eos[m].InternalEnergyFromDensityTemperatureIndex(rho[m], tidx, Cache[m]);
       press[m] = robust::ratio(
-          eos[m].PressureFromDensityTemperature(rho[m], Tnorm * Tequil, Cache[m]),
-          uscale);
+          eos[m].PressureFromDensityTemperatureIndex(rho[m], tidx, Cache[m]), uscale);
       sie[m] = robust::ratio(u[m], rhobar[m]);
       u[m] = robust::ratio(u[m], uscale);
       temp[m] = Tequil;
@@ -1147,7 +1572,7 @@ class PTESolverFixedP : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer>
   }
 
  private:
-  Real *dpdv, *dpdT, *vtemp;
+  mutable mix_impl::SolverArray_t<NMAT> dpdv, dpdT, vtemp;
   Real Tequil, Ttemp, Pequil;
 };
 
@@ -1162,50 +1587,53 @@ inline size_t PTESolverRhoURequiredScratchInBytes(const int nmat) {
   return PTESolverRhoURequiredScratch(nmat) * sizeof(Real);
 }
 
-template <typename EOSIndexer, typename RealIndexer, typename LambdaIndexer>
-class PTESolverRhoU : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer> {
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::InitBase;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::AssignIncrement;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::nmat;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::neq;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::ResidualNorm;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::vfrac_total;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::sie_total;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::eos;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::rho;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::vfrac;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::sie;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::temp;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::press;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::rho_total;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::uscale;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::TryIdealPTE;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::MatIndex;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::jacobian;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::residual;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::dx;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::u;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::rhobar;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::Cache;
-  using mix_impl::PTESolverBase<EOSIndexer, RealIndexer>::Tnorm;
+template <typename EOSIndexer, typename RealIndexer, typename LambdaIndexer, int NMAT = 0>
+class PTESolverRhoU : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer, NMAT,
+                                                     2 * NMAT> {
+  using Base_t = mix_impl::PTESolverBase<EOSIndexer, RealIndexer, NMAT, 2 * NMAT>;
+  using Base_t::InitBase;
+  using Base_t::AssignIncrement;
+  using Base_t::nmat;
+  using Base_t::neq;
+  using Base_t::ResidualNorm;
+  using Base_t::vfrac_total;
+  using Base_t::sie_total;
+  using Base_t::eos;
+  using Base_t::rho;
+  using Base_t::vfrac;
+  using Base_t::sie;
+  using Base_t::temp;
+  using Base_t::press;
+  using Base_t::rho_total;
+  using Base_t::uscale;
+  using Base_t::TryIdealPTE;
+  using Base_t::MatIndex;
+  using Base_t::jacobian;
+  using Base_t::residual;
+  using Base_t::dx;
+  using Base_t::u;
+  using Base_t::rhobar;
+  using Base_t::Cache;
+  using Base_t::Tnorm;
+  using Base_t::accuracy;
 
  public:
   // template the ctor to get type deduction/universal references prior to c++17
   template <typename EOS_t, typename Real_t, typename Lambda_t>
-  PORTABLE_INLINE_FUNCTION PTESolverRhoU(const int nmat, const EOS_t &&eos,
-                                         const Real vfrac_tot, const Real sie_tot,
-                                         Real_t &&rho, Real_t &&vfrac, Real_t &&sie,
-                                         Real_t &&temp, Real_t &&press, Lambda_t &&lambda,
-                                         Real *scratch, const Real Tguess = 0.0)
-      : mix_impl::PTESolverBase<EOSIndexer, RealIndexer>(nmat, 2 * nmat, eos, vfrac_tot,
-                                                         sie_tot, rho, vfrac, sie, temp,
-                                                         press, scratch, Tguess) {
-    dpdv = AssignIncrement(scratch, nmat);
-    dtdv = AssignIncrement(scratch, nmat);
-    dpde = AssignIncrement(scratch, nmat);
-    dtde = AssignIncrement(scratch, nmat);
-    vtemp = AssignIncrement(scratch, nmat);
-    utemp = AssignIncrement(scratch, nmat);
+  PORTABLE_INLINE_FUNCTION PTESolverRhoU(const int nmat, EOS_t &&eos, const Real vfrac_tot,
+                                         const Real sie_tot, Real_t &&rho, Real_t &&vfrac,
+                                         Real_t &&sie, Real_t &&temp, Real_t &&press,
+                                         Lambda_t &&lambda, Real *scratch,
+                                         const Real Tguess = 0.0,
+                                         const AccuracyParams &params = AccuracyParams())
+      : Base_t(nmat, 2 * nmat, eos, vfrac_tot, sie_tot, rho, vfrac, sie, temp, press,
+               scratch, Tguess, params) {
+    AssignIncrement(dpdv, scratch, nmat);
+    AssignIncrement(dtdv, scratch, nmat);
+    AssignIncrement(dpde, scratch, nmat);
+    AssignIncrement(dtde, scratch, nmat);
+    AssignIncrement(vtemp, scratch, nmat);
+    AssignIncrement(utemp, scratch, nmat);
     // TODO(JCD): use whatever lambdas are passed in
     /*for (int m = 0; m < nmat; m++) {
       if (variadic_utils::is_nullptr(lambda[m])) Cache[m] = lambda[m];
@@ -1241,7 +1669,6 @@ class PTESolverRhoU : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer> {
 
   PORTABLE_INLINE_FUNCTION
   bool CheckPTE() const {
-    using namespace mix_params;
     Real mean_p = vfrac[0] * press[0];
     Real mean_t = rhobar[0] * temp[0];
     Real error_p = 0.0;
@@ -1256,10 +1683,11 @@ class PTESolverRhoU : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer> {
     error_p = std::sqrt(error_p);
     error_t = std::sqrt(error_t);
     // Check for convergence
-    bool converged_p = (error_p < pte_rel_tolerance_p * std::abs(mean_p) ||
-                        error_p < pte_abs_tolerance_p);
+    bool converged_p = (error_p < accuracy.pte_rel_tolerance_p * std::abs(mean_p) ||
+                        error_p < accuracy.pte_abs_tolerance_p);
     bool converged_t =
-        (error_t < pte_rel_tolerance_t * mean_t || error_t < pte_abs_tolerance_t);
+        (error_t < accuracy.pte_rel_tolerance_t * mean_t ||
+         error_t < accuracy.pte_abs_tolerance_t);
     return (converged_p && converged_t);
   }
 
@@ -1385,29 +1813,38 @@ class PTESolverRhoU : public mix_impl::PTESolverBase<EOSIndexer, RealIndexer> {
   }
 
  private:
-  Real *dpdv, *dtdv, *dpde, *dtde, *vtemp, *utemp;
+  mutable mix_impl::SolverArray_t<NMAT> dpdv, dtdv, dpde, dtde, vtemp, utemp;
 };
 
 template <class System>
 PORTABLE_INLINE_FUNCTION bool PTESolver(System &s) {
-  using namespace mix_params;
+  const AccuracyParams &accuracy = s.Accuracy();
   // initialize the system, fill in residual, and get its norm
   Real err = s.Init();
 
   bool converged = false;
-  const int pte_max_iter = s.Nmat() * pte_max_iter_per_mat;
-  const Real residual_tol = s.Nmat() * pte_residual_tolerance;
+  const int pte_max_iter = s.Nmat() * accuracy.pte_max_iter_per_mat;
+  const Real residual_tol = s.Nmat() * accuracy.pte_residual_tolerance;
   auto &niter = s.Niter();
+  auto &nbacktrack = s.Nbacktrack();
+  nbacktrack = 0;
+  // whether the last Newton step was solved in single precision
+  bool single = false;
   for (niter = 0; niter < pte_max_iter; ++niter) {
-    // Check for convergence
+    // Check for convergence.  A state reached by a single precision step
+    // is refined by a double precision step before it is accepted.
     converged = s.CheckPTE();
-    if (converged) break;
+    if (converged && !single) break;
 
     // compute the Jacobian
     s.Jacobian();
 
-    // solve for the Newton step
-    bool success = s.Solve();
+    // solve for the Newton step, in single precision while the residual
+    // is large if mixed precision is enabled.  The residual and the
+    // convergence checks are always in double precision.
+    single = (!converged && accuracy.pte_mixed_precision_residual > 0.0 &&
+              err > accuracy.pte_mixed_precision_residual);
+    bool success = s.Solve(single);
     if (!success) {
       // do something to crash out?  Tell folks what happened?
       // printf("crashing out at iteration: %i\n", niter);
@@ -1424,27 +1861,32 @@ PORTABLE_INLINE_FUNCTION bool PTESolver(System &s) {
     scale = 1.0;
     Real err_old = err;
     err = s.TestUpdate(scale);
-    if (err > err_old + line_search_alpha * gradfdx) {
+    if (err > err_old + accuracy.line_search_alpha * gradfdx) {
       // backtrack
       Real err_mid = s.TestUpdate(0.5);
+      ++nbacktrack;
       if (err_mid < err && err_mid < err_old) {
         scale = 0.75 + 0.5 * robust::ratio(err_mid - err, err - 2.0 * err_mid + err_old);
       } else {
-        scale = line_search_fac;
+        scale = accuracy.line_search_fac;
       }
 
-      for (int line_iter = 0; line_iter < line_search_max_iter; line_iter++) {
+      for (int line_iter = 0; line_iter < accuracy.line_search_max_iter; line_iter++) {
         err = s.TestUpdate(scale);
-        if (err < err_old + line_search_alpha * scale * gradfdx) break;
-        scale *= line_search_fac;
+        ++nbacktrack;
+        if (err < err_old + accuracy.line_search_alpha * scale * gradfdx) break;
+        scale *= accuracy.line_search_fac;
       }
     }
 
-    // apply fixes post update, e.g. renormalize volume fractions to deal with round-off
-    s.Fixup();
+    // apply fixes post update, e.g. renormalize volume fractions to deal with round-off.
+    // The error left by a single precision step is larger than round-off and is
+    // removed by the next double precision step instead.
+    if (!single) s.Fixup();
 
-    // check for the case where we have converged as much as precision allows
-    if (err > 0.5 * err_old && err < residual_tol) {
+    // check for the case where we have converged as much as precision allows.
+    // Slow progress of a single precision step says nothing about that.
+    if (!single && err > 0.5 * err_old && err < residual_tol) {
       converged = true;
       break;
     }
@@ -1458,6 +1900,24 @@ PORTABLE_INLINE_FUNCTION bool PTESolver(System &s) {
   return converged;
 }
 
+// Calls f with std::integral_constant<int, nmat> when nmat has solver
+// specializations, and std::integral_constant<int, 0> otherwise. f
+// passes the value on as the NMAT template parameter of a solver.
+template <typename Function_t>
+PORTABLE_FORCEINLINE_FUNCTION auto DispatchOnNmat(const int nmat, Function_t &&f)
+    -> decltype(f(std::integral_constant<int, 0>())) {
+  switch (nmat) {
+  case 2:
+    return f(std::integral_constant<int, 2>());
+  case 3:
+    return f(std::integral_constant<int, 3>());
+  case 4:
+    return f(std::integral_constant<int, 4>());
+  default:
+    return f(std::integral_constant<int, 0>());
+  }
+}
+
 } // namespace singularity
 
 #endif // _SINGULARITY_EOS_CLOSURE_MIXED_CELL_MODELS_
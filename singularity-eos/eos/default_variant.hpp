@@ -41,6 +41,14 @@ namespace singularity {
 // create the alias
 using EOS = typename decltype(singularity::tl_to_Variant(singularity::combined_list))::vt;
 
+#ifdef SINGULARITY_EXPLICIT_INSTANTIATION
+// The vector functions of EOS for the common indexer types are
+// compiled once, into the singularity-eos library. See eos.cpp.
+#define SG_INSTANTIATED_VARIANT EOS
+SG_VARIANT_EXTERN_VECTOR_FUNCTIONS()
+#undef SG_INSTANTIATED_VARIANT
+#endif // SINGULARITY_EXPLICIT_INSTANTIATION
+
 } // namespace singularity
 
 #endif // _SINGULARITY_EOS_EOS_DEFAULT_VARIANT_HPP_
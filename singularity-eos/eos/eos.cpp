@@ -43,3 +43,17 @@
 // In the future, we could include centralized code here that we
 // always want compiled, such as template instantiations or
 // convenience functions.
+//
+// With SINGULARITY_EXPLICIT_INSTANTIATION, this is where the vector
+// functions of the default EOS variant are instantiated. See
+// eos_variant_instantiation.hpp.
+
+#ifdef SINGULARITY_EXPLICIT_INSTANTIATION
+#include <singularity-eos/eos/eos.hpp>
+
+namespace singularity {
+#define SG_INSTANTIATED_VARIANT EOS
+SG_VARIANT_INSTANTIATE_VECTOR_FUNCTIONS()
+#undef SG_INSTANTIATED_VARIANT
+} // namespace singularity
+#endif // SINGULARITY_EXPLICIT_INSTANTIATION
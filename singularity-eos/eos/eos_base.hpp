@@ -15,11 +15,18 @@
 #ifndef _SINGULARITY_EOS_EOS_EOS_BASE_
 #define _SINGULARITY_EOS_EOS_EOS_BASE_
 
+#include <cmath>
 #include <cstring>
+#include <limits>
 #include <string>
 
 #include <ports-of-call/portability.hpp>
 #include <ports-of-call/portable_errors.hpp>
+#include <singularity-eos/base/accuracy.hpp>
+#include <singularity-eos/base/constants.hpp>
+#include <singularity-eos/base/eos_error.hpp>
+#include <singularity-eos/base/robust_utils.hpp>
+#include <singularity-eos/base/root-finding-1d/root_finding.hpp>
 #include <singularity-eos/base/variadic_utils.hpp>
 
 namespace singularity {
@@ -33,6 +40,41 @@ static inline auto member_func_name(const char *type_name, const char *func_name
   singularity::mfuncname::member_func_name(typeid(CRTP).name(), __func__);
 
 namespace singularity {
+
+// The thermodynamic derivatives needed by implicit solvers, all at a
+// single state. Partial derivatives are at constant specific internal
+// energy (dPdRho, dTdRho), density (dPdE, dTdE), or temperature
+// (dEdRho). cv is dE/dT at constant density and gruneisen is
+// dPdE / rho.
+struct ThermoDerivatives {
+  Real dPdRho = 0;
+  Real dPdE = 0;
+  Real dTdRho = 0;
+  Real dTdE = 0;
+  Real dEdRho = 0;
+  Real cv = 0;
+  Real gruneisen = 0;
+};
+
+// Location of a temperature on the temperature axis of a table. When
+// several materials share a temperature grid, e.g., tables generated
+// by sesame2spiner with the -g flag, the index and interpolation
+// weights are computed once and reused for every material evaluated at
+// that temperature, as in the PTE solvers. nT == 0 marks an index that
+// carries only the temperature, as returned by models without tables.
+struct TemperatureIndex {
+  Real temperature = 0;
+  Real lT = 0;
+  // Identity of the log(T) grid the index was computed on
+  Real lTMin = 0;
+  Real lTMax = 0;
+  Real lTOffset = 0;
+  int nT = 0;
+  int i = 0;          // lower node on the log(T) axis
+  Real w[2] = {1, 0}; // interpolation weights for nodes i and i + 1
+  TableStatus whereAmI = TableStatus::OnTable;
+};
+
 namespace eos_base {
 
 namespace impl {
@@ -58,6 +100,64 @@ char *StrCat(char *destination, const char *source) {
   // the destination is returned by standard `strcat()`
   return destination;
 }
+
+// Brackets and tolerances for the default inversions in EosBase. The
+// root finds are done in the log of the unknown, so the brackets span
+// many decades and the tolerances are relative. The brackets are only
+// used where a model does not bound its domain, see InvertBracket.
+constexpr Real INVERT_LT_MIN = -7;     // log(1e-3 K)
+constexpr Real INVERT_LT_MAX = 28;     // log(1.4e12 K)
+constexpr Real INVERT_LRHO_MIN = -28;  // log(7e-13 g/cm^3)
+constexpr Real INVERT_LRHO_MAX = 37;   // log(1.2e16 g/cm^3), past nuclear density
+constexpr Real INVERT_LT_GUESS = 5.68; // log(ROOM_TEMPERATURE)
+constexpr Real INVERT_LRHO_GUESS = 0; // without a reference density
+constexpr Real INVERT_XTOL = 1e-12;
+constexpr Real INVERT_RTOL = 1e-12;
+
+// Relative density step of the finite difference in the default
+// DerivativesFromDensityInternalEnergy
+constexpr Real DERIVATIVE_EPS = 3e-6;
+
+// Bracket in log space of an inversion whose unknown lies in [lo, hi],
+// as reported by the MinimumDensity and MaximumDensity (or
+// temperature) of a model. A bound the model leaves open, zero below
+// or infinity above, falls back to the default bracket [ldef_lo,
+// ldef_hi]. The guess is moved into the bracket.
+PORTABLE_INLINE_FUNCTION void InvertBracket(const Real lo, const Real hi,
+                                            const Real ldef_lo, const Real ldef_hi,
+                                            Real &lguess, Real &lmin, Real &lmax) {
+  lmin = (lo > 0) ? std::log(lo) : ldef_lo;
+  lmax = (hi > 0 && std::isfinite(hi)) ? std::log(hi) : ldef_hi;
+  lguess = std::min(std::max(lguess, lmin), lmax);
+}
+
+// Finds x such that f(x) = target by root finding in log(x). The
+// tolerances are INVERT_XTOL and INVERT_RTOL at the default accuracy
+// and scale with accuracy.root_thresh otherwise. Returns NaN if there
+// is no root in [exp(lmin), exp(lmax)], so that one bad point of a
+// batch does not abort the others.
+template <typename F>
+PORTABLE_INLINE_FUNCTION Real InvertInLog(const F &f, const Real target,
+                                          const Real lguess, const Real lmin,
+                                          const Real lmax,
+                                          const AccuracyParams &accuracy) {
+  // Never evaluate f outside of the bracket, even where the secant
+  // steps out of it, since the bracket may be the model's domain
+  auto fOfLog = [&](const Real lx) {
+    return f(std::exp(std::min(std::max(lx, lmin), lmax)));
+  };
+  const Real scale = accuracy.root_thresh / AccuracyParams().root_thresh;
+  const Real xtol = INVERT_XTOL * scale;
+  const Real ytol = INVERT_RTOL * scale * std::abs(target);
+  Real lx = lguess;
+  const auto status =
+      RootFinding1D::regula_falsi(fOfLog, target, lguess, lmin, lmax, xtol, ytol, lx,
+                                  nullptr, false, accuracy.root_max_iter);
+  if (status != RootFinding1D::Status::SUCCESS) {
+    return std::numeric_limits<Real>::quiet_NaN();
+  }
+  return std::exp(lx);
+}
 } // namespace impl
 
 // This Macro adds the `using` statements that allow for the base class
@@ -78,7 +178,11 @@ char *StrCat(char *destination, const char *source) {
   using EosBase<EOSDERIVED>::GruneisenParamFromDensityInternalEnergy;                    \
   using EosBase<EOSDERIVED>::MinimumDensity;                                             \
   using EosBase<EOSDERIVED>::MinimumTemperature;                                         \
+  using EosBase<EOSDERIVED>::MaximumDensity;                                             \
+  using EosBase<EOSDERIVED>::MaximumTemperature;                                         \
   using EosBase<EOSDERIVED>::FillEos;                                                    \
+  using EosBase<EOSDERIVED>::DerivativesFromDensityTemperature;                          \
+  using EosBase<EOSDERIVED>::DerivativesFromDensityInternalEnergy;                       \
   using EosBase<EOSDERIVED>::EntropyFromDensityTemperature;                              \
   using EosBase<EOSDERIVED>::EntropyFromDensityInternalEnergy;                           \
   using EosBase<EOSDERIVED>::EntropyIsNotEnabled;                                        \
@@ -619,15 +723,278 @@ class EosBase {
                        output, lambdas[i]);
         });
   }
+
+  // The full set of thermodynamic derivatives at one state. This
+  // default is built from the scalar lookups of the model: dPdE and
+  // dTdE follow from the Gruneisen parameter and cv, and dPdRho and
+  // dTdRho are forward differences in density, which cost one extra
+  // pressure and temperature lookup. dEdRho = -cv dTdRho. Models with
+  // tabulated or closed form derivatives override it.
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION ThermoDerivatives DerivativesFromDensityInternalEnergy(
+      const Real rho, const Real sie,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    const CRTP &eos = *static_cast<CRTP const *>(this);
+    ThermoDerivatives d;
+    // Perturbed lookups first, so that lambda caches the unperturbed state
+    const Real drho = impl::DERIVATIVE_EPS * rho;
+    const Real P1 = eos.PressureFromDensityInternalEnergy(rho + drho, sie, lambda);
+    const Real T1 = eos.TemperatureFromDensityInternalEnergy(rho + drho, sie, lambda);
+    const Real P0 = eos.PressureFromDensityInternalEnergy(rho, sie, lambda);
+    const Real T0 = eos.TemperatureFromDensityInternalEnergy(rho, sie, lambda);
+    d.cv = eos.SpecificHeatFromDensityInternalEnergy(rho, sie, lambda);
+    d.gruneisen = eos.GruneisenParamFromDensityInternalEnergy(rho, sie, lambda);
+    d.dPdRho = robust::ratio(P1 - P0, drho);
+    d.dPdE = rho * d.gruneisen;
+    d.dTdRho = robust::ratio(T1 - T0, drho);
+    d.dTdE = robust::ratio(1.0, d.cv);
+    d.dEdRho = -d.cv * d.dTdRho;
+    return d;
+  }
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION ThermoDerivatives DerivativesFromDensityTemperature(
+      const Real rho, const Real temperature,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    const CRTP &eos = *static_cast<CRTP const *>(this);
+    const Real sie = eos.InternalEnergyFromDensityTemperature(rho, temperature, lambda);
+    return eos.DerivativesFromDensityInternalEnergy(rho, sie, lambda);
+  }
+  // Vector versions. derivs[i] must be assignable from a
+  // ThermoDerivatives, e.g., a pointer to an array of them.
+  template <typename DerivIndexer, typename ConstRealIndexer, typename LambdaIndexer>
+  inline void DerivativesFromDensityInternalEnergy(ConstRealIndexer &&rhos,
+                                                   ConstRealIndexer &&sies,
+                                                   DerivIndexer &&derivs, const int num,
+                                                   LambdaIndexer &&lambdas) const {
+    static auto const name = SG_MEMBER_FUNC_NAME();
+    static auto const cname = name.c_str();
+    CRTP copy = *(static_cast<CRTP const *>(this));
+    portableFor(
+        cname, 0, num, PORTABLE_LAMBDA(const int i) {
+          derivs[i] = copy.DerivativesFromDensityInternalEnergy(rhos[i], sies[i],
+                                                                lambdas[i]);
+        });
+  }
+  template <typename DerivIndexer, typename ConstRealIndexer, typename LambdaIndexer>
+  inline void DerivativesFromDensityTemperature(ConstRealIndexer &&rhos,
+                                                ConstRealIndexer &&temperatures,
+                                                DerivIndexer &&derivs, const int num,
+                                                LambdaIndexer &&lambdas) const {
+    static auto const name = SG_MEMBER_FUNC_NAME();
+    static auto const cname = name.c_str();
+    CRTP copy = *(static_cast<CRTP const *>(this));
+    portableFor(
+        cname, 0, num, PORTABLE_LAMBDA(const int i) {
+          derivs[i] = copy.DerivativesFromDensityTemperature(rhos[i], temperatures[i],
+                                                             lambdas[i]);
+        });
+  }
+
+  // Inversions of the forward lookups. These defaults root find on the
+  // forward lookups of the model, over the density or temperature
+  // range the model reports, and return NaN where there is no
+  // root. Models with closed forms or cheaper inverses override them
+  // with scalar functions of the same signature, which InvertState
+  // then picks up.
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION Real TemperatureFromDensityPressure(
+      const Real rho, const Real press,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    const CRTP &eos = *static_cast<CRTP const *>(this);
+    auto PofT = [&](const Real temp) {
+      return eos.PressureFromDensityTemperature(rho, temp, lambda);
+    };
+    Real lguess = impl::INVERT_LT_GUESS;
+    Real lmin, lmax;
+    impl::InvertBracket(eos.MinimumTemperature(), eos.MaximumTemperature(),
+                        impl::INVERT_LT_MIN, impl::INVERT_LT_MAX, lguess, lmin, lmax);
+    return impl::InvertInLog(PofT, press, lguess, lmin, lmax, eos.GetAccuracy());
+  }
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION Real DensityFromPressureInternalEnergy(
+      const Real press, const Real sie,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    const CRTP &eos = *static_cast<CRTP const *>(this);
+    auto PofRho = [&](const Real rho) {
+      return eos.PressureFromDensityInternalEnergy(rho, sie, lambda);
+    };
+    Real lguess = InvertLRhoGuess_();
+    Real lmin, lmax;
+    impl::InvertBracket(eos.MinimumDensity(), eos.MaximumDensity(),
+                        impl::INVERT_LRHO_MIN, impl::INVERT_LRHO_MAX, lguess, lmin,
+                        lmax);
+    return impl::InvertInLog(PofRho, press, lguess, lmin, lmax, eos.GetAccuracy());
+  }
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION Real TemperatureFromDensityEntropy(
+      const Real rho, const Real entropy,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    const CRTP &eos = *static_cast<CRTP const *>(this);
+    auto SofT = [&](const Real temp) {
+      return eos.EntropyFromDensityTemperature(rho, temp, lambda);
+    };
+    Real lguess = impl::INVERT_LT_GUESS;
+    Real lmin, lmax;
+    impl::InvertBracket(eos.MinimumTemperature(), eos.MaximumTemperature(),
+                        impl::INVERT_LT_MIN, impl::INVERT_LT_MAX, lguess, lmin, lmax);
+    return impl::InvertInLog(SofT, entropy, lguess, lmin, lmax, eos.GetAccuracy());
+  }
+  // Solves P(rho, T) = press for rho. Models with a closed form or a
+  // table inverse provide their own.
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION void
+  DensityEnergyFromPressureTemperature(const Real press, const Real temp,
+                                       Indexer_t &&lambda, Real &rho, Real &sie) const {
+    const CRTP &eos = *static_cast<CRTP const *>(this);
+    auto PofRho = [&](const Real r) {
+      return eos.PressureFromDensityTemperature(r, temp, lambda);
+    };
+    Real lguess = InvertLRhoGuess_();
+    Real lmin, lmax;
+    impl::InvertBracket(eos.MinimumDensity(), eos.MaximumDensity(),
+                        impl::INVERT_LRHO_MIN, impl::INVERT_LRHO_MAX, lguess, lmin,
+                        lmax);
+    rho = impl::InvertInLog(PofRho, press, lguess, lmin, lmax, eos.GetAccuracy());
+    sie = std::isnan(rho) ? rho
+                          : eos.InternalEnergyFromDensityTemperature(rho, temp, lambda);
+  }
+
+  // Generalized inversion. Given the pair of known quantities x and y,
+  // fills the quantities selected by the thermalqs bitmask output.
+  // Quantities not in output are left untouched. Each pair is reduced
+  // to density and temperature, or density and energy, with one of
+  // the inversions above (or DensityEnergyFromPressureTemperature for
+  // pressure and temperature), and the rest are forward lookups. If
+  // the inversion fails, every requested output is set to NaN.
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION void
+  InvertState(const InputPair pair, const Real x, const Real y, Real &rho, Real &temp,
+              Real &sie, Real &press, Real &cv, Real &bmod, const unsigned long output,
+              Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    const CRTP &eos = *static_cast<CRTP const *>(this);
+    Real r = 0, t = 0, e = 0, p = 0;
+    // Which of temperature and energy is known after the inversion
+    bool known_t = true;
+    bool known_e = false;
+    bool known_p = true;
+    switch (pair) {
+    case InputPair::DensityPressure:
+      r = x;
+      p = y;
+      t = eos.TemperatureFromDensityPressure(r, p, lambda);
+      break;
+    case InputPair::PressureTemperature:
+      p = x;
+      t = y;
+      eos.DensityEnergyFromPressureTemperature(p, t, lambda, r, e);
+      known_e = true;
+      break;
+    case InputPair::PressureEnergy:
+      p = x;
+      e = y;
+      r = eos.DensityFromPressureInternalEnergy(p, e, lambda);
+      known_t = false;
+      known_e = true;
+      break;
+    case InputPair::DensityEntropy:
+      r = x;
+      t = eos.TemperatureFromDensityEntropy(r, y, lambda);
+      known_p = false;
+      break;
+    }
+    if (std::isnan(r) || std::isnan(known_t ? t : e)) {
+      constexpr Real nan = std::numeric_limits<Real>::quiet_NaN();
+      if (output & thermalqs::density) rho = nan;
+      if (output & thermalqs::temperature) temp = nan;
+      if (output & thermalqs::specific_internal_energy) sie = nan;
+      if (output & thermalqs::pressure) press = nan;
+      if (output & thermalqs::specific_heat) cv = nan;
+      if (output & thermalqs::bulk_modulus) bmod = nan;
+      return;
+    }
+    if (output & thermalqs::density) rho = r;
+    if (output & thermalqs::temperature) {
+      temp = known_t ? t : eos.TemperatureFromDensityInternalEnergy(r, e, lambda);
+    }
+    if (output & thermalqs::specific_internal_energy) {
+      sie = known_e ? e : eos.InternalEnergyFromDensityTemperature(r, t, lambda);
+    }
+    if (output & thermalqs::pressure) {
+      press = known_p ? p : eos.PressureFromDensityTemperature(r, t, lambda);
+    }
+    if (output & thermalqs::specific_heat) {
+      cv = known_t ? eos.SpecificHeatFromDensityTemperature(r, t, lambda)
+                   : eos.SpecificHeatFromDensityInternalEnergy(r, e, lambda);
+    }
+    if (output & thermalqs::bulk_modulus) {
+      bmod = known_t ? eos.BulkModulusFromDensityTemperature(r, t, lambda)
+                     : eos.BulkModulusFromDensityInternalEnergy(r, e, lambda);
+    }
+  }
+  // Vector version of InvertState. This is the shared batched root
+  // finder: every element is inverted independently in one portableFor,
+  // and elements that fail are NaN without affecting the others.
+  template <typename RealIndexer, typename ConstRealIndexer, typename LambdaIndexer>
+  inline void InvertState(const InputPair pair, ConstRealIndexer &&xs,
+                          ConstRealIndexer &&ys, RealIndexer &&rhos, RealIndexer &&temps,
+                          RealIndexer &&sies, RealIndexer &&presses, RealIndexer &&cvs,
+                          RealIndexer &&bmods, const int num, const unsigned long output,
+                          LambdaIndexer &&lambdas) const {
+    static auto const name = SG_MEMBER_FUNC_NAME();
+    static auto const cname = name.c_str();
+    CRTP copy = *(static_cast<CRTP const *>(this));
+    portableFor(
+        cname, 0, num, PORTABLE_LAMBDA(const int i) {
+          copy.InvertState(pair, xs[i], ys[i], rhos[i], temps[i], sies[i], presses[i],
+                           cvs[i], bmods[i], output, lambdas[i]);
+        });
+  }
+
+  // Lookups at a temperature located once with GetTemperatureIndex and
+  // shared between materials. Models without tables only carry the
+  // temperature through, and tabulated models override these.
+  PORTABLE_INLINE_FUNCTION
+  TemperatureIndex GetTemperatureIndex(const Real temperature) const {
+    TemperatureIndex tidx;
+    tidx.temperature = temperature;
+    return tidx;
+  }
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION Real InternalEnergyFromDensityTemperatureIndex(
+      const Real rho, const TemperatureIndex &tidx,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    const CRTP &eos = *static_cast<CRTP const *>(this);
+    return eos.InternalEnergyFromDensityTemperature(rho, tidx.temperature, lambda);
+  }
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION Real PressureFromDensityTemperatureIndex(
+      const Real rho, const TemperatureIndex &tidx,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    const CRTP &eos = *static_cast<CRTP const *>(this);
+    return eos.PressureFromDensityTemperature(rho, tidx.temperature, lambda);
+  }
+
   // Report minimum values of density and temperature
   PORTABLE_FORCEINLINE_FUNCTION
   Real MinimumDensity() const { return 0; }
   PORTABLE_FORCEINLINE_FUNCTION
   Real MinimumTemperature() const { return 0; }
+  // Report maximum values of density and temperature, infinite if the
+  // model is not bounded
+  PORTABLE_FORCEINLINE_FUNCTION
+  Real MaximumDensity() const { return std::numeric_limits<Real>::infinity(); }
+  PORTABLE_FORCEINLINE_FUNCTION
+  Real MaximumTemperature() const { return std::numeric_limits<Real>::infinity(); }
 
   PORTABLE_INLINE_FUNCTION
   Real RhoPmin(const Real temp) const { return 0.0; }
 
+  // Tolerances of the model's internal table inversions. Models without
+  // any ignore them.
+  inline void SetAccuracy(const AccuracyParams &params) {}
+  PORTABLE_INLINE_FUNCTION
+  AccuracyParams GetAccuracy() const { return AccuracyParams(); }
+
   // Default entropy behavior is to cause an error
   PORTABLE_FORCEINLINE_FUNCTION
   void EntropyIsNotEnabled(const char *eosname) const {
@@ -665,6 +1032,16 @@ class EosBase {
   inline constexpr decltype(auto) GetUnmodifiedObject() {
     return *static_cast<CRTP *>(this);
   }
+
+ private:
+  // The density inversions start from the reference density, which
+  // for solids is on the branch where pressure rises with density
+  PORTABLE_INLINE_FUNCTION Real InvertLRhoGuess_() const {
+    const CRTP &eos = *static_cast<CRTP const *>(this);
+    Real rho, temp, sie, press, cv, bmod, dpde, dvdt;
+    eos.ValuesAtReferenceState(rho, temp, sie, press, cv, bmod, dpde, dvdt);
+    return (rho > 0 && std::isfinite(rho)) ? std::log(rho) : impl::INVERT_LRHO_GUESS;
+  }
 };
 } // namespace eos_base
 } // namespace singularity
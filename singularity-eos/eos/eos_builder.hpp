@@ -15,12 +15,17 @@
 #ifndef _SINGULARITY_EOS_EOS_EOS_BUILDER_HPP_
 #define _SINGULARITY_EOS_EOS_EOS_BUILDER_HPP_
 
+#include <type_traits>
 #include <utility>
 
 #include <ports-of-call/portability.hpp>
 
+#include <singularity-eos/base/table_transform.hpp>
 #include <singularity-eos/base/variadic_utils.hpp>
 #include <singularity-eos/eos/eos_variant.hpp>
+#include <singularity-eos/eos/modifiers/eos_unitsystem.hpp>
+#include <singularity-eos/eos/modifiers/scaled_eos.hpp>
+#include <singularity-eos/eos/modifiers/shifted_eos.hpp>
 
 namespace singularity {
 namespace EOSBuilder {
@@ -50,6 +55,62 @@ Variant<Ts...> Modify(const Variant<Ts...> &var, Args &&...args) {
   return var.template Modify<Mod>(std::forward<Args>(args)...);
 }
 
+namespace bake_impl {
+// Declared up front so that each overload can recurse into the others
+template <typename T>
+auto Bake(ShiftedEOS<T> eos, const TableTransform &transform);
+template <typename T>
+auto Bake(UnitSystem<T> eos, const TableTransform &transform);
+
+// The bottom of the stack. Only tabulated EOS's provide BakeTransform.
+template <typename T>
+T Bake(T eos, const TableTransform &transform) {
+  eos.BakeTransform(transform);
+  return eos;
+}
+template <typename T>
+auto Bake(ShiftedEOS<T> eos, const TableTransform &transform) {
+  return Bake(eos.UnmodifyOnce(), transform.Then(eos.GetTableTransform()));
+}
+template <typename T>
+auto Bake(UnitSystem<T> eos, const TableTransform &transform) {
+  return Bake(eos.UnmodifyOnce(), transform.Then(eos.GetTableTransform()));
+}
+
+template <typename T, typename = void>
+struct Bakeable : std::false_type {};
+template <typename T>
+struct Bakeable<T, std::void_t<decltype(std::declval<T &>().BakeTransform(
+                       std::declval<const TableTransform &>()))>> : std::true_type {};
+template <typename T>
+struct Bakeable<ShiftedEOS<T>> : Bakeable<T> {};
+template <typename T>
+struct Bakeable<UnitSystem<T>> : Bakeable<T> {};
+// ScaledEOS scales the energy but not the specific heat, so no
+// consistent set of tables reproduces it.
+template <typename T>
+struct Bakeable<ScaledEOS<T>> : std::false_type {};
+} // namespace bake_impl
+
+// True if EOS is a stack of ShiftedEOS and UnitSystem modifiers on
+// top of a tabulated EOS, which BakeModifiers accepts
+template <typename EOS>
+constexpr bool CanBakeModifiers = bake_impl::Bakeable<EOS>::value;
+
+// Folds a stack of ShiftedEOS and UnitSystem modifiers into the
+// tables of the tabulated EOS at its bottom and returns the bare
+// tabulated EOS, which then answers every query in the caller's units
+// without any per-call modifier overhead. Host only, before
+// GetOnDevice. The tables of the input are re-used or freed, so the
+// input must not be used afterwards.
+template <typename EOS>
+auto BakeModifiers(EOS eos) {
+  static_assert(CanBakeModifiers<EOS>,
+                "BakeModifiers needs ShiftedEOS and UnitSystem modifiers on a "
+                "tabulated EOS. ScaledEOS cannot be baked.");
+  return bake_impl::Bake(eos, TableTransform());
+}
+
 } // namespace EOSBuilder
 } // namespace singularity
 
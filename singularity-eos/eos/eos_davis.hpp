@@ -23,6 +23,7 @@
 #include <singularity-eos/base/math_utils.hpp>
 #include <singularity-eos/base/robust_utils.hpp>
 #include <singularity-eos/base/root-finding-1d/root_finding.hpp>
+#include <singularity-eos/base/simd_utils.hpp>
 #include <singularity-eos/eos/eos_base.hpp>
 
 namespace singularity {
@@ -39,9 +40,10 @@ class DavisReactants : public EosBase<DavisReactants> {
       : _rho0(rho0), _e0(e0), _P0(P0), _T0(T0), _A(A), _B(B), _C(C), _G0(G0), _Z(Z),
         _alpha(alpha), _Cv0(Cv0) {}
   DavisReactants GetOnDevice() { return *this; }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real TemperatureFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_real_t<Real_t, Real>
+  TemperatureFromDensityInternalEnergy(
+      const Real_t rho, const Real sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     const Real power_base = DimlessEdiff(rho, sie);
     if (power_base <= 0) {
@@ -52,25 +54,38 @@ class DavisReactants : public EosBase<DavisReactants> {
     const Real tmp = std::pow(power_base, 1.0 / (1.0 + _alpha));
     return Ts(rho) * tmp;
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real InternalEnergyFromDensityTemperature(
-      const Real rho, const Real temp,
+  template <typename Real_t, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+  TemperatureFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    const Real t_s = Ts(rho);
-    PORTABLE_REQUIRE(temp >= 0, "Negative temperature provided");
-    return Es(rho) +
-           _Cv0 * t_s / (1.0 + _alpha) * (std::pow(temp / t_s, 1.0 + _alpha) - 1.0);
-  }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real PressureFromDensityTemperature(
-      const Real rho, const Real temp,
+    const Real_t power_base = DimlessEdiff(rho, sie);
+    const Real_t tmp = simd_utils::pow(simd_utils::max<Real_t>(power_base, 0.0),
+                                       1.0 / (1.0 + _alpha));
+    return simd_utils::select(power_base <= Real_t(0.0), Real_t(0.0),
+                              Real_t(Ts(rho) * tmp));
+  }
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  InternalEnergyFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temp,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    using R = simd_utils::value_t<Real_t>;
+    const R t_s = Ts(rho);
+    PORTABLE_REQUIRE(simd_utils::all(temp >= R(0.0)), "Negative temperature provided");
+    return Es(rho) + _Cv0 * t_s / (1.0 + _alpha) *
+                         (simd_utils::pow(R(temp / t_s), 1.0 + _alpha) - 1.0);
+  }
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> PressureFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temp,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return PressureFromDensityInternalEnergy(
         rho, InternalEnergyFromDensityTemperature(rho, temp));
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real PressureFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> PressureFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return Ps(rho) + Gamma(rho) * rho * (sie - Es(rho));
   }
@@ -98,16 +113,17 @@ class DavisReactants : public EosBase<DavisReactants> {
     EntropyIsNotEnabled("DavisReactants");
     return 1.0;
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real SpecificHeatFromDensityTemperature(
-      const Real rho, const Real temp,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> SpecificHeatFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temp,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return SpecificHeatFromDensityInternalEnergy(
         rho, InternalEnergyFromDensityTemperature(rho, temp));
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real SpecificHeatFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_real_t<Real_t, Real>
+  SpecificHeatFromDensityInternalEnergy(
+      const Real_t rho, const Real sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     const Real power_base = DimlessEdiff(rho, sie);
     if (power_base <= 0) {
@@ -116,26 +132,46 @@ class DavisReactants : public EosBase<DavisReactants> {
     }
     return _Cv0 / std::pow(power_base, -_alpha / (1 + _alpha));
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real BulkModulusFromDensityTemperature(
-      const Real rho, const Real temp,
+  template <typename Real_t, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+  SpecificHeatFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    const Real_t power_base = DimlessEdiff(rho, sie);
+    const auto imaginary = power_base <= Real_t(0.0);
+    const Real_t cv =
+        _Cv0 / simd_utils::pow(simd_utils::select(imaginary, Real_t(1.0), power_base),
+                               -_alpha / (1 + _alpha));
+    return simd_utils::select(imaginary, Real_t(0.0), cv);
+  }
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> BulkModulusFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temp,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return BulkModulusFromDensityInternalEnergy(
         rho, InternalEnergyFromDensityTemperature(rho, temp));
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real BulkModulusFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_real_t<Real_t, Real>
+  BulkModulusFromDensityInternalEnergy(
+      const Real_t rho, const Real sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real GruneisenParamFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+  BulkModulusFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  GruneisenParamFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return Gamma(rho);
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real GruneisenParamFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  GruneisenParamFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return Gamma(rho);
   }
@@ -179,11 +215,24 @@ class DavisReactants : public EosBase<DavisReactants> {
   // static constexpr const char _eos_type[] = "DavisReactants";
   static constexpr unsigned long _preferred_input =
       thermalqs::density | thermalqs::specific_internal_energy;
-  PORTABLE_FORCEINLINE_FUNCTION Real DimlessEdiff(const Real rho, const Real sie) const;
+  template <typename Real_t>
+  PORTABLE_FORCEINLINE_FUNCTION simd_utils::value_t<Real_t>
+  DimlessEdiff(const Real_t rho, const simd_utils::value_t<Real_t> sie) const;
+  // Branching helpers have a scalar overload and a masked overload for packs
   PORTABLE_INLINE_FUNCTION Real Ps(const Real rho) const;
+  template <typename Real_t>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+  Ps(const Real_t rho) const;
   PORTABLE_INLINE_FUNCTION Real Es(const Real rho) const;
-  PORTABLE_INLINE_FUNCTION Real Ts(const Real rho) const;
+  template <typename Real_t>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+  Es(const Real_t rho) const;
+  template <typename Real_t>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> Ts(const Real_t rho) const;
   PORTABLE_INLINE_FUNCTION Real Gamma(const Real rho) const;
+  template <typename Real_t>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+  Gamma(const Real_t rho) const;
 };
 
 class DavisProducts : public EosBase<DavisProducts> {
@@ -194,28 +243,30 @@ class DavisProducts : public EosBase<DavisProducts> {
                 const Real pc, const Real Cv)
       : _a(a), _b(b), _k(k), _n(n), _vc(vc), _pc(pc), _Cv(Cv) {}
   DavisProducts GetOnDevice() { return *this; }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real TemperatureFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  TemperatureFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return Ts(rho) + (sie - Es(rho)) / _Cv;
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real InternalEnergyFromDensityTemperature(
-      const Real rho, const Real temp,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  InternalEnergyFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temp,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return _Cv * (temp - Ts(rho)) + Es(rho);
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real PressureFromDensityTemperature(
-      const Real rho, const Real temp,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> PressureFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temp,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return PressureFromDensityInternalEnergy(
         rho, InternalEnergyFromDensityTemperature(rho, temp));
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real PressureFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> PressureFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return Ps(rho) + rho * Gamma(rho) * (sie - Es(rho));
   }
@@ -239,38 +290,47 @@ class DavisProducts : public EosBase<DavisProducts> {
     EntropyIsNotEnabled("DavisProducts");
     return 1.0;
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real SpecificHeatFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> SpecificHeatFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return _Cv;
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real SpecificHeatFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  SpecificHeatFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return _Cv;
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real BulkModulusFromDensityTemperature(
-      const Real rho, const Real temp,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> BulkModulusFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temp,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return BulkModulusFromDensityInternalEnergy(
         rho, InternalEnergyFromDensityTemperature(rho, temp));
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real BulkModulusFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_real_t<Real_t, Real>
+  BulkModulusFromDensityInternalEnergy(
+      const Real_t rho, const Real sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real GruneisenParamFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+  BulkModulusFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  GruneisenParamFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return Gamma(rho);
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real GruneisenParamFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  GruneisenParamFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return Gamma(rho);
   }
@@ -313,6 +373,12 @@ class DavisProducts : public EosBase<DavisProducts> {
   // static constexpr const char _eos_type[] = "DavisProducts";
   static constexpr const unsigned long _preferred_input =
       thermalqs::density | thermalqs::specific_internal_energy;
+  // (v/v_c)^x + (v/v_c)^-x, and its powers, appear throughout
+  template <typename Real_t>
+  PORTABLE_FORCEINLINE_FUNCTION simd_utils::value_t<Real_t>
+  HalfSum(const simd_utils::value_t<Real_t> vvc) const {
+    return 0.5 * (simd_utils::pow(vvc, _n) + simd_utils::pow(vvc, -_n));
+  }
   PORTABLE_INLINE_FUNCTION Real F(const Real rho) const {
     if (rho <= 0) {
       return 0.;
@@ -325,8 +391,8 @@ class DavisProducts : public EosBase<DavisProducts> {
       return 0.;
     }
     const Real vvc = 1 / (rho * _vc);
-    return _pc * std::pow(0.5 * (std::pow(vvc, _n) + std::pow(vvc, -_n)), _a / _n) /
-           std::pow(vvc, _k + _a) * (_k - 1.0 + F(rho)) / (_k - 1.0 + _a);
+    return _pc * std::pow(HalfSum<Real>(vvc), _a / _n) / std::pow(vvc, _k + _a) *
+           (_k - 1.0 + F(rho)) / (_k - 1.0 + _a);
   }
   PORTABLE_INLINE_FUNCTION Real Es(const Real rho) const {
     if (rho <= 0) {
@@ -335,8 +401,7 @@ class DavisProducts : public EosBase<DavisProducts> {
     const Real vvc = 1 / (rho * _vc);
     const Real ec = _pc * _vc / (_k - 1.0 + _a);
     // const Real de = ecj-(Es(rho0)-_E0);
-    return ec * std::pow(0.5 * (std::pow(vvc, _n) + std::pow(vvc, -_n)), _a / _n) /
-           std::pow(vvc, _k - 1.0 + _a);
+    return ec * std::pow(HalfSum<Real>(vvc), _a / _n) / std::pow(vvc, _k - 1.0 + _a);
   }
   PORTABLE_INLINE_FUNCTION Real Ts(const Real rho) const {
     if (rho <= 0) {
@@ -344,16 +409,61 @@ class DavisProducts : public EosBase<DavisProducts> {
     }
     const Real vvc = 1 / (rho * _vc);
     return std::pow(2.0, -_a * _b / _n) * _pc * _vc / (_Cv * (_k - 1 + _a)) *
-           std::pow(0.5 * (std::pow(vvc, _n) + std::pow(vvc, -_n)), _a / _n * (1 - _b)) /
+           std::pow(HalfSum<Real>(vvc), _a / _n * (1 - _b)) /
            std::pow(vvc, _k - 1.0 + _a * (1 - _b));
   }
-  PORTABLE_INLINE_FUNCTION Real Gamma(const Real rho) const {
+  // Pack overloads. Densities at or below zero are mapped to a positive
+  // placeholder so every lane stays finite. The corresponding results
+  // are set to zero.
+  template <typename Real_t>
+  PORTABLE_FORCEINLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+  Vvc(const Real_t rho) const {
+    return 1.0 / (simd_utils::select(rho <= Real_t(0.0), Real_t(1.0), rho) * _vc);
+  }
+  template <typename Real_t>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+  F(const Real_t rho) const {
+    const Real_t vvc = Vvc(rho);
+    return simd_utils::select(rho <= Real_t(0.0), Real_t(0.0),
+                              Real_t(2.0 * _a / (simd_utils::pow(vvc, 2 * _n) + 1.0)));
+  }
+  template <typename Real_t>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+  Ps(const Real_t rho) const {
+    const Real_t vvc = Vvc(rho);
+    const Real_t ps = _pc * simd_utils::pow(HalfSum<Real_t>(vvc), _a / _n) /
+                      simd_utils::pow(vvc, _k + _a) * (_k - 1.0 + F(rho)) /
+                      (_k - 1.0 + _a);
+    return simd_utils::select(rho <= Real_t(0.0), Real_t(0.0), ps);
+  }
+  template <typename Real_t>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+  Es(const Real_t rho) const {
+    const Real_t vvc = Vvc(rho);
+    const Real ec = _pc * _vc / (_k - 1.0 + _a);
+    const Real_t es = ec * simd_utils::pow(HalfSum<Real_t>(vvc), _a / _n) /
+                      simd_utils::pow(vvc, _k - 1.0 + _a);
+    return simd_utils::select(rho <= Real_t(0.0), Real_t(0.0), es);
+  }
+  template <typename Real_t>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+  Ts(const Real_t rho) const {
+    const Real_t vvc = Vvc(rho);
+    const Real_t ts = std::pow(2.0, -_a * _b / _n) * _pc * _vc / (_Cv * (_k - 1 + _a)) *
+                      simd_utils::pow(HalfSum<Real_t>(vvc), _a / _n * (1 - _b)) /
+                      simd_utils::pow(vvc, _k - 1.0 + _a * (1 - _b));
+    return simd_utils::select(rho <= Real_t(0.0), Real_t(0.0), ts);
+  }
+  template <typename Real_t>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> Gamma(const Real_t rho) const {
     return _k - 1.0 + (1.0 - _b) * F(rho);
   }
 };
 
-PORTABLE_FORCEINLINE_FUNCTION Real DavisReactants::DimlessEdiff(const Real rho,
-                                                                const Real sie) const {
+template <typename Real_t>
+PORTABLE_FORCEINLINE_FUNCTION simd_utils::value_t<Real_t>
+DavisReactants::DimlessEdiff(const Real_t rho,
+                             const simd_utils::value_t<Real_t> sie) const {
   return (1.0 + _alpha) / (Ts(rho) * _Cv0) * (sie - Es(rho)) + 1.0;
 }
 
@@ -372,6 +482,22 @@ PORTABLE_INLINE_FUNCTION Real DavisReactants::Ps(const Real rho) const {
     return phat * (std::exp(b4y) - 1.0);
   }
 }
+template <typename Real_t>
+PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+DavisReactants::Ps(const Real_t rho) const {
+  using R = Real_t;
+  using simd_utils::pow;
+  const R y = 1.0 - simd_utils::ratio<R>(_rho0, simd_utils::max<R>(rho, 0.));
+  const Real phat = 0.25 * _A * _A / _B * _rho0;
+  const R b4y = 4.0 * _B * y;
+
+  const R p_compressed =
+      phat *
+      (b4y + 0.5 * (pow<2>(b4y) + onethird * (pow<3>(b4y) + _C * pow<4>(b4y) * 0.25)) +
+       pow<2>(y) / pow<4>(R(1 - y)));
+  const R p_expanded = phat * (simd_utils::exp(b4y) - 1.0);
+  return simd_utils::select(R(rho) >= R(_rho0), p_compressed, p_expanded);
+}
 PORTABLE_INLINE_FUNCTION Real DavisReactants::Es(const Real rho) const {
   const Real y = 1 - robust::ratio(_rho0, std::max(rho, 0.));
   const Real phat = 0.25 * _A * _A / _B * _rho0;
@@ -388,10 +514,31 @@ PORTABLE_INLINE_FUNCTION Real DavisReactants::Es(const Real rho) const {
   return _e0 + _P0 * (1.0 / _rho0 - robust::ratio(1.0, std::max(rho, 0.))) +
          phat / _rho0 * e_s;
 }
-PORTABLE_INLINE_FUNCTION Real DavisReactants::Ts(const Real rho) const {
-  const Real rho0overrho = robust::ratio(_rho0, std::max(rho, 0.));
-  const Real y = 1 - rho0overrho;
-  return _T0 * std::exp(-_Z * y) * std::pow(rho0overrho, -_G0 - _Z);
+template <typename Real_t>
+PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+DavisReactants::Es(const Real_t rho) const {
+  using R = Real_t;
+  const R y = 1 - simd_utils::ratio<R>(_rho0, simd_utils::max<R>(rho, 0.));
+  const Real phat = 0.25 * _A * _A / _B * _rho0;
+  const R b4y = 4 * _B * y;
+  const R z = rho / _rho0 - 1;
+  const R e_compressed =
+      0.5 * y * b4y *
+          (1.0 + onethird * b4y * (1.0 + 0.25 * b4y * (1.0 + _C * 0.2 * b4y))) +
+      onethird * simd_utils::pow<3>(z);
+  const R e_expanded = -y - (1.0 - simd_utils::exp(b4y)) / (4.0 * _B);
+  const R e_s = simd_utils::select(y > R(0.0), e_compressed, e_expanded);
+  const R rho_pos = simd_utils::max<R>(rho, 0.);
+  return _e0 + _P0 * (1.0 / _rho0 - simd_utils::ratio<R>(1.0, rho_pos)) +
+         phat / _rho0 * e_s;
+}
+template <typename Real_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+DavisReactants::Ts(const Real_t rho) const {
+  using R = simd_utils::value_t<Real_t>;
+  const R rho0overrho = simd_utils::ratio<R>(_rho0, simd_utils::max<R>(rho, 0.));
+  const R y = 1 - rho0overrho;
+  return _T0 * simd_utils::exp(R(-_Z * y)) * simd_utils::pow(rho0overrho, -_G0 - _Z);
 }
 PORTABLE_INLINE_FUNCTION Real DavisReactants::Gamma(const Real rho) const {
   if (rho >= _rho0) {
@@ -401,11 +548,21 @@ PORTABLE_INLINE_FUNCTION Real DavisReactants::Gamma(const Real rho) const {
     return _G0;
   }
 }
+template <typename Real_t>
+PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+DavisReactants::Gamma(const Real_t rho) const {
+  using R = Real_t;
+  const R y = 1 - simd_utils::ratio<R>(_rho0, simd_utils::max<R>(rho, 0.));
+  return simd_utils::select(R(rho) >= R(_rho0), R(_G0 + _Z * y), R(_G0));
+}
 
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real DavisReactants::BulkModulusFromDensityInternalEnergy(
-    const Real rho, const Real sie, Indexer_t &&lambda) const {
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::enable_if_real_t<Real_t, Real>
+DavisReactants::BulkModulusFromDensityInternalEnergy(const Real_t rho_in,
+                                                     const Real sie,
+                                                     Indexer_t &&lambda) const {
   using namespace math_utils;
+  const Real rho = rho_in;
   const Real y = 1 - robust::ratio(_rho0, std::max(rho, 0.));
   const Real phat = 0.25 * _A * _A / _B * _rho0;
   const Real b4y = 4 * _B * y;
@@ -423,6 +580,30 @@ PORTABLE_INLINE_FUNCTION Real DavisReactants::BulkModulusFromDensityInternalEner
         gamma * std::max(rho, 0.) * esv);
   return robust::ratio(numerator, std::max(rho, 0.));
 }
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+DavisReactants::BulkModulusFromDensityInternalEnergy(
+    const Real_t rho, const simd_utils::value_t<Real_t> sie, Indexer_t &&lambda) const {
+  using R = Real_t;
+  using simd_utils::pow;
+  const R rho_pos = simd_utils::max<R>(rho, 0.);
+  const R y = 1 - simd_utils::ratio<R>(_rho0, rho_pos);
+  const Real phat = 0.25 * _A * _A / _B * _rho0;
+  const R b4y = 4 * _B * y;
+  const R gamma = Gamma(rho_pos);
+  const R esv = -Ps(rho_pos);
+  const auto compressed = rho >= R(_rho0);
+  const R psv_compressed =
+      -phat * _rho0 *
+      (4 * _B * (1 + b4y + 0.5 * (pow<2>(b4y) + _C / 3 * pow<3>(b4y))) +
+       3 * y / pow<4>(R(1 - y)) + 4 * pow<2>(y) / pow<5>(R(1 - y)));
+  const R psv_expanded = -phat * 4 * _B * _rho0 * simd_utils::exp(b4y);
+  const R psv = simd_utils::select(compressed, psv_compressed, psv_expanded);
+  const R gammav = simd_utils::select(compressed, R(_Z * _rho0), R(0.0));
+  const R numerator = -(psv + (sie - Es(rho)) * rho_pos * (gammav - gamma * rho_pos) -
+                        gamma * rho_pos * esv);
+  return simd_utils::ratio<R>(numerator, rho_pos);
+}
 
 template <typename Indexer_t>
 PORTABLE_INLINE_FUNCTION void DavisReactants::DensityEnergyFromPressureTemperature(
@@ -483,22 +664,23 @@ DavisReactants::ValuesAtReferenceState(Real &rho, Real &temp, Real &sie, Real &p
   dvdt = gm1 * cv / bmod;
 }
 
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real DavisProducts::BulkModulusFromDensityInternalEnergy(
-    const Real rho, const Real sie, Indexer_t &&lambda) const {
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::enable_if_real_t<Real_t, Real>
+DavisProducts::BulkModulusFromDensityInternalEnergy(const Real_t rho_in,
+                                                    const Real sie,
+                                                    Indexer_t &&lambda) const {
   using namespace math_utils;
+  const Real rho = rho_in;
   if (rho <= 0) {
     return 0.;
   }
   const Real vvc = 1 / (rho * _vc);
   const Real Fx = -4 * _a * std::pow(vvc, 2 * _n - 1) / pow<2>(1 + std::pow(vvc, 2 * _n));
-  const Real tmp = std::pow(0.5 * (std::pow(vvc, _n) + std::pow(vvc, -_n)), _a / _n) /
-                   std::pow(vvc, _k + _a);
-  const Real tmp_x =
-      0.5 * _a * (std::pow(vvc, _n - 1) - std::pow(vvc, -_n - 1)) *
-          std::pow(0.5 * (std::pow(vvc, _n) + std::pow(vvc, -_n)), _a / _n - 1) /
-          std::pow(vvc, _k + _a) -
-      (_k + _a) * tmp / vvc;
+  const Real tmp = std::pow(HalfSum<Real>(vvc), _a / _n) / std::pow(vvc, _k + _a);
+  const Real tmp_x = 0.5 * _a * (std::pow(vvc, _n - 1) - std::pow(vvc, -_n - 1)) *
+                         std::pow(HalfSum<Real>(vvc), _a / _n - 1) /
+                         std::pow(vvc, _k + _a) -
+                     (_k + _a) * tmp / vvc;
   const Real psv = _pc / (_k - 1 + _a) * (tmp * Fx + (_k - 1 + F(rho)) * tmp_x) / _vc;
   // const Real esv = _pc*_vc/(_k-1+_a)*(tmp+vvc*tmp_x)/_vc;
   const Real esv = _pc / (_k - 1 + _a) * (tmp + vvc * tmp_x);
@@ -507,6 +689,27 @@ PORTABLE_INLINE_FUNCTION Real DavisProducts::BulkModulusFromDensityInternalEnerg
   return -(psv + (sie - Es(rho)) * rho * (gammav - gamma * rho) - gamma * rho * esv) /
          rho;
 }
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+DavisProducts::BulkModulusFromDensityInternalEnergy(
+    const Real_t rho, const simd_utils::value_t<Real_t> sie, Indexer_t &&lambda) const {
+  using R = Real_t;
+  using simd_utils::pow;
+  const R vvc = Vvc(rho);
+  const R Fx = -4 * _a * pow(vvc, 2 * _n - 1) / pow<2>(R(1 + pow(vvc, 2 * _n)));
+  const R tmp = pow(HalfSum<R>(vvc), _a / _n) / pow(vvc, _k + _a);
+  const R tmp_x = 0.5 * _a * (pow(vvc, _n - 1) - pow(vvc, -_n - 1)) *
+                      pow(HalfSum<R>(vvc), _a / _n - 1) / pow(vvc, _k + _a) -
+                  (_k + _a) * tmp / vvc;
+  const R psv = _pc / (_k - 1 + _a) * (tmp * Fx + (_k - 1 + F(rho)) * tmp_x) / _vc;
+  // const Real esv = _pc*_vc/(_k-1+_a)*(tmp+vvc*tmp_x)/_vc;
+  const R esv = _pc / (_k - 1 + _a) * (tmp + vvc * tmp_x);
+  const R gamma = Gamma(rho);
+  const R gammav = (1 - _b) * Fx * _vc;
+  const R bmod =
+      -(psv + (sie - Es(rho)) * rho * (gammav - gamma * rho) - gamma * rho * esv) / rho;
+  return simd_utils::select(rho <= R(0.0), R(0.0), bmod);
+}
 template <typename Indexer_t>
 PORTABLE_INLINE_FUNCTION void DavisProducts::DensityEnergyFromPressureTemperature(
     const Real press, const Real temp, Indexer_t &&lambda, Real &rho, Real &sie) const {
@@ -24,6 +24,7 @@
 #include <singularity-eos/base/math_utils.hpp>
 #include <singularity-eos/base/robust_utils.hpp>
 #include <singularity-eos/base/root-finding-1d/root_finding.hpp>
+#include <singularity-eos/base/simd_utils.hpp>
 #include <singularity-eos/eos/eos_base.hpp>
 
 namespace singularity {
@@ -64,25 +65,33 @@ class Gruneisen : public EosBase<Gruneisen> {
   static PORTABLE_INLINE_FUNCTION Real ComputeRhoMax(const Real s1, const Real s2,
                                                      const Real s3, const Real rho0);
   Gruneisen GetOnDevice() { return *this; }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real TemperatureFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  TemperatureFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return _T0 + sie / _Cv;
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real InternalEnergyFromDensityTemperature(
-      const Real rho, const Real temp,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  InternalEnergyFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temp,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return _Cv * (temp - _T0);
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real
-  PressureFromDensityTemperature(const Real rho, const Real temperature,
-                                 Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real PressureFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> PressureFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_real_t<Real_t, Real>
+  PressureFromDensityInternalEnergy(
+      const Real_t rho, const Real sie,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
+  template <typename Real_t, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+  PressureFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
   template <typename Indexer_t = Real *>
   PORTABLE_INLINE_FUNCTION Real MinInternalEnergyFromDensity(
@@ -95,37 +104,46 @@ class Gruneisen : public EosBase<Gruneisen> {
   PORTABLE_INLINE_FUNCTION Real EntropyFromDensityInternalEnergy(
       const Real rho, const Real sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real SpecificHeatFromDensityTemperature(
-      const Real rho, const Real temperatummmmmmre,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> SpecificHeatFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperatummmmmmre,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return _Cv;
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real SpecificHeatFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  SpecificHeatFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return _Cv;
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real BulkModulusFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> BulkModulusFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real BulkModulusFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_real_t<Real_t, Real>
+  BulkModulusFromDensityInternalEnergy(
+      const Real_t rho, const Real sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real GruneisenParamFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+  BulkModulusFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  GruneisenParamFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return Gamma(std::min(rho, _rho_max));
+    return Gamma(rho);
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real GruneisenParamFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  GruneisenParamFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return Gamma(std::min(rho, _rho_max));
+    return Gamma(rho);
   }
   template <typename Indexer_t = Real *>
   PORTABLE_INLINE_FUNCTION void
@@ -153,6 +171,8 @@ class Gruneisen : public EosBase<Gruneisen> {
            "rho_max:%e\n",
            s1, _C0, _s1, _s2, _s3, _G0, _b, _rho0, _T0, _P0, _Cv, _rho_max);
   }
+  // Lookups clamp the density to rho_max
+  PORTABLE_FORCEINLINE_FUNCTION Real MaximumDensity() const { return _rho_max; }
   template <typename Indexer_t>
   PORTABLE_INLINE_FUNCTION void
   DensityEnergyFromPressureTemperature(const Real press, const Real temp,
@@ -164,13 +184,24 @@ class Gruneisen : public EosBase<Gruneisen> {
  private:
   Real _C0, _s1, _s2, _s3, _G0, _b, _rho0, _T0, _P0, _Cv, _rho_max;
   // static constexpr const char _eos_type[] = {"Gruneisen"};
+  // Branching helpers have a scalar overload and a masked overload for packs
   PORTABLE_INLINE_FUNCTION
   Real Gamma(const Real rho_in) const {
     const Real rho = std::min(rho_in, _rho_max);
     return rho < _rho0 ? _G0 : _G0 * _rho0 / rho + _b * (1 - _rho0 / rho);
   }
+  template <typename Real_t>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+  Gamma(const Real_t rho_in) const {
+    const Real_t rho = simd_utils::min<Real_t>(rho_in, _rho_max);
+    return simd_utils::select(rho < Real_t(_rho0), Real_t(_G0),
+                              Real_t(_G0 * _rho0 / rho + _b * (1 - _rho0 / rho)));
+  }
   PORTABLE_INLINE_FUNCTION
   Real dPres_drho_e(const Real rho, const Real sie) const;
+  template <typename Real_t>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+  dPres_drho_e(const Real_t rho, const Real_t sie) const;
   static constexpr const unsigned long _preferred_input =
       thermalqs::density | thermalqs::specific_internal_energy;
   // Scaling factor for density singularity (reference pressure blows up). Consistent with
@@ -325,12 +356,34 @@ PORTABLE_INLINE_FUNCTION Real Gruneisen::dPres_drho_e(const Real rho_in,
            rho * Gamma(rho) * dE_H;
   }
 }
+template <typename Real_t>
+PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+Gruneisen::dPres_drho_e(const Real_t rho_in, const Real_t sie) const {
+  using R = Real_t;
+  using simd_utils::pow;
+  const R rho = simd_utils::min<R>(rho_in, _rho_max);
+  const R dP_expanded = math_utils::pow<2>(_C0) + Gamma(rho) * sie;
+  const R eta = 1 - _rho0 / rho;
+  const R s = _s1 * eta + _s2 * pow<2>(eta) + _s3 * pow<3>(eta);
+  const R ds = _s1 + 2 * _s2 * eta + 3 * _s3 * pow<2>(eta);
+  const R deta = _rho0 / pow<2>(rho);
+  const R dGam = (_b - _G0) * deta;
+  const R P_H = _P0 + math_utils::pow<2>(_C0) * _rho0 * eta / pow<2>(R(1 - s));
+  const R dP_H = math_utils::pow<2>(_C0) * _rho0 / pow<2>(R(1 - s)) * deta *
+                 (1 + 2 * eta * ds / (1 - s));
+  const R E_H = (P_H + _P0) * eta / _rho0 / 2.;
+  const R dE_H = deta * (P_H + _P0) / _rho0 / 2. + eta / _rho0 / 2 * dP_H;
+  const R dP_compressed = dP_H + Gamma(rho) * (sie - E_H) + rho * dGam * (sie - E_H) -
+                          rho * Gamma(rho) * dE_H;
+  return simd_utils::select(rho < R(_rho0), dP_expanded, dP_compressed);
+}
 
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real Gruneisen::PressureFromDensityInternalEnergy(
-    const Real rho_in, const Real sie, Indexer_t &&lambda) const {
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::enable_if_real_t<Real_t, Real>
+Gruneisen::PressureFromDensityInternalEnergy(const Real_t rho_in, const Real sie,
+                                             Indexer_t &&lambda) const {
   using namespace math_utils;
-  const Real rho = std::min(rho_in, _rho_max);
+  const Real rho = std::min<Real>(rho_in, _rho_max);
   Real P_H;
   Real E_H;
   if (rho >= _rho0) {
@@ -345,6 +398,24 @@ PORTABLE_INLINE_FUNCTION Real Gruneisen::PressureFromDensityInternalEnergy(
   }
   return P_H + Gamma(rho) * rho * (sie - E_H);
 }
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+Gruneisen::PressureFromDensityInternalEnergy(const Real_t rho_in,
+                                             const simd_utils::value_t<Real_t> sie,
+                                             Indexer_t &&lambda) const {
+  using R = Real_t;
+  using simd_utils::pow;
+  const R rho = simd_utils::min<R>(rho_in, _rho_max);
+  const auto compressed = rho >= R(_rho0);
+  const R eta = 1 - _rho0 / rho;
+  const R s = _s1 * eta + _s2 * pow<2>(eta) + _s3 * pow<3>(eta);
+  // The expanded branch isn't thermodynamically consistent but it's widely used
+  const R P_H = simd_utils::select(
+      compressed, R(_P0 + math_utils::pow<2>(_C0) * _rho0 * eta / pow<2>(R(1 - s))),
+      R(_P0 + math_utils::pow<2>(_C0) * (rho - _rho0)));
+  const R E_H = simd_utils::select(compressed, R((P_H + _P0) * eta / _rho0 / 2.), R(0.));
+  return P_H + Gamma(rho) * rho * (sie - E_H);
+}
 template <typename Indexer_t>
 PORTABLE_INLINE_FUNCTION Real
 Gruneisen::MinInternalEnergyFromDensity(const Real rho_in, Indexer_t &&lambda) const {
@@ -359,11 +430,11 @@ PORTABLE_INLINE_FUNCTION Real Gruneisen::EntropyFromDensityInternalEnergy(
   EntropyIsNotEnabled("Gruneisen");
   return 1.0;
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real Gruneisen::BulkModulusFromDensityInternalEnergy(
-    const Real rho_in, const Real sie, Indexer_t &&lambda) const {
-  using namespace gruneisen_utils;
-  const Real rho = std::min(rho_in, _rho_max);
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::enable_if_real_t<Real_t, Real>
+Gruneisen::BulkModulusFromDensityInternalEnergy(const Real_t rho_in, const Real sie,
+                                                Indexer_t &&lambda) const {
+  const Real rho = std::min<Real>(rho_in, _rho_max);
   // The if statement exists here to avoid the divide by zero
   if (rho < _rho0) {
     return rho * math_utils::pow<2>(_C0) +
@@ -375,11 +446,30 @@ PORTABLE_INLINE_FUNCTION Real Gruneisen::BulkModulusFromDensityInternalEnergy(
     return rho * dPdr_e + PressureFromDensityInternalEnergy(rho, sie) / rho * dPde_r;
   }
 }
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+Gruneisen::BulkModulusFromDensityInternalEnergy(const Real_t rho_in,
+                                                const simd_utils::value_t<Real_t> sie,
+                                                Indexer_t &&lambda) const {
+  using R = Real_t;
+  const R rho = simd_utils::min<R>(rho_in, _rho_max);
+  const R P = PressureFromDensityInternalEnergy(rho, sie);
+  // The expanded branch avoids the divide by zero in dPres_drho_e
+  const R bmod_expanded = rho * math_utils::pow<2>(_C0) + _G0 * (rho * sie + P);
+  const R dPdr_e = dPres_drho_e(rho, sie);
+  const R dPde_r = rho * Gamma(rho);
+  // Thermodynamic identity
+  const R bmod_compressed = rho * dPdr_e + P / rho * dPde_r;
+  return simd_utils::select(rho < R(_rho0), bmod_expanded, bmod_compressed);
+}
 // Below are "unimplemented" routines
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real Gruneisen::PressureFromDensityTemperature(
-    const Real rho_in, const Real temp, Indexer_t &&lambda) const {
-  const Real rho = std::min(rho_in, _rho_max);
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+Gruneisen::PressureFromDensityTemperature(const Real_t rho_in,
+                                          const simd_utils::value_t<Real_t> temp,
+                                          Indexer_t &&lambda) const {
+  using R = simd_utils::value_t<Real_t>;
+  const R rho = simd_utils::min<R>(rho_in, _rho_max);
   return PressureFromDensityInternalEnergy(
       rho, InternalEnergyFromDensityTemperature(rho, temp));
 }
@@ -390,10 +480,13 @@ PORTABLE_INLINE_FUNCTION Real Gruneisen::EntropyFromDensityTemperature(
   const Real sie = InternalEnergyFromDensityTemperature(rho, temp);
   return EntropyFromDensityInternalEnergy(rho, sie);
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real Gruneisen::BulkModulusFromDensityTemperature(
-    const Real rho_in, const Real temp, Indexer_t &&lambda) const {
-  const Real rho = std::min(rho_in, _rho_max);
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+Gruneisen::BulkModulusFromDensityTemperature(const Real_t rho_in,
+                                             const simd_utils::value_t<Real_t> temp,
+                                             Indexer_t &&lambda) const {
+  using R = simd_utils::value_t<Real_t>;
+  const R rho = simd_utils::min<R>(rho_in, _rho_max);
   return BulkModulusFromDensityInternalEnergy(
       rho, InternalEnergyFromDensityTemperature(rho, temp));
 }
@@ -40,11 +40,15 @@
 #include <ports-of-call/portable_errors.hpp>
 
 // singularity-eos
+#include <singularity-eos/base/accuracy.hpp>
 #include <singularity-eos/base/constants.hpp>
 #include <singularity-eos/base/hermite.hpp>
 #include <singularity-eos/base/math_utils.hpp>
 #include <singularity-eos/base/robust_utils.hpp>
 #include <singularity-eos/base/root-finding-1d/root_finding.hpp>
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+#include <singularity-eos/base/table_heatmap.hpp>
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
 #include <singularity-eos/eos/eos_base.hpp>
 
 // spiner
@@ -213,6 +217,15 @@ class HelmElectrons {
 
   inline HelmElectrons GetOnDevice();
   inline void Finalize();
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+  inline void SetHeatmap(TableHeatmap *heatmap) {
+    heatmap_ = heatmap;
+    if (heatmap_ != nullptr) {
+      heatmapGrid_ = heatmap_->AddGrid("electrons_rhoYe_T", "log(rho Ye)", lRhoMin_,
+                                       lRhoMax_, NRHO, "log(T)", lTMin_, lTMax_, NTEMP);
+    }
+  }
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
 
   PORTABLE_INLINE_FUNCTION
   void GetFromDensityTemperature(Real rho, Real lT, Real Ye, Real Ytot, Real De, Real lDe,
@@ -259,6 +272,11 @@ class HelmElectrons {
   // number density
   DataBox xf_, xfd_, xft_, xfdt_;
 
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+  TableHeatmap *heatmap_ = nullptr;
+  int heatmapGrid_ = 0;
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+
   static constexpr std::size_t NTEMP = 101;
   static constexpr std::size_t NRHO = 271;
 
@@ -443,8 +461,19 @@ class Helmholtz : public EosBase<Helmholtz> {
     other.coul_ = coul_.GetOnDevice();
     other.electrons_ = electrons_.GetOnDevice();
     other.options_ = options_;
+    other.accuracy_ = accuracy_;
     return other;
   }
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+  // Counts the cells of the electron table visited by lookups into
+  // heatmap, which must outlive this object and its copies. Pass
+  // nullptr to stop. See table_heatmap.hpp.
+  inline void SetHeatmap(TableHeatmap *heatmap) { electrons_.SetHeatmap(heatmap); }
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+  // Tolerances and iteration limits of the temperature inversion. See accuracy.hpp.
+  inline void SetAccuracy(const AccuracyParams &params) { accuracy_ = params; }
+  PORTABLE_INLINE_FUNCTION
+  AccuracyParams GetAccuracy() const { return accuracy_; }
   inline void Finalize() {
     rad_.Finalize();
     ions_.Finalize();
@@ -705,7 +734,7 @@ class Helmholtz : public EosBase<Helmholtz> {
                                               const Real ywot, const Real De,
                                               const Real lDe, Indexer_t &&lambda) const;
 
-  static constexpr Real ROOT_THRESH = 1e-14;
+  AccuracyParams accuracy_;
   static constexpr Real HELM_EOS_EPS = 1e-10;
   Options options_;
   HelmRad rad_;
@@ -797,7 +826,7 @@ PORTABLE_INLINE_FUNCTION Real Helmholtz::lTFromRhoSie_(const Real rho, const Rea
           },
           e, Tguess, math_utils::pow10(electrons_.lTMin()),
           math_utils::pow10(electrons_.lTMax()), HELM_EOS_EPS, T, nullptr,
-          options_.VERBOSE, false);
+          options_.VERBOSE, false, accuracy_.newton_max_iter);
       if (status != RootFinding1D::Status::SUCCESS) {
         if (options_.VERBOSE) {
           printf("Newton-Raphson failed to converge, falling back to regula falsi\n");
@@ -810,8 +839,8 @@ PORTABLE_INLINE_FUNCTION Real Helmholtz::lTFromRhoSie_(const Real rho, const Rea
               return e[VAL];
             },
             e, Tguess, math_utils::pow10(electrons_.lTMin()),
-            math_utils::pow10(electrons_.lTMax()), ROOT_THRESH, ROOT_THRESH, T, nullptr,
-            options_.VERBOSE);
+            math_utils::pow10(electrons_.lTMax()), accuracy_.root_thresh,
+            accuracy_.root_thresh, T, nullptr, options_.VERBOSE, accuracy_.root_max_iter);
         if (status != RootFinding1D::Status::SUCCESS) {
           lT = lTAnalytic_(rho, e, ni, options_.GAS_IONIZED * ne);
           T = math_utils::pow10(lT);
@@ -826,8 +855,8 @@ PORTABLE_INLINE_FUNCTION Real Helmholtz::lTFromRhoSie_(const Real rho, const Rea
             return e[VAL];
           },
           e, Tguess, math_utils::pow10(electrons_.lTMin()),
-          math_utils::pow10(electrons_.lTMax()), ROOT_THRESH, ROOT_THRESH, T, nullptr,
-          options_.VERBOSE);
+          math_utils::pow10(electrons_.lTMax()), accuracy_.root_thresh,
+          accuracy_.root_thresh, T, nullptr, options_.VERBOSE, accuracy_.root_max_iter);
       if (status != RootFinding1D::Status::SUCCESS) {
         lT = lTAnalytic_(rho, e, ni, options_.GAS_IONIZED * ne);
         T = math_utils::pow10(lT);
@@ -908,6 +937,10 @@ inline HelmElectrons HelmElectrons::GetOnDevice() {
   other.xfd_ = Spiner::getOnDeviceDataBox(xfd_);
   other.xft_ = Spiner::getOnDeviceDataBox(xft_);
   other.xfdt_ = Spiner::getOnDeviceDataBox(xfdt_);
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+  other.heatmap_ = heatmap_;
+  other.heatmapGrid_ = heatmapGrid_;
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
   return other;
 }
 
@@ -944,6 +977,14 @@ void HelmElectrons::GetFromDensityTemperature(Real rho, Real lT, Real Ye, Real Y
                                               Real eele[NDERIV], Real sele[NDERIV],
                                               Real etaele[NDERIV], Real xne[NDERIV],
                                               bool only_e) const {
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+  if (heatmap_ != nullptr) {
+    const TableStatus whereAmI = (lT < lTMin_)   ? TableStatus::OffBottom
+                                 : (lT > lTMax_) ? TableStatus::OffTop
+                                                 : TableStatus::OnTable;
+    heatmap_->Record(heatmapGrid_, lDe, lT, whereAmI);
+  }
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
   // Bound lRho, lT
   rho = std::min(rhoMax(), std::max(rhoMin(), rho));
   De = std::min(rhoMax(), std::max(rhoMin(), De));
@@ -27,6 +27,7 @@
 #include <singularity-eos/base/constants.hpp>
 #include <singularity-eos/base/eos_error.hpp>
 #include <singularity-eos/base/robust_utils.hpp>
+#include <singularity-eos/base/simd_utils.hpp>
 #include <singularity-eos/eos/eos_base.hpp>
 
 #define MYMAX(a, b) a > b ? a : b
@@ -52,11 +53,13 @@ class IdealGas : public EosBase<IdealGas> {
   }
 
   IdealGas GetOnDevice() { return *this; }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real TemperatureFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  TemperatureFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return MYMAX(0.0, sie / _Cv);
+    using R = simd_utils::value_t<Real_t>;
+    return simd_utils::max<R>(sie / _Cv, 0.0);
   }
   PORTABLE_INLINE_FUNCTION void checkParams() const {
     // Portable_require seems to do the opposite of what it should. Conditions
@@ -68,23 +71,27 @@ class IdealGas : public EosBase<IdealGas> {
     PORTABLE_ALWAYS_REQUIRE(_EntropyRho0 >= 0,
                             "Entropy reference density must be positive");
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real InternalEnergyFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  InternalEnergyFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return MYMAX(0.0, _Cv * temperature);
+    using R = simd_utils::value_t<Real_t>;
+    return simd_utils::max<R>(_Cv * temperature, 0.0);
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real PressureFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> PressureFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return MYMAX(0.0, _gm1 * rho * _Cv * temperature);
+    using R = simd_utils::value_t<Real_t>;
+    return simd_utils::max<R>(_gm1 * rho * _Cv * temperature, 0.0);
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real PressureFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> PressureFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return MYMAX(0.0, _gm1 * rho * sie);
+    using R = simd_utils::value_t<Real_t>;
+    return simd_utils::max<R>(_gm1 * rho * sie, 0.0);
   }
   template <typename Indexer_t = Real *>
   PORTABLE_INLINE_FUNCTION Real MinInternalEnergyFromDensity(
@@ -92,53 +99,61 @@ class IdealGas : public EosBase<IdealGas> {
     return 0.0;
   };
 
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real
-  EntropyFromDensityTemperature(const Real rho, const Real temperature,
-                                Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return _Cv * log(robust::ratio(temperature, _EntropyT0)) +
-           _gm1 * _Cv * log(robust::ratio(_EntropyRho0, rho));
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> EntropyFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    using R = simd_utils::value_t<Real_t>;
+    return _Cv * simd_utils::log(simd_utils::ratio<R>(temperature, _EntropyT0)) +
+           _gm1 * _Cv * simd_utils::log(simd_utils::ratio<R>(_EntropyRho0, rho));
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real EntropyFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> EntropyFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    const Real temp = TemperatureFromDensityInternalEnergy(rho, sie, lambda);
+    using R = simd_utils::value_t<Real_t>;
+    const R temp = TemperatureFromDensityInternalEnergy(rho, sie, lambda);
     return EntropyFromDensityTemperature(rho, temp, lambda);
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real SpecificHeatFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> SpecificHeatFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return _Cv;
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real SpecificHeatFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  SpecificHeatFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return _Cv;
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real BulkModulusFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> BulkModulusFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return MYMAX(0.0, (_gm1 + 1) * _gm1 * rho * _Cv * temperature);
+    using R = simd_utils::value_t<Real_t>;
+    return simd_utils::max<R>((_gm1 + 1) * _gm1 * rho * _Cv * temperature, 0.0);
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real BulkModulusFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  BulkModulusFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return MYMAX(0.0, (_gm1 + 1) * _gm1 * rho * sie);
+    using R = simd_utils::value_t<Real_t>;
+    return simd_utils::max<R>((_gm1 + 1) * _gm1 * rho * sie, 0.0);
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real GruneisenParamFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  GruneisenParamFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return _gm1;
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real GruneisenParamFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  GruneisenParamFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return _gm1;
   }
@@ -182,6 +197,43 @@ class IdealGas : public EosBase<IdealGas> {
     sie = MYMAX(0.0, _Cv * temp);
     rho = MYMAX(0.0, press / (_gm1 * sie));
   }
+  // Closed forms of the inversions used by InvertState
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION Real TemperatureFromDensityPressure(
+      const Real rho, const Real press,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    return MYMAX(0.0, press / (_gm1 * rho * _Cv));
+  }
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION Real DensityFromPressureInternalEnergy(
+      const Real press, const Real sie,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    return MYMAX(0.0, press / (_gm1 * sie));
+  }
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION Real TemperatureFromDensityEntropy(
+      const Real rho, const Real entropy,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    return _EntropyT0 * std::exp(entropy / _Cv) * std::pow(rho / _EntropyRho0, _gm1);
+  }
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION ThermoDerivatives DerivativesFromDensityInternalEnergy(
+      const Real rho, const Real sie,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    ThermoDerivatives d;
+    d.dPdRho = _gm1 * std::max(sie, 0.0);
+    d.dPdE = _gm1 * rho;
+    d.dTdE = 1.0 / _Cv;
+    d.cv = _Cv;
+    d.gruneisen = _gm1;
+    return d;
+  }
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION ThermoDerivatives DerivativesFromDensityTemperature(
+      const Real rho, const Real temperature,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    return DerivativesFromDensityInternalEnergy(rho, _Cv * temperature, lambda);
+  }
   inline void Finalize() {}
   static std::string EosType() { return std::string("IdealGas"); }
   static std::string EosPyType() { return EosType(); }
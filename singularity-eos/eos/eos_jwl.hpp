@@ -28,6 +28,7 @@
 #include <singularity-eos/base/constants.hpp>
 #include <singularity-eos/base/eos_error.hpp>
 #include <singularity-eos/base/root-finding-1d/root_finding.hpp>
+#include <singularity-eos/base/simd_utils.hpp>
 #include <singularity-eos/eos/eos_base.hpp>
 
 namespace singularity {
@@ -50,21 +51,23 @@ class JWL : public EosBase<JWL> {
     assert(Cv > 0.0);
   }
   JWL GetOnDevice() { return *this; }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real TemperatureFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  TemperatureFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real InternalEnergyFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  InternalEnergyFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real
-  PressureFromDensityTemperature(const Real rho, const Real temperature,
-                                 Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real PressureFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> PressureFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> PressureFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
   template <typename Indexer_t = Real *>
   PORTABLE_INLINE_FUNCTION Real MinInternalEnergyFromDensity(
@@ -77,29 +80,33 @@ class JWL : public EosBase<JWL> {
   PORTABLE_INLINE_FUNCTION Real EntropyFromDensityInternalEnergy(
       const Real rho, const Real sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real SpecificHeatFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> SpecificHeatFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real SpecificHeatFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  SpecificHeatFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real BulkModulusFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> BulkModulusFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real BulkModulusFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  BulkModulusFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real GruneisenParamFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  GruneisenParamFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real GruneisenParamFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  GruneisenParamFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
   template <typename Indexer_t = Real *>
   PORTABLE_INLINE_FUNCTION void
@@ -136,29 +143,43 @@ class JWL : public EosBase<JWL> {
 
  private:
   Real _A, _B, _R1, _R2, _w, _rho0, _Cv, _c1, _c2;
-  PORTABLE_INLINE_FUNCTION Real ReferenceEnergy(const Real rho) const;
-  PORTABLE_INLINE_FUNCTION Real ReferencePressure(const Real rho) const;
+  template <typename Real_t>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  ReferenceEnergy(const Real_t rho) const;
+  template <typename Real_t>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  ReferencePressure(const Real_t rho) const;
   // static constexpr const char _eos_type[] = "JWL";
   static constexpr const unsigned long _preferred_input =
       thermalqs::density | thermalqs::specific_internal_energy;
 };
 
-PORTABLE_FORCEINLINE_FUNCTION Real JWL::ReferencePressure(const Real rho) const {
-  const Real x = robust::ratio(_rho0, rho);
-  return _A * robust::safe_arg_exp(-_R1 * x) + _B * robust::safe_arg_exp(-_R2 * x);
+template <typename Real_t>
+PORTABLE_FORCEINLINE_FUNCTION simd_utils::value_t<Real_t>
+JWL::ReferencePressure(const Real_t rho) const {
+  using R = simd_utils::value_t<Real_t>;
+  const R x = simd_utils::ratio<R>(_rho0, rho);
+  return _A * simd_utils::safe_arg_exp(-_R1 * x) +
+         _B * simd_utils::safe_arg_exp(-_R2 * x);
 }
-PORTABLE_FORCEINLINE_FUNCTION Real JWL::ReferenceEnergy(const Real rho) const {
-  const Real x = robust::ratio(_rho0, rho);
-  return _c1 * robust::safe_arg_exp(-_R1 * x) + _c2 * robust::safe_arg_exp(-_R2 * x);
+template <typename Real_t>
+PORTABLE_FORCEINLINE_FUNCTION simd_utils::value_t<Real_t>
+JWL::ReferenceEnergy(const Real_t rho) const {
+  using R = simd_utils::value_t<Real_t>;
+  const R x = simd_utils::ratio<R>(_rho0, rho);
+  return _c1 * simd_utils::safe_arg_exp(-_R1 * x) +
+         _c2 * simd_utils::safe_arg_exp(-_R2 * x);
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real JWL::InternalEnergyFromDensityTemperature(
-    const Real rho, const Real temp, Indexer_t &&lambda) const {
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+JWL::InternalEnergyFromDensityTemperature(
+    const Real_t rho, const simd_utils::value_t<Real_t> temp, Indexer_t &&lambda) const {
   return ReferenceEnergy(rho) + _Cv * temp;
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real JWL::PressureFromDensityInternalEnergy(
-    const Real rho, const Real sie, Indexer_t &&lambda) const {
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+JWL::PressureFromDensityInternalEnergy(
+    const Real_t rho, const simd_utils::value_t<Real_t> sie, Indexer_t &&lambda) const {
   return ReferencePressure(rho) + _w * rho * (sie - ReferenceEnergy(rho));
 }
 template <typename Indexer_t>
@@ -173,35 +194,41 @@ PORTABLE_INLINE_FUNCTION Real JWL::EntropyFromDensityInternalEnergy(
   EntropyIsNotEnabled("JWL");
   return 1.0;
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real JWL::TemperatureFromDensityInternalEnergy(
-    const Real rho, const Real sie, Indexer_t &&lambda) const {
-  return robust::ratio((sie - ReferenceEnergy(rho)), _Cv);
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+JWL::TemperatureFromDensityInternalEnergy(
+    const Real_t rho, const simd_utils::value_t<Real_t> sie, Indexer_t &&lambda) const {
+  using R = simd_utils::value_t<Real_t>;
+  return simd_utils::ratio<R>((sie - ReferenceEnergy(rho)), _Cv);
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real JWL::SpecificHeatFromDensityInternalEnergy(
-    const Real rho, const Real sie, Indexer_t &&lambda) const {
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+JWL::SpecificHeatFromDensityInternalEnergy(
+    const Real_t rho, const simd_utils::value_t<Real_t> sie, Indexer_t &&lambda) const {
   return _Cv;
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real JWL::BulkModulusFromDensityInternalEnergy(
-    const Real rho, const Real sie, Indexer_t &&lambda) const {
-  const Real x = robust::ratio(_rho0, rho);
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+JWL::BulkModulusFromDensityInternalEnergy(
+    const Real_t rho, const simd_utils::value_t<Real_t> sie, Indexer_t &&lambda) const {
+  using R = simd_utils::value_t<Real_t>;
+  const R x = simd_utils::ratio<R>(_rho0, rho);
   // return
   // (_w+1)*(PressureFromDensityInternalEnergy(rho,sie)-ReferencePressure(rho))+x*(_A*_R1*std::exp(-_R1*x)+_B*_R2*std::exp(-_R2*x));
   return (_w + 1) * _w * rho * (sie - ReferenceEnergy(rho)) +
-         x * (_A * _R1 * robust::safe_arg_exp(-_R1 * x) +
-              _B * _R2 * robust::safe_arg_exp(-_R2 * x));
+         x * (_A * _R1 * simd_utils::safe_arg_exp(-_R1 * x) +
+              _B * _R2 * simd_utils::safe_arg_exp(-_R2 * x));
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real JWL::GruneisenParamFromDensityInternalEnergy(
-    const Real rho, const Real sie, Indexer_t &&lambda) const {
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+JWL::GruneisenParamFromDensityInternalEnergy(
+    const Real_t rho, const simd_utils::value_t<Real_t> sie, Indexer_t &&lambda) const {
   return _w;
 }
 // Below are "unimplemented" routines
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real JWL::PressureFromDensityTemperature(
-    const Real rho, const Real temp, Indexer_t &&lambda) const {
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> JWL::PressureFromDensityTemperature(
+    const Real_t rho, const simd_utils::value_t<Real_t> temp, Indexer_t &&lambda) const {
   return PressureFromDensityInternalEnergy(
       rho, InternalEnergyFromDensityTemperature(rho, temp));
 }
@@ -211,21 +238,24 @@ PORTABLE_INLINE_FUNCTION Real JWL::EntropyFromDensityTemperature(
   EntropyIsNotEnabled("JWL");
   return 1.0;
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real JWL::SpecificHeatFromDensityTemperature(
-    const Real rho, const Real temp, Indexer_t &&lambda) const {
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+JWL::SpecificHeatFromDensityTemperature(
+    const Real_t rho, const simd_utils::value_t<Real_t> temp, Indexer_t &&lambda) const {
   return SpecificHeatFromDensityInternalEnergy(
       rho, InternalEnergyFromDensityTemperature(rho, temp));
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real JWL::BulkModulusFromDensityTemperature(
-    const Real rho, const Real temp, Indexer_t &&lambda) const {
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+JWL::BulkModulusFromDensityTemperature(
+    const Real_t rho, const simd_utils::value_t<Real_t> temp, Indexer_t &&lambda) const {
   return BulkModulusFromDensityInternalEnergy(
       rho, InternalEnergyFromDensityTemperature(rho, temp));
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real JWL::GruneisenParamFromDensityTemperature(
-    const Real rho, const Real temp, Indexer_t &&lambda) const {
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+JWL::GruneisenParamFromDensityTemperature(
+    const Real_t rho, const simd_utils::value_t<Real_t> temp, Indexer_t &&lambda) const {
   return _w;
 }
 template <typename Indexer_t>
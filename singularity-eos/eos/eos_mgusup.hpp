@@ -143,11 +143,13 @@ class MGUsup : public EosBase<MGUsup> {
            _Cs, _s, _G0, _Cv0, _E0, _S0);
     printf("\n\n");
   }
-  // Density/Energy from P/T not unique, if used will give error
-  template <typename Indexer_t>
-  PORTABLE_INLINE_FUNCTION void
-  DensityEnergyFromPressureTemperature(const Real press, const Real temp,
-                                       Indexer_t &&lambda, Real &rho, Real &sie) const;
+  // The Hugoniot diverges where 1 - s eta vanishes, just above this
+  PORTABLE_FORCEINLINE_FUNCTION Real MaximumDensity() const {
+    return (_s > 1.0) ? (1.0 - 1e-10) * _rho0 * _s / (_s - 1.0)
+                      : std::numeric_limits<Real>::infinity();
+  }
+  // Density/Energy from P/T is the root find in EosBase, which finds one
+  // root if there are several
   inline void Finalize() {}
   static std::string EosType() { return std::string("MGUsup"); }
   static std::string EosPyType() { return EosType(); }
@@ -345,13 +347,6 @@ PORTABLE_INLINE_FUNCTION Real MGUsup::BulkModulusFromDensityInternalEnergy(
   value = robust::ratio(_rho0, rho) * value;
   return value;
 }
-// AEM: Give error since function is not well defined
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION void MGUsup::DensityEnergyFromPressureTemperature(
-    const Real press, const Real temp, Indexer_t &&lambda, Real &rho, Real &sie) const {
-  EOS_ERROR("MGUsup::DensityEnergyFromPressureTemperature: "
-            "Not implemented.\n");
-}
 // AEM: We should add entropy and Gruneissen parameters here so that it is complete
 // If we add also alpha and BT, those should also be in here.
 template <typename Indexer_t>
@@ -27,6 +27,7 @@
 #include <singularity-eos/base/constants.hpp>
 #include <singularity-eos/base/eos_error.hpp>
 #include <singularity-eos/base/robust_utils.hpp>
+#include <singularity-eos/base/simd_utils.hpp>
 #include <singularity-eos/eos/eos_base.hpp>
 
 namespace singularity {
@@ -57,36 +58,44 @@ class NobleAbel : public EosBase<NobleAbel> {
     checkParams();
   }
   NobleAbel GetOnDevice() { return *this; }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real TemperatureFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  TemperatureFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return std::max(robust::SMALL(), (sie - _qq) / _Cv);
+    using R = simd_utils::value_t<Real_t>;
+    return simd_utils::max<R>(robust::SMALL(), (sie - _qq) / _Cv);
   }
   PORTABLE_INLINE_FUNCTION void checkParams() const {
     PORTABLE_ALWAYS_REQUIRE(_Cv > 0, "Heat capacity must be positive");
     PORTABLE_ALWAYS_REQUIRE(_gm1 >= 0, "Gruneisen parameter must be positive");
     PORTABLE_ALWAYS_REQUIRE(_bb >= 0, "Covolume must be positive");
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real InternalEnergyFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  InternalEnergyFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return std::max(_qq, _Cv * temperature + _qq);
+    using R = simd_utils::value_t<Real_t>;
+    return simd_utils::max<R>(_qq, _Cv * temperature + _qq);
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real PressureFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> PressureFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return std::max(robust::SMALL(),
-                    robust::ratio(_gm1 * rho * _Cv * temperature, 1.0 - _bb * rho));
+    using R = simd_utils::value_t<Real_t>;
+    return simd_utils::max<R>(robust::SMALL(),
+                              simd_utils::ratio<R>(_gm1 * rho * _Cv * temperature,
+                                                   1.0 - _bb * rho));
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real PressureFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> PressureFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return std::max(robust::SMALL(),
-                    robust::ratio(_gm1 * rho * (sie - _qq), 1.0 - _bb * rho));
+    using R = simd_utils::value_t<Real_t>;
+    return simd_utils::max<R>(robust::SMALL(),
+                              simd_utils::ratio<R>(_gm1 * rho * (sie - _qq),
+                                                   1.0 - _bb * rho));
   }
   template <typename Indexer_t = Real *>
   PORTABLE_INLINE_FUNCTION Real MinInternalEnergyFromDensity(
@@ -94,65 +103,80 @@ class NobleAbel : public EosBase<NobleAbel> {
     return _qq;
   }
 
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real
-  EntropyFromDensityTemperature(const Real rho, const Real temperature,
-                                Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    const Real vol = robust::ratio(1.0, rho);
-    return _Cv * std::log(robust::ratio(temperature, _T0) + robust::SMALL()) +
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> EntropyFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    using R = simd_utils::value_t<Real_t>;
+    const R vol = simd_utils::ratio<R>(1.0, rho);
+    return _Cv *
+               simd_utils::log(simd_utils::ratio<R>(temperature, _T0) + robust::SMALL()) +
            _gm1 * _Cv *
-               std::log(robust::ratio(vol - _bb, _vol0 - _bb) + robust::SMALL()) +
+               simd_utils::log(simd_utils::ratio<R>(vol - _bb, _vol0 - _bb) +
+                               robust::SMALL()) +
            _qp;
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real EntropyFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> EntropyFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    const Real vol = robust::ratio(1.0, rho);
-    return _Cv * std::log(robust::ratio(sie - _qq, _sie0 - _qq) + robust::SMALL()) +
+    using R = simd_utils::value_t<Real_t>;
+    const R vol = simd_utils::ratio<R>(1.0, rho);
+    return _Cv * simd_utils::log(simd_utils::ratio<R>(sie - _qq, _sie0 - _qq) +
+                                 robust::SMALL()) +
            _gm1 * _Cv *
-               std::log(robust::ratio(vol - _bb, _vol0 - _bb) + robust::SMALL()) +
+               simd_utils::log(simd_utils::ratio<R>(vol - _bb, _vol0 - _bb) +
+                               robust::SMALL()) +
            _qp;
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real SpecificHeatFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> SpecificHeatFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return _Cv;
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real SpecificHeatFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  SpecificHeatFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return _Cv;
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real BulkModulusFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> BulkModulusFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return std::max(robust::SMALL(),
-                    robust::ratio(_gm1 * (_gm1 + 1.0) * rho * _Cv * temperature,
-                                  (1.0 - _bb * rho) * (1.0 - _bb * rho)));
+    using R = simd_utils::value_t<Real_t>;
+    return simd_utils::max<R>(
+        robust::SMALL(),
+        simd_utils::ratio<R>(_gm1 * (_gm1 + 1.0) * rho * _Cv * temperature,
+                             (1.0 - _bb * rho) * (1.0 - _bb * rho)));
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real BulkModulusFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  BulkModulusFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return std::max(robust::SMALL(),
-                    robust::ratio(_gm1 * (_gm1 + 1.0) * rho * (sie - _qq),
-                                  (1.0 - _bb * rho) * (1.0 - _bb * rho)));
+    using R = simd_utils::value_t<Real_t>;
+    return simd_utils::max<R>(
+        robust::SMALL(), simd_utils::ratio<R>(_gm1 * (_gm1 + 1.0) * rho * (sie - _qq),
+                                              (1.0 - _bb * rho) * (1.0 - _bb * rho)));
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real GruneisenParamFromDensityTemperature(
-      const Real rho, const Real temperature,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  GruneisenParamFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temperature,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return robust::ratio(_gm1, (1.0 - _bb * rho));
+    using R = simd_utils::value_t<Real_t>;
+    return simd_utils::ratio<R>(_gm1, (1.0 - _bb * rho));
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real GruneisenParamFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  GruneisenParamFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return robust::ratio(_gm1, (1.0 - _bb * rho));
+    using R = simd_utils::value_t<Real_t>;
+    return simd_utils::ratio<R>(_gm1, (1.0 - _bb * rho));
   }
   template <typename Indexer_t = Real *>
   PORTABLE_INLINE_FUNCTION void
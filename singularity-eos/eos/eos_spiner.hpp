@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <cstdlib>
 #include <iomanip>
+#include <limits>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -33,11 +34,19 @@
 #include <ports-of-call/portability.hpp>
 
 // base
+#include <singularity-eos/base/accuracy.hpp>
 #include <singularity-eos/base/constants.hpp>
 #include <singularity-eos/base/fast-math/logs.hpp>
 #include <singularity-eos/base/robust_utils.hpp>
 #include <singularity-eos/base/root-finding-1d/root_finding.hpp>
 #include <singularity-eos/base/sp5/singularity_eos_sp5.hpp>
+#include <singularity-eos/base/sp5/sp5_compression.hpp>
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+#include <singularity-eos/base/table_heatmap.hpp>
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+#include <singularity-eos/base/table_patches.hpp>
+#include <singularity-eos/base/table_transform.hpp>
+#include <singularity-eos/base/table_window.hpp>
 #include <singularity-eos/base/variadic_utils.hpp>
 #include <singularity-eos/eos/eos_base.hpp>
 
@@ -64,6 +73,11 @@ using namespace eos_base;
 
   For low densities, we floor the density. For high densities, we
   we use log-linear extrapolation.
+
+  Unlike the analytic models, the scalar API here is not templated on
+  the value type. Each lookup gathers from a table cell chosen per
+  point and most inversions are root finds, so a SIMD pack would only
+  loop over its lanes.
 */
 class SpinerEOSDependsRhoT : public EosBase<SpinerEOSDependsRhoT> {
   using DataBox = Spiner::DataBox<Real>;
@@ -91,6 +105,8 @@ class SpinerEOSDependsRhoT : public EosBase<SpinerEOSDependsRhoT> {
   using EosBase<SpinerEOSDependsRhoT>::GruneisenParamFromDensityTemperature;
   using EosBase<SpinerEOSDependsRhoT>::GruneisenParamFromDensityInternalEnergy;
   using EosBase<SpinerEOSDependsRhoT>::FillEos;
+  using EosBase<SpinerEOSDependsRhoT>::DerivativesFromDensityTemperature;
+  using EosBase<SpinerEOSDependsRhoT>::DerivativesFromDensityInternalEnergy;
   using EosBase<SpinerEOSDependsRhoT>::EntropyIsNotEnabled;
 
   inline SpinerEOSDependsRhoT(const std::string &filename, int matid,
@@ -98,6 +114,14 @@ class SpinerEOSDependsRhoT : public EosBase<SpinerEOSDependsRhoT> {
   inline SpinerEOSDependsRhoT(const std::string &filename,
                               const std::string &materialName,
                               bool reproducibility_mode = false);
+  // Crops the tables to window after loading. See Crop.
+  inline SpinerEOSDependsRhoT(const std::string &filename, int matid,
+                              const TableWindow &window,
+                              bool reproducibility_mode = false);
+  inline SpinerEOSDependsRhoT(const std::string &filename,
+                              const std::string &materialName,
+                              const TableWindow &window,
+                              bool reproducibility_mode = false);
   PORTABLE_INLINE_FUNCTION
   SpinerEOSDependsRhoT() : memoryStatus_(DataStatus::Deallocated) {}
 
@@ -107,6 +131,11 @@ class SpinerEOSDependsRhoT : public EosBase<SpinerEOSDependsRhoT> {
   PORTABLE_INLINE_FUNCTION Real TemperatureFromDensityInternalEnergy(
       const Real rho, const Real sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
+  // Inverts the pressure table directly. Used by InvertState.
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION Real TemperatureFromDensityPressure(
+      const Real rho, const Real press,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
   template <typename Indexer_t = Real *>
   PORTABLE_INLINE_FUNCTION Real MinInternalEnergyFromDensity(
       const Real rho, Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
@@ -155,6 +184,15 @@ class SpinerEOSDependsRhoT : public EosBase<SpinerEOSDependsRhoT> {
   PORTABLE_INLINE_FUNCTION Real GruneisenParamFromDensityInternalEnergy(
       const Real rho, const Real sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
+  // Read from the derivative tables rather than differenced
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION ThermoDerivatives DerivativesFromDensityTemperature(
+      const Real rho, const Real temperature,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION ThermoDerivatives DerivativesFromDensityInternalEnergy(
+      const Real rho, const Real sie,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
   template <typename Indexer_t = Real *>
   PORTABLE_INLINE_FUNCTION void
   DensityEnergyFromPressureTemperature(const Real press, const Real temp,
@@ -197,6 +235,8 @@ class SpinerEOSDependsRhoT : public EosBase<SpinerEOSDependsRhoT> {
   }
   PORTABLE_FORCEINLINE_FUNCTION Real MinimumDensity() const { return rhoMin(); }
   PORTABLE_FORCEINLINE_FUNCTION Real MinimumTemperature() const { return T_(lTMin_); }
+  PORTABLE_FORCEINLINE_FUNCTION Real MaximumDensity() const { return rhoMax(); }
+  PORTABLE_FORCEINLINE_FUNCTION Real MaximumTemperature() const { return TMax(); }
   PORTABLE_INLINE_FUNCTION
   int nlambda() const noexcept { return _n_lambda; }
   PORTABLE_INLINE_FUNCTION
@@ -204,6 +244,56 @@ class SpinerEOSDependsRhoT : public EosBase<SpinerEOSDependsRhoT> {
   PORTABLE_INLINE_FUNCTION
   TableStatus tableStatus() const { return whereAmI_; }
   RootFinding1D::RootCounts counts;
+  // Host-side diagnostics. See models.rst for thread safety.
+  inline void SetDiagnostics(const bool diagnostics) { diagnostics_ = diagnostics; }
+  PORTABLE_INLINE_FUNCTION
+  bool Diagnostics() const { return diagnostics_; }
+  // Tolerance and iteration limit of the table inversions. See accuracy.hpp.
+  inline void SetAccuracy(const AccuracyParams &params) { accuracy_ = params; }
+  PORTABLE_INLINE_FUNCTION
+  AccuracyParams GetAccuracy() const { return accuracy_; }
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+  // Counts the table cells visited by lookups into heatmap, which
+  // must outlive this object and its copies. Pass nullptr to stop.
+  // See table_heatmap.hpp.
+  inline void SetHeatmap(TableHeatmap *heatmap);
+  // Smallest window containing the table cells visited according to
+  // heatmap. If nothing was visited, the window is the whole table.
+  inline TableWindow VisitedWindow(const TableHeatmap &heatmap,
+                                   const int margin = 2) const;
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+
+  // Location of a temperature on the log(T) axis of the tables. If
+  // several materials share a temperature grid, e.g., because they
+  // were generated by sesame2spiner with the -g flag, the index and
+  // interpolation weights can be computed once and reused for every
+  // material evaluated at that temperature. An index computed on
+  // another grid falls back to a regular lookup at its temperature.
+  using TemperatureIndex = singularity::TemperatureIndex;
+  PORTABLE_INLINE_FUNCTION
+  TemperatureIndex GetTemperatureIndex(const Real temperature) const;
+  PORTABLE_INLINE_FUNCTION
+  bool SharesTemperatureGrid(const SpinerEOSDependsRhoT &other) const;
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION Real InternalEnergyFromDensityTemperatureIndex(
+      const Real rho, const TemperatureIndex &tidx,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION Real PressureFromDensityTemperatureIndex(
+      const Real rho, const TemperatureIndex &tidx,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
+
+  // Absorbs the map applied by a stack of modifiers into the
+  // tables, so that this object returns what the modified EOS
+  // would. Host only. See EOSBuilder::BakeModifiers.
+  // Tables with refined patches cannot be baked.
+  inline void BakeTransform(const TableTransform &transform);
+  // Drops the table nodes outside window, keeping window.margin
+  // nodes on each side, and recomputes the cold curve and the other
+  // derived tables. Lookups inside the window are unchanged. Outside
+  // it, the usual extrapolation applies at the new bounds. Host only.
+  inline void Crop(const TableWindow &window);
+
   inline void Finalize();
   static std::string EosType() { return std::string("SpinerEOSDependsRhoT"); }
   static std::string EosPyType() { return EosType(); }
@@ -211,6 +301,18 @@ class SpinerEOSDependsRhoT : public EosBase<SpinerEOSDependsRhoT> {
  private:
   herr_t loadDataboxes_(const std::string &matid_str, hid_t file, hid_t lTGroup,
                         hid_t coldGroup);
+  inline void setDerivedTables_();
+  inline void finalizeDerivedTables_();
+  PORTABLE_FORCEINLINE_FUNCTION
+  bool diagnosticsEnabled_() const noexcept {
+    return diagnostics_ && (memoryStatus_ != DataStatus::OnDevice);
+  }
+  PORTABLE_FORCEINLINE_FUNCTION
+  void recordVisit_(const Real lRho, const Real lT, const TableStatus whereAmI) const {
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+    if (heatmap_ != nullptr) heatmap_->Record(heatmapGrid_, lRho, lT, whereAmI);
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+  }
   inline void fixBulkModulus_();
   inline void setlTColdCrit_();
 
@@ -238,6 +340,31 @@ class SpinerEOSDependsRhoT : public EosBase<SpinerEOSDependsRhoT> {
   PORTABLE_FORCEINLINE_FUNCTION
   Real T_(const Real lT) const noexcept { return fromLog_(lT, lTOffset_); }
 
+  // Same index and weights as the linear interpolation in Spiner
+  template <typename Grid_t>
+  static PORTABLE_FORCEINLINE_FUNCTION void weights_(const Grid_t &grid, const Real x,
+                                                     int &ix, Real w[2]) {
+    ix = grid.index(x);
+    const Real x0 = grid.x(ix);
+    w[1] = (x - x0) / (grid.x(ix + 1) - x0);
+    w[0] = 1. - w[1];
+  }
+  PORTABLE_INLINE_FUNCTION
+  bool onTemperatureGrid_(const TemperatureIndex &tidx) const;
+  PORTABLE_FORCEINLINE_FUNCTION
+  Real interpTIndex_(const int field, const DataBox &db, const Real lRho,
+                     const TemperatureIndex &tidx) const {
+    if (patches_.Covers(lRho, tidx.lT)) {
+      return patches_.Interp(field, db, lRho, tidx.lT);
+    }
+    int j;
+    Real wRho[2];
+    weights_(db.range(1), lRho, j, wRho);
+    const int i = tidx.i;
+    return (wRho[0] * (tidx.w[0] * db(j, i) + tidx.w[1] * db(j, i + 1)) +
+            wRho[1] * (tidx.w[0] * db(j + 1, i) + tidx.w[1] * db(j + 1, i + 1)));
+  }
+
   template <typename Indexer_t = Real *>
   PORTABLE_INLINE_FUNCTION Real
   lTFromlRhoSie_(const Real lRho, const Real sie, TableStatus &whereAmI,
@@ -263,8 +390,16 @@ class SpinerEOSDependsRhoT : public EosBase<SpinerEOSDependsRhoT> {
   PORTABLE_INLINE_FUNCTION
   Real CvFromlRholT_(const Real lRho, const Real lT, const TableStatus &whereAmI) const;
   PORTABLE_INLINE_FUNCTION
+  Real SFromlRhoTlT_(const Real lRho, const Real T, const Real lT,
+                     const TableStatus &whereAmI) const;
+  PORTABLE_INLINE_FUNCTION
   Real bModFromRholRhoTlT_(const Real rho, const Real lRho, const Real T, const Real lT,
                            const TableStatus &whereAmI) const;
+  // sie is only used off the top of the table
+  PORTABLE_INLINE_FUNCTION
+  ThermoDerivatives derivsFromRholRhoSielT_(const Real rho, const Real lRho,
+                                            const Real sie, const Real lT,
+                                            const TableStatus &whereAmI) const;
   PORTABLE_INLINE_FUNCTION
   TableStatus getLocDependsRhoSie_(const Real lRho, const Real sie) const;
   PORTABLE_INLINE_FUNCTION
@@ -277,6 +412,14 @@ class SpinerEOSDependsRhoT : public EosBase<SpinerEOSDependsRhoT> {
   // static constexpr const char _eos_type[] {"SpinerEOSDependsRhoT"};
   static constexpr const int numDataBoxes_ = 12;
   DataBox P_, sie_, bMod_, dPdRho_, dPdE_, dTdRho_, dTdE_, dEdRho_, dEdT_;
+  // Optional refinement of the tables above, stored in this order
+  struct PatchField {
+    enum { P, sie, bMod, dPdRho, dPdE, dTdRho, dTdE, dEdRho, dEdT };
+  };
+  TablePatches patches_;
+  // Entropy, which older tables do not have. It is not patched.
+  DataBox S_;
+  bool hasEntropy_ = false;
   DataBox PMax_, sielTMax_, dEdTMax_, gm1Max_;
   DataBox lTColdCrit_;
   DataBox PCold_, sieCold_, bModCold_;
@@ -294,7 +437,12 @@ class SpinerEOSDependsRhoT : public EosBase<SpinerEOSDependsRhoT> {
   // whereAmI_ and status_ used only for reporting. They are not thread-safe.
   mutable TableStatus whereAmI_ = TableStatus::OnTable;
   mutable RootFinding1D::Status status_ = RootFinding1D::Status::SUCCESS;
-  static constexpr const Real ROOT_THRESH = 1e-14; // TODO: experiment
+  bool diagnostics_ = true;
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+  TableHeatmap *heatmap_ = nullptr;
+  int heatmapGrid_ = 0;
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+  AccuracyParams accuracy_;
   static constexpr const Real SOFT_THRESH = 1e-8;
   DataStatus memoryStatus_ = DataStatus::Deallocated;
   static constexpr const int _n_lambda = 2;
@@ -326,6 +474,7 @@ class SpinerEOSDependsRhoSie : public EosBase<SpinerEOSDependsRhoSie> {
  public:
   struct SP5Tables {
     DataBox P, bMod, dPdRho, dPdE, dTdRho, dTdE, dEdRho;
+    DataBox S; // only if hasEntropy_
   };
   // Generic functions provided by the base class. These contain
   // e.g. the vector overloads that use the scalar versions declared
@@ -345,6 +494,8 @@ class SpinerEOSDependsRhoSie : public EosBase<SpinerEOSDependsRhoSie> {
   using EosBase<SpinerEOSDependsRhoSie>::GruneisenParamFromDensityTemperature;
   using EosBase<SpinerEOSDependsRhoSie>::GruneisenParamFromDensityInternalEnergy;
   using EosBase<SpinerEOSDependsRhoSie>::FillEos;
+  using EosBase<SpinerEOSDependsRhoSie>::DerivativesFromDensityTemperature;
+  using EosBase<SpinerEOSDependsRhoSie>::DerivativesFromDensityInternalEnergy;
   using EosBase<SpinerEOSDependsRhoSie>::EntropyIsNotEnabled;
 
   PORTABLE_INLINE_FUNCTION SpinerEOSDependsRhoSie()
@@ -354,6 +505,14 @@ class SpinerEOSDependsRhoSie : public EosBase<SpinerEOSDependsRhoSie> {
   inline SpinerEOSDependsRhoSie(const std::string &filename,
                                 const std::string &materialName,
                                 bool reproducibility_mode = false);
+  // Crops the tables to window after loading. See Crop.
+  inline SpinerEOSDependsRhoSie(const std::string &filename, int matid,
+                                const TableWindow &window,
+                                bool reproducibility_mode = false);
+  inline SpinerEOSDependsRhoSie(const std::string &filename,
+                                const std::string &materialName,
+                                const TableWindow &window,
+                                bool reproducibility_mode = false);
   inline SpinerEOSDependsRhoSie GetOnDevice();
 
   template <typename Indexer_t = Real *>
@@ -410,6 +569,15 @@ class SpinerEOSDependsRhoSie : public EosBase<SpinerEOSDependsRhoSie> {
   PORTABLE_INLINE_FUNCTION Real GruneisenParamFromDensityInternalEnergy(
       const Real rho, const Real sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
+  // Read from the derivative tables rather than differenced
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION ThermoDerivatives DerivativesFromDensityTemperature(
+      const Real rho, const Real temperature,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION ThermoDerivatives DerivativesFromDensityInternalEnergy(
+      const Real rho, const Real sie,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
   template <typename Indexer_t = Real *>
   PORTABLE_INLINE_FUNCTION void
   DensityEnergyFromPressureTemperature(const Real press, const Real temp,
@@ -453,6 +621,8 @@ class SpinerEOSDependsRhoSie : public EosBase<SpinerEOSDependsRhoSie> {
 
   PORTABLE_FORCEINLINE_FUNCTION Real MinimumDensity() const { return rhoMin(); }
   PORTABLE_FORCEINLINE_FUNCTION Real MinimumTemperature() const { return TMin(); }
+  PORTABLE_FORCEINLINE_FUNCTION Real MaximumDensity() const { return rhoMax(); }
+  PORTABLE_FORCEINLINE_FUNCTION Real MaximumTemperature() const { return TMax(); }
 
   PORTABLE_INLINE_FUNCTION
   int nlambda() const noexcept { return _n_lambda; }
@@ -466,13 +636,60 @@ class SpinerEOSDependsRhoSie : public EosBase<SpinerEOSDependsRhoSie> {
   PORTABLE_INLINE_FUNCTION
   RootFinding1D::Status rootStatus() const { return status_; }
   RootFinding1D::RootCounts counts;
+  // Host-side diagnostics. See models.rst for thread safety.
+  inline void SetDiagnostics(const bool diagnostics) { diagnostics_ = diagnostics; }
+  PORTABLE_INLINE_FUNCTION
+  bool Diagnostics() const { return diagnostics_; }
+  // Tolerance and iteration limit of the table inversions. See accuracy.hpp.
+  inline void SetAccuracy(const AccuracyParams &params) { accuracy_ = params; }
+  PORTABLE_INLINE_FUNCTION
+  AccuracyParams GetAccuracy() const { return accuracy_; }
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+  // Counts the table cells visited by lookups into heatmap, which
+  // must outlive this object and its copies. Pass nullptr to stop.
+  // See table_heatmap.hpp.
+  inline void SetHeatmap(TableHeatmap *heatmap);
+  // Smallest window containing the table cells visited according to
+  // heatmap. If nothing was visited, the window is the whole table.
+  inline TableWindow VisitedWindow(const TableHeatmap &heatmap,
+                                   const int margin = 2) const;
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
   static std::string EosType() { return std::string("SpinerEOSDependsRhoSie"); }
   static std::string EosPyType() { return EosType(); }
+  // Absorbs the map applied by a stack of modifiers into the
+  // tables. Host only. See EOSBuilder::BakeModifiers.
+  inline void BakeTransform(const TableTransform &transform);
+  // Drops the (rho, T) table nodes outside window, keeping
+  // window.margin nodes on each side, and the (rho, sie) nodes
+  // outside the energies the window spans. Lookups inside the window
+  // are unchanged. Host only.
+  inline void Crop(const TableWindow &window);
   inline void Finalize();
 
  private:
   inline herr_t loadDataboxes_(const std::string &matid_str, hid_t file, hid_t lTGroup,
                                hid_t lEGroup);
+  inline void setDerivedTables_();
+  PORTABLE_FORCEINLINE_FUNCTION
+  bool diagnosticsEnabled_() const noexcept {
+    return diagnostics_ && (memoryStatus_ != DataStatus::OnDevice);
+  }
+  PORTABLE_FORCEINLINE_FUNCTION
+  void recordVisitRhoT_(const Real lRho, const Real lT) const {
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+    if (heatmap_ != nullptr) {
+      heatmap_->Record(heatmapRhoT_, lRho, lT, TableStatus::OnTable);
+    }
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+  }
+  PORTABLE_FORCEINLINE_FUNCTION
+  void recordVisitRhoSie_(const Real lRho, const Real lE) const {
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+    if (heatmap_ != nullptr) {
+      heatmap_->Record(heatmapRhoSie_, lRho, lE, TableStatus::OnTable);
+    }
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+  }
   inline void calcBMod_(SP5Tables &tables);
 
   static PORTABLE_FORCEINLINE_FUNCTION Real toLog_(const Real x, const Real offset) {
@@ -493,11 +710,16 @@ class SpinerEOSDependsRhoSie : public EosBase<SpinerEOSDependsRhoSie> {
   template <typename Indexer_t = Real *>
   PORTABLE_INLINE_FUNCTION Real lRhoFromPlT_(const Real P, const Real lT,
                                              Indexer_t &&lambda) const;
+  // tables is dependsRhoT_ or dependsRhoSie_, and y is log(T) or log(sie)
+  PORTABLE_INLINE_FUNCTION
+  ThermoDerivatives derivsFromTables_(const Real rho, const Real lRho, const Real y,
+                                      const SP5Tables &tables) const;
 
   DataBox sie_; // depends on (rho,T)
   DataBox T_;   // depends on (rho, sie)
   SP5Tables dependsRhoT_;
   SP5Tables dependsRhoSie_;
+  bool hasEntropy_ = false; // older tables have no entropy
   int numRho_;
   Real rhoNormal_, TNormal_, sieNormal_, PNormal_;
   Real CvNormal_, bModNormal_, dPdENormal_, dVdTNormal_;
@@ -512,11 +734,45 @@ class SpinerEOSDependsRhoSie : public EosBase<SpinerEOSDependsRhoSie> {
   int matid_;
   bool reproducible_;
   mutable RootFinding1D::Status status_;
+  bool diagnostics_ = true;
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+  TableHeatmap *heatmap_ = nullptr;
+  int heatmapRhoT_ = 0, heatmapRhoSie_ = 1;
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+  AccuracyParams accuracy_;
   static constexpr const int _n_lambda = 1;
   static constexpr const char *_lambda_names[1] = {"log(rho)"};
   DataStatus memoryStatus_ = DataStatus::Deallocated;
 };
 
+// Several SpinerEOSDependsRhoT materials loaded from one sp5 file whose
+// tables share a temperature grid, e.g., a file generated by
+// sesame2spiner with the -g flag. Loading fails if the grids differ,
+// so a temperature index computed by one material is valid for all of
+// them. The materials are ordinary EOS objects, to be placed in a
+// Variant and handed to the PTE solvers. Host only.
+class SpinerMaterialLibrary {
+ public:
+  using TemperatureIndex = singularity::TemperatureIndex;
+  SpinerMaterialLibrary() = default;
+  inline SpinerMaterialLibrary(const std::string &filename,
+                               const std::vector<int> &matids,
+                               bool reproducibility_mode = false);
+  std::size_t size() const { return materials_.size(); }
+  const SpinerEOSDependsRhoT &operator[](const std::size_t m) const {
+    return materials_[m];
+  }
+  TemperatureIndex GetTemperatureIndex(const Real temperature) const {
+    return materials_.front().GetTemperatureIndex(temperature);
+  }
+  // Device copies of the materials, in the order they were loaded
+  inline std::vector<SpinerEOSDependsRhoT> GetOnDevice();
+  inline void Finalize();
+
+ private:
+  std::vector<SpinerEOSDependsRhoT> materials_;
+};
+
 // implementation details below
 // ======================================================================
 
@@ -558,6 +814,43 @@ class r_interp {
   }
 };
 
+// As l_interp and r_interp, but on the patch-refined table
+class l_patch_interp {
+ private:
+  const TablePatches &patches;
+  const int field;
+  const DataBox &base;
+  const Real fixed;
+
+ public:
+  PORTABLE_INLINE_FUNCTION
+  l_patch_interp(const TablePatches &patches_, const int field_, const DataBox &base_,
+                 const Real fixed_)
+      : patches{patches_}, field{field_}, base{base_}, fixed{fixed_} {}
+
+  PORTABLE_INLINE_FUNCTION Real operator()(const Real x) const {
+    return patches.Interp(field, base, x, fixed);
+  }
+};
+
+class r_patch_interp {
+ private:
+  const TablePatches &patches;
+  const int field;
+  const DataBox &base;
+  const Real fixed;
+
+ public:
+  PORTABLE_INLINE_FUNCTION
+  r_patch_interp(const TablePatches &patches_, const int field_, const DataBox &base_,
+                 const Real fixed_)
+      : patches{patches_}, field{field_}, base{base_}, fixed{fixed_} {}
+
+  PORTABLE_INLINE_FUNCTION Real operator()(const Real x) const {
+    return patches.Interp(field, base, fixed, x);
+  }
+};
+
 class prod_interp_1d {
  private:
   const DataBox &field1, field2;
@@ -594,7 +887,7 @@ inline SpinerEOSDependsRhoT::SpinerEOSDependsRhoT(const std::string &filename, i
   hid_t file, matGroup, lTGroup, coldGroup;
   herr_t status = H5_SUCCESS;
 
-  file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  file = SP5::Compression::Open(filename, matid_str);
   matGroup = H5Gopen(file, matid_str.c_str(), H5P_DEFAULT);
   lTGroup = H5Gopen(matGroup, SP5::Depends::logRhoLogT, H5P_DEFAULT);
   coldGroup = H5Gopen(matGroup, SP5::Depends::coldCurve, H5P_DEFAULT);
@@ -621,7 +914,7 @@ inline SpinerEOSDependsRhoT::SpinerEOSDependsRhoT(const std::string &filename,
   hid_t file, matGroup, lTGroup, coldGroup;
   herr_t status = H5_SUCCESS;
 
-  file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  file = SP5::Compression::Open(filename, materialName);
   matGroup = H5Gopen(file, materialName.c_str(), H5P_DEFAULT);
   lTGroup = H5Gopen(matGroup, SP5::Depends::logRhoLogT, H5P_DEFAULT);
   coldGroup = H5Gopen(matGroup, SP5::Depends::coldCurve, H5P_DEFAULT);
@@ -642,6 +935,34 @@ inline SpinerEOSDependsRhoT::SpinerEOSDependsRhoT(const std::string &filename,
   }
 }
 
+inline SpinerEOSDependsRhoT::SpinerEOSDependsRhoT(const std::string &filename, int matid,
+                                                  const TableWindow &window,
+                                                  bool reproducibility_mode)
+    : SpinerEOSDependsRhoT(filename, matid, reproducibility_mode) {
+  Crop(window);
+}
+
+inline SpinerEOSDependsRhoT::SpinerEOSDependsRhoT(const std::string &filename,
+                                                  const std::string &materialName,
+                                                  const TableWindow &window,
+                                                  bool reproducibility_mode)
+    : SpinerEOSDependsRhoT(filename, materialName, reproducibility_mode) {
+  Crop(window);
+}
+
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+inline void SpinerEOSDependsRhoT::SetHeatmap(TableHeatmap *heatmap) {
+  heatmap_ = heatmap;
+  if (heatmap_ != nullptr) {
+    const auto &lRhoGrid = P_.range(1);
+    const auto &lTGrid = P_.range(0);
+    heatmapGrid_ = heatmap_->AddGrid("rho_T", "log(rho)", lRhoGrid.min(), lRhoGrid.max(),
+                                     lRhoGrid.nPoints(), "log(T)", lTGrid.min(),
+                                     lTGrid.max(), lTGrid.nPoints());
+  }
+}
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+
 inline SpinerEOSDependsRhoT SpinerEOSDependsRhoT::GetOnDevice() {
   SpinerEOSDependsRhoT other;
   other.P_ = Spiner::getOnDeviceDataBox<Real>(P_);
@@ -653,6 +974,9 @@ inline SpinerEOSDependsRhoT SpinerEOSDependsRhoT::GetOnDevice() {
   other.dTdE_ = Spiner::getOnDeviceDataBox<Real>(dTdE_);
   other.dEdRho_ = Spiner::getOnDeviceDataBox<Real>(dEdRho_);
   other.dEdT_ = Spiner::getOnDeviceDataBox<Real>(dEdT_);
+  other.patches_ = patches_.GetOnDevice();
+  if (hasEntropy_) other.S_ = Spiner::getOnDeviceDataBox<Real>(S_);
+  other.hasEntropy_ = hasEntropy_;
   other.PMax_ = Spiner::getOnDeviceDataBox<Real>(PMax_);
   other.sielTMax_ = Spiner::getOnDeviceDataBox<Real>(sielTMax_);
   other.dEdTMax_ = Spiner::getOnDeviceDataBox<Real>(dEdTMax_);
@@ -689,6 +1013,12 @@ inline SpinerEOSDependsRhoT SpinerEOSDependsRhoT::GetOnDevice() {
   other.matid_ = matid_;
   other.reproducible_ = reproducible_;
   other.status_ = status_;
+  other.diagnostics_ = diagnostics_;
+  other.accuracy_ = accuracy_;
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+  other.heatmap_ = heatmap_;
+  other.heatmapGrid_ = heatmapGrid_;
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
   other.memoryStatus_ = DataStatus::OnDevice;
   return other;
 }
@@ -703,6 +1033,8 @@ void SpinerEOSDependsRhoT::Finalize() {
   dTdE_.finalize();
   dEdRho_.finalize();
   dEdT_.finalize();
+  patches_.Finalize();
+  if (hasEntropy_) S_.finalize();
   PMax_.finalize();
   sielTMax_.finalize();
   dEdTMax_.finalize();
@@ -747,6 +1079,17 @@ inline herr_t SpinerEOSDependsRhoT::loadDataboxes_(const std::string &matid_str,
   status += dTdE_.loadHDF(lTGroup, SP5::Fields::dTdE);
   status += dEdRho_.loadHDF(lTGroup, SP5::Fields::dEdRho);
   status += dEdT_.loadHDF(lTGroup, SP5::Fields::dEdT);
+  if (TablePatches::Exists(lTGroup)) {
+    status += patches_.loadHDF(lTGroup, P_,
+                               {SP5::Fields::P, SP5::Fields::sie, SP5::Fields::bMod,
+                                SP5::Fields::dPdRho, SP5::Fields::dPdE,
+                                SP5::Fields::dTdRho, SP5::Fields::dTdE,
+                                SP5::Fields::dEdRho, SP5::Fields::dEdT});
+  }
+  hasEntropy_ = (H5Lexists(lTGroup, SP5::Fields::entropy, H5P_DEFAULT) > 0);
+  if (hasEntropy_) {
+    status += S_.loadHDF(lTGroup, SP5::Fields::entropy);
+  }
 
   // cold curves
   status += PCold_.loadHDF(coldGroup, SP5::Fields::P);
@@ -754,6 +1097,35 @@ inline herr_t SpinerEOSDependsRhoT::loadDataboxes_(const std::string &matid_str,
   status += bModCold_.loadHDF(coldGroup, SP5::Fields::bMod);
   status += dPdRhoCold_.loadHDF(coldGroup, SP5::Fields::dPdRho);
 
+  setDerivedTables_();
+
+  // reference state
+  Real lRhoNormal = lRho_(rhoNormal_);
+  // if rho normal not on the table, set it to the middle
+  if (!(lRhoMin_ < lRhoNormal && lRhoNormal < lRhoMax_)) {
+    lRhoNormal = 0.5 * (lRhoMin_ + lRhoMax_);
+    rhoNormal_ = rho_(lRhoNormal);
+  }
+  // Same for temperature. Use room temperature if it's available
+  TNormal_ = ROOM_TEMPERATURE;
+  Real lTNormal = lT_(TNormal_);
+  if (!(lTMin_ < lTNormal && lTNormal < lTMax_)) {
+    lTNormal = 0.5 * (lTMin_ + lTMax_);
+    TNormal_ = T_(lTNormal);
+  }
+  sieNormal_ = patches_.Interp(PatchField::sie, sie_, lRhoNormal, lTNormal);
+  PNormal_ = patches_.Interp(PatchField::P, P_, lRhoNormal, lTNormal);
+  CvNormal_ = patches_.Interp(PatchField::dEdT, dEdT_, lRhoNormal, lTNormal);
+  bModNormal_ = patches_.Interp(PatchField::bMod, bMod_, lRhoNormal, lTNormal);
+  dPdENormal_ = patches_.Interp(PatchField::dPdE, dPdE_, lRhoNormal, lTNormal);
+  Real dPdR = patches_.Interp(PatchField::dPdRho, dPdRho_, lRhoNormal, lTNormal);
+  dVdTNormal_ = dPdENormal_ * CvNormal_ / (rhoNormal_ * rhoNormal_ * dPdR);
+
+  return status;
+}
+
+// Everything that is computed from, rather than read from, the tables
+inline void SpinerEOSDependsRhoT::setDerivedTables_() {
   numRho_ = bMod_.dim(2);
   numT_ = bMod_.dim(1);
 
@@ -813,11 +1185,11 @@ inline herr_t SpinerEOSDependsRhoT::loadDataboxes_(const std::string &matid_str,
     Real lRho = bModCold_.range(0).x(j);
     Real lT = lTColdCrit_(j);
     Real rho = rho_(lRho);
-    bModCold_(j) = bMod_.interpToReal(lRho, lT);
-    dPdECold_(j) = dPdE_.interpToReal(lRho, lT);
-    dTdRhoCold_(j) = dTdRho_.interpToReal(lRho, lT);
-    dTdECold_(j) = dTdE_.interpToReal(lRho, lT);
-    dEdTCold_(j) = dEdT_.interpToReal(lRho, lT);
+    bModCold_(j) = patches_.Interp(PatchField::bMod, bMod_, lRho, lT);
+    dPdECold_(j) = patches_.Interp(PatchField::dPdE, dPdE_, lRho, lT);
+    dTdRhoCold_(j) = patches_.Interp(PatchField::dTdRho, dTdRho_, lRho, lT);
+    dTdECold_(j) = patches_.Interp(PatchField::dTdE, dTdE_, lRho, lT);
+    dEdTCold_(j) = patches_.Interp(PatchField::dEdT, dEdT_, lRho, lT);
   }
 
   // major vs. minor axes change, so this must be done by hand
@@ -834,36 +1206,130 @@ inline herr_t SpinerEOSDependsRhoT::loadDataboxes_(const std::string &matid_str,
     gm1Max_(j) = robust::ratio(dPdE_(j, numT_ - 1), rho); // max gruneisen
     sielTMax_(j) = sie_(j, numT_ - 1);
   }
+}
 
-  // reference state
-  Real lRhoNormal = lRho_(rhoNormal_);
-  // if rho normal not on the table, set it to the middle
-  if (!(lRhoMin_ < lRhoNormal && lRhoNormal < lRhoMax_)) {
-    lRhoNormal = 0.5 * (lRhoMin_ + lRhoMax_);
-    rhoNormal_ = rho_(lRhoNormal);
+inline void SpinerEOSDependsRhoT::BakeTransform(const TableTransform &transform) {
+  using table_transform::Multiply;
+  using table_transform::Retabulate;
+  if (memoryStatus_ != DataStatus::OnHost) {
+    EOS_ERROR("SpinerEOSDependsRhoT: tables must be on host to be transformed\n");
+  }
+  if (!transform.IsValid()) {
+    EOS_ERROR("SpinerEOSDependsRhoT: invalid table transform\n");
+  }
+  if (transform.IsIdentity()) return;
+  if (patches_.NumPatches() > 0) {
+    EOS_ERROR("SpinerEOSDependsRhoT: tables with refined patches cannot be baked\n");
+  }
+
+  // 2D tables are indexed (rho, T). Cold curves depend on rho only.
+  const Real scales[] = {transform.temp, transform.rho};
+  const Real cold_scales[] = {transform.rho};
+  const Multiply press{transform.press};
+  auto sie = [&](const Real e) { return transform.SieFromTable(e); };
+  Retabulate(P_, scales, press);
+  Retabulate(sie_, scales, sie);
+  Retabulate(bMod_, scales, press);
+  Retabulate(dPdRho_, scales, Multiply{transform.dPdRho()});
+  Retabulate(dPdE_, scales, Multiply{transform.dPdE()});
+  Retabulate(dTdRho_, scales, Multiply{transform.dTdRho()});
+  Retabulate(dTdE_, scales, Multiply{transform.dTdE()});
+  Retabulate(dEdRho_, scales, Multiply{transform.dEdRho()});
+  Retabulate(dEdT_, scales, Multiply{transform.dEdT()});
+  if (hasEntropy_) Retabulate(S_, scales, Multiply{transform.entropy});
+  Retabulate(PCold_, cold_scales, press);
+  Retabulate(sieCold_, cold_scales, sie);
+  Retabulate(bModCold_, cold_scales, press);
+  Retabulate(dPdRhoCold_, cold_scales, Multiply{transform.dPdRho()});
+  lRhoOffset_ = transform.RhoOffset(lRhoOffset_);
+  lTOffset_ = transform.TOffset(lTOffset_);
+
+  finalizeDerivedTables_();
+  setDerivedTables_();
+
+  transform.ReferenceStateFromTable(rhoNormal_, TNormal_, sieNormal_, PNormal_,
+                                    CvNormal_, bModNormal_, dPdENormal_, dVdTNormal_);
+}
+
+inline void SpinerEOSDependsRhoT::Crop(const TableWindow &window) {
+  if (memoryStatus_ != DataStatus::OnHost) {
+    EOS_ERROR("SpinerEOSDependsRhoT: tables must be on host to be cropped\n");
   }
-  // Same for temperature. Use room temperature if it's available
-  TNormal_ = ROOM_TEMPERATURE;
-  Real lTNormal = lT_(TNormal_);
-  if (!(lTMin_ < lTNormal && lTNormal < lTMax_)) {
-    lTNormal = 0.5 * (lTMin_ + lTMax_);
-    TNormal_ = T_(lTNormal);
+  if (!window.IsValid()) {
+    EOS_ERROR("SpinerEOSDependsRhoT: invalid table window\n");
   }
-  sieNormal_ = sie_.interpToReal(lRhoNormal, lTNormal);
-  PNormal_ = P_.interpToReal(lRhoNormal, lTNormal);
-  CvNormal_ = dEdT_.interpToReal(lRhoNormal, lTNormal);
-  bModNormal_ = bMod_.interpToReal(lRhoNormal, lTNormal);
-  dPdENormal_ = dPdE_.interpToReal(lRhoNormal, lTNormal);
-  Real dPdR = dPdRho_.interpToReal(lRhoNormal, lTNormal);
-  dVdTNormal_ = dPdENormal_ * CvNormal_ / (rhoNormal_ * rhoNormal_ * dPdR);
 
-  return status;
+  // 2D tables are indexed (rho, T). Cold curves depend on rho only.
+  int lo[2], hi[2];
+  table_window::NodeRange(P_.range(1), lRho_(window.rhoMin), lRho_(window.rhoMax),
+                          window.margin, lo[1], hi[1]);
+  table_window::NodeRange(P_.range(0), lT_(window.TMin), lT_(window.TMax),
+                          window.margin, lo[0], hi[0]);
+  DataBox *tables[] = {&P_,      &sie_,  &bMod_,   &dPdRho_, &dPdE_,
+                       &dTdRho_, &dTdE_, &dEdRho_, &dEdT_};
+  for (DataBox *db : tables) {
+    table_window::Crop(*db, lo, hi);
+  }
+  if (hasEntropy_) table_window::Crop(S_, lo, hi);
+  DataBox *cold[] = {&PCold_, &sieCold_, &bModCold_, &dPdRhoCold_};
+  for (DataBox *db : cold) {
+    table_window::Crop(*db, &lo[1], &hi[1]);
+  }
+  patches_.Crop(lo, hi);
+
+  // The reference state keeps the values read from the full table.
+  finalizeDerivedTables_();
+  setDerivedTables_();
+}
+
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+inline TableWindow SpinerEOSDependsRhoT::VisitedWindow(const TableHeatmap &heatmap,
+                                                       const int margin) const {
+  TableWindow window;
+  window.margin = margin;
+  const int grid = heatmap.FindGrid("rho_T");
+  Real lRhoLo, lRhoHi, lTLo, lTHi;
+  if (grid >= 0 && heatmap.VisitedBounds(grid, lRhoLo, lRhoHi, lTLo, lTHi)) {
+    window.rhoMin = rho_(lRhoLo);
+    window.rhoMax = rho_(lRhoHi);
+    window.TMin = T_(lTLo);
+    window.TMax = T_(lTHi);
+  }
+  return window;
+}
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+
+// Frees the tables setDerivedTables_ allocates
+inline void SpinerEOSDependsRhoT::finalizeDerivedTables_() {
+  PMax_.finalize();
+  sielTMax_.finalize();
+  dEdTMax_.finalize();
+  gm1Max_.finalize();
+  dPdECold_.finalize();
+  dTdRhoCold_.finalize();
+  dTdECold_.finalize();
+  dEdTCold_.finalize();
+  lTColdCrit_.finalize();
+  rho_at_pmin_.finalize();
 }
 
 inline void SpinerEOSDependsRhoT::fixBulkModulus_() {
   // assumes all databoxes are the same size
   // TODO: do we need to smooth this data with a median filter
   // or something like that?
+  auto bModFrom = [](const Real rho, const Real press, const Real DPDR_E,
+                     const Real DPDE_R, const Real DEDR_T) {
+    Real DPDR_T = DPDR_E + DPDE_R * DEDR_T;
+    Real bMod;
+    if (DPDE_R > 0.0 && rho > 0.0) {
+      bMod = rho * DPDR_E + DPDE_R * (press / rho);
+    } else if (rho > 0.0) {
+      bMod = std::max(rho * DPDR_T, 0.0);
+    } else {
+      bMod = 0.0;
+    }
+    return std::max(bMod, std::abs(robust::EPS()));
+  };
   for (int j = 0; j < numRho_; j++) {
     Real lRho = bMod_.range(1).x(j);
     Real rho = rho_(lRho);
@@ -873,18 +1339,18 @@ inline void SpinerEOSDependsRhoT::fixBulkModulus_() {
       Real DPDR_E = dPdRho_.interpToReal(lRho, lT);
       Real DPDE_R = dPdE_.interpToReal(lRho, lT);
       Real DEDR_T = dEdRho_.interpToReal(lRho, lT);
-      Real DPDR_T = DPDR_E + DPDE_R * DEDR_T;
-      Real bMod;
-      if (DPDE_R > 0.0 && rho > 0.0) {
-        bMod = rho * DPDR_E + DPDE_R * (press / rho);
-      } else if (rho > 0.0) {
-        bMod = std::max(rho * DPDR_T, 0.0);
-      } else {
-        bMod = 0.0;
-      }
-      bMod_(j, i) = std::max(bMod, std::abs(robust::EPS()));
+      bMod_(j, i) = bModFrom(rho, press, DPDR_E, DPDE_R, DEDR_T);
     }
   }
+  // Same fix on the patch nodes, which are then matched to the fixed
+  // base table where the two meet.
+  patches_.ForEachNode([&](const int k, const Real lRho, const Real lT) {
+    patches_.Value(PatchField::bMod, k) = bModFrom(
+        rho_(lRho), patches_.Value(PatchField::P, k),
+        patches_.Value(PatchField::dPdRho, k), patches_.Value(PatchField::dPdE, k),
+        patches_.Value(PatchField::dEdRho, k));
+  });
+  patches_.Conform(PatchField::bMod, bMod_);
 }
 
 inline void SpinerEOSDependsRhoT::setlTColdCrit_() {
@@ -929,15 +1395,17 @@ inline void SpinerEOSDependsRhoT::setlTColdCrit_() {
     if (last_pos_crossing <= 0) { // off the grid
       lTColdCrit_(j) = lTMin_;
     } else { // at least one pos crossing. Use last one.
-      const callable_interp::r_interp sieFunc(sie_, lRho);
+      const callable_interp::r_patch_interp sieFunc(patches_, PatchField::sie, sie_,
+                                                    lRho);
       Real lT;
       int ilast = crossings[last_pos_crossing];
       // expand bounds by +/- 1.e-14 to help with round-off
       Real lTlower = bMod_.range(0).x(ilast) - 1.0e-14;
       Real lTupper = bMod_.range(0).x(ilast + 1) + 1.0e-14;
       Real lTGuess = 0.5 * (lTlower + lTupper);
-      auto status = ROOT_FINDER(sieFunc, sieCold, lTGuess, lTlower, lTupper, ROOT_THRESH,
-                                ROOT_THRESH, lT);
+      auto status = ROOT_FINDER(sieFunc, sieCold, lTGuess, lTlower, lTupper,
+                                accuracy_.root_thresh, accuracy_.root_thresh, lT,
+                                nullptr, false, accuracy_.root_max_iter);
       if (status != RootFinding1D::Status::SUCCESS) {
         lT = lTGuess;
       }
@@ -954,6 +1422,21 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::TemperatureFromDensityIntern
   TableStatus whereAmI;
   const Real lRho = lRho_(rho);
   const Real lT = lTFromlRhoSie_(lRho, sie, whereAmI, lambda);
+  recordVisit_(lRho, lT, whereAmI);
+  return T_(lT);
+}
+
+template <typename Indexer_t>
+PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::TemperatureFromDensityPressure(
+    const Real rho, const Real press, Indexer_t &&lambda) const {
+  TableStatus whereAmI;
+  const Real lRho = lRho_(rho);
+  const Real lT = lTFromlRhoP_(lRho, press, whereAmI, lambda);
+  recordVisit_(lRho, lT, whereAmI);
+  if (!variadic_utils::is_nullptr(lambda)) {
+    lambda[Lambda::lRho] = lRho;
+    lambda[Lambda::lT] = lT;
+  }
   return T_(lT);
 }
 
@@ -963,6 +1446,7 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::InternalEnergyFromDensityTem
   Real lRho, lT;
   getLogsRhoT_(rho, temperature, lRho, lT, lambda);
   TableStatus whereAmI = getLocDependsRhoT_(lRho, lT);
+  recordVisit_(lRho, lT, whereAmI);
   return sieFromlRhoTlT_(lRho, temperature, lT, whereAmI);
 }
 
@@ -972,15 +1456,85 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::PressureFromDensityTemperatu
   Real lRho, lT;
   getLogsRhoT_(rho, temperature, lRho, lT, lambda);
   TableStatus whereAmI = getLocDependsRhoT_(lRho, lT);
+  recordVisit_(lRho, lT, whereAmI);
   return PFromRholRhoTlT_(rho, lRho, temperature, lT, whereAmI);
 }
 
+PORTABLE_INLINE_FUNCTION
+SpinerEOSDependsRhoT::TemperatureIndex
+SpinerEOSDependsRhoT::GetTemperatureIndex(const Real temperature) const {
+  TemperatureIndex tidx;
+  tidx.temperature = temperature;
+  tidx.lT = lT_(temperature);
+  tidx.whereAmI = getLocDependsRhoT_(lRhoMin_, tidx.lT);
+  const auto &grid = P_.range(0);
+  tidx.lTMin = grid.min();
+  tidx.lTMax = grid.max();
+  tidx.lTOffset = lTOffset_;
+  tidx.nT = grid.nPoints();
+  weights_(grid, tidx.lT, tidx.i, tidx.w);
+  return tidx;
+}
+
+PORTABLE_INLINE_FUNCTION bool
+SpinerEOSDependsRhoT::SharesTemperatureGrid(const SpinerEOSDependsRhoT &other) const {
+  const auto &grid = P_.range(0);
+  const auto &other_grid = other.P_.range(0);
+  return (lTOffset_ == other.lTOffset_) && (grid.min() == other_grid.min()) &&
+         (grid.max() == other_grid.max()) && (grid.nPoints() == other_grid.nPoints());
+}
+
+PORTABLE_INLINE_FUNCTION bool
+SpinerEOSDependsRhoT::onTemperatureGrid_(const TemperatureIndex &tidx) const {
+  const auto &grid = P_.range(0);
+  return (tidx.nT == grid.nPoints()) && (tidx.lTOffset == lTOffset_) &&
+         (tidx.lTMin == grid.min()) && (tidx.lTMax == grid.max());
+}
+
+template <typename Indexer_t>
+PORTABLE_INLINE_FUNCTION Real
+SpinerEOSDependsRhoT::InternalEnergyFromDensityTemperatureIndex(
+    const Real rho, const TemperatureIndex &tidx, Indexer_t &&lambda) const {
+  if (!onTemperatureGrid_(tidx)) {
+    return InternalEnergyFromDensityTemperature(rho, tidx.temperature, lambda);
+  }
+  const Real lRho = lRho_(rho);
+  if (!variadic_utils::is_nullptr(lambda)) {
+    lambda[Lambda::lRho] = lRho;
+    lambda[Lambda::lT] = tidx.lT;
+  }
+  recordVisit_(lRho, tidx.lT, tidx.whereAmI);
+  if (tidx.whereAmI == TableStatus::OnTable) {
+    return interpTIndex_(PatchField::sie, sie_, lRho, tidx);
+  }
+  return sieFromlRhoTlT_(lRho, tidx.temperature, tidx.lT, tidx.whereAmI);
+}
+
+template <typename Indexer_t>
+PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::PressureFromDensityTemperatureIndex(
+    const Real rho, const TemperatureIndex &tidx, Indexer_t &&lambda) const {
+  if (!onTemperatureGrid_(tidx)) {
+    return PressureFromDensityTemperature(rho, tidx.temperature, lambda);
+  }
+  const Real lRho = lRho_(rho);
+  if (!variadic_utils::is_nullptr(lambda)) {
+    lambda[Lambda::lRho] = lRho;
+    lambda[Lambda::lT] = tidx.lT;
+  }
+  recordVisit_(lRho, tidx.lT, tidx.whereAmI);
+  if (tidx.whereAmI == TableStatus::OnTable) {
+    return interpTIndex_(PatchField::P, P_, lRho, tidx);
+  }
+  return PFromRholRhoTlT_(rho, lRho, tidx.temperature, tidx.lT, tidx.whereAmI);
+}
+
 template <typename Indexer_t>
 PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::PressureFromDensityInternalEnergy(
     const Real rho, const Real sie, Indexer_t &&lambda) const {
   TableStatus whereAmI;
   Real lRho = lRho_(rho);
   Real lT = lTFromlRhoSie_(lRho, sie, whereAmI, lambda);
+  recordVisit_(lRho, lT, whereAmI);
   Real P;
   if (whereAmI == TableStatus::OffBottom) { // cold curve
     P = PCold_.interpToReal(lRho);
@@ -988,7 +1542,7 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::PressureFromDensityInternalE
     const Real gm1 = gm1Max_.interpToReal(lRho);
     P = gm1 * rho * sie;
   } else { // on table
-    P = P_.interpToReal(lRho, lT);
+    P = patches_.Interp(PatchField::P, P_, lRho, lT);
   }
   return P;
 }
@@ -1002,14 +1556,28 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::MinInternalEnergyFromDensity
 template <typename Indexer_t>
 PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::EntropyFromDensityTemperature(
     const Real rho, const Real temperature, Indexer_t &&lambda) const {
-  EntropyIsNotEnabled("SpinerEOSDependsRhoT");
-  return 1.0;
+  if (!hasEntropy_) {
+    EntropyIsNotEnabled("SpinerEOSDependsRhoT");
+    return 1.0;
+  }
+  Real lRho, lT;
+  getLogsRhoT_(rho, temperature, lRho, lT, lambda);
+  TableStatus whereAmI = getLocDependsRhoT_(lRho, lT);
+  recordVisit_(lRho, lT, whereAmI);
+  return SFromlRhoTlT_(lRho, temperature, lT, whereAmI);
 }
 template <typename Indexer_t>
 PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::EntropyFromDensityInternalEnergy(
     const Real rho, const Real sie, Indexer_t &&lambda) const {
-  EntropyIsNotEnabled("SpinerEOSDependsRhoT");
-  return 1.0;
+  if (!hasEntropy_) {
+    EntropyIsNotEnabled("SpinerEOSDependsRhoT");
+    return 1.0;
+  }
+  TableStatus whereAmI;
+  const Real lRho = lRho_(rho);
+  const Real lT = lTFromlRhoSie_(lRho, sie, whereAmI, lambda);
+  recordVisit_(lRho, lT, whereAmI);
+  return SFromlRhoTlT_(lRho, T_(lT), lT, whereAmI);
 }
 
 template <typename Indexer_t>
@@ -1018,6 +1586,7 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::SpecificHeatFromDensityTempe
   Real lRho, lT;
   getLogsRhoT_(rho, temperature, lRho, lT, lambda);
   TableStatus whereAmI = getLocDependsRhoT_(lRho, lT);
+  recordVisit_(lRho, lT, whereAmI);
   return CvFromlRholT_(lRho, lT, whereAmI);
 }
 
@@ -1028,6 +1597,7 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::SpecificHeatFromDensityInter
   Real Cv;
   const Real lRho = lRho_(rho);
   const Real lT = lTFromlRhoSie_(lRho, sie, whereAmI, lambda);
+  recordVisit_(lRho, lT, whereAmI);
   if (whereAmI == TableStatus::OffBottom) { // cold curve
     // on cold curve. Currently, we assume constant extrapolation.
     // TODO(JMM): Do something more sophisticated
@@ -1035,7 +1605,7 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::SpecificHeatFromDensityInter
   } else if (whereAmI == TableStatus::OffTop) { // ideal gas
     Cv = dEdTMax_.interpToReal(lRho);           // Cv assumed constant in T
   } else {                                      // on table
-    Cv = dEdT_.interpToReal(lRho, lT);
+    Cv = patches_.Interp(PatchField::dEdT, dEdT_, lRho, lT);
   }
   return Cv > robust::EPS() ? Cv : robust::EPS();
 }
@@ -1046,6 +1616,7 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::BulkModulusFromDensityTemper
   Real lRho, lT;
   getLogsRhoT_(rho, temperature, lRho, lT, lambda);
   TableStatus whereAmI = getLocDependsRhoT_(lRho, lT);
+  recordVisit_(lRho, lT, whereAmI);
   return bModFromRholRhoTlT_(rho, lRho, temperature, lT, whereAmI);
 }
 
@@ -1056,6 +1627,7 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::GruneisenParamFromDensityTem
   getLogsRhoT_(rho, temp, lRho, lT, lambda);
 
   TableStatus whereAmI = getLocDependsRhoT_(lRho, lT);
+  recordVisit_(lRho, lT, whereAmI);
   if (whereAmI == TableStatus::OffBottom) {
     // use cold curves
     Real dpde = dPdECold_.interpToReal(lRho);
@@ -1063,7 +1635,7 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::GruneisenParamFromDensityTem
   } else if (whereAmI == TableStatus::OffTop) {
     gm1 = gm1Max_.interpToReal(lRho);
   } else { // on table
-    const Real dpde = dPdE_.interpToReal(lRho, lT);
+    const Real dpde = patches_.Interp(PatchField::dPdE, dPdE_, lRho, lT);
     gm1 = robust::ratio(std::abs(dpde), std::abs(rho));
   }
   return gm1;
@@ -1076,6 +1648,7 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::BulkModulusFromDensityIntern
   Real bMod;
   const Real lRho = lRho_(rho);
   const Real lT = lTFromlRhoSie_(lRho, sie, whereAmI, lambda);
+  recordVisit_(lRho, lT, whereAmI);
   if (whereAmI == TableStatus::OffBottom) {
     bMod = bModCold_.interpToReal(lRho);
   } else if (whereAmI == TableStatus::OffTop) {
@@ -1096,18 +1669,46 @@ SpinerEOSDependsRhoT::GruneisenParamFromDensityInternalEnergy(const Real rho,
   Real gm1;
   const Real lRho = lRho_(rho);
   const Real lT = lTFromlRhoSie_(lRho, sie, whereAmI, lambda);
+  recordVisit_(lRho, lT, whereAmI);
   if (whereAmI == TableStatus::OffBottom) {
     Real dpde = dPdECold_.interpToReal(lRho);
     gm1 = robust::ratio(std::abs(dpde), std::abs(rho));
   } else if (whereAmI == TableStatus::OffTop) {
     gm1 = gm1Max_.interpToReal(lRho);
   } else {
-    const Real dpde = dPdE_.interpToReal(lRho, lT);
+    const Real dpde = patches_.Interp(PatchField::dPdE, dPdE_, lRho, lT);
     gm1 = robust::ratio(std::abs(dpde), std::abs(rho));
   }
   return gm1;
 }
 
+template <typename Indexer_t>
+PORTABLE_INLINE_FUNCTION ThermoDerivatives
+SpinerEOSDependsRhoT::DerivativesFromDensityTemperature(const Real rho,
+                                                        const Real temperature,
+                                                        Indexer_t &&lambda) const {
+  Real lRho, lT;
+  getLogsRhoT_(rho, temperature, lRho, lT, lambda);
+  TableStatus whereAmI = getLocDependsRhoT_(lRho, lT);
+  recordVisit_(lRho, lT, whereAmI);
+  const Real sie = (whereAmI == TableStatus::OffTop)
+                       ? sieFromlRhoTlT_(lRho, temperature, lT, whereAmI)
+                       : 0;
+  return derivsFromRholRhoSielT_(rho, lRho, sie, lT, whereAmI);
+}
+
+template <typename Indexer_t>
+PORTABLE_INLINE_FUNCTION ThermoDerivatives
+SpinerEOSDependsRhoT::DerivativesFromDensityInternalEnergy(const Real rho,
+                                                           const Real sie,
+                                                           Indexer_t &&lambda) const {
+  TableStatus whereAmI;
+  const Real lRho = lRho_(rho);
+  const Real lT = lTFromlRhoSie_(lRho, sie, whereAmI, lambda);
+  recordVisit_(lRho, lT, whereAmI);
+  return derivsFromRholRhoSielT_(rho, lRho, sie, lT, whereAmI);
+}
+
 // TODO(JMM): This would be faster with hand-tuned code
 template <typename Indexer_t>
 PORTABLE_INLINE_FUNCTION void SpinerEOSDependsRhoT::DensityEnergyFromPressureTemperature(
@@ -1154,6 +1755,7 @@ SpinerEOSDependsRhoT::FillEos(Real &rho, Real &temp, Real &energy, Real &press,
     lT = lT_(temp);
   }
   whereAmI = getLocDependsRhoT_(lRho, lT);
+  recordVisit_(lRho, lT, whereAmI);
   if (output & thermalqs::specific_internal_energy) {
     energy = sieFromlRhoTlT_(lRho, temp, lT, whereAmI);
   }
@@ -1215,7 +1817,7 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::lRhoFromPlT_(
   Real lRhoGuess = reproducible_ ? lRhoMax_ : 0.5 * (lRhoMin_ + lRhoMax_);
   // Real lRhoGuess = lRhoMin_ + 0.9*(lRhoMax_ - lRhoMin_);
   const RootFinding1D::RootCounts *pcounts =
-      (memoryStatus_ == DataStatus::OnDevice) ? nullptr : &counts;
+      diagnosticsEnabled_() ? &counts : nullptr;
   if (!variadic_utils::is_nullptr(lambda) && lRhoMin_ <= lambda[Lambda::lRho] &&
       lambda[Lambda::lRho] <= lRhoMax_) {
     lRhoGuess = lambda[Lambda::lRho];
@@ -1223,24 +1825,27 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::lRhoFromPlT_(
   if (lT <= lTMin_) { // cold curve
     whereAmI = TableStatus::OffBottom;
     const callable_interp::interp PFunc(PCold_);
-    status =
-        ROOT_FINDER(PFunc, P, lRhoGuess,
-                    // lRhoMin_, lRhoMax_,
-                    lRhoMinSearch_, lRhoMax_, ROOT_THRESH, ROOT_THRESH, lRho, pcounts);
+    status = ROOT_FINDER(PFunc, P, lRhoGuess,
+                         // lRhoMin_, lRhoMax_,
+                         lRhoMinSearch_, lRhoMax_, accuracy_.root_thresh,
+                         accuracy_.root_thresh, lRho, pcounts, false,
+                         accuracy_.root_max_iter);
   } else if (lT >= lTMax_) { // ideal gas
     whereAmI = TableStatus::OffTop;
     const callable_interp::prod_interp_1d PFunc(gm1Max_, dEdTMax_, lT);
-    status =
-        ROOT_FINDER(PFunc, P, lRhoGuess,
-                    // lRhoMin_, lRhoMax_,
-                    lRhoMinSearch_, lRhoMax_, ROOT_THRESH, ROOT_THRESH, lRho, pcounts);
+    status = ROOT_FINDER(PFunc, P, lRhoGuess,
+                         // lRhoMin_, lRhoMax_,
+                         lRhoMinSearch_, lRhoMax_, accuracy_.root_thresh,
+                         accuracy_.root_thresh, lRho, pcounts, false,
+                         accuracy_.root_max_iter);
   } else { // on table
     whereAmI = TableStatus::OnTable;
-    const callable_interp::l_interp PFunc(P_, lT);
-    status =
-        ROOT_FINDER(PFunc, P, lRhoGuess,
-                    // lRhoMin_, lRhoMax_,
-                    lRhoMinSearch_, lRhoMax_, ROOT_THRESH, ROOT_THRESH, lRho, pcounts);
+    const callable_interp::l_patch_interp PFunc(patches_, PatchField::P, P_, lT);
+    status = ROOT_FINDER(PFunc, P, lRhoGuess,
+                         // lRhoMin_, lRhoMax_,
+                         lRhoMinSearch_, lRhoMax_, accuracy_.root_thresh,
+                         accuracy_.root_thresh, lRho, pcounts, false,
+                         accuracy_.root_max_iter);
   }
   if (status != RootFinding1D::Status::SUCCESS) {
 #if SPINER_EOS_VERBOSE
@@ -1258,7 +1863,7 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::lRhoFromPlT_(
     lambda[Lambda::lRho] = lRho;
     lambda[Lambda::lT] = lT;
   }
-  if (memoryStatus_ != DataStatus::OnDevice) {
+  if (diagnosticsEnabled_()) {
     status_ = status;
     whereAmI_ = whereAmI;
   }
@@ -1270,7 +1875,7 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::lTFromlRhoSie_(
     const Real lRho, const Real sie, TableStatus &whereAmI, Indexer_t &&lambda) const {
 
   const RootFinding1D::RootCounts *pcounts =
-      (memoryStatus_ == DataStatus::OnDevice) ? nullptr : &counts;
+      diagnosticsEnabled_() ? &counts : nullptr;
   RootFinding1D::Status status = RootFinding1D::Status::SUCCESS;
   Real lT;
 
@@ -1296,9 +1901,10 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::lTFromlRhoSie_(
         lambda[Lambda::lT] <= lTMax_) {
       lTGuess = lambda[Lambda::lT];
     }
-    const callable_interp::r_interp sieFunc(sie_, lRho);
-    status = ROOT_FINDER(sieFunc, sie, lTGuess, lTMin_, lTMax_, ROOT_THRESH, ROOT_THRESH,
-                         lT, pcounts);
+    const callable_interp::r_patch_interp sieFunc(patches_, PatchField::sie, sie_, lRho);
+    status = ROOT_FINDER(sieFunc, sie, lTGuess, lTMin_, lTMax_, accuracy_.root_thresh,
+                         accuracy_.root_thresh, lT, pcounts, false,
+                         accuracy_.root_max_iter);
 
     if (status != RootFinding1D::Status::SUCCESS) {
 #if SPINER_EOS_VERBOSE
@@ -1320,7 +1926,7 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::lTFromlRhoSie_(
     lambda[Lambda::lRho] = lRho;
     lambda[Lambda::lT] = lT;
   }
-  if (memoryStatus_ != DataStatus::OnDevice) {
+  if (diagnosticsEnabled_()) {
     status_ = status;
     whereAmI_ = whereAmI;
   }
@@ -1331,7 +1937,7 @@ template <typename Indexer_t>
 PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::lTFromlRhoP_(
     const Real lRho, const Real press, TableStatus &whereAmI, Indexer_t &&lambda) const {
   const RootFinding1D::RootCounts *pcounts =
-      (memoryStatus_ == DataStatus::OnDevice) ? nullptr : &counts;
+      diagnosticsEnabled_() ? &counts : nullptr;
   RootFinding1D::Status status = RootFinding1D::Status::SUCCESS;
   Real lT, lTGuess;
 
@@ -1358,9 +1964,10 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::lTFromlRhoP_(
     } else {
       lTGuess = 0.5 * (lTMin_ + lTMax_);
     }
-    const callable_interp::r_interp PFunc(P_, lRho);
-    status = ROOT_FINDER(PFunc, press, lTGuess, lTMin_, lTMax_, ROOT_THRESH, ROOT_THRESH,
-                         lT, pcounts);
+    const callable_interp::r_patch_interp PFunc(patches_, PatchField::P, P_, lRho);
+    status = ROOT_FINDER(PFunc, press, lTGuess, lTMin_, lTMax_, accuracy_.root_thresh,
+                         accuracy_.root_thresh, lT, pcounts, false,
+                         accuracy_.root_max_iter);
     if (status != RootFinding1D::Status::SUCCESS) {
 #if SPINER_EOS_VERBOSE
       std::stringstream errorMessage;
@@ -1378,7 +1985,7 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoT::lTFromlRhoP_(
     lambda[Lambda::lRho] = lRho;
     lambda[Lambda::lT] = lT;
   }
-  if (memoryStatus_ != DataStatus::OnDevice) {
+  if (diagnosticsEnabled_()) {
     status_ = status;
     whereAmI_ = whereAmI;
   }
@@ -1396,7 +2003,7 @@ Real SpinerEOSDependsRhoT::sieFromlRhoTlT_(const Real lRho, const Real T, const
     const Real e0 = sielTMax_.interpToReal(lRho);
     sie = e0 + Cv * (T - TMax_);
   } else { // on table
-    sie = sie_.interpToReal(lRho, lT);
+    sie = patches_.Interp(PatchField::sie, sie_, lRho, lT);
   }
   return sie;
 }
@@ -1415,7 +2022,7 @@ Real SpinerEOSDependsRhoT::PFromRholRhoTlT_(const Real rho, const Real lRho, con
     const Real e = e0 + Cv * (T - TMax_);
     P = gm1 * rho * e;
   } else { // if ( whereAmI == TableStatus::OnTable) {
-    P = P_.interpToReal(lRho, lT);
+    P = patches_.Interp(PatchField::P, P_, lRho, lT);
   }
   return P;
 }
@@ -1431,11 +2038,27 @@ Real SpinerEOSDependsRhoT::CvFromlRholT_(const Real lRho, const Real lT,
   } else if (whereAmI == TableStatus::OffTop) { // ideal gas
     Cv = dEdTMax_.interpToReal(lRho);           // Cv assumed constant in T
   } else {                                      // on table
-    Cv = dEdT_.interpToReal(lRho, lT);
+    Cv = patches_.Interp(PatchField::dEdT, dEdT_, lRho, lT);
   }
   return Cv > robust::EPS() ? Cv : robust::EPS();
 }
 
+PORTABLE_INLINE_FUNCTION
+Real SpinerEOSDependsRhoT::SFromlRhoTlT_(const Real lRho, const Real T, const Real lT,
+                                         const TableStatus &whereAmI) const {
+  Real S;
+  if (whereAmI == TableStatus::OffBottom) {
+    // No unique temperature on the cold curve. Constant extrapolation.
+    S = S_.interpToReal(lRho, lTMin_);
+  } else if (whereAmI == TableStatus::OffTop) { // ideal gas
+    const Real Cv = dEdTMax_.interpToReal(lRho);
+    S = S_.interpToReal(lRho, lTMax_) + Cv * std::log(T / TMax_);
+  } else { // on table
+    S = S_.interpToReal(lRho, lT);
+  }
+  return S;
+}
+
 PORTABLE_INLINE_FUNCTION
 Real SpinerEOSDependsRhoT::bModFromRholRhoTlT_(const Real rho, const Real lRho,
                                                const Real T, const Real lT,
@@ -1450,11 +2073,45 @@ Real SpinerEOSDependsRhoT::bModFromRholRhoTlT_(const Real rho, const Real lRho,
     const Real e = e0 + Cv * (T - TMax_);
     bMod = (gm1 + 1) * gm1 * rho * e;
   } else { // on table
-    bMod = bMod_.interpToReal(lRho, lT);
+    bMod = patches_.Interp(PatchField::bMod, bMod_, lRho, lT);
   }
   return bMod > robust::EPS() ? bMod : robust::EPS();
 }
 
+PORTABLE_INLINE_FUNCTION
+ThermoDerivatives SpinerEOSDependsRhoT::derivsFromRholRhoSielT_(
+    const Real rho, const Real lRho, const Real sie, const Real lT,
+    const TableStatus &whereAmI) const {
+  ThermoDerivatives d;
+  if (whereAmI == TableStatus::OffBottom) { // cold curve
+    d.dPdRho = dPdRhoCold_.interpToReal(lRho);
+    d.dPdE = dPdECold_.interpToReal(lRho);
+    d.dTdRho = dTdRhoCold_.interpToReal(lRho);
+    d.dTdE = dTdECold_.interpToReal(lRho);
+    d.cv = dEdTCold_.interpToReal(lRho);
+    d.dEdRho = -robust::ratio(d.dTdRho, d.dTdE);
+  } else if (whereAmI == TableStatus::OffTop) { // ideal gas
+    // e = sie(rho, TMax) + Cv (T - TMax), with Cv and gm1 constant in T
+    const Real gm1 = gm1Max_.interpToReal(lRho);
+    d.cv = dEdTMax_.interpToReal(lRho);
+    d.dPdRho = gm1 * sie;
+    d.dPdE = gm1 * rho;
+    d.dEdRho = patches_.Interp(PatchField::dEdRho, dEdRho_, lRho, lTMax_);
+    d.dTdE = robust::ratio(1.0, d.cv);
+    d.dTdRho = -d.dEdRho * d.dTdE;
+  } else { // on table
+    d.dPdRho = patches_.Interp(PatchField::dPdRho, dPdRho_, lRho, lT);
+    d.dPdE = patches_.Interp(PatchField::dPdE, dPdE_, lRho, lT);
+    d.dTdRho = patches_.Interp(PatchField::dTdRho, dTdRho_, lRho, lT);
+    d.dTdE = patches_.Interp(PatchField::dTdE, dTdE_, lRho, lT);
+    d.dEdRho = patches_.Interp(PatchField::dEdRho, dEdRho_, lRho, lT);
+    d.cv = patches_.Interp(PatchField::dEdT, dEdT_, lRho, lT);
+  }
+  d.cv = d.cv > robust::EPS() ? d.cv : robust::EPS();
+  d.gruneisen = robust::ratio(std::abs(d.dPdE), std::abs(rho));
+  return d;
+}
+
 PORTABLE_INLINE_FUNCTION
 TableStatus SpinerEOSDependsRhoT::getLocDependsRhoSie_(const Real lRho,
                                                        const Real sie) const {
@@ -1469,7 +2126,7 @@ TableStatus SpinerEOSDependsRhoT::getLocDependsRhoSie_(const Real lRho,
   } else {
     whereAmI = TableStatus::OnTable;
   }
-  if (memoryStatus_ != DataStatus::OnDevice) {
+  if (diagnosticsEnabled_()) {
     whereAmI_ = whereAmI;
   }
   return whereAmI;
@@ -1484,7 +2141,7 @@ SpinerEOSDependsRhoT::getLocDependsRhoT_(const Real lRho, const Real lT) const {
     whereAmI = TableStatus::OffTop;
   else
     whereAmI = TableStatus::OnTable;
-  if (memoryStatus_ != DataStatus::OnDevice) {
+  if (diagnosticsEnabled_()) {
     whereAmI_ = whereAmI;
   }
   return whereAmI;
@@ -1500,7 +2157,7 @@ inline SpinerEOSDependsRhoSie::SpinerEOSDependsRhoSie(const std::string &filenam
   hid_t file, matGroup, lTGroup, lEGroup;
   herr_t status = H5_SUCCESS;
 
-  file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  file = SP5::Compression::Open(filename, matid_str);
   matGroup = H5Gopen(file, matid_str.c_str(), H5P_DEFAULT);
   lTGroup = H5Gopen(matGroup, SP5::Depends::logRhoLogT, H5P_DEFAULT);
   lEGroup = H5Gopen(matGroup, SP5::Depends::logRhoLogSie, H5P_DEFAULT);
@@ -1527,7 +2184,7 @@ inline SpinerEOSDependsRhoSie::SpinerEOSDependsRhoSie(const std::string &filenam
   hid_t file, matGroup, lTGroup, lEGroup;
   herr_t status = H5_SUCCESS;
 
-  file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  file = SP5::Compression::Open(filename, materialName);
   matGroup = H5Gopen(file, materialName.c_str(), H5P_DEFAULT);
   lTGroup = H5Gopen(matGroup, SP5::Depends::logRhoLogT, H5P_DEFAULT);
   lEGroup = H5Gopen(matGroup, SP5::Depends::logRhoLogSie, H5P_DEFAULT);
@@ -1548,10 +2205,33 @@ inline SpinerEOSDependsRhoSie::SpinerEOSDependsRhoSie(const std::string &filenam
   }
 }
 
+inline SpinerEOSDependsRhoSie::SpinerEOSDependsRhoSie(const std::string &filename,
+                                                      int matid,
+                                                      const TableWindow &window,
+                                                      bool reproducibility_mode)
+    : SpinerEOSDependsRhoSie(filename, matid, reproducibility_mode) {
+  Crop(window);
+}
+
+inline SpinerEOSDependsRhoSie::SpinerEOSDependsRhoSie(const std::string &filename,
+                                                      const std::string &materialName,
+                                                      const TableWindow &window,
+                                                      bool reproducibility_mode)
+    : SpinerEOSDependsRhoSie(filename, materialName, reproducibility_mode) {
+  Crop(window);
+}
+
 herr_t SpinerEOSDependsRhoSie::loadDataboxes_(const std::string &matid_str, hid_t file,
                                               hid_t lTGroup, hid_t lEGroup) {
   herr_t status = H5_SUCCESS;
 
+  // Lookups here use the base tables only, so a table with patches
+  // would silently disagree with SpinerEOSDependsRhoT inside them.
+  if (TablePatches::Exists(lTGroup)) {
+    EOS_ERROR("SpinerEOSDependsRhoSie: tables with refined patches are only "
+              "supported by SpinerEOSDependsRhoT\n");
+  }
+
   // offsets
   status +=
       H5LTget_attribute_double(file, matid_str.c_str(), SP5::Offsets::rho, &lRhoOffset_);
@@ -1589,20 +2269,15 @@ herr_t SpinerEOSDependsRhoSie::loadDataboxes_(const std::string &matid_str, hid_
   status += dependsRhoSie_.dTdRho.loadHDF(lEGroup, SP5::Fields::dTdRho);
   status += dependsRhoSie_.dTdE.loadHDF(lEGroup, SP5::Fields::dTdE);
   status += dependsRhoSie_.dEdRho.loadHDF(lEGroup, SP5::Fields::dEdRho);
+  // entropy, if the table has it
+  hasEntropy_ = (H5Lexists(lTGroup, SP5::Fields::entropy, H5P_DEFAULT) > 0 &&
+                 H5Lexists(lEGroup, SP5::Fields::entropy, H5P_DEFAULT) > 0);
+  if (hasEntropy_) {
+    status += dependsRhoT_.S.loadHDF(lTGroup, SP5::Fields::entropy);
+    status += dependsRhoSie_.S.loadHDF(lEGroup, SP5::Fields::entropy);
+  }
 
-  // Fix up bulk modulus
-  calcBMod_(dependsRhoT_);
-  calcBMod_(dependsRhoSie_);
-
-  // Metadata for root finding extrapolation
-  numRho_ = sie_.dim(2);
-  lRhoMin_ = sie_.range(1).min();
-  lRhoMax_ = sie_.range(1).max();
-  rhoMax_ = fromLog_(lRhoMax_, lRhoOffset_);
-
-  // slice to maximum of rho
-  PlRhoMax_ = dependsRhoT_.P.slice(numRho_ - 1);
-  dPdRhoMax_ = dependsRhoT_.dPdRho.slice(numRho_ - 1);
+  setDerivedTables_();
 
   // reference state
   Real lRhoNormal = toLog_(rhoNormal_, lRhoOffset_);
@@ -1631,6 +2306,152 @@ herr_t SpinerEOSDependsRhoSie::loadDataboxes_(const std::string &matid_str, hid_
   return status;
 }
 
+inline void SpinerEOSDependsRhoSie::setDerivedTables_() {
+  // Fix up bulk modulus
+  calcBMod_(dependsRhoT_);
+  calcBMod_(dependsRhoSie_);
+
+  // Metadata for root finding extrapolation
+  numRho_ = sie_.dim(2);
+  lRhoMin_ = sie_.range(1).min();
+  lRhoMax_ = sie_.range(1).max();
+  rhoMax_ = fromLog_(lRhoMax_, lRhoOffset_);
+
+  // slice to maximum of rho
+  PlRhoMax_ = dependsRhoT_.P.slice(numRho_ - 1);
+  dPdRhoMax_ = dependsRhoT_.dPdRho.slice(numRho_ - 1);
+}
+
+inline void SpinerEOSDependsRhoSie::BakeTransform(const TableTransform &transform) {
+  using table_transform::Multiply;
+  using table_transform::Retabulate;
+  if (memoryStatus_ != DataStatus::OnHost) {
+    EOS_ERROR("SpinerEOSDependsRhoSie: tables must be on host to be transformed\n");
+  }
+  if (!transform.IsValid()) {
+    EOS_ERROR("SpinerEOSDependsRhoSie: invalid table transform\n");
+  }
+  if (transform.IsIdentity()) return;
+
+  // Tables are indexed (rho, T) or (rho, sie)
+  const Real rhoT_scales[] = {transform.temp, transform.rho};
+  const Real rhoSie_scales[] = {transform.sie, transform.rho};
+  auto bake = [&](SP5Tables &tables, const Real *scales) {
+    const Multiply press{transform.press};
+    Retabulate(tables.P, scales, press);
+    Retabulate(tables.bMod, scales, press);
+    Retabulate(tables.dPdRho, scales, Multiply{transform.dPdRho()});
+    Retabulate(tables.dPdE, scales, Multiply{transform.dPdE()});
+    Retabulate(tables.dTdRho, scales, Multiply{transform.dTdRho()});
+    Retabulate(tables.dTdE, scales, Multiply{transform.dTdE()});
+    Retabulate(tables.dEdRho, scales, Multiply{transform.dEdRho()});
+    if (hasEntropy_) Retabulate(tables.S, scales, Multiply{transform.entropy});
+  };
+  Retabulate(sie_, rhoT_scales, [&](const Real e) { return transform.SieFromTable(e); });
+  Retabulate(T_, rhoSie_scales, [&](const Real T) { return transform.TFromTable(T); });
+  bake(dependsRhoT_, rhoT_scales);
+  bake(dependsRhoSie_, rhoSie_scales);
+  // The energy offset absorbs the shift and may become negative.
+  lRhoOffset_ = transform.RhoOffset(lRhoOffset_);
+  lTOffset_ = transform.TOffset(lTOffset_);
+  lEOffset_ = transform.SieOffset(lEOffset_);
+
+  // PlRhoMax_ and dPdRhoMax_ still point into the old tables
+  setDerivedTables_();
+
+  transform.ReferenceStateFromTable(rhoNormal_, TNormal_, sieNormal_, PNormal_,
+                                    CvNormal_, bModNormal_, dPdENormal_, dVdTNormal_);
+}
+
+inline void SpinerEOSDependsRhoSie::Crop(const TableWindow &window) {
+  if (memoryStatus_ != DataStatus::OnHost) {
+    EOS_ERROR("SpinerEOSDependsRhoSie: tables must be on host to be cropped\n");
+  }
+  if (!window.IsValid()) {
+    EOS_ERROR("SpinerEOSDependsRhoSie: invalid table window\n");
+  }
+  auto crop = [this](SP5Tables &tables, const int *lo, const int *hi) {
+    DataBox *dbs[] = {&tables.P,      &tables.bMod, &tables.dPdRho, &tables.dPdE,
+                      &tables.dTdRho, &tables.dTdE, &tables.dEdRho};
+    for (DataBox *db : dbs) {
+      table_window::Crop(*db, lo, hi);
+    }
+    if (hasEntropy_) table_window::Crop(tables.S, lo, hi);
+  };
+
+  // Tables are indexed (rho, T) or (rho, sie)
+  const Real lRhoLo = toLog_(window.rhoMin, lRhoOffset_);
+  const Real lRhoHi = toLog_(window.rhoMax, lRhoOffset_);
+  int lo[2], hi[2];
+  table_window::NodeRange(sie_.range(1), lRhoLo, lRhoHi, window.margin, lo[1], hi[1]);
+  table_window::NodeRange(sie_.range(0), toLog_(window.TMin, lTOffset_),
+                          toLog_(window.TMax, lTOffset_), window.margin, lo[0], hi[0]);
+  table_window::Crop(sie_, lo, hi);
+  crop(dependsRhoT_, lo, hi);
+
+  // Keep the energies spanned by the cropped (rho, T) table
+  Real sieMin = std::numeric_limits<Real>::max();
+  Real sieMax = std::numeric_limits<Real>::lowest();
+  for (int j = 0; j < sie_.dim(2); ++j) {
+    for (int i = 0; i < sie_.dim(1); ++i) {
+      sieMin = std::min(sieMin, sie_(j, i));
+      sieMax = std::max(sieMax, sie_(j, i));
+    }
+  }
+  table_window::NodeRange(T_.range(1), lRhoLo, lRhoHi, window.margin, lo[1], hi[1]);
+  table_window::NodeRange(T_.range(0), toLog_(sieMin, lEOffset_),
+                          toLog_(sieMax, lEOffset_), window.margin, lo[0], hi[0]);
+  table_window::Crop(T_, lo, hi);
+  crop(dependsRhoSie_, lo, hi);
+
+  // PlRhoMax_ and dPdRhoMax_ still point into the old tables. The
+  // reference state keeps the values read from the full table.
+  setDerivedTables_();
+}
+
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+inline TableWindow SpinerEOSDependsRhoSie::VisitedWindow(const TableHeatmap &heatmap,
+                                                         const int margin) const {
+  TableWindow visited;
+  visited.margin = margin;
+  visited.rhoMin = visited.TMin = std::numeric_limits<Real>::max();
+  visited.rhoMax = visited.TMax = std::numeric_limits<Real>::lowest();
+  bool found = false;
+  Real lRhoLo, lRhoHi, yLo, yHi;
+  const int gridRhoT = heatmap.FindGrid("rho_T");
+  if (gridRhoT >= 0 && heatmap.VisitedBounds(gridRhoT, lRhoLo, lRhoHi, yLo, yHi)) {
+    found = true;
+    visited.rhoMin = fromLog_(lRhoLo, lRhoOffset_);
+    visited.rhoMax = fromLog_(lRhoHi, lRhoOffset_);
+    visited.TMin = fromLog_(yLo, lTOffset_);
+    visited.TMax = fromLog_(yHi, lTOffset_);
+  }
+  // Lookups in (rho, sie) visit the temperatures tabulated in T_
+  // over the visited cells
+  const int gridRhoSie = heatmap.FindGrid("rho_sie");
+  if (gridRhoSie >= 0 && heatmap.VisitedBounds(gridRhoSie, lRhoLo, lRhoHi, yLo, yHi)) {
+    found = true;
+    visited.rhoMin = std::min(visited.rhoMin, fromLog_(lRhoLo, lRhoOffset_));
+    visited.rhoMax = std::max(visited.rhoMax, fromLog_(lRhoHi, lRhoOffset_));
+    int jlo, jhi, ilo, ihi;
+    table_window::NodeRange(T_.range(1), lRhoLo, lRhoHi, 0, jlo, jhi);
+    table_window::NodeRange(T_.range(0), yLo, yHi, 0, ilo, ihi);
+    for (int j = jlo; j <= jhi; ++j) {
+      for (int i = ilo; i <= ihi; ++i) {
+        visited.TMin = std::min(visited.TMin, T_(j, i));
+        visited.TMax = std::max(visited.TMax, T_(j, i));
+      }
+    }
+  }
+  if (!found) {
+    TableWindow window;
+    window.margin = margin;
+    return window;
+  }
+  return visited;
+}
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+
 inline void SpinerEOSDependsRhoSie::calcBMod_(SP5Tables &tables) {
   for (int j = 0; j < tables.bMod.dim(2); j++) {
     Real lRho = tables.bMod.range(1).x(j);
@@ -1654,6 +2475,25 @@ inline void SpinerEOSDependsRhoSie::calcBMod_(SP5Tables &tables) {
   }
 }
 
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+inline void SpinerEOSDependsRhoSie::SetHeatmap(TableHeatmap *heatmap) {
+  heatmap_ = heatmap;
+  if (heatmap_ != nullptr) {
+    const auto &lRhoGrid = dependsRhoT_.P.range(1);
+    const auto &lTGrid = dependsRhoT_.P.range(0);
+    const auto &lEGrid = dependsRhoSie_.P.range(0);
+    heatmapRhoT_ =
+        heatmap_->AddGrid("rho_T", "log(rho)", lRhoGrid.min(), lRhoGrid.max(),
+                          lRhoGrid.nPoints(), "log(T)", lTGrid.min(), lTGrid.max(),
+                          lTGrid.nPoints());
+    heatmapRhoSie_ =
+        heatmap_->AddGrid("rho_sie", "log(rho)", lRhoGrid.min(), lRhoGrid.max(),
+                          lRhoGrid.nPoints(), "log(sie)", lEGrid.min(), lEGrid.max(),
+                          lEGrid.nPoints());
+  }
+}
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+
 inline SpinerEOSDependsRhoSie SpinerEOSDependsRhoSie::GetOnDevice() {
   SpinerEOSDependsRhoSie other;
   using Spiner::getOnDeviceDataBox;
@@ -1673,6 +2513,11 @@ inline SpinerEOSDependsRhoSie SpinerEOSDependsRhoSie::GetOnDevice() {
   other.dependsRhoSie_.dTdRho = getOnDeviceDataBox<Real>(dependsRhoSie_.dTdRho);
   other.dependsRhoSie_.dTdE = getOnDeviceDataBox<Real>(dependsRhoSie_.dTdE);
   other.dependsRhoSie_.dEdRho = getOnDeviceDataBox<Real>(dependsRhoSie_.dEdRho);
+  if (hasEntropy_) {
+    other.dependsRhoT_.S = getOnDeviceDataBox<Real>(dependsRhoT_.S);
+    other.dependsRhoSie_.S = getOnDeviceDataBox<Real>(dependsRhoSie_.S);
+  }
+  other.hasEntropy_ = hasEntropy_;
   other.numRho_ = numRho_;
   other.lRhoMin_ = lRhoMin_;
   other.lRhoMax_ = lRhoMax_;
@@ -1693,6 +2538,13 @@ inline SpinerEOSDependsRhoSie SpinerEOSDependsRhoSie::GetOnDevice() {
   other.matid_ = matid_;
   other.reproducible_ = reproducible_;
   other.status_ = status_;
+  other.diagnostics_ = diagnostics_;
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+  other.heatmap_ = heatmap_;
+  other.heatmapRhoT_ = heatmapRhoT_;
+  other.heatmapRhoSie_ = heatmapRhoSie_;
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+  other.accuracy_ = accuracy_;
   other.memoryStatus_ = DataStatus::OnDevice;
   return other;
 }
@@ -1714,6 +2566,10 @@ void SpinerEOSDependsRhoSie::Finalize() {
   dependsRhoSie_.dTdRho.finalize();
   dependsRhoSie_.dTdE.finalize();
   dependsRhoSie_.dEdRho.finalize();
+  if (hasEntropy_) {
+    dependsRhoT_.S.finalize();
+    dependsRhoSie_.S.finalize();
+  }
   if (memoryStatus_ == DataStatus::OnDevice) { // these are slices on host
     PlRhoMax_.finalize();
     dPdRhoMax_.finalize();
@@ -1757,14 +2613,20 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoSie::MinInternalEnergyFromDensi
 template <typename Indexer_t>
 PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoSie::EntropyFromDensityTemperature(
     const Real rho, const Real temperature, Indexer_t &&lambda) const {
-  EntropyIsNotEnabled("SpinerEOSDependsRhoSie");
-  return 1.0;
+  if (!hasEntropy_) {
+    EntropyIsNotEnabled("SpinerEOSDependsRhoSie");
+    return 1.0;
+  }
+  return interpRhoT_(rho, temperature, dependsRhoT_.S, lambda);
 }
 template <typename Indexer_t>
 PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoSie::EntropyFromDensityInternalEnergy(
     const Real rho, const Real sie, Indexer_t &&lambda) const {
-  EntropyIsNotEnabled("SpinerEOSDependsRhoSie");
-  return 1.0;
+  if (!hasEntropy_) {
+    EntropyIsNotEnabled("SpinerEOSDependsRhoSie");
+    return 1.0;
+  }
+  return interpRhoSie_(rho, sie, dependsRhoSie_.S, lambda);
 }
 
 template <typename Indexer_t>
@@ -1809,10 +2671,38 @@ SpinerEOSDependsRhoSie::GruneisenParamFromDensityInternalEnergy(
     const Real rho, const Real sie, Indexer_t &&lambda) const {
   const Real lRho = toLog_(rho, lRhoOffset_);
   const Real lE = toLog_(sie, lEOffset_);
+  recordVisitRhoSie_(lRho, lE);
   const Real dpde = dependsRhoSie_.dPdE.interpToReal(lRho, lE);
   return dpde / rho;
 }
 
+template <typename Indexer_t>
+PORTABLE_INLINE_FUNCTION ThermoDerivatives
+SpinerEOSDependsRhoSie::DerivativesFromDensityTemperature(const Real rho, const Real T,
+                                                          Indexer_t &&lambda) const {
+  const Real lRho = toLog_(rho, lRhoOffset_);
+  const Real lT = toLog_(T, lTOffset_);
+  if (!variadic_utils::is_nullptr(lambda)) {
+    lambda[0] = lRho;
+  }
+  recordVisitRhoT_(lRho, lT);
+  return derivsFromTables_(rho, lRho, lT, dependsRhoT_);
+}
+
+template <typename Indexer_t>
+PORTABLE_INLINE_FUNCTION ThermoDerivatives
+SpinerEOSDependsRhoSie::DerivativesFromDensityInternalEnergy(const Real rho,
+                                                             const Real sie,
+                                                             Indexer_t &&lambda) const {
+  const Real lRho = toLog_(rho, lRhoOffset_);
+  const Real lE = toLog_(sie, lEOffset_);
+  if (!variadic_utils::is_nullptr(lambda)) {
+    lambda[0] = lRho;
+  }
+  recordVisitRhoSie_(lRho, lE);
+  return derivsFromTables_(rho, lRho, lE, dependsRhoSie_);
+}
+
 template <typename Indexer_t>
 PORTABLE_INLINE_FUNCTION void
 SpinerEOSDependsRhoSie::DensityEnergyFromPressureTemperature(const Real press,
@@ -1822,6 +2712,7 @@ SpinerEOSDependsRhoSie::DensityEnergyFromPressureTemperature(const Real press,
   Real lT = toLog_(temp, lTOffset_);
   Real lRho = lRhoFromPlT_(press, lT, lambda);
   rho = fromLog_(lRho, lRhoOffset_);
+  recordVisitRhoT_(lRho, lT);
   sie = sie_.interpToReal(lRho, lT);
 }
 
@@ -1851,6 +2742,7 @@ SpinerEOSDependsRhoSie::FillEos(Real &rho, Real &temp, Real &energy, Real &press
   }
   if (output & thermalqs::temperature) {
     lE = toLog_(energy, lEOffset_);
+    recordVisitRhoSie_(lRho, lE);
     temp = T_.interpToReal(lRho, lE);
     if (output & thermalqs::pressure) {
       press = dependsRhoSie_.P.interpToReal(lRho, lE);
@@ -1864,6 +2756,7 @@ SpinerEOSDependsRhoSie::FillEos(Real &rho, Real &temp, Real &energy, Real &press
   }
   if (output & thermalqs::specific_internal_energy) {
     lT = toLog_(temp, lTOffset_);
+    recordVisitRhoT_(lRho, lT);
     energy = sie_.interpToReal(lRho, lT);
     if (output & thermalqs::pressure) {
       press = dependsRhoT_.P.interpToReal(lRho, lT);
@@ -1899,6 +2792,7 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoSie::interpRhoT_(
   if (!variadic_utils::is_nullptr(lambda)) {
     lambda[0] = lRho;
   }
+  recordVisitRhoT_(lRho, lT);
   return db.interpToReal(lRho, lT);
 }
 
@@ -1910,14 +2804,31 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoSie::interpRhoSie_(
   if (!variadic_utils::is_nullptr(lambda)) {
     lambda[0] = lRho;
   }
+  recordVisitRhoSie_(lRho, lE);
   return db.interpToReal(lRho, lE);
 }
 
+PORTABLE_INLINE_FUNCTION
+ThermoDerivatives
+SpinerEOSDependsRhoSie::derivsFromTables_(const Real rho, const Real lRho, const Real y,
+                                          const SP5Tables &tables) const {
+  ThermoDerivatives d;
+  d.dPdRho = tables.dPdRho.interpToReal(lRho, y);
+  d.dPdE = tables.dPdE.interpToReal(lRho, y);
+  d.dTdRho = tables.dTdRho.interpToReal(lRho, y);
+  d.dTdE = tables.dTdE.interpToReal(lRho, y);
+  d.dEdRho = tables.dEdRho.interpToReal(lRho, y);
+  d.cv = robust::ratio(1.0, d.dTdE);
+  d.cv = d.cv > robust::EPS() ? d.cv : robust::EPS();
+  d.gruneisen = robust::ratio(d.dPdE, rho);
+  return d;
+}
+
 template <typename Indexer_t>
 PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoSie::lRhoFromPlT_(
     const Real P, const Real lT, Indexer_t &&lambda) const {
   const RootFinding1D::RootCounts *pcounts =
-      (memoryStatus_ == DataStatus::OnDevice) ? nullptr : &counts;
+      diagnosticsEnabled_() ? &counts : nullptr;
   Real lRho;
   Real dPdRhoMax = dPdRhoMax_.interpToReal(lT);
   Real PMax = PlRhoMax_.interpToReal(lT);
@@ -1934,9 +2845,10 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoSie::lRhoFromPlT_(
       lRhoGuess = lambda[0];
     }
     const callable_interp::l_interp PFunc(dependsRhoT_.P, lT);
-    auto status = ROOT_FINDER(PFunc, P, lRhoGuess, lRhoMin_, lRhoMax_, robust::EPS(),
-                              robust::EPS(), lRho, pcounts);
-    if (memoryStatus_ != DataStatus::OnDevice) {
+    auto status = ROOT_FINDER(PFunc, P, lRhoGuess, lRhoMin_, lRhoMax_,
+                              accuracy_.root_thresh, accuracy_.root_thresh, lRho,
+                              pcounts, false, accuracy_.root_max_iter);
+    if (diagnosticsEnabled_()) {
       status_ = status;
     }
     if (status != RootFinding1D::Status::SUCCESS) {
@@ -1956,6 +2868,39 @@ PORTABLE_INLINE_FUNCTION Real SpinerEOSDependsRhoSie::lRhoFromPlT_(
   return lRho;
 }
 
+inline SpinerMaterialLibrary::SpinerMaterialLibrary(const std::string &filename,
+                                                    const std::vector<int> &matids,
+                                                    bool reproducibility_mode) {
+  materials_.reserve(matids.size());
+  for (const int matid : matids) {
+    materials_.emplace_back(filename, matid, reproducibility_mode);
+    if (!materials_.back().SharesTemperatureGrid(materials_.front())) {
+      std::stringstream errorMessage;
+      errorMessage << "SpinerMaterialLibrary: matid " << matid << " in " << filename
+                   << " does not share the temperature grid of matid "
+                   << materials_.front().matid() << std::endl;
+      Finalize();
+      EOS_ERROR(errorMessage.str().c_str());
+    }
+  }
+}
+
+inline std::vector<SpinerEOSDependsRhoT> SpinerMaterialLibrary::GetOnDevice() {
+  std::vector<SpinerEOSDependsRhoT> device;
+  device.reserve(materials_.size());
+  for (auto &eos : materials_) {
+    device.push_back(eos.GetOnDevice());
+  }
+  return device;
+}
+
+inline void SpinerMaterialLibrary::Finalize() {
+  for (auto &eos : materials_) {
+    eos.Finalize();
+  }
+  materials_.clear();
+}
+
 } // namespace singularity
 
 #endif // SINGULARITY_USE_SPINER_WITH_HDF5
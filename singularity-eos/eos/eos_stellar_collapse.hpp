@@ -18,12 +18,15 @@
 #ifdef SINGULARITY_USE_SPINER_WITH_HDF5
 
 // C++ includes
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <string>
 #include <vector>
 
 // C includes
+#include <cmath>
+#include <cstdio>
 #include <cstdlib>
 #include <hdf5.h>
 #include <hdf5_hl.h>
@@ -32,11 +35,17 @@
 #include <ports-of-call/portability.hpp>
 
 // singularity-eos
+#include <singularity-eos/base/accuracy.hpp>
 #include <singularity-eos/base/constants.hpp>
 #include <singularity-eos/base/fast-math/logs.hpp>
 #include <singularity-eos/base/robust_utils.hpp>
 #include <singularity-eos/base/root-finding-1d/root_finding.hpp>
 #include <singularity-eos/base/sp5/singularity_eos_sp5.hpp>
+#include <singularity-eos/base/sp5/sp5_compression.hpp>
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+#include <singularity-eos/base/table_heatmap.hpp>
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+#include <singularity-eos/base/table_transform.hpp>
 #include <singularity-eos/base/variadic_utils.hpp>
 #include <singularity-eos/eos/eos_base.hpp>
 
@@ -89,9 +98,20 @@ class StellarCollapse : public EosBase<StellarCollapse> {
 
   inline StellarCollapse(const std::string &filename, bool use_sp5 = false,
                          bool filter_bmod = true);
+  // Restricts the tables to the electron fractions in [YeMin, YeMax].
+  // If YeMin == YeMax, the tables are collapsed to 2D slices at that
+  // electron fraction and the Ye stored in lambda is ignored.
+  inline StellarCollapse(const std::string &filename, bool use_sp5, bool filter_bmod,
+                         const Real YeMin, const Real YeMax);
 
-  // Saves to an SP5 file
-  inline void Save(const std::string &filename);
+  // Saves to an SP5 file, optionally chunked and compressed
+  inline void Save(const std::string &filename,
+                   const SP5::Compression::Options &compression = {});
+
+  // Absorbs the map applied by a stack of modifiers into the
+  // tables. The Ye axis, mass fractions, and chemical potentials are
+  // unaffected. Host only. See EOSBuilder::BakeModifiers.
+  inline void BakeTransform(const TableTransform &transform);
 
   PORTABLE_INLINE_FUNCTION
   StellarCollapse() : memoryStatus_(DataStatus::Deallocated) {}
@@ -149,10 +169,6 @@ class StellarCollapse : public EosBase<StellarCollapse> {
   PORTABLE_INLINE_FUNCTION Real GruneisenParamFromDensityInternalEnergy(
       const Real rho, const Real sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t>
-  PORTABLE_INLINE_FUNCTION void
-  DensityEnergyFromPressureTemperature(const Real press, const Real temp,
-                                       Indexer_t &&lambda, Real &rho, Real &sie) const;
 
   // Properties of an NSE EOS
   template <typename Indexer_t = Real *>
@@ -191,21 +207,41 @@ class StellarCollapse : public EosBase<StellarCollapse> {
   PORTABLE_FORCEINLINE_FUNCTION Real YeMax() const { return YeMax_; }
   PORTABLE_FORCEINLINE_FUNCTION Real sieMin() const { return sieMin_; }
   PORTABLE_FORCEINLINE_FUNCTION Real sieMax() const { return sieMax_; }
+  PORTABLE_FORCEINLINE_FUNCTION bool FixedYe() const { return fixedYe_; }
   PORTABLE_INLINE_FUNCTION void PrintParams() const {
     printf("StellarCollapse parameters:\n"
-           "depends on log10(rho), log10(T), Ye\n"
+           "depends on log10(rho), log10(T)%s\n"
            "lrho bounds = %.14e, %.14e\n"
            "lT bounds = %.14e, %.14e\n"
            "Ye bounds = %.14e, %.14e\n",
-           lRhoMin_, lRhoMax_, lTMin_, lTMax_, YeMin_, YeMax_);
+           fixedYe_ ? " at fixed Ye" : ", Ye", lRhoMin_, lRhoMax_, lTMin_, lTMax_,
+           YeMin_, YeMax_);
     return;
   }
   PORTABLE_FORCEINLINE_FUNCTION Real MinimumDensity() const { return rhoMin(); }
   PORTABLE_FORCEINLINE_FUNCTION Real MinimumTemperature() const { return TMin(); }
+  PORTABLE_FORCEINLINE_FUNCTION Real MaximumDensity() const { return rhoMax(); }
+  PORTABLE_FORCEINLINE_FUNCTION Real MaximumTemperature() const { return TMax(); }
   PORTABLE_INLINE_FUNCTION
   int nlambda() const noexcept { return _n_lambda; }
   inline RootFinding1D::Status rootStatus() const { return status_; }
   RootFinding1D::RootCounts counts;
+  // Host-side diagnostics. See models.rst for thread safety.
+  inline void SetDiagnostics(const bool diagnostics) { diagnostics_ = diagnostics; }
+  PORTABLE_INLINE_FUNCTION
+  bool Diagnostics() const { return diagnostics_; }
+  // Tolerance and iteration limit of the energy inversion. See accuracy.hpp.
+  inline void SetAccuracy(const AccuracyParams &params) { accuracy_ = params; }
+  PORTABLE_INLINE_FUNCTION
+  AccuracyParams GetAccuracy() const { return accuracy_; }
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+  // Counts the (log(rho), log(T)) table cells visited by lookups into
+  // heatmap, summed over Ye. Lookups below the cold curve or above the
+  // hot curve count as off the bottom or top. heatmap must outlive
+  // this object and its copies. Pass nullptr to stop. See
+  // table_heatmap.hpp.
+  inline void SetHeatmap(TableHeatmap *heatmap);
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
   inline void Finalize();
   static std::string EosType() { return std::string("StellarCollapse"); }
   static std::string EosPyType() { return EosType(); }
@@ -221,6 +257,21 @@ class StellarCollapse : public EosBase<StellarCollapse> {
 
  private:
   inline void LoadFromSP5File_(const std::string &filename);
+  PORTABLE_FORCEINLINE_FUNCTION
+  bool diagnosticsEnabled_() const noexcept {
+    return diagnostics_ && (memoryStatus_ != DataStatus::OnDevice);
+  }
+  PORTABLE_FORCEINLINE_FUNCTION
+  void recordVisit_(const Real lRho, const Real lT) const {
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+    if (heatmap_ != nullptr) {
+      const TableStatus whereAmI = (lT <= lTMin_)   ? TableStatus::OffBottom
+                                   : (lT >= lTMax_) ? TableStatus::OffTop
+                                                    : TableStatus::OnTable;
+      heatmap_->Record(heatmapGrid_, lRho, lT, whereAmI);
+    }
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+  }
   inline void LoadFromStellarCollapseFile_(const std::string &filename, bool filter_bmod);
   inline int readSCInt_(const hid_t &file_id, const std::string &name);
   inline void readBounds_(const hid_t &file_id, const std::string &name, int size,
@@ -237,6 +288,21 @@ class StellarCollapse : public EosBase<StellarCollapse> {
   inline void computeBulkModulus_();
   inline void computeColdAndHotCurves_();
   inline void setNormalValues_();
+  inline void restrictYe_(const Real YeLo, const Real YeHi);
+  inline void cropYe_(DataBox &db, const int iLo, const int iHi) const;
+  inline void sliceYe_(DataBox &db, const Real Ye) const;
+
+  // In fixed-Ye mode the tables are 2D in (lT, lRho) and the cold and
+  // hot curves are 1D in lRho.
+  PORTABLE_FORCEINLINE_FUNCTION Real interp_(const DataBox &db, const Real Ye,
+                                             const Real lT,
+                                             const Real lRho) const noexcept {
+    return fixedYe_ ? db.interpToReal(lT, lRho) : db.interpToReal(Ye, lT, lRho);
+  }
+  PORTABLE_FORCEINLINE_FUNCTION Real interpCurve_(const DataBox &db, const Real Ye,
+                                                  const Real lRho) const noexcept {
+    return fixedYe_ ? db.interpToReal(lRho) : db.interpToReal(Ye, lRho);
+  }
 
   template <typename Indexer_t>
   PORTABLE_FORCEINLINE_FUNCTION void checkLambda_(Indexer_t &&lambda) const noexcept {
@@ -304,6 +370,7 @@ class StellarCollapse : public EosBase<StellarCollapse> {
     lT = lT_(temp);
     Ye = lambda[Lambda::Ye];
     lambda[Lambda::lT] = lT;
+    recordVisit_(lRho, lT);
   }
   template <typename Indexer_t>
   PORTABLE_INLINE_FUNCTION __attribute__((always_inline)) void
@@ -312,6 +379,7 @@ class StellarCollapse : public EosBase<StellarCollapse> {
     lRho = lRho_(rho);
     lT = lTFromlRhoSie_(lRho, sie, lambda);
     Ye = lambda[Lambda::Ye];
+    recordVisit_(lRho, lT);
     return;
   }
 
@@ -344,14 +412,17 @@ class StellarCollapse : public EosBase<StellarCollapse> {
   Real lTMin_, lTMax_;
   Real YeMin_, YeMax_;
   Real sieMin_, sieMax_;
+  bool fixedYe_ = false;
 
   static constexpr Real MeV2GK_ = 11.604525006;
   static constexpr Real GK2MeV_ = 1. / MeV2GK_;
   static constexpr Real MeV2K_ = 1.e9 * MeV2GK_;
   static constexpr Real K2MeV_ = 1. / MeV2K_;
-  static constexpr Real TNormal_ = 5 * GK2MeV_; // Threshold of NSE
-  static constexpr Real rhoNormal_ = 2.e12;     // 1./100'th of nuclear density
-  static constexpr Real YeNormal_ = 0.3517;     // Beta equilibrium value
+  // Not constants, as a baked transform moves them to caller units
+  Real TNormal_ = 5 * GK2MeV_;              // Threshold of NSE
+  Real rhoNormal_ = 2.e12;                  // 1./100'th of nuclear density
+  static constexpr Real YeNormal_ = 0.3517; // Beta equilibrium value
+  Real YeRef_ = YeNormal_;                  // YeNormal_ clamped to the table
   Real sieNormal_, PNormal_, SNormal_;
   Real CvNormal_, bModNormal_, dPdENormal_, dVdTNormal_;
 
@@ -364,7 +435,12 @@ class StellarCollapse : public EosBase<StellarCollapse> {
 
   // whereAmI_ and status_ used only for reporting. They are not thread-safe.
   mutable RootFinding1D::Status status_ = RootFinding1D::Status::SUCCESS;
-  static constexpr const Real ROOT_THRESH = 1e-14; // TODO: experiment
+  bool diagnostics_ = true;
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+  TableHeatmap *heatmap_ = nullptr;
+  int heatmapGrid_ = 0;
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+  AccuracyParams accuracy_;
   DataStatus memoryStatus_ = DataStatus::Deallocated;
   static constexpr const int _n_lambda = 2;
   static constexpr const char *_lambda_names[] = {"Ye", "log(T)"};
@@ -385,15 +461,17 @@ class LogT {
  public:
   using DataBox = Spiner::DataBox<Real>;
   PORTABLE_INLINE_FUNCTION
-  LogT(const DataBox &field, const Real Ye, const Real lRho)
-      : field_(field), Ye_(Ye), lRho_(lRho) {}
+  LogT(const DataBox &field, const Real Ye, const Real lRho, const bool fixed_ye = false)
+      : field_(field), Ye_(Ye), lRho_(lRho), fixed_ye_(fixed_ye) {}
   PORTABLE_INLINE_FUNCTION Real operator()(const Real lT) const {
-    return field_.interpToReal(Ye_, lT, lRho_);
+    return fixed_ye_ ? field_.interpToReal(lT, lRho_)
+                     : field_.interpToReal(Ye_, lT, lRho_);
   }
 
  private:
   const DataBox &field_;
   const Real Ye_, lRho_;
+  const bool fixed_ye_;
 };
 
 } // namespace callable_interp
@@ -401,6 +479,8 @@ class LogT {
 // For some reason, the linker doesn't like this being a member field
 // of StellarCollapse.  So we'll make it a global variable.
 constexpr char METADATA_NAME[] = "Metadata";
+// Electron fraction of a table saved in fixed-Ye mode
+constexpr char FIXED_YE_NAME[] = "fixedYe";
 
 inline StellarCollapse::StellarCollapse(const std::string &filename, bool use_sp5,
                                         bool filter_bmod) {
@@ -412,10 +492,25 @@ inline StellarCollapse::StellarCollapse(const std::string &filename, bool use_sp
   setNormalValues_();
 }
 
+inline StellarCollapse::StellarCollapse(const std::string &filename, bool use_sp5,
+                                        bool filter_bmod, const Real YeMin,
+                                        const Real YeMax) {
+  if (use_sp5) {
+    LoadFromSP5File_(filename);
+  } else {
+    LoadFromStellarCollapseFile_(filename, filter_bmod);
+  }
+  restrictYe_(YeMin, YeMax);
+  setNormalValues_();
+}
+
 // Saves to an SP5 file
-inline void StellarCollapse::Save(const std::string &filename) {
+inline void StellarCollapse::Save(const std::string &filename,
+                                  const SP5::Compression::Options &compression) {
   herr_t status = H5_SUCCESS;
-  hid_t file = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  const std::string outname =
+      compression.Enabled() ? filename + ".uncompressed" : filename;
+  hid_t file = H5Fcreate(outname.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
 
   // Metadata
   hid_t metadata = H5Gcreate(file, METADATA_NAME, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
@@ -423,6 +518,9 @@ inline void StellarCollapse::Save(const std::string &filename) {
                                      SP5::Offsets::message);
   status +=
       H5LTset_attribute_double(file, METADATA_NAME, SP5::Offsets::sie, &lEOffset_, 1);
+  if (fixedYe_) {
+    status += H5LTset_attribute_double(file, METADATA_NAME, FIXED_YE_NAME, &YeMin_, 1);
+  }
   H5Gclose(metadata);
 
   // Databoxes
@@ -448,11 +546,25 @@ inline void StellarCollapse::Save(const std::string &filename) {
   status += munu_.saveHDF(file, "munu");
 
   status += H5Fclose(file);
+  if (compression.Enabled()) {
+    status += SP5::Compression::Repack(outname, filename, compression);
+    std::remove(outname.c_str());
+  }
   if (status != H5_SUCCESS) {
     EOS_ERROR("[StellarCollapse::Save]: There was a problem with HDF5\n");
   }
 }
 
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+inline void StellarCollapse::SetHeatmap(TableHeatmap *heatmap) {
+  heatmap_ = heatmap;
+  if (heatmap_ != nullptr) {
+    heatmapGrid_ = heatmap_->AddGrid("rho_T", "log(rho)", lRhoMin_, lRhoMax_, numRho_,
+                                     "log(T)", lTMin_, lTMax_, numT_);
+  }
+}
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+
 inline StellarCollapse StellarCollapse::GetOnDevice() {
   StellarCollapse other;
   other.lP_ = Spiner::getOnDeviceDataBox<Real>(lP_);
@@ -483,6 +595,10 @@ inline StellarCollapse StellarCollapse::GetOnDevice() {
   other.lTMax_ = lTMax_;
   other.YeMin_ = YeMin_;
   other.YeMax_ = YeMax_;
+  other.fixedYe_ = fixedYe_;
+  other.YeRef_ = YeRef_;
+  other.rhoNormal_ = rhoNormal_;
+  other.TNormal_ = TNormal_;
   other.sieMin_ = sieMin_;
   other.sieMax_ = sieMax_;
   other.lEOffset_ = lEOffset_;
@@ -494,6 +610,12 @@ inline StellarCollapse StellarCollapse::GetOnDevice() {
   other.dPdENormal_ = dPdENormal_;
   other.dVdTNormal_ = dVdTNormal_;
   other.status_ = status_;
+  other.diagnostics_ = diagnostics_;
+  other.accuracy_ = accuracy_;
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+  other.heatmap_ = heatmap_;
+  other.heatmapGrid_ = heatmapGrid_;
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
   return other;
 }
 
@@ -526,6 +648,7 @@ PORTABLE_INLINE_FUNCTION Real StellarCollapse::TemperatureFromDensityInternalEne
     const Real rho, const Real sie, Indexer_t &&lambda) const {
   const Real lRho = lRho_(rho);
   const Real lT = lTFromlRhoSie_(lRho, sie, lambda);
+  recordVisit_(lRho, lT);
   return T_(lT);
 }
 
@@ -534,7 +657,7 @@ PORTABLE_INLINE_FUNCTION Real StellarCollapse::InternalEnergyFromDensityTemperat
     const Real rho, const Real temp, Indexer_t &&lambda) const {
   Real lRho, lT, Ye;
   getLogsFromRhoT_(rho, temp, lambda, lRho, lT, Ye);
-  const Real lE = lE_.interpToReal(Ye, lT, lRho);
+  const Real lE = interp_(lE_, Ye, lT, lRho);
   return le2e_(lE);
 }
 
@@ -543,7 +666,7 @@ PORTABLE_INLINE_FUNCTION Real StellarCollapse::PressureFromDensityTemperature(
     const Real rho, const Real temperature, Indexer_t &&lambda) const {
   Real lRho, lT, Ye;
   getLogsFromRhoT_(rho, temperature, lambda, lRho, lT, Ye);
-  const Real lP = lP_.interpToReal(Ye, lT, lRho);
+  const Real lP = interp_(lP_, Ye, lT, lRho);
   return lP2P_(lP);
 }
 
@@ -552,7 +675,7 @@ PORTABLE_INLINE_FUNCTION Real StellarCollapse::PressureFromDensityInternalEnergy
     const Real rho, const Real sie, Indexer_t &&lambda) const {
   Real lRho, lT, Ye;
   getLogsFromRhoSie_(rho, sie, lambda, lRho, lT, Ye);
-  const Real lP = lP_.interpToReal(Ye, lT, lRho);
+  const Real lP = interp_(lP_, Ye, lT, lRho);
   return lP2P_(lP);
 }
 template <typename Indexer_t>
@@ -567,7 +690,7 @@ PORTABLE_INLINE_FUNCTION Real StellarCollapse::EntropyFromDensityTemperature(
     const Real rho, const Real temperature, Indexer_t &&lambda) const {
   Real lRho, lT, Ye;
   getLogsFromRhoT_(rho, temperature, lambda, lRho, lT, Ye);
-  const Real entropy = entropy_.interpToReal(Ye, lT, lRho);
+  const Real entropy = interp_(entropy_, Ye, lT, lRho);
   return (entropy > robust::EPS() ? entropy : robust::EPS());
 }
 
@@ -576,7 +699,7 @@ PORTABLE_INLINE_FUNCTION Real StellarCollapse::EntropyFromDensityInternalEnergy(
     const Real rho, const Real sie, Indexer_t &&lambda) const {
   Real lRho, lT, Ye;
   getLogsFromRhoSie_(rho, sie, lambda, lRho, lT, Ye);
-  const Real entropy = entropy_.interpToReal(Ye, lT, lRho);
+  const Real entropy = interp_(entropy_, Ye, lT, lRho);
   return (entropy > robust::EPS() ? entropy : robust::EPS());
 }
 
@@ -585,7 +708,7 @@ PORTABLE_INLINE_FUNCTION Real StellarCollapse::SpecificHeatFromDensityTemperatur
     const Real rho, const Real temperature, Indexer_t &&lambda) const {
   Real lRho, lT, Ye;
   getLogsFromRhoT_(rho, temperature, lambda, lRho, lT, Ye);
-  const Real Cv = dEdT_.interpToReal(Ye, lT, lRho);
+  const Real Cv = interp_(dEdT_, Ye, lT, lRho);
   return (Cv > robust::EPS() ? Cv : robust::EPS());
 }
 
@@ -594,7 +717,7 @@ PORTABLE_INLINE_FUNCTION Real StellarCollapse::SpecificHeatFromDensityInternalEn
     const Real rho, const Real sie, Indexer_t &&lambda) const {
   Real lRho, lT, Ye;
   getLogsFromRhoSie_(rho, sie, lambda, lRho, lT, Ye);
-  const Real Cv = dEdT_.interpToReal(Ye, lT, lRho);
+  const Real Cv = interp_(dEdT_, Ye, lT, lRho);
   return (Cv > robust::EPS() ? Cv : robust::EPS());
 }
 
@@ -603,7 +726,7 @@ PORTABLE_INLINE_FUNCTION Real StellarCollapse::BulkModulusFromDensityTemperature
     const Real rho, const Real temperature, Indexer_t &&lambda) const {
   Real lRho, lT, Ye;
   getLogsFromRhoT_(rho, temperature, lambda, lRho, lT, Ye);
-  const Real lbmod = lBMod_.interpToReal(Ye, lT, lRho);
+  const Real lbmod = interp_(lBMod_, Ye, lT, lRho);
   const Real bMod = lB2B_(lbmod);
   return bMod > robust::EPS() ? bMod : robust::EPS();
 }
@@ -613,7 +736,7 @@ PORTABLE_INLINE_FUNCTION Real StellarCollapse::GruneisenParamFromDensityTemperat
     const Real rho, const Real temp, Indexer_t &&lambda) const {
   Real lRho, lT, Ye;
   getLogsFromRhoT_(rho, temp, lambda, lRho, lT, Ye);
-  const Real dpde = dPdE_.interpToReal(Ye, lT, lRho);
+  const Real dpde = interp_(dPdE_, Ye, lT, lRho);
   const Real gm1 = std::abs(dpde) / (std::abs(rho) + robust::EPS());
   return gm1;
 }
@@ -623,7 +746,7 @@ PORTABLE_INLINE_FUNCTION Real StellarCollapse::BulkModulusFromDensityInternalEne
     const Real rho, const Real sie, Indexer_t &&lambda) const {
   Real lRho, lT, Ye;
   getLogsFromRhoSie_(rho, sie, lambda, lRho, lT, Ye);
-  const Real lbmod = lBMod_.interpToReal(Ye, lT, lRho);
+  const Real lbmod = interp_(lBMod_, Ye, lT, lRho);
   const Real bMod = lB2B_(lbmod);
   return bMod;
 }
@@ -633,30 +756,23 @@ PORTABLE_INLINE_FUNCTION Real StellarCollapse::GruneisenParamFromDensityInternal
     const Real rho, const Real sie, Indexer_t &&lambda) const {
   Real lRho, lT, Ye;
   getLogsFromRhoSie_(rho, sie, lambda, lRho, lT, Ye);
-  const Real dpde = dPdE_.interpToReal(Ye, lT, lRho);
+  const Real dpde = interp_(dPdE_, Ye, lT, lRho);
   const Real gm1 = std::abs(dpde) / (std::abs(rho) + robust::EPS());
   return gm1;
 }
 
-// TODO(JMM): Fill in this stub if we ever use this EOS in a PTE code.
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION void StellarCollapse::DensityEnergyFromPressureTemperature(
-    const Real press, const Real temp, Indexer_t &&lambda, Real &rho, Real &sie) const {
-  EOS_ERROR("StellarCollapse::DensityEnergyFromPRessureTemperature is a stub");
-}
-
 template <typename Indexer_t>
 PORTABLE_INLINE_FUNCTION void StellarCollapse::MassFractionsFromDensityTemperature(
     const Real rho, const Real temperature, Real &Xa, Real &Xh, Real &Xn, Real &Xp,
     Real &Abar, Real &Zbar, Indexer_t &&lambda) const {
   Real lRho, lT, Ye;
   getLogsFromRhoT_(rho, temperature, lambda, lRho, lT, Ye);
-  Xa = Xa_.interpToReal(Ye, lT, lRho);
-  Xh = Xh_.interpToReal(Ye, lT, lRho);
-  Xn = Xn_.interpToReal(Ye, lT, lRho);
-  Xp = Xp_.interpToReal(Ye, lT, lRho);
-  Abar = Abar_.interpToReal(Ye, lT, lRho);
-  Zbar = Zbar_.interpToReal(Ye, lT, lRho);
+  Xa = interp_(Xa_, Ye, lT, lRho);
+  Xh = interp_(Xh_, Ye, lT, lRho);
+  Xn = interp_(Xn_, Ye, lT, lRho);
+  Xp = interp_(Xp_, Ye, lT, lRho);
+  Abar = interp_(Abar_, Ye, lT, lRho);
+  Zbar = interp_(Zbar_, Ye, lT, lRho);
 }
 
 template <typename Indexer_t>
@@ -665,11 +781,11 @@ PORTABLE_INLINE_FUNCTION void StellarCollapse::ChemicalPotentialsFromDensityTemp
     Real &muhat, Real &munu, Indexer_t &&lambda) const {
   Real lRho, lT, Ye;
   getLogsFromRhoT_(rho, temperature, lambda, lRho, lT, Ye);
-  mu_e = mu_e_.interpToReal(Ye, lT, lRho);
-  mu_n = mu_n_.interpToReal(Ye, lT, lRho);
-  mu_p = mu_p_.interpToReal(Ye, lT, lRho);
-  muhat = muhat_.interpToReal(Ye, lT, lRho);
-  munu = munu_.interpToReal(Ye, lT, lRho);
+  mu_e = interp_(mu_e_, Ye, lT, lRho);
+  mu_n = interp_(mu_n_, Ye, lT, lRho);
+  mu_p = interp_(mu_p_, Ye, lT, lRho);
+  muhat = interp_(muhat_, Ye, lT, lRho);
+  munu = interp_(munu_, Ye, lT, lRho);
 }
 
 template <typename Indexer_t>
@@ -693,19 +809,19 @@ StellarCollapse::FillEos(Real &rho, Real &temp, Real &energy, Real &press, Real
     UNDEFINED_ERROR;
   }
   if (output & thermalqs::specific_internal_energy) {
-    const Real lE = lE_.interpToReal(Ye, lT, lRho);
+    const Real lE = interp_(lE_, Ye, lT, lRho);
     energy = le2e_(lE);
   }
   if (output & thermalqs::pressure) {
-    const Real lP = lP_.interpToReal(Ye, lT, lRho);
+    const Real lP = interp_(lP_, Ye, lT, lRho);
     press = lP2P_(lP);
   }
   if (output & thermalqs::specific_heat) {
-    const Real Cv = dEdT_.interpToReal(Ye, lT, lRho);
+    const Real Cv = interp_(dEdT_, Ye, lT, lRho);
     cv = (Cv > robust::EPS() ? Cv : robust::EPS());
   }
   if (output & thermalqs::bulk_modulus) {
-    const Real lbmod = lBMod_.interpToReal(Ye, lT, lRho);
+    const Real lbmod = interp_(lBMod_, Ye, lT, lRho);
     bmod = lB2B_(lbmod);
   }
 }
@@ -724,14 +840,14 @@ StellarCollapse::ValuesAtReferenceState(Real &rho, Real &temp, Real &sie, Real &
   dpde = dPdENormal_;
   dvdt = dVdTNormal_;
   Real lT = lT_(temp);
-  lambda[Lambda::Ye] = YeNormal_;
+  lambda[Lambda::Ye] = YeRef_;
   lambda[Lambda::lT] = lT;
 }
 
 inline void StellarCollapse::LoadFromSP5File_(const std::string &filename) {
   herr_t status = H5_SUCCESS;
 
-  hid_t file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  hid_t file = SP5::Compression::Open(filename);
 
   // Offsets
   hid_t metadata = H5Gopen(file, METADATA_NAME, H5P_DEFAULT);
@@ -760,24 +876,35 @@ inline void StellarCollapse::LoadFromSP5File_(const std::string &filename) {
   status += muhat_.loadHDF(file, "muhat");
   status += munu_.loadHDF(file, "munu");
 
+  // A table saved in fixed-Ye mode is 2D
+  fixedYe_ = (lP_.rank() == 2);
+  if (fixedYe_) {
+    status += H5LTget_attribute_double(file, METADATA_NAME, FIXED_YE_NAME, &YeMin_);
+    YeMax_ = YeMin_;
+  }
+
   status += H5Fclose(file);
   if (status != H5_SUCCESS) {
     EOS_ERROR("[StellarCollapse::Load]: There was a problem with HDF5\n");
   }
 
   // bounds, etc.
-  auto YeGrid = lP_.range(2);
   auto lTGrid = lP_.range(1);
   auto lRGrid = lP_.range(0);
   numRho_ = lRGrid.nPoints();
   numT_ = lTGrid.nPoints();
-  numYe_ = YeGrid.nPoints();
   lRhoMin_ = lRGrid.min();
   lRhoMax_ = lRGrid.max();
   lTMin_ = lTGrid.min();
   lTMax_ = lTGrid.max();
-  YeMin_ = YeGrid.min();
-  YeMax_ = YeGrid.max();
+  if (fixedYe_) {
+    numYe_ = 1;
+  } else {
+    auto YeGrid = lP_.range(2);
+    numYe_ = YeGrid.nPoints();
+    YeMin_ = YeGrid.min();
+    YeMax_ = YeGrid.max();
+  }
   sieMin_ = eCold_.min();
   sieMax_ = eHot_.max();
 }
@@ -1085,10 +1212,23 @@ inline void StellarCollapse::computeBulkModulus_() {
 }
 
 inline void StellarCollapse::computeColdAndHotCurves_() {
-  eCold_.resize(numYe_, numRho_);
-  eHot_.resize(numYe_, numRho_);
   int iTCold = 0;
   int iTHot = numT_ - 1;
+  if (fixedYe_) {
+    eCold_.resize(numRho_);
+    eHot_.resize(numRho_);
+    for (int irho = 0; irho < numRho_; ++irho) {
+      eCold_(irho) = le2e_(lE_(iTCold, irho));
+      eHot_(irho) = le2e_(lE_(iTHot, irho));
+    }
+    sieMin_ = eCold_.min();
+    sieMax_ = eHot_.max();
+    eCold_.setRange(0, lRhoMin_, lRhoMax_, numRho_);
+    eHot_.setRange(0, lRhoMin_, lRhoMax_, numRho_);
+    return;
+  }
+  eCold_.resize(numYe_, numRho_);
+  eHot_.resize(numYe_, numRho_);
   for (int iY = 0; iY < numYe_; ++iY) {
     for (int irho = 0; irho < numRho_; ++irho) {
       Real lECold = lE_(iY, iTCold, irho);
@@ -1105,30 +1245,152 @@ inline void StellarCollapse::computeColdAndHotCurves_() {
   eHot_.setRange(1, YeMin_, YeMax_, numYe_);
 }
 
+// Restricts every table to the Ye nodes bracketing [YeLo, YeHi]. If
+// YeLo == YeHi, the tables are instead interpolated linearly in Ye to
+// 2D (lT, lRho) slices.
+inline void StellarCollapse::restrictYe_(const Real YeLo, const Real YeHi) {
+  if (fixedYe_) {
+    EOS_ERROR("StellarCollapse: Ye range of a fixed-Ye table cannot be restricted\n");
+  }
+  if (!(YeMin_ <= YeLo && YeLo <= YeHi && YeHi <= YeMax_)) {
+    EOS_ERROR("StellarCollapse: requested Ye range is not contained in the table\n");
+  }
+  DataBox *tables[] = {&lP_, &lE_, &dPdRho_, &dPdE_, &dEdT_, &lBMod_,
+                       &entropy_, &Xa_, &Xh_, &Xn_, &Xp_, &Abar_,
+                       &Zbar_, &mu_e_, &mu_n_, &mu_p_, &muhat_, &munu_};
+  if (YeLo == YeHi) {
+    for (DataBox *db : tables) {
+      sliceYe_(*db, YeLo);
+    }
+    fixedYe_ = true;
+    numYe_ = 1;
+    YeMin_ = YeMax_ = YeLo;
+  } else {
+    const Grid_t YeGrid = lP_.range(2);
+    const Real dY = (YeMax_ - YeMin_) / (numYe_ - 1);
+    int iLo = static_cast<int>(std::floor((YeLo - YeMin_) / dY));
+    int iHi = static_cast<int>(std::ceil((YeHi - YeMin_) / dY));
+    iLo = std::max(0, std::min(iLo, numYe_ - 2));
+    iHi = std::min(numYe_ - 1, std::max(iHi, iLo + 1));
+    for (DataBox *db : tables) {
+      cropYe_(*db, iLo, iHi);
+    }
+    numYe_ = iHi - iLo + 1;
+    YeMin_ = YeGrid.x(iLo);
+    YeMax_ = YeGrid.x(iHi);
+  }
+  eCold_.finalize();
+  eHot_.finalize();
+  computeColdAndHotCurves_();
+}
+
+inline void StellarCollapse::BakeTransform(const TableTransform &transform) {
+  using table_transform::Multiply;
+  using table_transform::Retabulate;
+  using table_transform::ScaleLog;
+  if (memoryStatus_ == DataStatus::OnDevice) {
+    EOS_ERROR("StellarCollapse: tables must be on host to be transformed\n");
+  }
+  if (!transform.IsValid()) {
+    EOS_ERROR("StellarCollapse: invalid table transform\n");
+  }
+  if (transform.IsIdentity()) return;
+
+  // Tables are indexed (Ye, lT, lRho), or (lT, lRho) in fixed-Ye
+  // mode. The density, temperature, pressure, and bulk modulus
+  // offsets are zero, so only the energy offset changes.
+  const Real scales[] = {transform.rho, transform.temp, 1};
+  const Real inv_sie = 1. / transform.sie;
+  auto identity = [](const Real v) { return v; };
+  auto press = [&](const Real lP) { return ScaleLog(lP, transform.press); };
+  Retabulate(lP_, scales, press);
+  Retabulate(lE_, scales, [&](const Real lE) { return ScaleLog(lE, inv_sie); });
+  Retabulate(lBMod_, scales, press);
+  Retabulate(dPdRho_, scales, Multiply{transform.dPdRho()});
+  Retabulate(dPdE_, scales, Multiply{transform.dPdE()});
+  Retabulate(dEdT_, scales, Multiply{transform.dEdT()});
+  Retabulate(entropy_, scales, Multiply{transform.entropy});
+  DataBox *untransformed[] = {&Xa_,   &Xh_,   &Xn_,   &Xp_,    &Abar_, &Zbar_,
+                              &mu_e_, &mu_n_, &mu_p_, &muhat_, &munu_};
+  for (DataBox *db : untransformed) {
+    Retabulate(*db, scales, identity);
+  }
+  lEOffset_ = transform.SieOffset(lEOffset_);
+
+  lRhoMin_ = lP_.range(0).min();
+  lRhoMax_ = lP_.range(0).max();
+  lTMin_ = lP_.range(1).min();
+  lTMax_ = lP_.range(1).max();
+  eCold_.finalize();
+  eHot_.finalize();
+  computeColdAndHotCurves_();
+
+  transform.ReferenceStateFromTable(rhoNormal_, TNormal_, sieNormal_, PNormal_,
+                                    CvNormal_, bModNormal_, dPdENormal_, dVdTNormal_);
+  SNormal_ = transform.SFromTable(SNormal_);
+}
+
+inline void StellarCollapse::cropYe_(DataBox &db, const int iLo, const int iHi) const {
+  const int nY = iHi - iLo + 1;
+  const auto &YeGrid = db.range(2);
+  DataBox out(nY, numT_, numRho_);
+  for (int iY = 0; iY < nY; ++iY) {
+    for (int iT = 0; iT < numT_; ++iT) {
+      for (int irho = 0; irho < numRho_; ++irho) {
+        out(iY, iT, irho) = db(iY + iLo, iT, irho);
+      }
+    }
+  }
+  out.setRange(2, Grid_t(YeGrid.x(iLo), YeGrid.x(iHi), nY));
+  out.setRange(1, db.range(1));
+  out.setRange(0, db.range(0));
+  db.finalize();
+  db = out;
+}
+
+inline void StellarCollapse::sliceYe_(DataBox &db, const Real Ye) const {
+  const auto &YeGrid = db.range(2);
+  const int nY = YeGrid.nPoints();
+  const Real x = (Ye - YeGrid.min()) / ((YeGrid.max() - YeGrid.min()) / (nY - 1));
+  const int iY = std::max(0, std::min(static_cast<int>(std::floor(x)), nY - 2));
+  const Real w = x - iY;
+  DataBox out(numT_, numRho_);
+  for (int iT = 0; iT < numT_; ++iT) {
+    for (int irho = 0; irho < numRho_; ++irho) {
+      out(iT, irho) = (1 - w) * db(iY, iT, irho) + w * db(iY + 1, iT, irho);
+    }
+  }
+  out.setRange(1, db.range(1));
+  out.setRange(0, db.range(0));
+  db.finalize();
+  db = out;
+}
+
 inline void StellarCollapse::setNormalValues_() {
   const Real lT = lT_(TNormal_);
   const Real lRho = lRho_(rhoNormal_);
-  const Real Ye = YeNormal_;
+  YeRef_ = std::min(std::max(YeNormal_, YeMin_), YeMax_);
+  const Real Ye = YeRef_;
 
-  const Real lE = lE_.interpToReal(Ye, lT, lRho);
+  const Real lE = interp_(lE_, Ye, lT, lRho);
   sieNormal_ = le2e_(lE);
 
-  const Real lP = lP_.interpToReal(Ye, lT, lRho);
+  const Real lP = interp_(lP_, Ye, lT, lRho);
   PNormal_ = lP2P_(lP);
 
-  const Real entropy = entropy_.interpToReal(Ye, lT, lRho);
+  const Real entropy = interp_(entropy_, Ye, lT, lRho);
   SNormal_ = entropy;
 
-  const Real Cv = dEdT_.interpToReal(Ye, lT, lRho);
+  const Real Cv = interp_(dEdT_, Ye, lT, lRho);
   CvNormal_ = (Cv > robust::EPS() ? Cv : robust::EPS());
 
-  const Real lB = lBMod_.interpToReal(Ye, lT, lRho);
+  const Real lB = interp_(lBMod_, Ye, lT, lRho);
   const Real bMod = lB2B_(lB);
   bModNormal_ = bMod > robust::EPS() ? bMod : robust::EPS();
 
-  dPdENormal_ = dPdE_.interpToReal(Ye, lT, lRho);
+  dPdENormal_ = interp_(dPdE_, Ye, lT, lRho);
 
-  Real dPdR = dPdRho_.interpToReal(Ye, lT, lRho);
+  Real dPdR = interp_(dPdRho_, Ye, lT, lRho);
   dVdTNormal_ = dPdENormal_ * CvNormal_ / (rhoNormal_ * rhoNormal_ * dPdR);
 }
 
@@ -1143,16 +1405,16 @@ PORTABLE_INLINE_FUNCTION Real StellarCollapse::lTFromlRhoSie_(
   Real lTGuess = lambda[Lambda::lT];
 
   const RootFinding1D::RootCounts *pcounts =
-      (memoryStatus_ == DataStatus::OnDevice) ? nullptr : &counts;
+      diagnosticsEnabled_() ? &counts : nullptr;
 
   // If sie above hot curve or below cold curve, force it onto the table.
   // TODO(JMM): Rethink this as needed.
-  if (sie <= eCold_.interpToReal(Ye, lRho)) {
+  if (sie <= interpCurve_(eCold_, Ye, lRho)) {
     lT = lTGuess = lTMin_;
     if (pcounts != nullptr) {
       pcounts->increment(0);
     }
-  } else if (sie >= eHot_.interpToReal(Ye, lRho)) {
+  } else if (sie >= interpCurve_(eHot_, Ye, lRho)) {
     lT = lTGuess = lTMax_;
     if (pcounts != nullptr) {
       pcounts->increment(0);
@@ -1164,9 +1426,10 @@ PORTABLE_INLINE_FUNCTION Real StellarCollapse::lTFromlRhoSie_(
     }
     // Get log(sie)
     Real lE = e2le_(sie);
-    const callable_interp::LogT lEFunc(lE_, Ye, lRho);
-    status = regula_falsi(lEFunc, lE, lTGuess, lTMin_, lTMax_, ROOT_THRESH, ROOT_THRESH,
-                          lT, pcounts);
+    const callable_interp::LogT lEFunc(lE_, Ye, lRho, fixedYe_);
+    status = regula_falsi(lEFunc, lE, lTGuess, lTMin_, lTMax_, accuracy_.root_thresh,
+                          accuracy_.root_thresh, lT, pcounts, false,
+                          accuracy_.root_max_iter);
     if (status != RootFinding1D::Status::SUCCESS) {
 #if STELLAR_COLLAPSE_EOS_VERBOSE
       std::stringstream errorMessage;
@@ -1181,7 +1444,7 @@ PORTABLE_INLINE_FUNCTION Real StellarCollapse::lTFromlRhoSie_(
       lT = lTGuess;
     }
   }
-  if (memoryStatus_ != DataStatus::OnDevice) {
+  if (diagnosticsEnabled_()) {
     status_ = status;
   }
   lambda[Lambda::lT] = lT;
@@ -19,7 +19,11 @@
 #include <ports-of-call/portability.hpp>
 #include <ports-of-call/portable_errors.hpp>
 #include <singularity-eos/base/variadic_utils.hpp>
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+#include <singularity-eos/base/query_trace.hpp>
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
 #include <singularity-eos/eos/eos_base.hpp>
+#include <singularity-eos/eos/eos_variant_instantiation.hpp>
 
 using Real = double;
 
@@ -285,6 +289,99 @@ class Variant {
         eos_);
   }
 
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION Real TemperatureFromDensityPressure(
+      const Real rho, const Real press,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    return mpark::visit(
+        [&rho, &press, &lambda](const auto &eos) {
+          return eos.TemperatureFromDensityPressure(rho, press, lambda);
+        },
+        eos_);
+  }
+
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION Real DensityFromPressureInternalEnergy(
+      const Real press, const Real sie,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    return mpark::visit(
+        [&press, &sie, &lambda](const auto &eos) {
+          return eos.DensityFromPressureInternalEnergy(press, sie, lambda);
+        },
+        eos_);
+  }
+
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION Real TemperatureFromDensityEntropy(
+      const Real rho, const Real entropy,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    return mpark::visit(
+        [&rho, &entropy, &lambda](const auto &eos) {
+          return eos.TemperatureFromDensityEntropy(rho, entropy, lambda);
+        },
+        eos_);
+  }
+
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION void
+  InvertState(const InputPair pair, const Real x, const Real y, Real &rho, Real &temp,
+              Real &sie, Real &press, Real &cv, Real &bmod, const unsigned long output,
+              Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    return mpark::visit(
+        [&](const auto &eos) {
+          return eos.InvertState(pair, x, y, rho, temp, sie, press, cv, bmod, output,
+                                 lambda);
+        },
+        eos_);
+  }
+
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION ThermoDerivatives DerivativesFromDensityTemperature(
+      const Real rho, const Real temperature,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    return mpark::visit(
+        [&](const auto &eos) {
+          return eos.DerivativesFromDensityTemperature(rho, temperature, lambda);
+        },
+        eos_);
+  }
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION ThermoDerivatives DerivativesFromDensityInternalEnergy(
+      const Real rho, const Real sie,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    return mpark::visit(
+        [&](const auto &eos) {
+          return eos.DerivativesFromDensityInternalEnergy(rho, sie, lambda);
+        },
+        eos_);
+  }
+
+  PORTABLE_INLINE_FUNCTION
+  TemperatureIndex GetTemperatureIndex(const Real temperature) const {
+    return mpark::visit(
+        [&](const auto &eos) { return eos.GetTemperatureIndex(temperature); }, eos_);
+  }
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION Real InternalEnergyFromDensityTemperatureIndex(
+      const Real rho, const TemperatureIndex &tidx,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    return mpark::visit(
+        [&](const auto &eos) {
+          return eos.InternalEnergyFromDensityTemperatureIndex(rho, tidx, lambda);
+        },
+        eos_);
+  }
+  template <typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION Real PressureFromDensityTemperatureIndex(
+      const Real rho, const TemperatureIndex &tidx,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
+    return mpark::visit(
+        [&](const auto &eos) {
+          return eos.PressureFromDensityTemperatureIndex(rho, tidx, lambda);
+        },
+        eos_);
+  }
+
   PORTABLE_INLINE_FUNCTION
   Real RhoPmin(const Real temp) const {
     return mpark::visit([&temp](const auto &eos) { return eos.RhoPmin(temp); }, eos_);
@@ -300,6 +397,16 @@ class Variant {
     return mpark::visit([](const auto &eos) { return eos.MinimumTemperature(); }, eos_);
   }
 
+  PORTABLE_FORCEINLINE_FUNCTION
+  Real MaximumDensity() const {
+    return mpark::visit([](const auto &eos) { return eos.MaximumDensity(); }, eos_);
+  }
+
+  PORTABLE_FORCEINLINE_FUNCTION
+  Real MaximumTemperature() const {
+    return mpark::visit([](const auto &eos) { return eos.MaximumTemperature(); }, eos_);
+  }
+
   /*
   Vector versions of the member functions run on the host but the scalar
   lookups will run on the device
@@ -323,7 +430,11 @@ class Variant {
   TemperatureFromDensityInternalEnergy(ConstRealIndexer &&rhos, ConstRealIndexer &&sies,
                                        RealIndexer &&temperatures, const int num,
                                        LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::TemperatureFromDensityInternalEnergy,
+                                 rhos, sies, temperatures, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &sies, &temperatures, &num, &lambdas](const auto &eos) {
           return eos.TemperatureFromDensityInternalEnergy(
               std::forward<ConstRealIndexer>(rhos), std::forward<ConstRealIndexer>(sies),
@@ -331,6 +442,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, temperatures);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
   template <typename RealIndexer, typename ConstRealIndexer>
   inline void TemperatureFromDensityInternalEnergy(ConstRealIndexer &&rhos,
@@ -348,7 +462,11 @@ class Variant {
   TemperatureFromDensityInternalEnergy(ConstRealIndexer &&rhos, ConstRealIndexer &&sies,
                                        RealIndexer &&temperatures, Real *scratch,
                                        const int num, LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::TemperatureFromDensityInternalEnergy,
+                                 rhos, sies, temperatures, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &sies, &temperatures, &scratch, &num, &lambdas](const auto &eos) {
           return eos.TemperatureFromDensityInternalEnergy(
               std::forward<ConstRealIndexer>(rhos), std::forward<ConstRealIndexer>(sies),
@@ -356,6 +474,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, temperatures);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -375,7 +496,11 @@ class Variant {
                                                    ConstRealIndexer &&temperatures,
                                                    RealIndexer &&sies, const int num,
                                                    LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::InternalEnergyFromDensityTemperature,
+                                 rhos, temperatures, sies, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &temperatures, &sies, &num, &lambdas](const auto &eos) {
           return eos.InternalEnergyFromDensityTemperature(
               std::forward<ConstRealIndexer>(rhos),
@@ -383,6 +508,9 @@ class Variant {
               std::forward<RealIndexer>(sies), num, std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, sies);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -402,7 +530,11 @@ class Variant {
                                                    RealIndexer &&sies, Real *scratch,
                                                    const int num,
                                                    LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::InternalEnergyFromDensityTemperature,
+                                 rhos, temperatures, sies, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &temperatures, &sies, &scratch, &num, &lambdas](const auto &eos) {
           return eos.InternalEnergyFromDensityTemperature(
               std::forward<ConstRealIndexer>(rhos),
@@ -410,6 +542,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, sies);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -428,7 +563,11 @@ class Variant {
                                              ConstRealIndexer &&temperatures,
                                              RealIndexer &&pressures, const int num,
                                              LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::PressureFromDensityTemperature, rhos,
+                                 temperatures, pressures, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &temperatures, &pressures, &num, &lambdas](const auto &eos) {
           return eos.PressureFromDensityTemperature(
               std::forward<ConstRealIndexer>(rhos),
@@ -437,6 +576,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, pressures);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -456,7 +598,11 @@ class Variant {
   PressureFromDensityTemperature(ConstRealIndexer &&rhos, ConstRealIndexer &&temperatures,
                                  RealIndexer &&pressures, Real *scratch, const int num,
                                  LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::PressureFromDensityTemperature, rhos,
+                                 temperatures, pressures, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &temperatures, &pressures, &scratch, &num, &lambdas](const auto &eos) {
           return eos.PressureFromDensityTemperature(
               std::forward<ConstRealIndexer>(rhos),
@@ -465,6 +611,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, pressures);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -482,7 +631,11 @@ class Variant {
                                                 ConstRealIndexer &&sies,
                                                 RealIndexer &&pressures, const int num,
                                                 LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::PressureFromDensityInternalEnergy,
+                                 rhos, sies, pressures, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &sies, &pressures, &num, &lambdas](const auto &eos) {
           return eos.PressureFromDensityInternalEnergy(
               std::forward<ConstRealIndexer>(rhos), std::forward<ConstRealIndexer>(sies),
@@ -490,6 +643,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, pressures);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -508,7 +664,11 @@ class Variant {
   PressureFromDensityInternalEnergy(ConstRealIndexer &&rhos, ConstRealIndexer &&sies,
                                     RealIndexer &&pressures, Real *scratch, const int num,
                                     LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::PressureFromDensityInternalEnergy,
+                                 rhos, sies, pressures, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &sies, &pressures, &scratch, &num, &lambdas](const auto &eos) {
           return eos.PressureFromDensityInternalEnergy(
               std::forward<ConstRealIndexer>(rhos), std::forward<ConstRealIndexer>(sies),
@@ -516,6 +676,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, pressures);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
   ///
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -576,7 +739,11 @@ class Variant {
                                             ConstRealIndexer &&temperatures,
                                             RealIndexer &&entropies, const int num,
                                             LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::EntropyFromDensityTemperature, rhos,
+                                 temperatures, entropies, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &temperatures, &entropies, &num, &lambdas](const auto &eos) {
           return eos.EntropyFromDensityTemperature(
               std::forward<ConstRealIndexer>(rhos),
@@ -585,6 +752,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, entropies);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -604,7 +774,11 @@ class Variant {
   EntropyFromDensityTemperature(ConstRealIndexer &&rhos, ConstRealIndexer &&temperatures,
                                 RealIndexer &&entropies, Real *scratch, const int num,
                                 LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::EntropyFromDensityTemperature, rhos,
+                                 temperatures, entropies, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &temperatures, &entropies, &scratch, &num, &lambdas](const auto &eos) {
           return eos.EntropyFromDensityTemperature(
               std::forward<ConstRealIndexer>(rhos),
@@ -613,6 +787,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, entropies);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -630,7 +807,11 @@ class Variant {
                                                ConstRealIndexer &&sies,
                                                RealIndexer &&entropies, const int num,
                                                LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::EntropyFromDensityInternalEnergy,
+                                 rhos, sies, entropies, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &sies, &entropies, &num, &lambdas](const auto &eos) {
           return eos.EntropyFromDensityInternalEnergy(
               std::forward<ConstRealIndexer>(rhos), std::forward<ConstRealIndexer>(sies),
@@ -638,6 +819,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, entropies);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer, typename LambdaIndexer>
@@ -656,7 +840,11 @@ class Variant {
   EntropyFromDensityInternalEnergy(ConstRealIndexer &&rhos, ConstRealIndexer &&sies,
                                    RealIndexer &&entropies, Real *scratch, const int num,
                                    LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::EntropyFromDensityInternalEnergy,
+                                 rhos, sies, entropies, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &sies, &entropies, &scratch, &num, &lambdas](const auto &eos) {
           return eos.EntropyFromDensityInternalEnergy(
               std::forward<ConstRealIndexer>(rhos), std::forward<ConstRealIndexer>(sies),
@@ -664,6 +852,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, entropies);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -682,7 +873,11 @@ class Variant {
                                                  ConstRealIndexer &&temperatures,
                                                  RealIndexer &&cvs, const int num,
                                                  LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::SpecificHeatFromDensityTemperature,
+                                 rhos, temperatures, cvs, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &temperatures, &cvs, &num, &lambdas](const auto &eos) {
           return eos.SpecificHeatFromDensityTemperature(
               std::forward<ConstRealIndexer>(rhos),
@@ -690,6 +885,9 @@ class Variant {
               std::forward<RealIndexer>(cvs), num, std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, cvs);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -710,7 +908,11 @@ class Variant {
                                                  RealIndexer &&cvs, Real *scratch,
                                                  const int num,
                                                  LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::SpecificHeatFromDensityTemperature,
+                                 rhos, temperatures, cvs, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &temperatures, &cvs, &scratch, &num, &lambdas](const auto &eos) {
           return eos.SpecificHeatFromDensityTemperature(
               std::forward<ConstRealIndexer>(rhos),
@@ -719,6 +921,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, cvs);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -736,13 +941,21 @@ class Variant {
                                                     ConstRealIndexer &&sies,
                                                     RealIndexer &&cvs, const int num,
                                                     LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(
+        query_trace::Query::SpecificHeatFromDensityInternalEnergy, rhos, sies, cvs, num,
+        lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &sies, &cvs, &num, &lambdas](const auto &eos) {
           return eos.SpecificHeatFromDensityInternalEnergy(
               std::forward<ConstRealIndexer>(rhos), std::forward<ConstRealIndexer>(sies),
               std::forward<RealIndexer>(cvs), num, std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, cvs);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
   template <typename RealIndexer, typename ConstRealIndexer>
   inline void SpecificHeatFromDensityInternalEnergy(ConstRealIndexer &&rhos,
@@ -760,7 +973,12 @@ class Variant {
   SpecificHeatFromDensityInternalEnergy(ConstRealIndexer &&rhos, ConstRealIndexer &&sies,
                                         RealIndexer &&cvs, Real *scratch, const int num,
                                         LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(
+        query_trace::Query::SpecificHeatFromDensityInternalEnergy, rhos, sies, cvs, num,
+        lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &sies, &cvs, &scratch, &num, &lambdas](const auto &eos) {
           return eos.SpecificHeatFromDensityInternalEnergy(
               std::forward<ConstRealIndexer>(rhos), std::forward<ConstRealIndexer>(sies),
@@ -768,6 +986,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, cvs);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -787,7 +1008,11 @@ class Variant {
                                                 ConstRealIndexer &&temperatures,
                                                 RealIndexer &&bmods, const int num,
                                                 LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::BulkModulusFromDensityTemperature,
+                                 rhos, temperatures, bmods, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &temperatures, &bmods, &num, &lambdas](const auto &eos) {
           return eos.BulkModulusFromDensityTemperature(
               std::forward<ConstRealIndexer>(rhos),
@@ -796,6 +1021,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, bmods);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
   template <typename RealIndexer, typename ConstRealIndexer>
   inline void BulkModulusFromDensityTemperature(ConstRealIndexer &&rhos,
@@ -815,7 +1043,11 @@ class Variant {
                                                 RealIndexer &&bmods, Real *scratch,
                                                 const int num,
                                                 LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::BulkModulusFromDensityTemperature,
+                                 rhos, temperatures, bmods, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &temperatures, &bmods, &scratch, &num, &lambdas](const auto &eos) {
           return eos.BulkModulusFromDensityTemperature(
               std::forward<ConstRealIndexer>(rhos),
@@ -824,6 +1056,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, bmods);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -841,7 +1076,11 @@ class Variant {
                                                    ConstRealIndexer &&sies,
                                                    RealIndexer &&bmods, const int num,
                                                    LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::BulkModulusFromDensityInternalEnergy,
+                                 rhos, sies, bmods, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &sies, &bmods, &num, &lambdas](const auto &eos) {
           return eos.BulkModulusFromDensityInternalEnergy(
               std::forward<ConstRealIndexer>(rhos), std::forward<ConstRealIndexer>(sies),
@@ -849,6 +1088,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, bmods);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -867,7 +1109,11 @@ class Variant {
   BulkModulusFromDensityInternalEnergy(ConstRealIndexer &&rhos, ConstRealIndexer &&sies,
                                        RealIndexer &&bmods, Real *scratch, const int num,
                                        LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::BulkModulusFromDensityInternalEnergy,
+                                 rhos, sies, bmods, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &sies, &bmods, &scratch, &num, &lambdas](const auto &eos) {
           return eos.BulkModulusFromDensityInternalEnergy(
               std::forward<ConstRealIndexer>(rhos), std::forward<ConstRealIndexer>(sies),
@@ -875,6 +1121,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, bmods);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -894,7 +1143,11 @@ class Variant {
                                                    ConstRealIndexer &&temperatures,
                                                    RealIndexer &&gm1s, const int num,
                                                    LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::GruneisenParamFromDensityTemperature,
+                                 rhos, temperatures, gm1s, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &temperatures, &gm1s, &num, &lambdas](const auto &eos) {
           return eos.GruneisenParamFromDensityTemperature(
               std::forward<ConstRealIndexer>(rhos),
@@ -902,6 +1155,9 @@ class Variant {
               std::forward<RealIndexer>(gm1s), num, std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, gm1s);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -922,7 +1178,11 @@ class Variant {
                                                    RealIndexer &&gm1s, Real *scratch,
                                                    const int num,
                                                    LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(query_trace::Query::GruneisenParamFromDensityTemperature,
+                                 rhos, temperatures, gm1s, num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &temperatures, &gm1s, &scratch, &num, &lambdas](const auto &eos) {
           return eos.GruneisenParamFromDensityTemperature(
               std::forward<ConstRealIndexer>(rhos),
@@ -931,6 +1191,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, gm1s);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -949,13 +1212,21 @@ class Variant {
                                                       ConstRealIndexer &&sies,
                                                       RealIndexer &&gm1s, const int num,
                                                       LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(
+        query_trace::Query::GruneisenParamFromDensityInternalEnergy, rhos, sies, gm1s,
+        num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &sies, &gm1s, &lambdas, &num](const auto &eos) {
           return eos.GruneisenParamFromDensityInternalEnergy(
               std::forward<ConstRealIndexer>(rhos), std::forward<ConstRealIndexer>(sies),
               std::forward<RealIndexer>(gm1s), num, std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, gm1s);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer, typename ConstRealIndexer>
@@ -975,7 +1246,12 @@ class Variant {
                                                       RealIndexer &&gm1s, Real *scratch,
                                                       const int num,
                                                       LambdaIndexer &&lambdas) const {
-    return mpark::visit(
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    auto capture = BeginCapture_(
+        query_trace::Query::GruneisenParamFromDensityInternalEnergy, rhos, sies, gm1s,
+        num, lambdas);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+    mpark::visit(
         [&rhos, &sies, &gm1s, &scratch, &lambdas, &num](const auto &eos) {
           return eos.GruneisenParamFromDensityInternalEnergy(
               std::forward<ConstRealIndexer>(rhos), std::forward<ConstRealIndexer>(sies),
@@ -983,6 +1259,9 @@ class Variant {
               std::forward<LambdaIndexer>(lambdas));
         },
         eos_);
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+    EndCapture_(capture, gm1s);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   }
 
   template <typename RealIndexer>
@@ -1013,6 +1292,100 @@ class Variant {
         eos_);
   }
 
+  template <typename RealIndexer, typename ConstRealIndexer>
+  inline void InvertState(const InputPair pair, ConstRealIndexer &&xs,
+                          ConstRealIndexer &&ys, RealIndexer &&rhos, RealIndexer &&temps,
+                          RealIndexer &&sies, RealIndexer &&presses, RealIndexer &&cvs,
+                          RealIndexer &&bmods, const int num,
+                          const unsigned long output) const {
+    NullIndexer lambdas{}; // Returns null pointer for every index
+    return InvertState(pair, std::forward<ConstRealIndexer>(xs),
+                       std::forward<ConstRealIndexer>(ys),
+                       std::forward<RealIndexer>(rhos), std::forward<RealIndexer>(temps),
+                       std::forward<RealIndexer>(sies),
+                       std::forward<RealIndexer>(presses), std::forward<RealIndexer>(cvs),
+                       std::forward<RealIndexer>(bmods), num, output, lambdas);
+  }
+
+  template <typename RealIndexer, typename ConstRealIndexer, typename LambdaIndexer>
+  inline void InvertState(const InputPair pair, ConstRealIndexer &&xs,
+                          ConstRealIndexer &&ys, RealIndexer &&rhos, RealIndexer &&temps,
+                          RealIndexer &&sies, RealIndexer &&presses, RealIndexer &&cvs,
+                          RealIndexer &&bmods, const int num, const unsigned long output,
+                          LambdaIndexer &&lambdas) const {
+    return mpark::visit(
+        [&](const auto &eos) {
+          return eos.InvertState(
+              pair, std::forward<ConstRealIndexer>(xs),
+              std::forward<ConstRealIndexer>(ys), std::forward<RealIndexer>(rhos),
+              std::forward<RealIndexer>(temps), std::forward<RealIndexer>(sies),
+              std::forward<RealIndexer>(presses), std::forward<RealIndexer>(cvs),
+              std::forward<RealIndexer>(bmods), num, output,
+              std::forward<LambdaIndexer>(lambdas));
+        },
+        eos_);
+  }
+
+  template <typename DerivIndexer, typename ConstRealIndexer>
+  inline void DerivativesFromDensityTemperature(ConstRealIndexer &&rhos,
+                                                ConstRealIndexer &&temperatures,
+                                                DerivIndexer &&derivs,
+                                                const int num) const {
+    NullIndexer lambdas{}; // Returns null pointer for every index
+    return DerivativesFromDensityTemperature(std::forward<ConstRealIndexer>(rhos),
+                                             std::forward<ConstRealIndexer>(temperatures),
+                                             std::forward<DerivIndexer>(derivs), num,
+                                             lambdas);
+  }
+
+  template <typename DerivIndexer, typename ConstRealIndexer, typename LambdaIndexer>
+  inline void DerivativesFromDensityTemperature(ConstRealIndexer &&rhos,
+                                                ConstRealIndexer &&temperatures,
+                                                DerivIndexer &&derivs, const int num,
+                                                LambdaIndexer &&lambdas) const {
+    return mpark::visit(
+        [&](const auto &eos) {
+          return eos.DerivativesFromDensityTemperature(
+              std::forward<ConstRealIndexer>(rhos),
+              std::forward<ConstRealIndexer>(temperatures),
+              std::forward<DerivIndexer>(derivs), num,
+              std::forward<LambdaIndexer>(lambdas));
+        },
+        eos_);
+  }
+
+  template <typename DerivIndexer, typename ConstRealIndexer>
+  inline void DerivativesFromDensityInternalEnergy(ConstRealIndexer &&rhos,
+                                                   ConstRealIndexer &&sies,
+                                                   DerivIndexer &&derivs,
+                                                   const int num) const {
+    NullIndexer lambdas{}; // Returns null pointer for every index
+    return DerivativesFromDensityInternalEnergy(
+        std::forward<ConstRealIndexer>(rhos), std::forward<ConstRealIndexer>(sies),
+        std::forward<DerivIndexer>(derivs), num, lambdas);
+  }
+
+  template <typename DerivIndexer, typename ConstRealIndexer, typename LambdaIndexer>
+  inline void DerivativesFromDensityInternalEnergy(ConstRealIndexer &&rhos,
+                                                   ConstRealIndexer &&sies,
+                                                   DerivIndexer &&derivs, const int num,
+                                                   LambdaIndexer &&lambdas) const {
+    return mpark::visit(
+        [&](const auto &eos) {
+          return eos.DerivativesFromDensityInternalEnergy(
+              std::forward<ConstRealIndexer>(rhos), std::forward<ConstRealIndexer>(sies),
+              std::forward<DerivIndexer>(derivs), num,
+              std::forward<LambdaIndexer>(lambdas));
+        },
+        eos_);
+  }
+
+#ifdef SINGULARITY_EXPLICIT_INSTANTIATION
+  // Non-template overloads of the vector functions for the common
+  // indexer types. See eos_variant_instantiation.hpp.
+  SG_VARIANT_DECLARE_VECTOR_FUNCTIONS()
+#endif // SINGULARITY_EXPLICIT_INSTANTIATION
+
   // Tooling for modifiers
   inline constexpr bool IsModified() const {
     return mpark::visit([](const auto &eos) { return eos.IsModified(); }, eos_);
@@ -1069,7 +1442,43 @@ class Variant {
   inline void Finalize() noexcept {
     return mpark::visit([](auto &eos) { return eos.Finalize(); }, eos_);
   }
+
+  inline void SetAccuracy(const AccuracyParams &params) {
+    return mpark::visit([&params](auto &eos) { return eos.SetAccuracy(params); }, eos_);
+  }
+
+  PORTABLE_INLINE_FUNCTION
+  AccuracyParams GetAccuracy() const {
+    return mpark::visit([](const auto &eos) { return eos.GetAccuracy(); }, eos_);
+  }
+
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+ private:
+  // Snapshots the inputs and lambdas of a vector call for the trace
+  // writer before the call runs. Calls on device-only memory are
+  // skipped.
+  template <typename ConstRealIndexer, typename RealIndexer, typename LambdaIndexer>
+  inline query_trace::Pending BeginCapture_(const query_trace::Query query,
+                                            ConstRealIndexer &&xs, ConstRealIndexer &&ys,
+                                            RealIndexer &&outs, const int num,
+                                            LambdaIndexer &&lambdas) const {
+    auto &writer = query_trace::GlobalWriter();
+    if (!writer.Active()) return query_trace::Pending();
+    return writer.Begin(query, static_cast<int>(eos_.index()), xs, ys, outs, num,
+                        lambdas, nlambda());
+  }
+  // Hands the outputs of the completed call to the trace writer
+  template <typename RealIndexer>
+  inline void EndCapture_(query_trace::Pending &capture, RealIndexer &&outs) const {
+    query_trace::GlobalWriter().Finish(capture, outs);
+  }
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
 };
+
+#ifdef SINGULARITY_EXPLICIT_INSTANTIATION
+SG_VARIANT_DEFINE_VECTOR_FUNCTIONS()
+#endif // SINGULARITY_EXPLICIT_INSTANTIATION
+
 } // namespace singularity
 
 #endif // EOS_VARIANT_HPP
@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#ifndef SINGULARITY_EOS_EOS_EOS_VARIANT_INSTANTIATION_HPP_
+#define SINGULARITY_EOS_EOS_EOS_VARIANT_INSTANTIATION_HPP_
+
+// Machinery for SINGULARITY_EXPLICIT_INSTANTIATION.
+//
+// The vector functions of Variant are templates on their indexer
+// types, so every translation unit that calls one instantiates a
+// visit over every EOS in the variant. Explicit instantiation
+// declarations do not help here: member templates defined in the
+// class body are implicitly inline, and compilers instantiate inline
+// functions regardless, so that they may be inlined.
+//
+// Instead, when SINGULARITY_EXPLICIT_INSTANTIATION is defined,
+// Variant gains non-template overloads of the vector functions for
+// the common indexer types. These are defined out of line, and
+// therefore not inline, and simply forward to the templates. Overload
+// resolution prefers them over the templates when the argument types
+// match exactly. For the default EOS variant, they are declared
+// extern in default_variant.hpp and compiled once, in eos.cpp, into
+// the singularity-eos library. Indexer types not listed here fall
+// back to the templates as usual.
+//
+// The lists below are X-macros. Each takes a macro F and applies it
+// to every entry.
+
+#include <ports-of-call/portability.hpp>
+
+// Vector functions of the form f(rhos, xs, ys, num[, lambdas])
+#define SG_FOR_EACH_VECTOR_FUNCTION(F)                                                   \
+  F(TemperatureFromDensityInternalEnergy)                                                \
+  F(InternalEnergyFromDensityTemperature)                                                \
+  F(PressureFromDensityTemperature)                                                      \
+  F(PressureFromDensityInternalEnergy)                                                   \
+  F(EntropyFromDensityTemperature)                                                       \
+  F(EntropyFromDensityInternalEnergy)                                                    \
+  F(SpecificHeatFromDensityTemperature)                                                  \
+  F(SpecificHeatFromDensityInternalEnergy)                                               \
+  F(BulkModulusFromDensityTemperature)                                                   \
+  F(BulkModulusFromDensityInternalEnergy)                                                \
+  F(GruneisenParamFromDensityTemperature)                                                \
+  F(GruneisenParamFromDensityInternalEnergy)
+
+// Indexer types, as (ConstRealIndexer, RealIndexer) pairs. Raw
+// pointers are also instantiated with Real ** lambdas. Views are
+// not, as a Kokkos view does not index to a Real *.
+#define SG_FOR_EACH_POINTER_INDEXER(F, NAME)                                             \
+  F(NAME, const Real *, Real *)                                                          \
+  F(NAME, Real *, Real *)
+#ifdef PORTABILITY_STRATEGY_KOKKOS
+#define SG_FOR_EACH_VIEW_INDEXER(F, NAME)                                                \
+  F(NAME, Kokkos::View<const Real *>, Kokkos::View<Real *>)                              \
+  F(NAME, Kokkos::View<Real *>, Kokkos::View<Real *>)
+#else
+#define SG_FOR_EACH_VIEW_INDEXER(F, NAME)
+#endif // PORTABILITY_STRATEGY_KOKKOS
+
+// Declarations, for use inside the body of Variant
+#define SG_VARIANT_DECLARE_VECTOR_(NAME, CRI, RI)                                        \
+  void NAME(CRI rhos, CRI xs, RI ys, const int num) const;
+#define SG_VARIANT_DECLARE_VECTOR_LAMBDA_(NAME, CRI, RI)                                 \
+  SG_VARIANT_DECLARE_VECTOR_(NAME, CRI, RI)                                              \
+  void NAME(CRI rhos, CRI xs, RI ys, const int num, Real **lambdas) const;
+#define SG_VARIANT_DECLARE_VECTOR_FUNCTION_(NAME)                                        \
+  SG_FOR_EACH_POINTER_INDEXER(SG_VARIANT_DECLARE_VECTOR_LAMBDA_, NAME)                   \
+  SG_FOR_EACH_VIEW_INDEXER(SG_VARIANT_DECLARE_VECTOR_, NAME)
+#define SG_VARIANT_DECLARE_VECTOR_FUNCTIONS()                                            \
+  SG_FOR_EACH_VECTOR_FUNCTION(SG_VARIANT_DECLARE_VECTOR_FUNCTION_)
+
+// Out-of-line definitions, which forward to the templates. The
+// explicit template arguments guarantee the templates are selected.
+#define SG_VARIANT_DEFINE_VECTOR_(NAME, CRI, RI)                                         \
+  template <typename... EOSs>                                                            \
+  void Variant<EOSs...>::NAME(CRI rhos, CRI xs, RI ys, const int num) const {            \
+    this->template NAME<RI &, CRI &>(rhos, xs, ys, num);                                 \
+  }
+#define SG_VARIANT_DEFINE_VECTOR_LAMBDA_(NAME, CRI, RI)                                  \
+  SG_VARIANT_DEFINE_VECTOR_(NAME, CRI, RI)                                               \
+  template <typename... EOSs>                                                            \
+  void Variant<EOSs...>::NAME(CRI rhos, CRI xs, RI ys, const int num, Real **lambdas)    \
+      const {                                                                            \
+    this->template NAME<RI &, CRI &, Real **&>(rhos, xs, ys, num, lambdas);              \
+  }
+#define SG_VARIANT_DEFINE_VECTOR_FUNCTION_(NAME)                                         \
+  SG_FOR_EACH_POINTER_INDEXER(SG_VARIANT_DEFINE_VECTOR_LAMBDA_, NAME)                    \
+  SG_FOR_EACH_VIEW_INDEXER(SG_VARIANT_DEFINE_VECTOR_, NAME)
+#define SG_VARIANT_DEFINE_VECTOR_FUNCTIONS()                                             \
+  SG_FOR_EACH_VECTOR_FUNCTION(SG_VARIANT_DEFINE_VECTOR_FUNCTION_)
+
+// Explicit instantiations for a concrete variant type, which must be
+// named by the macro SG_INSTANTIATED_VARIANT. PREFIX is either
+// `template` for a definition or `extern template` for a
+// declaration.
+#define SG_VARIANT_INSTANTIATE_VECTOR_(PREFIX, NAME, CRI, RI)                            \
+  PREFIX void SG_INSTANTIATED_VARIANT::NAME(CRI, CRI, RI, const int) const;
+#define SG_VARIANT_INSTANTIATE_VECTOR_LAMBDA_(PREFIX, NAME, CRI, RI)                     \
+  SG_VARIANT_INSTANTIATE_VECTOR_(PREFIX, NAME, CRI, RI)                                  \
+  PREFIX void SG_INSTANTIATED_VARIANT::NAME(CRI, CRI, RI, const int, Real **) const;
+#define SG_VARIANT_EXTERN_(NAME, CRI, RI)                                                \
+  SG_VARIANT_INSTANTIATE_VECTOR_(extern template, NAME, CRI, RI)
+#define SG_VARIANT_EXTERN_LAMBDA_(NAME, CRI, RI)                                         \
+  SG_VARIANT_INSTANTIATE_VECTOR_LAMBDA_(extern template, NAME, CRI, RI)
+#define SG_VARIANT_INSTANCE_(NAME, CRI, RI)                                              \
+  SG_VARIANT_INSTANTIATE_VECTOR_(template, NAME, CRI, RI)
+#define SG_VARIANT_INSTANCE_LAMBDA_(NAME, CRI, RI)                                       \
+  SG_VARIANT_INSTANTIATE_VECTOR_LAMBDA_(template, NAME, CRI, RI)
+#define SG_VARIANT_EXTERN_FUNCTION_(NAME)                                                \
+  SG_FOR_EACH_POINTER_INDEXER(SG_VARIANT_EXTERN_LAMBDA_, NAME)                           \
+  SG_FOR_EACH_VIEW_INDEXER(SG_VARIANT_EXTERN_, NAME)
+#define SG_VARIANT_INSTANCE_FUNCTION_(NAME)                                              \
+  SG_FOR_EACH_POINTER_INDEXER(SG_VARIANT_INSTANCE_LAMBDA_, NAME)                         \
+  SG_FOR_EACH_VIEW_INDEXER(SG_VARIANT_INSTANCE_, NAME)
+#define SG_VARIANT_EXTERN_VECTOR_FUNCTIONS()                                             \
+  SG_FOR_EACH_VECTOR_FUNCTION(SG_VARIANT_EXTERN_FUNCTION_)
+#define SG_VARIANT_INSTANTIATE_VECTOR_FUNCTIONS()                                        \
+  SG_FOR_EACH_VECTOR_FUNCTION(SG_VARIANT_INSTANCE_FUNCTION_)
+
+#endif // SINGULARITY_EOS_EOS_EOS_VARIANT_INSTANTIATION_HPP_
@@ -24,6 +24,7 @@
 #include <singularity-eos/base/constants.hpp>
 #include <singularity-eos/base/math_utils.hpp>
 #include <singularity-eos/base/robust_utils.hpp>
+#include <singularity-eos/base/simd_utils.hpp>
 #include <singularity-eos/eos/eos_base.hpp>
 
 namespace singularity {
@@ -47,75 +48,84 @@ class Vinet : public EosBase<Vinet> {
   }
 
   Vinet GetOnDevice() { return *this; }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real TemperatureFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  TemperatureFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real InternalEnergyFromDensityTemperature(
-      const Real rho, const Real temp,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  InternalEnergyFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temp,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real
-  PressureFromDensityTemperature(const Real rho, const Real temp,
-                                 Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real PressureFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> PressureFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temp,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> PressureFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
   template <typename Indexer_t = Real *>
   PORTABLE_INLINE_FUNCTION Real MinInternalEnergyFromDensity(
       const Real rho, Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
   // Entropy added AEM Dec. 2022
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real
-  EntropyFromDensityTemperature(const Real rho, const Real temp,
-                                Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real EntropyFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> EntropyFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temp,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real SpecificHeatFromDensityTemperature(
-      const Real rho, const Real temp,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> EntropyFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
+      Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> SpecificHeatFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temp,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return _Cv0;
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real SpecificHeatFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  SpecificHeatFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
     return _Cv0;
   }
   // Thermal Bulk Modulus added AEM Dec 2022
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real TBulkModulusFromDensityTemperature(
-      const Real rho, const Real temp,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> TBulkModulusFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temp,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real BulkModulusFromDensityTemperature(
-      const Real rho, const Real temp,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t> BulkModulusFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temp,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real BulkModulusFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  BulkModulusFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
   // Thermal expansion coefficient added AEM 2022
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real TExpansionCoeffFromDensityTemperature(
-      const Real rho, const Real temp,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  TExpansionCoeffFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temp,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const;
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real GruneisenParamFromDensityTemperature(
-      const Real rho, const Real temp,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  GruneisenParamFromDensityTemperature(
+      const Real_t rho, const simd_utils::value_t<Real_t> temp,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return robust::ratio(_A0 * _B0, _Cv0 * rho);
+    using R = simd_utils::value_t<Real_t>;
+    return simd_utils::ratio<R>(_A0 * _B0, _Cv0 * rho);
   }
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION Real GruneisenParamFromDensityInternalEnergy(
-      const Real rho, const Real sie,
+  template <typename Real_t = Real, typename Indexer_t = Real *>
+  PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+  GruneisenParamFromDensityInternalEnergy(
+      const Real_t rho, const simd_utils::value_t<Real_t> sie,
       Indexer_t &&lambda = static_cast<Real *>(nullptr)) const {
-    return robust::ratio(_A0 * _B0, _Cv0 * rho);
+    using R = simd_utils::value_t<Real_t>;
+    return simd_utils::ratio<R>(_A0 * _B0, _Cv0 * rho);
   }
   template <typename Indexer_t = Real *>
   PORTABLE_INLINE_FUNCTION void
@@ -147,11 +157,8 @@ class Vinet : public EosBase<Vinet> {
     }
     printf("\n\n");
   }
-  // Density/Energy from P/T not unique, if used will give error
-  template <typename Indexer_t = Real *>
-  PORTABLE_INLINE_FUNCTION void
-  DensityEnergyFromPressureTemperature(const Real press, const Real temp,
-                                       Indexer_t &&lambda, Real &rho, Real &sie) const;
+  // Density/Energy from P/T is the root find in EosBase, which finds one
+  // root if there are several
   inline void Finalize() {}
   static std::string EosType() { return std::string("Vinet"); }
   static std::string EosPyType() { return EosType(); }
@@ -165,8 +172,14 @@ class Vinet : public EosBase<Vinet> {
   Real _VIP[VinetInternalParametersSize], _d2tod40[PressureCoeffsd2tod40Size];
   void CheckVinet();
   void InitializeVinet(const Real *expcoeffs);
-  PORTABLE_INLINE_FUNCTION void Vinet_F_DT_func(const Real rho, const Real T,
-                                                Real *output) const;
+  template <typename Real_t>
+  PORTABLE_INLINE_FUNCTION void Vinet_F_DT_func(const Real_t rho, const Real_t T,
+                                                Real_t *output) const;
+  // Entropy on the isotherm, with a scalar overload and a masked overload for packs
+  PORTABLE_INLINE_FUNCTION Real Entropy_(const Real rho, const Real T) const;
+  template <typename Real_t>
+  PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+  Entropy_(const Real_t rho, const Real_t T) const;
 };
 
 inline void Vinet::CheckVinet() {
@@ -220,16 +233,47 @@ inline void Vinet::InitializeVinet(const Real *d2tod40input) {
   }                                                          // _VIP[n+2]=fn, ind=n+2
 }
 
-PORTABLE_INLINE_FUNCTION void Vinet::Vinet_F_DT_func(const Real rho, const Real T,
-                                                     Real *output) const {
+PORTABLE_INLINE_FUNCTION Real Vinet::Entropy_(const Real rho, const Real T) const {
+  if (T < 0.0) {
+#ifndef NDEBUG
+    PORTABLE_WARN("Negative temperature input");
+#endif // NDEBUG
+    return 0.0;
+  }
+  return (_A0 * _B0) * (robust::ratio(1.0, rho) - robust::ratio(1, _rho0)) +
+         _Cv0 * std::log(robust::ratio(T, _T0)) + _S0;
+}
+template <typename Real_t>
+PORTABLE_INLINE_FUNCTION simd_utils::enable_if_pack_t<Real_t, Real_t>
+Vinet::Entropy_(const Real_t rho, const Real_t T) const {
+  using R = Real_t;
+#ifndef NDEBUG
+  if (!simd_utils::all(T >= R(0.0))) {
+    PORTABLE_WARN("Negative temperature input");
+  }
+#endif // NDEBUG
+  // Entropy is zero for negative temperatures
+  const auto negative_T = T < R(0.0);
+  return simd_utils::select(
+      negative_T, R(0.0),
+      R((_A0 * _B0) * (simd_utils::ratio<R>(1.0, rho) - robust::ratio(1, _rho0)) +
+        _Cv0 * simd_utils::log(simd_utils::ratio<R>(
+                   simd_utils::select(negative_T, R(_T0), T), _T0)) +
+        _S0));
+}
+
+template <typename Real_t>
+PORTABLE_INLINE_FUNCTION void Vinet::Vinet_F_DT_func(const Real_t rho, const Real_t T,
+                                                     Real_t *output) const {
+  using R = Real_t;
   constexpr int pref0vp = -2, pref0vip = 2, maxind = VinetInternalParametersSize - 3;
-  Real sumP = 0.0, sumB = 0.0, sumE = 0.0;
+  R sumP = 0.0, sumB = 0.0, sumE = 0.0;
 
-  Real x = std::cbrt(robust::ratio(_rho0, rho)); /*rho-dependent*/
-  Real x2inv = robust::ratio(1.0, x * x);
-  Real onemx = 1.0 - x;
-  Real etatimes1mx = _VIP[1] * onemx;
-  Real expetatimes1mx = exp(etatimes1mx);
+  R x = simd_utils::cbrt(simd_utils::ratio<R>(_rho0, rho)); /*rho-dependent*/
+  R x2inv = simd_utils::ratio<R>(1.0, x * x);
+  R onemx = 1.0 - x;
+  R etatimes1mx = _VIP[1] * onemx;
+  R expetatimes1mx = simd_utils::exp(etatimes1mx);
 
 #pragma unroll
   for (int ind = maxind; ind >= 2; ind--) {              //_d2tod40[0]=d2
@@ -246,33 +290,24 @@ PORTABLE_INLINE_FUNCTION void Vinet::Vinet_F_DT_func(const Real rho, const Real
   sumE = _VIP[1] * onemx * sumE;
 
   /* T0 isotherm */
-  Real energy = 9.0 * robust::ratio(_B0, _VIP[1] * _VIP[1] * _rho0) *
-                    (_VIP[pref0vip] - expetatimes1mx * (_VIP[pref0vip] - sumE)) -
-                (_A0 * _B0) * (robust::ratio(_T0, _rho0) - robust::ratio(_T0, rho));
-  Real pressure = 3.0 * _B0 * x2inv * onemx * expetatimes1mx * sumP;
-  Real temp = (1.0 + onemx * (_VIP[1] * x + 1.0)) * sumP + x * onemx * sumB;
+  R energy = 9.0 * robust::ratio(_B0, _VIP[1] * _VIP[1] * _rho0) *
+                 (_VIP[pref0vip] - expetatimes1mx * (_VIP[pref0vip] - sumE)) -
+             (_A0 * _B0) * (robust::ratio(_T0, _rho0) - simd_utils::ratio<R>(_T0, rho));
+  R pressure = 3.0 * _B0 * x2inv * onemx * expetatimes1mx * sumP;
+  R temp = (1.0 + onemx * (_VIP[1] * x + 1.0)) * sumP + x * onemx * sumB;
   temp = robust::ratio(_B0, _rho0) * x * expetatimes1mx * temp;
 
   /* Go to required temperature */
   energy = energy + _Cv0 * (T - _T0) + _E0;
   pressure = pressure + (_A0 * _B0) * (T - _T0);
-  Real dpdrho = temp;
+  R dpdrho = temp;
   Real dpdt = _A0 * _B0;
   Real dedt = _Cv0;
-  Real dedrho = robust::ratio(pressure - T * (_A0 * _B0), rho * rho);
-  Real entropy;
-  if (T < 0.0) {
-#ifndef NDEBUG
-    PORTABLE_WARN("Negative temperature input");
-#endif // NDEBUG
-    entropy = 0.0;
-  } else {
-    entropy = (_A0 * _B0) * (robust::ratio(1.0, rho) - robust::ratio(1, _rho0)) +
-              _Cv0 * std::log(robust::ratio(T, _T0)) + _S0;
-  }
-  Real soundspeed =
-      std::max(0.0, dpdrho + T * robust::ratio(dpdt * dpdt, rho * rho * _Cv0));
-  soundspeed = std::sqrt(soundspeed);
+  R dedrho = simd_utils::ratio<R>(pressure - T * (_A0 * _B0), rho * rho);
+  const R entropy = Entropy_(rho, T);
+  R soundspeed = simd_utils::max<R>(
+      0.0, dpdrho + T * simd_utils::ratio<R>(dpdt * dpdt, rho * rho * _Cv0));
+  soundspeed = simd_utils::sqrt(soundspeed);
 
   output[0] = energy;
   output[1] = pressure;
@@ -285,64 +320,78 @@ PORTABLE_INLINE_FUNCTION void Vinet::Vinet_F_DT_func(const Real rho, const Real
 
   return;
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real Vinet::InternalEnergyFromDensityTemperature(
-    const Real rho, const Real temp, Indexer_t &&lambda) const {
-  Real output[8];
-  Vinet_F_DT_func(rho, temp, output);
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+Vinet::InternalEnergyFromDensityTemperature(
+    const Real_t rho, const simd_utils::value_t<Real_t> temp, Indexer_t &&lambda) const {
+  using R = simd_utils::value_t<Real_t>;
+  R output[8];
+  Vinet_F_DT_func<R>(rho, temp, output);
   return output[0];
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real Vinet::PressureFromDensityTemperature(
-    const Real rho, const Real temp, Indexer_t &&lambda) const {
-  Real output[8];
-  Vinet_F_DT_func(rho, temp, output);
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+Vinet::PressureFromDensityTemperature(
+    const Real_t rho, const simd_utils::value_t<Real_t> temp, Indexer_t &&lambda) const {
+  using R = simd_utils::value_t<Real_t>;
+  R output[8];
+  Vinet_F_DT_func<R>(rho, temp, output);
   return output[1];
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real Vinet::EntropyFromDensityTemperature(
-    const Real rho, const Real temp, Indexer_t &&lambda) const {
-  Real output[8];
-  Vinet_F_DT_func(rho, temp, output);
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+Vinet::EntropyFromDensityTemperature(
+    const Real_t rho, const simd_utils::value_t<Real_t> temp, Indexer_t &&lambda) const {
+  using R = simd_utils::value_t<Real_t>;
+  R output[8];
+  Vinet_F_DT_func<R>(rho, temp, output);
   return output[6];
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real Vinet::TExpansionCoeffFromDensityTemperature(
-    const Real rho, const Real temp, Indexer_t &&lambda) const {
-  Real output[8];
-  Vinet_F_DT_func(rho, temp, output);
-  return robust::ratio(output[3], output[2] * rho);
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+Vinet::TExpansionCoeffFromDensityTemperature(
+    const Real_t rho, const simd_utils::value_t<Real_t> temp, Indexer_t &&lambda) const {
+  using R = simd_utils::value_t<Real_t>;
+  R output[8];
+  Vinet_F_DT_func<R>(rho, temp, output);
+  return simd_utils::ratio<R>(output[3], output[2] * rho);
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real Vinet::TBulkModulusFromDensityTemperature(
-    const Real rho, const Real temp, Indexer_t &&lambda) const {
-  Real output[8];
-  Vinet_F_DT_func(rho, temp, output);
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+Vinet::TBulkModulusFromDensityTemperature(
+    const Real_t rho, const simd_utils::value_t<Real_t> temp, Indexer_t &&lambda) const {
+  using R = simd_utils::value_t<Real_t>;
+  R output[8];
+  Vinet_F_DT_func<R>(rho, temp, output);
   return output[2] * rho;
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real Vinet::BulkModulusFromDensityTemperature(
-    const Real rho, const Real temp, Indexer_t &&lambda) const {
-  Real output[8];
-  Vinet_F_DT_func(rho, temp, output);
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+Vinet::BulkModulusFromDensityTemperature(
+    const Real_t rho, const simd_utils::value_t<Real_t> temp, Indexer_t &&lambda) const {
+  using R = simd_utils::value_t<Real_t>;
+  R output[8];
+  Vinet_F_DT_func<R>(rho, temp, output);
   return output[7] * output[7] * rho;
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real Vinet::TemperatureFromDensityInternalEnergy(
-    const Real rho, const Real sie, Indexer_t &&lambda) const {
-  Real Tref;
-  Real output[8];
-  Tref = _T0;
-  Vinet_F_DT_func(rho, Tref, output);
-  return robust::ratio(sie - output[0], _Cv0) + Tref;
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+Vinet::TemperatureFromDensityInternalEnergy(
+    const Real_t rho, const simd_utils::value_t<Real_t> sie, Indexer_t &&lambda) const {
+  using R = simd_utils::value_t<Real_t>;
+  R output[8];
+  const R Tref = _T0;
+  Vinet_F_DT_func<R>(rho, Tref, output);
+  return simd_utils::ratio<R>(sie - output[0], _Cv0) + Tref;
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real Vinet::PressureFromDensityInternalEnergy(
-    const Real rho, const Real sie, Indexer_t &&lambda) const {
-  Real temp;
-  Real output[8];
-  temp = TemperatureFromDensityInternalEnergy(rho, sie);
-  Vinet_F_DT_func(rho, temp, output);
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+Vinet::PressureFromDensityInternalEnergy(
+    const Real_t rho, const simd_utils::value_t<Real_t> sie, Indexer_t &&lambda) const {
+  using R = simd_utils::value_t<Real_t>;
+  R output[8];
+  const R temp = TemperatureFromDensityInternalEnergy(rho, sie);
+  Vinet_F_DT_func<R>(rho, temp, output);
   return output[1];
 }
 template <typename Indexer_t>
@@ -351,31 +400,26 @@ Vinet::MinInternalEnergyFromDensity(const Real rho, Indexer_t &&lambda) const {
   MinInternalEnergyIsNotEnabled("Vinet");
   return 0.0;
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real Vinet::EntropyFromDensityInternalEnergy(
-    const Real rho, const Real sie, Indexer_t &&lambda) const {
-  Real temp;
-  Real output[8];
-  temp = TemperatureFromDensityInternalEnergy(rho, sie);
-  Vinet_F_DT_func(rho, temp, output);
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+Vinet::EntropyFromDensityInternalEnergy(
+    const Real_t rho, const simd_utils::value_t<Real_t> sie, Indexer_t &&lambda) const {
+  using R = simd_utils::value_t<Real_t>;
+  R output[8];
+  const R temp = TemperatureFromDensityInternalEnergy(rho, sie);
+  Vinet_F_DT_func<R>(rho, temp, output);
   return output[6];
 }
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION Real Vinet::BulkModulusFromDensityInternalEnergy(
-    const Real rho, const Real sie, Indexer_t &&lambda) const {
-  Real temp;
-  Real output[8];
-  temp = TemperatureFromDensityInternalEnergy(rho, sie);
-  Vinet_F_DT_func(rho, temp, output);
+template <typename Real_t, typename Indexer_t>
+PORTABLE_INLINE_FUNCTION simd_utils::value_t<Real_t>
+Vinet::BulkModulusFromDensityInternalEnergy(
+    const Real_t rho, const simd_utils::value_t<Real_t> sie, Indexer_t &&lambda) const {
+  using R = simd_utils::value_t<Real_t>;
+  R output[8];
+  const R temp = TemperatureFromDensityInternalEnergy(rho, sie);
+  Vinet_F_DT_func<R>(rho, temp, output);
   return output[7] * output[7] * rho;
 }
-// AEM: Give error since function is not well defined
-template <typename Indexer_t>
-PORTABLE_INLINE_FUNCTION void Vinet::DensityEnergyFromPressureTemperature(
-    const Real press, const Real temp, Indexer_t &&lambda, Real &rho, Real &sie) const {
-  EOS_ERROR("Vinet::DensityEnergyFromPressureTemperature: "
-            "Not implemented.\n");
-}
 // AEM: We should add entropy and Gruneissen parameters here so that it is complete
 // If we add also alpha and BT, those should also be in here.
 template <typename Indexer_t>
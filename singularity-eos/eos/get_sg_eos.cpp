@@ -13,6 +13,7 @@
 //------------------------------------------------------------------------------
 
 #include <map>
+#include <memory>
 #include <ports-of-call/portability.hpp>
 #include <singularity-eos/closure/mixed_cell_models.hpp>
 #include <singularity-eos/eos/eos.hpp>
@@ -20,6 +21,10 @@
 #include <singularity-eos/eos/get_sg_eos_functors.hpp>
 #include <singularity-eos/eos/singularity_eos.hpp>
 
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+#include <singularity-eos/base/query_trace.hpp>
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
+
 using namespace singularity;
 
 // mapping from EAP integer to
@@ -29,6 +34,7 @@ static const std::map<const int, const unsigned long> EAPInputToBD = {
     {-1, thermalqs::pressure | thermalqs::temperature},
     {0, thermalqs::specific_internal_energy | thermalqs::density},
     {1, thermalqs::specific_internal_energy | thermalqs::density},
+    {2, thermalqs::specific_internal_energy | thermalqs::density},
 };
 
 // EAP centric arguments and function signature
@@ -51,7 +57,42 @@ int get_sg_eos( // sizing information
     double *frac_bmod, double *frac_dpde, double *frac_cv,
     // Mass fraction cutoff for PTE
     double mass_frac_cutoff) {
+  return get_sg_eos_with_cost(nmat, ncell, cell_dim, input_int, eos_offsets, eos, offsets,
+                              press, pmax, vol, spvol, sie, temp, bmod, dpde, cv,
+                              frac_mass, frac_vol, frac_ie, frac_bmod, frac_dpde, frac_cv,
+                              mass_frac_cutoff, nullptr);
+}
+
+// As get_sg_eos, but optionally reports an estimate of the work done
+// in each cell, e.g., for load balancing
+int get_sg_eos_with_cost( // sizing information
+    int nmat, int ncell, int cell_dim,
+    // Input parameters
+    int input_int,
+    // eos index offsets
+    int *eos_offsets,
+    // equation of state array
+    EOS *eos,
+    // index offsets
+    int *offsets,
+    // per cell quantities
+    double *press, double *pmax, double *vol, double *spvol, double *sie, double *temp,
+    double *bmod, double *dpde, double *cv,
+    // per material quantities
+    double *frac_mass, double *frac_vol, double *frac_ie,
+    // optional per material quantities
+    double *frac_bmod, double *frac_dpde, double *frac_cv,
+    // Mass fraction cutoff for PTE
+    double mass_frac_cutoff,
+    // optional per cell cost
+    double *cell_cost) {
   // printBacktrace();
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+  // before any of the inputs are normalized or overwritten
+  query_trace::CaptureGetSgEos(input_int, nmat, ncell, cell_dim, eos_offsets, offsets,
+                               spvol, sie, press, temp, frac_mass, frac_vol, frac_ie,
+                               mass_frac_cutoff);
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
   // kernel return value will be the number of failures
   int ret{0};
   // handle optionals
@@ -61,13 +102,16 @@ int get_sg_eos( // sizing information
   if (frac_dpde == NULL || frac_dpde == nullptr) do_frac_dpde = false;
   bool do_frac_cv{true};
   if (frac_dpde == NULL || frac_dpde == nullptr) do_frac_cv = false;
+  bool do_cost{true};
+  if (cell_cost == NULL || cell_cost == nullptr) do_cost = false;
   // get inputs
   enum class input_condition {
     RHO_T_INPUT = -3,
     RHO_P_INPUT = -2,
     P_T_INPUT = -1,
     NORM_RHO_E_INPUT = 0,
-    RHO_E_INPUT = 1
+    RHO_E_INPUT = 1,
+    RHO_E_FIXED_SIE_INPUT = 2
   };
   const auto input{EAPInputToBD.at(input_int)};
   const bool p_is_inp{static_cast<bool>(input & thermalqs::pressure)};
@@ -94,6 +138,8 @@ int get_sg_eos( // sizing information
   if (do_frac_bmod) frac_bmod_hv = host_frac_v(frac_bmod, cell_dim, nmat);
   if (do_frac_dpde) frac_dpde_hv = host_frac_v(frac_dpde, cell_dim, nmat);
   if (do_frac_cv) frac_cv_hv = host_frac_v(frac_cv, cell_dim, nmat);
+  host_v cost_hv;
+  if (do_cost) cost_hv = host_v(cell_cost, cell_dim);
 
   // get device views if necessary
   indirection_v offsets_v{create_mirror_view_and_copy(DMS(), offsets_hv)};
@@ -114,6 +160,8 @@ int get_sg_eos( // sizing information
   if (do_frac_bmod) frac_bmod_v = create_mirror_view_and_copy(DMS(), frac_bmod_hv);
   if (do_frac_dpde) frac_dpde_v = create_mirror_view_and_copy(DMS(), frac_dpde_hv);
   if (do_frac_cv) frac_cv_v = create_mirror_view_and_copy(DMS(), frac_cv_hv);
+  dev_v cost_v;
+  if (do_cost) cost_v = create_mirror_view_and_copy(DMS(), cost_hv);
   // array of eos's
   const auto eos_nmat{*std::max_element(eos_offsets, eos_offsets + nmat)};
   Kokkos::View<EOS *, Llft, HS, Unmgd> eos_hv(eos, eos_nmat);
@@ -126,13 +174,25 @@ int get_sg_eos( // sizing information
   // assume atomics are required for correctness if serial not even enabled
   constexpr auto at_int{at_int_full};
 #endif // KOKKOS_ENABLE_SERIAL
+  auto input_int_enum = static_cast<input_condition>(input_int);
   // set up scratch arrays
+#ifdef SINGULARITY_GET_SG_EOS_TEAM_SCRATCH
+  // the (rho,e) kernel carves its per-cell arrays out of team scratch,
+  // so it needs neither the token pool nor the global scratch below
+  const bool team_scratch{input_int_enum == input_condition::NORM_RHO_E_INPUT ||
+                          input_int_enum == input_condition::RHO_E_INPUT};
+#else
+  constexpr bool team_scratch{false};
+#endif // SINGULARITY_GET_SG_EOS_TEAM_SCRATCH
   constexpr auto KGlobal = Kokkos::Experimental::UniqueTokenScope::Global;
-  Kokkos::Experimental::UniqueToken<DES, KGlobal> tokens{};
+  using tokens_t = Kokkos::Experimental::UniqueToken<DES, KGlobal>;
+  std::unique_ptr<tokens_t> tokens;
+  if (!team_scratch) tokens.reset(new tokens_t());
   using VAWI = Kokkos::ViewAllocateWithoutInitializing;
 
-  const bool small_loop{tokens.size() > ncell};
-  const decltype(tokens)::size_type scratch_size{std::min(tokens.size(), ncell)};
+  const tokens_t::size_type ntokens{team_scratch ? 0 : tokens->size()};
+  const bool small_loop{ntokens > ncell};
+  const tokens_t::size_type scratch_size{std::min(ntokens, ncell)};
   ScratchV<int> pte_mats(VAWI("PTE::scratch mats"), scratch_size, nmat);
   ScratchV<int> pte_idxs(VAWI("PTE::scratch idxs"), scratch_size, nmat);
   ScratchV<double> mass_pte(VAWI("PTE::scratch mass"), scratch_size, nmat);
@@ -145,13 +205,12 @@ int get_sg_eos( // sizing information
   int pte_solver_scratch_size{};
   ScratchV<double> solver_scratch;
   // declare init and final functors
-  auto input_int_enum = static_cast<input_condition>(input_int);
   init_functor i_func;
   final_functor f_func(spvol_v, temp_v, press_v, sie_v, bmod_v, cv_v, dpde_v, pte_mats,
                        press_pte, vfrac_pte, temp_pte, sie_pte, frac_mass_v, frac_ie_v,
                        frac_vol_v, vol_v, eos_v, pte_idxs, rho_pte, frac_bmod_v,
-                       frac_cv_v, frac_dpde_v, nmat, do_frac_bmod, do_frac_cv,
-                       do_frac_dpde);
+                       frac_cv_v, frac_dpde_v, cost_v, nmat, do_frac_bmod, do_frac_cv,
+                       do_frac_dpde, do_cost);
   // only initialize init functor when needed
   if (input_int_enum != input_condition::P_T_INPUT) {
     i_func = init_functor(frac_mass_v, pte_idxs, eos_offsets_v, frac_vol_v, frac_ie_v,
@@ -178,7 +237,7 @@ int get_sg_eos( // sizing information
     singularity::get_sg_eos_rho_t(rt_name.c_str(), ncell, offsets_v, eos_v, press_v,
                                   pmax_v, sie_v, frac_mass_v, pte_idxs, pte_mats,
                                   press_pte, vfrac_pte, rho_pte, sie_pte, temp_pte,
-                                  solver_scratch, tokens, small_loop, i_func, f_func);
+                                  solver_scratch, *tokens, small_loop, i_func, f_func);
     break;
   }
   case input_condition::RHO_P_INPUT: {
@@ -194,7 +253,7 @@ int get_sg_eos( // sizing information
     singularity::get_sg_eos_rho_p(rp_name.c_str(), ncell, offsets_v, eos_v, press_v,
                                   pmax_v, sie_v, frac_mass_v, pte_idxs, pte_mats,
                                   press_pte, vfrac_pte, rho_pte, sie_pte, temp_pte,
-                                  solver_scratch, tokens, small_loop, i_func, f_func);
+                                  solver_scratch, *tokens, small_loop, i_func, f_func);
     break;
   }
   case input_condition::P_T_INPUT: {
@@ -206,7 +265,7 @@ int get_sg_eos( // sizing information
     singularity::get_sg_eos_p_t(pt_name.c_str(), ncell, nmat, offsets_v, eos_offsets_v,
                                 eos_v, press_v, pmax_v, vol_v, spvol_v, sie_v, temp_v,
                                 frac_mass_v, pte_idxs, pte_mats, press_pte, vfrac_pte,
-                                rho_pte, sie_pte, temp_pte, solver_scratch, tokens,
+                                rho_pte, sie_pte, temp_pte, solver_scratch, *tokens,
                                 small_loop, f_func);
     break;
   }
@@ -215,14 +274,32 @@ int get_sg_eos( // sizing information
     // no break so fallthrough to case 1
   case input_condition::RHO_E_INPUT: {
     // rho-sie input
+    const std::string re_name = "PTE::solve (rho,e) input" + perf_nums;
+#ifdef SINGULARITY_GET_SG_EOS_TEAM_SCRATCH
+    singularity::get_sg_eos_rho_e(re_name.c_str(), ncell, nmat, offsets_v, eos_v, press_v,
+                                  pmax_v, sie_v, i_func, f_func);
+#else
     pte_solver_scratch_size = PTESolverRhoTRequiredScratch(nmat);
     solver_scratch = ScratchV<double>(VAWI("PTE::scratch solver"), scratch_size,
                                       pte_solver_scratch_size);
-    const std::string re_name = "PTE::solve (rho,e) input" + perf_nums;
     singularity::get_sg_eos_rho_e(re_name.c_str(), ncell, offsets_v, eos_v, press_v,
                                   pmax_v, sie_v, pte_idxs, press_pte, vfrac_pte, rho_pte,
-                                  sie_pte, temp_pte, solver_scratch, tokens, small_loop,
+                                  sie_pte, temp_pte, solver_scratch, *tokens, small_loop,
                                   i_func, f_func);
+#endif // SINGULARITY_GET_SG_EOS_TEAM_SCRATCH
+    break;
+  }
+  case input_condition::RHO_E_FIXED_SIE_INPUT: {
+    // rho-sie input with per-material sie
+    // equilibrate pressure only, holding the material energies fixed
+    pte_solver_scratch_size = PTESolverFixedSieRequiredScratch(nmat);
+    solver_scratch = ScratchV<double>(VAWI("PTE::scratch solver"), scratch_size,
+                                      pte_solver_scratch_size);
+    const std::string rs_name = "PTE::solve (rho,e) input fixed sie" + perf_nums;
+    singularity::get_sg_eos_rho_e_fixed_sie(
+        rs_name.c_str(), ncell, offsets_v, eos_v, press_v, pmax_v, frac_mass_v,
+        frac_ie_v, pte_idxs, pte_mats, press_pte, vfrac_pte, rho_pte, sie_pte, temp_pte,
+        solver_scratch, *tokens, small_loop, i_func, f_func);
     break;
   }
   }
@@ -273,6 +350,10 @@ int get_sg_eos( // sizing information
   if (do_frac_cv) {
     deep_copy(DES(), frac_cv_hv, frac_cv_v);
   }
+  // optionally copy-back the per cell cost
+  if (do_cost) {
+    deep_copy(DES(), cost_hv, cost_v);
+  }
 #endif // PORTABILITY_STRATEGY_KOKKOS
   return ret;
 }
@@ -102,6 +102,12 @@ void get_sg_eos_p_t(const char *name, int ncell, int nmat, indirection_v &offset
                     Kokkos::Experimental::UniqueToken<DES, KGlobal> &tokens,
                     bool small_loop, final_functor &f_func);
 // rho e input
+#ifdef SINGULARITY_GET_SG_EOS_TEAM_SCRATCH
+// all per-cell arrays live in team scratch
+void get_sg_eos_rho_e(const char *name, int ncell, int nmat, indirection_v &offsets_v,
+                      Kokkos::View<EOS *, Llft> &eos_v, dev_v &press_v, dev_v &pmax_v,
+                      dev_v &sie_v, init_functor &i_func, final_functor &f_func);
+#else
 void get_sg_eos_rho_e(const char *name, int ncell, indirection_v &offsets_v,
                       Kokkos::View<EOS *, Llft> &eos_v, dev_v &press_v, dev_v &pmax_v,
                       dev_v &sie_v, ScratchV<int> &pte_idxs, ScratchV<double> &press_pte,
@@ -110,6 +116,19 @@ void get_sg_eos_rho_e(const char *name, int ncell, indirection_v &offsets_v,
                       ScratchV<double> &solver_scratch,
                       Kokkos::Experimental::UniqueToken<DES, KGlobal> &tokens,
                       bool small_loop, init_functor &i_func, final_functor &f_func);
+#endif // SINGULARITY_GET_SG_EOS_TEAM_SCRATCH
+// rho e input, pressure equilibrium only with fixed material energies
+void get_sg_eos_rho_e_fixed_sie(const char *name, int ncell, indirection_v &offsets_v,
+                                Kokkos::View<EOS *, Llft> &eos_v, dev_v &press_v,
+                                dev_v &pmax_v, dev_frac_v &frac_mass_v,
+                                dev_frac_v &frac_ie_v, ScratchV<int> &pte_idxs,
+                                ScratchV<int> &pte_mats, ScratchV<double> &press_pte,
+                                ScratchV<double> &vfrac_pte, ScratchV<double> &rho_pte,
+                                ScratchV<double> &sie_pte, ScratchV<double> &temp_pte,
+                                ScratchV<double> &solver_scratch,
+                                Kokkos::Experimental::UniqueToken<DES, KGlobal> &tokens,
+                                bool small_loop, init_functor &i_func,
+                                final_functor &f_func);
 } // namespace singularity
 #endif // PORTABILITY_STRATEGY_KOKKOS
 
@@ -0,0 +1,87 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#include <chrono>
+#include <future>
+#include <mutex>
+
+#include <singularity-eos/eos/eos.hpp>
+#include <singularity-eos/eos/singularity_eos.hpp>
+
+// The handle returned by get_sg_eos_async. The work runs on a host
+// worker thread, which launches the same kernels and copies as
+// get_sg_eos.
+struct sg_eos_request {
+  std::future<int> result;
+};
+
+namespace {
+// Requests share the default Kokkos execution space and fence it, so
+// they run one at a time.
+std::mutex &async_request_mutex() {
+  static std::mutex m;
+  return m;
+}
+} // namespace
+
+int get_sg_eos_async( // sizing information
+    int nmat, int ncell, int cell_dim,
+    // Input parameters
+    int input_int,
+    // eos index offsets
+    int *eos_offsets,
+    // equation of state array
+    EOS *eos,
+    // index offsets
+    int *offsets,
+    // per cell quantities
+    double *press, double *pmax, double *vol, double *spvol, double *sie, double *temp,
+    double *bmod, double *dpde, double *cv,
+    // per material quantities
+    double *frac_mass, double *frac_vol, double *frac_ie,
+    // optional per material quantities
+    double *frac_bmod, double *frac_dpde, double *frac_cv,
+    // Mass fraction cutoff for PTE
+    double mass_frac_cutoff,
+    // optional per cell cost
+    double *cell_cost,
+    // handle to the request
+    sg_eos_request **request) {
+  auto req = new sg_eos_request;
+  // all arguments are pointers or values, so capture them by copy.
+  // The caller owns the buffers until the request completes.
+  req->result = std::async(std::launch::async, [=]() {
+    std::lock_guard<std::mutex> lock(async_request_mutex());
+    return get_sg_eos_with_cost(nmat, ncell, cell_dim, input_int, eos_offsets, eos,
+                                offsets, press, pmax, vol, spvol, sie, temp, bmod, dpde,
+                                cv, frac_mass, frac_vol, frac_ie, frac_bmod, frac_dpde,
+                                frac_cv, mass_frac_cutoff, cell_cost);
+  });
+  *request = req;
+  return 0;
+}
+
+int get_sg_eos_test(sg_eos_request *request) {
+  if (request == nullptr) return 1;
+  const auto status = request->result.wait_for(std::chrono::seconds(0));
+  return (status == std::future_status::ready) ? 1 : 0;
+}
+
+int get_sg_eos_wait(sg_eos_request *&request) {
+  if (request == nullptr) return 0;
+  const int ret = request->result.get();
+  delete request;
+  request = nullptr;
+  return ret;
+}
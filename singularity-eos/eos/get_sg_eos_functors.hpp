@@ -61,6 +61,27 @@ struct init_functor {
         press_v{press_v_}, sie_v{sie_v_}, nmat{nmat}, mass_frac_cutoff{
                                                           mass_frac_cutoff_} {}
 
+  // A copy of this functor that works on a different set of per-cell
+  // scratch arrays, e.g., arrays in Kokkos team scratch memory
+  PORTABLE_INLINE_FUNCTION
+  init_functor with_scratch(const ScratchV<int> &pte_idxs_,
+                            const ScratchV<int> &pte_mats_,
+                            const ScratchV<double> &vfrac_pte_,
+                            const ScratchV<double> &sie_pte_,
+                            const ScratchV<double> &temp_pte_,
+                            const ScratchV<double> &press_pte_,
+                            const ScratchV<double> &rho_pte_) const {
+    init_functor out(*this);
+    out.pte_idxs = pte_idxs_;
+    out.pte_mats = pte_mats_;
+    out.vfrac_pte = vfrac_pte_;
+    out.sie_pte = sie_pte_;
+    out.temp_pte = temp_pte_;
+    out.press_pte = press_pte_;
+    out.rho_pte = rho_pte_;
+    return out;
+  }
+
   PORTABLE_INLINE_FUNCTION
   void operator()(const int i, const int tid, double &mass_sum, int &npte,
                   const Real t_mult, const Real s_mult, const Real p_mult) const {
@@ -172,10 +193,12 @@ struct final_functor {
   dev_frac_v frac_bmod_v;
   dev_frac_v frac_cv_v;
   dev_frac_v frac_dpde_v;
+  dev_v cost_v;
   int nmat;
   bool do_frac_bmod;
   bool do_frac_cv;
   bool do_frac_dpde;
+  bool do_cost;
 
  public:
   final_functor(dev_v &spvol_v_, dev_v &temp_v_, dev_v &press_v_, dev_v &sie_v_,
@@ -186,16 +209,52 @@ struct final_functor {
                 dev_v &vol_v_, Kokkos::View<EOS *, Llft> &eos_v_,
                 ScratchV<int> &pte_idxs_, ScratchV<double> &rho_pte_,
                 dev_frac_v &frac_bmod_v_, dev_frac_v &frac_cv_v_,
-                dev_frac_v &frac_dpde_v_, int &nmat_, bool do_frac_bmod_,
-                bool do_frac_cv_, bool do_frac_dpde_)
+                dev_frac_v &frac_dpde_v_, dev_v &cost_v_, int &nmat_,
+                bool do_frac_bmod_, bool do_frac_cv_, bool do_frac_dpde_, bool do_cost_)
       : spvol_v{spvol_v_}, temp_v{temp_v_}, press_v{press_v_}, sie_v{sie_v_},
         bmod_v{bmod_v_}, cv_v{cv_v_}, dpde_v{dpde_v_}, pte_mats{pte_mats_},
         press_pte{press_pte_}, vfrac_pte{vfrac_pte_}, temp_pte{temp_pte_},
         sie_pte{sie_pte_}, frac_mass_v{frac_mass_v_}, frac_ie_v{frac_ie_v_},
         frac_vol_v{frac_vol_v_}, vol_v{vol_v_}, eos_v{eos_v_}, pte_idxs{pte_idxs_},
         rho_pte{rho_pte_}, frac_bmod_v{frac_bmod_v_}, frac_cv_v{frac_cv_v_},
-        frac_dpde_v{frac_dpde_v_}, nmat{nmat_}, do_frac_bmod{do_frac_bmod_},
-        do_frac_cv{do_frac_cv_}, do_frac_dpde{do_frac_dpde_} {}
+        frac_dpde_v{frac_dpde_v_}, cost_v{cost_v_}, nmat{nmat_},
+        do_frac_bmod{do_frac_bmod_}, do_frac_cv{do_frac_cv_},
+        do_frac_dpde{do_frac_dpde_}, do_cost{do_cost_} {}
+
+  // A copy of this functor that works on a different set of per-cell
+  // scratch arrays, e.g., arrays in Kokkos team scratch memory
+  PORTABLE_INLINE_FUNCTION
+  final_functor with_scratch(const ScratchV<int> &pte_idxs_,
+                             const ScratchV<int> &pte_mats_,
+                             const ScratchV<double> &vfrac_pte_,
+                             const ScratchV<double> &sie_pte_,
+                             const ScratchV<double> &temp_pte_,
+                             const ScratchV<double> &press_pte_,
+                             const ScratchV<double> &rho_pte_) const {
+    final_functor out(*this);
+    out.pte_idxs = pte_idxs_;
+    out.pte_mats = pte_mats_;
+    out.vfrac_pte = vfrac_pte_;
+    out.sie_pte = sie_pte_;
+    out.temp_pte = temp_pte_;
+    out.press_pte = press_pte_;
+    out.rho_pte = rho_pte_;
+    return out;
+  }
+
+  // Records the work done in cell i, if requested. The estimate is
+  // the number of material EOS evaluations. Sweeps over the npte
+  // materials are counted once for the initial state, twice per PTE
+  // iteration (Jacobian and full step), and once per line search
+  // backtrack. nroot adds single evaluations made by root finds in
+  // the cell. A pure cell without a root find costs 1.
+  PORTABLE_FORCEINLINE_FUNCTION
+  void record_cost(const int i, const int npte, const int niter, const int nbacktrack = 0,
+                   const int nroot = 0) const {
+    if (do_cost) {
+      cost_v(i) = static_cast<Real>(npte * (1 + 2 * niter + nbacktrack) + nroot);
+    }
+  }
 
  public:
   PORTABLE_INLINE_FUNCTION
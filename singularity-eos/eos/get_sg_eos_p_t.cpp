@@ -86,6 +86,8 @@ void get_sg_eos_p_t(const char *name, int ncell, int nmat, indirection_v &offset
         }
         // assign remaining outputs
         f_func(i, tid, nmat, mass_sum, 0.0, 0.0, 0.0, true, cache);
+        // report the work done in this cell, one P-T inversion per material
+        f_func.record_cost(i, nmat, 0);
         // assign max pressure
         pmax_v(i) = press_v(i) > pmax_v(i) ? press_v(i) : pmax_v(i);
         // release the token used for scratch arrays
@@ -12,6 +12,8 @@
 // publicly and display publicly, and to permit others to do so.
 //------------------------------------------------------------------------------
 
+#include <cstddef>
+
 #include <ports-of-call/portability.hpp>
 #include <singularity-eos/closure/mixed_cell_models.hpp>
 #include <singularity-eos/eos/eos.hpp>
@@ -19,6 +21,99 @@
 #include <singularity-eos/eos/get_sg_eos_functors.hpp>
 
 namespace singularity {
+#ifdef SINGULARITY_GET_SG_EOS_TEAM_SCRATCH
+void get_sg_eos_rho_e(const char *name, int ncell, int nmat, indirection_v &offsets_v,
+                      Kokkos::View<EOS *, Llft> &eos_v, dev_v &press_v, dev_v &pmax_v,
+                      dev_v &sie_v, init_functor &i_func, final_functor &f_func) {
+  // One cell per thread. All per-cell PTE working memory is carved out
+  // of Kokkos team scratch, so no unique token or global scratch is
+  // needed and the working set stays in fast memory where it fits.
+#if defined(KOKKOS_ENABLE_CUDA) || defined(KOKKOS_ENABLE_HIP)
+  constexpr int cells_per_team = 32;
+#else
+  constexpr int cells_per_team = 1;
+#endif
+  using policy_t = Kokkos::TeamPolicy<DES>;
+  using member_t = typename policy_t::member_type;
+  const int nsolver = PTESolverRhoTRequiredScratch(nmat);
+  // solver scratch plus rho, vfrac, sie, temp, press and two index arrays
+  const std::size_t real_bytes = (nsolver + 5 * nmat) * sizeof(double);
+  const std::size_t int_bytes = 2 * nmat * sizeof(int);
+  const std::size_t cell_bytes = real_bytes + int_bytes;
+  // use level 0 (shared memory on GPUs) when it fits, level 1 otherwise
+  const std::size_t max_level0 = policy_t::scratch_size_max(0);
+  const int level = (cells_per_team * cell_bytes <= max_level0) ? 0 : 1;
+  const int nteams = (ncell + cells_per_team - 1) / cells_per_team;
+  policy_t policy(nteams, cells_per_team);
+  policy.set_scratch_size(level, Kokkos::PerThread(cell_bytes));
+  Kokkos::parallel_for(
+      name, policy, KOKKOS_LAMBDA(const member_t &team) {
+        const int iloop = team.league_rank() * cells_per_team + team.team_rank();
+        if (iloop >= ncell) return;
+        // cell offset
+        const int i{offsets_v(iloop) - 1};
+        // each thread owns exactly one row of its scratch views
+        constexpr int tid{0};
+        double *rscr =
+            static_cast<double *>(team.thread_scratch(level).get_shmem(real_bytes));
+        int *iscr = static_cast<int *>(team.thread_scratch(level).get_shmem(int_bytes));
+        ScratchV<double> solver_tm(rscr, 1, nsolver);
+        ScratchV<double> rho_tm(rscr + nsolver, 1, nmat);
+        ScratchV<double> vfrac_tm(rscr + nsolver + nmat, 1, nmat);
+        ScratchV<double> sie_tm(rscr + nsolver + 2 * nmat, 1, nmat);
+        ScratchV<double> temp_tm(rscr + nsolver + 3 * nmat, 1, nmat);
+        ScratchV<double> press_tm(rscr + nsolver + 4 * nmat, 1, nmat);
+        ScratchV<int> idxs_tm(iscr, 1, nmat);
+        ScratchV<int> mats_tm(iscr + nmat, 1, nmat);
+        const init_functor i_team = i_func.with_scratch(
+            idxs_tm, mats_tm, vfrac_tm, sie_tm, temp_tm, press_tm, rho_tm);
+        const final_functor f_team = f_func.with_scratch(
+            idxs_tm, mats_tm, vfrac_tm, sie_tm, temp_tm, press_tm, rho_tm);
+        double mass_sum{0.0};
+        int npte{0};
+        // initialize values for solver / lookup
+        i_team(i, tid, mass_sum, npte, 0.0, 1.0, 0.0);
+        // need to initialize the scratch before it's used to avoid undefined behavior
+        for (int idx = 0; idx < nsolver; ++idx) {
+          solver_tm(tid, idx) = 0.0;
+        }
+        // get cache from offsets into scratch
+        const int neq = npte + 1;
+        singularity::mix_impl::CacheAccessor cache(&solver_tm(tid, 0) +
+                                                   neq * (neq + 4) + 2 * npte);
+        bool pte_converged = true;
+        int niter{0};
+        int nbacktrack{0};
+        if (npte > 1) {
+          singularity::EOSAccessor_ eos_inx(eos_v, &idxs_tm(tid, 0));
+          DispatchOnNmat(npte, [&](auto nmat_c) {
+            constexpr int NMAT = decltype(nmat_c)::value;
+            PTESolverRhoT<singularity::EOSAccessor_, Real *, Real **, NMAT> method(
+                npte, eos_inx, 1.0, sie_v(i), &rho_tm(tid, 0), &vfrac_tm(tid, 0),
+                &sie_tm(tid, 0), &temp_tm(tid, 0), &press_tm(tid, 0), cache,
+                &solver_tm(tid, 0));
+            pte_converged = PTESolver(method);
+            niter = method.Niter();
+            nbacktrack = method.Nbacktrack();
+          });
+        } else {
+          // pure cell (nmat = 1)
+          temp_tm(tid, 0) = eos_v(idxs_tm(tid, 0))
+                                .TemperatureFromDensityInternalEnergy(
+                                    rho_tm(tid, 0), sie_tm(tid, 0), cache[0]);
+          press_tm(tid, 0) = eos_v(idxs_tm(tid, 0))
+                                 .PressureFromDensityTemperature(
+                                     rho_tm(tid, 0), temp_tm(tid, 0), cache[0]);
+        }
+        // assign outputs
+        f_team(i, tid, npte, mass_sum, 1.0, 0.0, 1.0, pte_converged, cache);
+        // report the work done in this cell
+        f_team.record_cost(i, npte, niter, nbacktrack);
+        // assign max pressure
+        pmax_v(i) = press_v(i) > pmax_v(i) ? press_v(i) : pmax_v(i);
+      });
+}
+#else
 void get_sg_eos_rho_e(const char *name, int ncell, indirection_v &offsets_v,
                       Kokkos::View<EOS *, Llft> &eos_v, dev_v &press_v, dev_v &pmax_v,
                       dev_v &sie_v, ScratchV<int> &pte_idxs, ScratchV<double> &press_pte,
@@ -48,16 +143,23 @@ void get_sg_eos_rho_e(const char *name, int ncell, indirection_v &offsets_v,
         singularity::mix_impl::CacheAccessor cache(&solver_scratch(tid, 0) +
                                                    neq * (neq + 4) + 2 * npte);
         bool pte_converged = true;
+        int niter{0};
+        int nbacktrack{0};
         if (npte > 1) {
           // create solver lambda
           // eos accessor
           singularity::EOSAccessor_ eos_inx(eos_v, &pte_idxs(tid, 0));
           // reset inputs
-          PTESolverRhoT<singularity::EOSAccessor_, Real *, Real **> method(
-              npte, eos_inx, 1.0, sie_v(i), &rho_pte(tid, 0), &vfrac_pte(tid, 0),
-              &sie_pte(tid, 0), &temp_pte(tid, 0), &press_pte(tid, 0), cache,
-              &solver_scratch(tid, 0));
-          pte_converged = PTESolver(method);
+          DispatchOnNmat(npte, [&](auto nmat_c) {
+            constexpr int NMAT = decltype(nmat_c)::value;
+            PTESolverRhoT<singularity::EOSAccessor_, Real *, Real **, NMAT> method(
+                npte, eos_inx, 1.0, sie_v(i), &rho_pte(tid, 0), &vfrac_pte(tid, 0),
+                &sie_pte(tid, 0), &temp_pte(tid, 0), &press_pte(tid, 0), cache,
+                &solver_scratch(tid, 0));
+            pte_converged = PTESolver(method);
+            niter = method.Niter();
+            nbacktrack = method.Nbacktrack();
+          });
         } else {
           // pure cell (nmat = 1)
           temp_pte(tid, 0) = eos_v(pte_idxs(tid, 0))
@@ -69,6 +171,8 @@ void get_sg_eos_rho_e(const char *name, int ncell, indirection_v &offsets_v,
         }
         // assign outputs
         f_func(i, tid, npte, mass_sum, 1.0, 0.0, 1.0, pte_converged, cache);
+        // report the work done in this cell
+        f_func.record_cost(i, npte, niter, nbacktrack);
         // assign max pressure
         pmax_v(i) = press_v(i) > pmax_v(i) ? press_v(i) : pmax_v(i);
         // release the token used for scratch arrays
@@ -76,4 +180,5 @@ void get_sg_eos_rho_e(const char *name, int ncell, indirection_v &offsets_v,
       });
   return;
 }
+#endif // SINGULARITY_GET_SG_EOS_TEAM_SCRATCH
 } // namespace singularity
@@ -49,15 +49,24 @@ void get_sg_eos_rho_p(const char *name, int ncell, indirection_v &offsets_v,
         singularity::mix_impl::CacheAccessor cache(&solver_scratch(tid, 0) +
                                                    neq * (neq + 4) + 2 * npte);
         bool pte_converged = true;
+        int niter{0};
+        int nbacktrack{0};
+        // pressure evaluations made by the root find of a pure cell
+        int nroot{0};
         if (npte > 1) {
           // create solver lambda
           // eos accessor
           singularity::EOSAccessor_ eos_inx(eos_v, &pte_idxs(tid, 0));
-          PTESolverFixedP<singularity::EOSAccessor_, Real *, Real *> method(
-              npte, eos_inx, 1.0, press_pte(tid, 0), &rho_pte(tid, 0), &vfrac_pte(tid, 0),
-              &sie_pte(tid, 0), &temp_pte(tid, 0), &press_pte(tid, 0), cache[0],
-              &solver_scratch(tid, 0));
-          pte_converged = PTESolver(method);
+          DispatchOnNmat(npte, [&](auto nmat_c) {
+            constexpr int NMAT = decltype(nmat_c)::value;
+            PTESolverFixedP<singularity::EOSAccessor_, Real *, Real *, NMAT> method(
+                npte, eos_inx, 1.0, press_pte(tid, 0), &rho_pte(tid, 0),
+                &vfrac_pte(tid, 0), &sie_pte(tid, 0), &temp_pte(tid, 0),
+                &press_pte(tid, 0), cache[0], &solver_scratch(tid, 0));
+            pte_converged = PTESolver(method);
+            niter = method.Niter();
+            nbacktrack = method.Nbacktrack();
+          });
           // calculate total sie
           for (int mp = 0; mp < npte; ++mp) {
             const int m = pte_mats(tid, mp);
@@ -67,6 +76,7 @@ void get_sg_eos_rho_p(const char *name, int ncell, indirection_v &offsets_v,
           // pure cell (nmat = 1)
           // calculate sie from single eos
           auto p_from_t = [&](const Real &t_i) {
+            ++nroot;
             return eos_v(pte_idxs(tid, 0))
                 .PressureFromDensityTemperature(rho_pte(tid, 0), t_i, cache[0]);
           };
@@ -90,6 +100,8 @@ void get_sg_eos_rho_p(const char *name, int ncell, indirection_v &offsets_v,
         sie_v(i) = sie_tot_true;
         // assign remaining outputs
         f_func(i, tid, npte, mass_sum, 1.0, 0.0, 0.0, pte_converged, cache);
+        // report the work done in this cell
+        f_func.record_cost(i, npte, niter, nbacktrack, nroot);
         // assign max pressure
         pmax_v(i) = press_v(i) > pmax_v(i) ? press_v(i) : pmax_v(i);
         // release the token used for scratch arrays
@@ -50,15 +50,22 @@ void get_sg_eos_rho_t(const char *name, int ncell, indirection_v &offsets_v,
         singularity::mix_impl::CacheAccessor cache(&solver_scratch(tid, 0) +
                                                    neq * (neq + 4) + 2 * npte);
         bool pte_converged = true;
+        int niter{0};
+        int nbacktrack{0};
         if (npte > 1) {
           // create solver lambda
           // eos accessor
           singularity::EOSAccessor_ eos_inx(eos_v, &pte_idxs(tid, 0));
-          PTESolverFixedT<singularity::EOSAccessor_, Real *, Real **> method(
-              npte, eos_inx, 1.0, temp_pte(tid, 0), &rho_pte(tid, 0), &vfrac_pte(tid, 0),
-              &sie_pte(tid, 0), &temp_pte(tid, 0), &press_pte(tid, 0), cache,
-              &solver_scratch(tid, 0));
-          pte_converged = PTESolver(method);
+          DispatchOnNmat(npte, [&](auto nmat_c) {
+            constexpr int NMAT = decltype(nmat_c)::value;
+            PTESolverFixedT<singularity::EOSAccessor_, Real *, Real **, NMAT> method(
+                npte, eos_inx, 1.0, temp_pte(tid, 0), &rho_pte(tid, 0),
+                &vfrac_pte(tid, 0), &sie_pte(tid, 0), &temp_pte(tid, 0),
+                &press_pte(tid, 0), cache, &solver_scratch(tid, 0));
+            pte_converged = PTESolver(method);
+            niter = method.Niter();
+            nbacktrack = method.Nbacktrack();
+          });
           // calculate total internal energy
           for (int mp = 0; mp < npte; ++mp) {
             const int m = pte_mats(tid, mp);
@@ -81,6 +88,8 @@ void get_sg_eos_rho_t(const char *name, int ncell, indirection_v &offsets_v,
         sie_v(i) = sie_tot_true;
         // assign quantities
         f_func(i, tid, npte, mass_sum, 0.0, 0.0, 1.0, pte_converged, cache);
+        // report the work done in this cell
+        f_func.record_cost(i, npte, niter, nbacktrack);
         // assign max pressure
         pmax_v(i) = press_v(i) > pmax_v(i) ? press_v(i) : pmax_v(i);
         // release the token used for scratch arrays
@@ -26,6 +26,7 @@
 #include <ports-of-call/portability.hpp>
 #include <singularity-eos/base/constants.hpp>
 #include <singularity-eos/base/eos_error.hpp>
+#include <singularity-eos/base/table_transform.hpp>
 #include <singularity-eos/eos/eos_base.hpp>
 
 namespace singularity {
@@ -109,6 +110,9 @@ class UnitSystem : public EosBase<UnitSystem<T>> {
                          rho_unit_, sie_unit_, temp_unit_);
   }
   inline void Finalize() { t_.Finalize(); }
+  inline void SetAccuracy(const AccuracyParams &params) { t_.SetAccuracy(params); }
+  PORTABLE_INLINE_FUNCTION
+  AccuracyParams GetAccuracy() const { return t_.GetAccuracy(); }
 
   template <typename Indexer_t = Real *>
   PORTABLE_FUNCTION Real TemperatureFromDensityInternalEnergy(
@@ -260,6 +264,12 @@ class UnitSystem : public EosBase<UnitSystem<T>> {
   PORTABLE_FORCEINLINE_FUNCTION Real MinimumTemperature() const {
     return inv_temp_unit_ * t_.MinimumTemperature();
   }
+  PORTABLE_FORCEINLINE_FUNCTION Real MaximumDensity() const {
+    return inv_rho_unit_ * t_.MaximumDensity();
+  }
+  PORTABLE_FORCEINLINE_FUNCTION Real MaximumTemperature() const {
+    return inv_temp_unit_ * t_.MaximumTemperature();
+  }
 
   // vector implementations
   template <typename LambdaIndexer>
@@ -441,6 +451,18 @@ class UnitSystem : public EosBase<UnitSystem<T>> {
 
   inline constexpr T UnmodifyOnce() { return t_; }
 
+  // The map this modifier applies, so that a tabulated EOS can absorb
+  // it. See EOSBuilder::BakeModifiers.
+  inline TableTransform GetTableTransform() const {
+    TableTransform transform;
+    transform.rho = rho_unit_;
+    transform.temp = temp_unit_;
+    transform.sie = sie_unit_;
+    transform.press = inv_press_unit_;
+    transform.entropy = inv_entropy_unit_;
+    return transform;
+  }
+
   inline constexpr decltype(auto) GetUnmodifiedObject() {
     return t_.GetUnmodifiedObject();
   }
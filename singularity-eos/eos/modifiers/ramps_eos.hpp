@@ -101,6 +101,9 @@ class BilinearRampEOS : public EosBase<BilinearRampEOS<T>> {
 
   auto GetOnDevice() { return BilinearRampEOS<T>(t_.GetOnDevice(), r0_, a_, b_, c_); }
   inline void Finalize() { t_.Finalize(); }
+  inline void SetAccuracy(const AccuracyParams &params) { t_.SetAccuracy(params); }
+  PORTABLE_INLINE_FUNCTION
+  AccuracyParams GetAccuracy() const { return t_.GetAccuracy(); }
 
   PORTABLE_INLINE_FUNCTION
   Real get_ramp_pressure(Real rho) const {
@@ -77,6 +77,9 @@ class RelativisticEOS : public EosBase<RelativisticEOS<T>> {
 
   auto GetOnDevice() { return RelativisticEOS<T>(t_.GetOnDevice(), cl_); }
   inline void Finalize() { t_.Finalize(); }
+  inline void SetAccuracy(const AccuracyParams &params) { t_.SetAccuracy(params); }
+  PORTABLE_INLINE_FUNCTION
+  AccuracyParams GetAccuracy() const { return t_.GetAccuracy(); }
 
   template <typename Indexer_t = Real *>
   PORTABLE_FUNCTION Real TemperatureFromDensityInternalEnergy(
@@ -166,6 +169,12 @@ class RelativisticEOS : public EosBase<RelativisticEOS<T>> {
   PORTABLE_FORCEINLINE_FUNCTION Real MinimumTemperature() const {
     return t_.MinimumTemperature();
   }
+  PORTABLE_FORCEINLINE_FUNCTION Real MaximumDensity() const {
+    return t_.MaximumDensity();
+  }
+  PORTABLE_FORCEINLINE_FUNCTION Real MaximumTemperature() const {
+    return t_.MaximumTemperature();
+  }
 
   static constexpr unsigned long PreferredInput() { return T::PreferredInput(); }
 
@@ -74,6 +74,9 @@ class ScaledEOS : public EosBase<ScaledEOS<T>> {
 
   auto GetOnDevice() { return ScaledEOS<T>(t_.GetOnDevice(), scale_); }
   inline void Finalize() { t_.Finalize(); }
+  inline void SetAccuracy(const AccuracyParams &params) { t_.SetAccuracy(params); }
+  PORTABLE_INLINE_FUNCTION
+  AccuracyParams GetAccuracy() const { return t_.GetAccuracy(); }
 
   template <typename Indexer_t = Real *>
   PORTABLE_FUNCTION Real TemperatureFromDensityInternalEnergy(
@@ -352,6 +355,12 @@ class ScaledEOS : public EosBase<ScaledEOS<T>> {
   PORTABLE_FORCEINLINE_FUNCTION Real MinimumTemperature() const {
     return t_.MinimumTemperature();
   }
+  PORTABLE_FORCEINLINE_FUNCTION Real MaximumDensity() const {
+    return inv_scale_ * t_.MaximumDensity();
+  }
+  PORTABLE_FORCEINLINE_FUNCTION Real MaximumTemperature() const {
+    return t_.MaximumTemperature();
+  }
 
   inline constexpr bool IsModified() const { return true; }
 
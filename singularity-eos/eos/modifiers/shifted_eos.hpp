@@ -26,6 +26,7 @@
 #include <ports-of-call/portability.hpp>
 #include <singularity-eos/base/constants.hpp>
 #include <singularity-eos/base/eos_error.hpp>
+#include <singularity-eos/base/table_transform.hpp>
 #include <singularity-eos/eos/eos_base.hpp>
 
 namespace singularity {
@@ -57,6 +58,8 @@ class ShiftedEOS : public EosBase<ShiftedEOS<T>> {
   using EosBase<ShiftedEOS<T>>::GruneisenParamFromDensityTemperature;
   using EosBase<ShiftedEOS<T>>::GruneisenParamFromDensityInternalEnergy;
   using EosBase<ShiftedEOS<T>>::FillEos;
+  using EosBase<ShiftedEOS<T>>::DerivativesFromDensityTemperature;
+  using EosBase<ShiftedEOS<T>>::DerivativesFromDensityInternalEnergy;
 
   using BaseType = T;
 
@@ -73,6 +76,9 @@ class ShiftedEOS : public EosBase<ShiftedEOS<T>> {
 
   auto GetOnDevice() { return ShiftedEOS<T>(t_.GetOnDevice(), shift_); }
   inline void Finalize() { t_.Finalize(); }
+  inline void SetAccuracy(const AccuracyParams &params) { t_.SetAccuracy(params); }
+  PORTABLE_INLINE_FUNCTION
+  AccuracyParams GetAccuracy() const { return t_.GetAccuracy(); }
 
   template <typename Indexer_t = Real *>
   PORTABLE_FUNCTION Real TemperatureFromDensityInternalEnergy(
@@ -115,6 +121,17 @@ class ShiftedEOS : public EosBase<ShiftedEOS<T>> {
       const Real rho, const Real sie, Indexer_t &&lambda = nullptr) const {
     return t_.GruneisenParamFromDensityInternalEnergy(rho, sie - shift_, lambda);
   }
+  // The shift leaves every derivative unchanged
+  template <typename Indexer_t = Real *>
+  PORTABLE_FUNCTION ThermoDerivatives DerivativesFromDensityTemperature(
+      const Real rho, const Real temperature, Indexer_t &&lambda = nullptr) const {
+    return t_.DerivativesFromDensityTemperature(rho, temperature, lambda);
+  }
+  template <typename Indexer_t = Real *>
+  PORTABLE_FUNCTION ThermoDerivatives DerivativesFromDensityInternalEnergy(
+      const Real rho, const Real sie, Indexer_t &&lambda = nullptr) const {
+    return t_.DerivativesFromDensityInternalEnergy(rho, sie - shift_, lambda);
+  }
   template <typename Indexer_t = Real *>
   PORTABLE_FUNCTION Real PressureFromDensityTemperature(
       const Real rho, const Real temperature, Indexer_t &&lambda = nullptr) const {
@@ -365,11 +382,25 @@ class ShiftedEOS : public EosBase<ShiftedEOS<T>> {
   PORTABLE_FORCEINLINE_FUNCTION Real MinimumTemperature() const {
     return t_.MinimumTemperature();
   }
+  PORTABLE_FORCEINLINE_FUNCTION Real MaximumDensity() const {
+    return t_.MaximumDensity();
+  }
+  PORTABLE_FORCEINLINE_FUNCTION Real MaximumTemperature() const {
+    return t_.MaximumTemperature();
+  }
 
   inline constexpr bool IsModified() const { return true; }
 
   inline constexpr T UnmodifyOnce() { return t_; }
 
+  // The map this modifier applies, so that a tabulated EOS can absorb
+  // it. See EOSBuilder::BakeModifiers.
+  inline TableTransform GetTableTransform() const {
+    TableTransform transform;
+    transform.sie_shift = -shift_;
+    return transform;
+  }
+
   inline constexpr decltype(auto) GetUnmodifiedObject() {
     return t_.GetUnmodifiedObject();
   }
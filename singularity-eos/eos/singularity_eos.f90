@@ -58,6 +58,9 @@ module singularity_eos
     get_sg_MinInternalEnergyFromDensity_f,&
     get_sg_BulkModulusFromDensityInternalEnergy_f,&
     get_sg_eos_f,&
+    get_sg_eos_async_f,&
+    get_sg_eos_test_f,&
+    get_sg_eos_wait_f,&
     finalize_sg_eos_f
 
 ! interface functions
@@ -330,6 +333,109 @@ module singularity_eos
     end function get_sg_eos
   end interface
 
+  interface
+    integer(kind=c_int) function &
+      get_sg_eos_with_cost(nmat, ncell, cell_dim,&
+                           option,&
+                           eos_offsets,&
+                           eos,&
+                           offsets,&
+                           press, pmax, vol, spvol, sie, temp, bmod, dpde, cv,&
+                           frac_mass, frac_vol, frac_sie,&
+                           frac_bmod, frac_dpde, frac_cv,&
+                           mass_frac_cutoff, cell_cost)&
+      bind(C, name='get_sg_eos_with_cost')
+      import
+      integer(kind=c_int), value, intent(in) :: nmat
+      integer(kind=c_int), value, intent(in) :: ncell
+      integer(kind=c_int), value, intent(in) :: cell_dim
+      integer(kind=c_int), value, intent(in) :: option
+      type(c_ptr), value, intent(in) :: eos_offsets
+      ! better eos ptrs
+      type(c_ptr), value, intent(in) :: eos
+      ! other inputs
+      type(c_ptr), value, intent(in) :: offsets
+      type(c_ptr), value, intent(in) :: press
+      type(c_ptr), value, intent(in) :: pmax
+      type(c_ptr), value, intent(in) :: vol
+      type(c_ptr), value, intent(in) :: spvol
+      type(c_ptr), value, intent(in) :: sie
+      type(c_ptr), value, intent(in) :: temp
+      type(c_ptr), value, intent(in) :: bmod
+      type(c_ptr), value, intent(in) :: dpde
+      type(c_ptr), value, intent(in) :: cv
+      type(c_ptr), value, intent(in) :: frac_mass
+      type(c_ptr), value, intent(in) :: frac_vol
+      type(c_ptr), value, intent(in) :: frac_sie
+      type(c_ptr), value, intent(in) :: frac_bmod
+      type(c_ptr), value, intent(in) :: frac_dpde
+      type(c_ptr), value, intent(in) :: frac_cv
+      real(kind=c_double), value, intent(in) :: mass_frac_cutoff
+      type(c_ptr), value, intent(in) :: cell_cost
+    end function get_sg_eos_with_cost
+  end interface
+
+  interface
+    integer(kind=c_int) function &
+      get_sg_eos_async(nmat, ncell, cell_dim,&
+                       option,&
+                       eos_offsets,&
+                       eos,&
+                       offsets,&
+                       press, pmax, vol, spvol, sie, temp, bmod, dpde, cv,&
+                       frac_mass, frac_vol, frac_sie,&
+                       frac_bmod, frac_dpde, frac_cv,&
+                       mass_frac_cutoff, cell_cost, request)&
+      bind(C, name='get_sg_eos_async')
+      import
+      integer(kind=c_int), value, intent(in) :: nmat
+      integer(kind=c_int), value, intent(in) :: ncell
+      integer(kind=c_int), value, intent(in) :: cell_dim
+      integer(kind=c_int), value, intent(in) :: option
+      type(c_ptr), value, intent(in) :: eos_offsets
+      ! better eos ptrs
+      type(c_ptr), value, intent(in) :: eos
+      ! other inputs
+      type(c_ptr), value, intent(in) :: offsets
+      type(c_ptr), value, intent(in) :: press
+      type(c_ptr), value, intent(in) :: pmax
+      type(c_ptr), value, intent(in) :: vol
+      type(c_ptr), value, intent(in) :: spvol
+      type(c_ptr), value, intent(in) :: sie
+      type(c_ptr), value, intent(in) :: temp
+      type(c_ptr), value, intent(in) :: bmod
+      type(c_ptr), value, intent(in) :: dpde
+      type(c_ptr), value, intent(in) :: cv
+      type(c_ptr), value, intent(in) :: frac_mass
+      type(c_ptr), value, intent(in) :: frac_vol
+      type(c_ptr), value, intent(in) :: frac_sie
+      type(c_ptr), value, intent(in) :: frac_bmod
+      type(c_ptr), value, intent(in) :: frac_dpde
+      type(c_ptr), value, intent(in) :: frac_cv
+      real(kind=c_double), value, intent(in) :: mass_frac_cutoff
+      type(c_ptr), value, intent(in) :: cell_cost
+      type(c_ptr), intent(out) :: request
+    end function get_sg_eos_async
+  end interface
+
+  interface
+    integer(kind=c_int) function &
+      get_sg_eos_test(request) &
+      bind(C, name='get_sg_eos_test')
+      import
+      type(c_ptr), value, intent(in) :: request
+    end function get_sg_eos_test
+  end interface
+
+  interface
+    integer(kind=c_int) function &
+      get_sg_eos_wait(request) &
+      bind(C, name='get_sg_eos_wait')
+      import
+      type(c_ptr), intent(inout) :: request
+    end function get_sg_eos_wait
+  end interface
+
   interface
     integer(kind=c_int) function &
       finalize_sg_eos(nmat, eos, own_kokkos) &
@@ -353,7 +459,7 @@ contains
                                 dpde, cv,&
                                 frac_mass, frac_vol, frac_sie,&
                                 frac_bmod, frac_dpde, frac_cv,&
-                                mass_frac_cutoff) &
+                                mass_frac_cutoff, cell_cost) &
     result(err)
     integer(kind=c_int), intent(in) :: nmat
     integer(kind=c_int), intent(in) :: ncell
@@ -379,15 +485,17 @@ contains
     real(kind=8), dimension(:,:), target, optional, intent(inout) :: frac_dpde
     real(kind=8), dimension(:,:), target, optional, intent(inout) :: frac_cv
     real(kind=8),                         optional, intent(in)    :: mass_frac_cutoff
+    real(kind=8), dimension(:),   target, optional, intent(inout) :: cell_cost
 
     ! pointers
-    type(c_ptr) :: bmod_ptr, dpde_ptr, cv_ptr
+    type(c_ptr) :: bmod_ptr, dpde_ptr, cv_ptr, cost_ptr
 
     real(kind=c_double) :: mass_frac_cutoff_used
 
     bmod_ptr = C_NULL_PTR
     dpde_ptr = C_NULL_PTR
     cv_ptr = C_NULL_PTR
+    cost_ptr = C_NULL_PTR
     if(present(frac_bmod)) then
       bmod_ptr = c_loc(frac_bmod)
     endif
@@ -397,18 +505,23 @@ contains
     if(present(frac_cv)) then
       cv_ptr = c_loc(frac_cv)
     endif
+    if(present(cell_cost)) then
+      cost_ptr = c_loc(cell_cost)
+    endif
     if(present(mass_frac_cutoff)) then
       mass_frac_cutoff_used = mass_frac_cutoff
     else
       mass_frac_cutoff_used = 1.0d-12
     endif
 
-    err = get_sg_eos(nmat, ncell, cell_dim, option, c_loc(eos_offsets),&
-                     eos%ptr, c_loc(offsets), c_loc(press), c_loc(pmax),&
-                     c_loc(vol), c_loc(spvol), c_loc(sie), c_loc(temp),&
-                     c_loc(bmod), c_loc(dpde),c_loc(cv), c_loc(frac_mass),&
-                     c_loc(frac_vol),c_loc(frac_sie), bmod_ptr, dpde_ptr,&
-                     cv_ptr, mass_frac_cutoff_used)
+    err = get_sg_eos_with_cost(nmat, ncell, cell_dim, option,&
+                               c_loc(eos_offsets), eos%ptr, c_loc(offsets),&
+                               c_loc(press), c_loc(pmax), c_loc(vol),&
+                               c_loc(spvol), c_loc(sie), c_loc(temp),&
+                               c_loc(bmod), c_loc(dpde),c_loc(cv),&
+                               c_loc(frac_mass), c_loc(frac_vol),&
+                               c_loc(frac_sie), bmod_ptr, dpde_ptr, cv_ptr,&
+                               mass_frac_cutoff_used, cost_ptr)
   end function get_sg_eos_f
 
   integer function init_sg_eos_f(nmat, eos) &
@@ -752,6 +865,97 @@ contains
        eos%ptr, c_loc(rhos(1,1,1)), c_loc(sies(1,1,1)), c_loc(bmods(1,1,1)), len)
   end function get_sg_BulkModulusFromDensityInternalEnergy_f
   
+  ! As get_sg_eos_f, but returns immediately with a handle in
+  ! request. All arrays must stay allocated and untouched until
+  ! get_sg_eos_wait_f returns, so they must be contiguous, or the
+  ! compiler may pass temporaries.
+  integer function get_sg_eos_async_f(request, nmat, ncell, cell_dim,&
+                                      option,&
+                                      eos_offsets,&
+                                      eos,&
+                                      offsets,&
+                                      press, pmax, vol, spvol, sie, temp,&
+                                      bmod, dpde, cv,&
+                                      frac_mass, frac_vol, frac_sie,&
+                                      frac_bmod, frac_dpde, frac_cv,&
+                                      mass_frac_cutoff, cell_cost) &
+    result(err)
+    type(c_ptr), intent(out)        :: request
+    integer(kind=c_int), intent(in) :: nmat
+    integer(kind=c_int), intent(in) :: ncell
+    integer(kind=c_int), intent(in) :: cell_dim
+    integer(kind=c_int), intent(in) :: option
+    integer(kind=c_int), dimension(:), target, intent(in) :: eos_offsets
+    type(sg_eos_ary_t), intent(in)  :: eos
+    integer(kind=c_int), dimension(:), target, intent(in) :: offsets
+    real(kind=8), dimension(:),   target, intent(in)    :: press
+    real(kind=8), dimension(:),   target, intent(in)    :: pmax
+    real(kind=8), dimension(:),   target, intent(in)    :: vol
+    real(kind=8), dimension(:),   target, intent(in)    :: spvol
+    real(kind=8), dimension(:),   target, intent(in)    :: sie
+    real(kind=8), dimension(:),   target, intent(in)    :: temp
+    real(kind=8), dimension(:),   target, intent(in)    :: bmod
+    real(kind=8), dimension(:),   target, intent(in)    :: dpde
+    real(kind=8), dimension(:),   target, intent(in)    :: cv
+    real(kind=8), dimension(:,:), target, intent(in) :: frac_mass
+    real(kind=8), dimension(:,:), target, intent(inout) :: frac_vol
+    real(kind=8), dimension(:,:), target, intent(inout) :: frac_sie
+    ! optionals
+    real(kind=8), dimension(:,:), target, optional, intent(inout) :: frac_bmod
+    real(kind=8), dimension(:,:), target, optional, intent(inout) :: frac_dpde
+    real(kind=8), dimension(:,:), target, optional, intent(inout) :: frac_cv
+    real(kind=8),                         optional, intent(in)    :: mass_frac_cutoff
+    real(kind=8), dimension(:),   target, optional, intent(inout) :: cell_cost
+
+    ! pointers
+    type(c_ptr) :: bmod_ptr, dpde_ptr, cv_ptr, cost_ptr
+
+    real(kind=c_double) :: mass_frac_cutoff_used
+
+    bmod_ptr = C_NULL_PTR
+    dpde_ptr = C_NULL_PTR
+    cv_ptr = C_NULL_PTR
+    cost_ptr = C_NULL_PTR
+    if(present(frac_bmod)) then
+      bmod_ptr = c_loc(frac_bmod)
+    endif
+    if(present(frac_dpde)) then
+      dpde_ptr = c_loc(frac_dpde)
+    endif
+    if(present(frac_cv)) then
+      cv_ptr = c_loc(frac_cv)
+    endif
+    if(present(cell_cost)) then
+      cost_ptr = c_loc(cell_cost)
+    endif
+    if(present(mass_frac_cutoff)) then
+      mass_frac_cutoff_used = mass_frac_cutoff
+    else
+      mass_frac_cutoff_used = 1.0d-12
+    endif
+
+    err = get_sg_eos_async(nmat, ncell, cell_dim, option,&
+                           c_loc(eos_offsets), eos%ptr, c_loc(offsets),&
+                           c_loc(press), c_loc(pmax), c_loc(vol),&
+                           c_loc(spvol), c_loc(sie), c_loc(temp),&
+                           c_loc(bmod), c_loc(dpde),c_loc(cv),&
+                           c_loc(frac_mass), c_loc(frac_vol),&
+                           c_loc(frac_sie), bmod_ptr, dpde_ptr, cv_ptr,&
+                           mass_frac_cutoff_used, cost_ptr, request)
+  end function get_sg_eos_async_f
+
+  integer function get_sg_eos_test_f(request) &
+    result(done)
+    type(c_ptr), intent(in) :: request
+    done = get_sg_eos_test(request)
+  end function get_sg_eos_test_f
+
+  integer function get_sg_eos_wait_f(request) &
+    result(err)
+    type(c_ptr), intent(inout) :: request
+    err = get_sg_eos_wait(request)
+  end function get_sg_eos_wait_f
+
   integer function finalize_sg_eos_f(nmat, eos) &
     result(err)
     integer(c_int), value, intent(in) :: nmat
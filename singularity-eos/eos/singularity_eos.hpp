@@ -120,6 +120,66 @@ int get_sg_eos( // sizing information
     // Mass fraction cutoff for PTE
     double mass_frac_cutoff);
 
+// As get_sg_eos. If cell_cost is not null, it is filled with an
+// estimate of the work done in each cell.
+int get_sg_eos_with_cost( // sizing information
+    int nmat, int ncell, int cell_dim,
+    // Input parameters
+    int input_int,
+    // eos index offsets
+    int *eos_offsets,
+    // equation of state array
+    EOS *eos,
+    // index offsets
+    int *offsets,
+    // per cell quantities
+    double *press, double *pmax, double *vol, double *spvol, double *sie, double *temp,
+    double *bmod, double *dpde, double *cv,
+    // per material quantities
+    double *frac_mass, double *frac_vol, double *frac_ie,
+    // optional per material quantities
+    double *frac_bmod, double *frac_dpde, double *frac_cv,
+    // Mass fraction cutoff for PTE
+    double mass_frac_cutoff,
+    // optional per cell cost
+    double *cell_cost);
+
+// Asynchronous get_sg_eos_with_cost. Enqueues the work and returns
+// immediately with a request handle. The caller must not touch any of
+// the buffers passed in until the request completes.
+struct sg_eos_request;
+
+int get_sg_eos_async( // sizing information
+    int nmat, int ncell, int cell_dim,
+    // Input parameters
+    int input_int,
+    // eos index offsets
+    int *eos_offsets,
+    // equation of state array
+    EOS *eos,
+    // index offsets
+    int *offsets,
+    // per cell quantities
+    double *press, double *pmax, double *vol, double *spvol, double *sie, double *temp,
+    double *bmod, double *dpde, double *cv,
+    // per material quantities
+    double *frac_mass, double *frac_vol, double *frac_ie,
+    // optional per material quantities
+    double *frac_bmod, double *frac_dpde, double *frac_cv,
+    // Mass fraction cutoff for PTE
+    double mass_frac_cutoff,
+    // optional per cell cost
+    double *cell_cost,
+    // handle to the request
+    sg_eos_request **request);
+
+// Returns 1 if the request has completed and 0 otherwise. Does not block.
+int get_sg_eos_test(sg_eos_request *request);
+
+// Blocks until the request completes, frees it, and returns the
+// result get_sg_eos would have returned.
+int get_sg_eos_wait(sg_eos_request *&request);
+
 int finalize_sg_eos(const int nmat, EOS *&eos, const int own_kokkos = 0);
 
 #if defined(__cplusplus)
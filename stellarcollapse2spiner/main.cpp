@@ -15,26 +15,108 @@
 // publicly and display publicly, and to permit others to do so.
 //======================================================================
 
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include <singularity-eos/eos/eos.hpp>
 
 using singularity::StellarCollapse;
 
+// Reads the integer value of the option at argv[i] into value. Returns
+// false if the value is missing, not an integer, or outside [lo, hi].
+static bool parseIntOption(int argc, char *argv[], int &i, int lo, int hi, int &value) {
+  if (i + 1 >= argc) return false;
+  const char *arg = argv[++i];
+  char *end;
+  const long v = std::strtol(arg, &end, 10);
+  if (end == arg || *end != '\0' || v < lo || v > hi) return false;
+  value = static_cast<int>(v);
+  return true;
+}
+
+// Reads the floating point value of the option at argv[i] into value.
+// Returns false if the value is missing or not a number.
+static bool parseRealOption(int argc, char *argv[], int &i, Real &value) {
+  if (i + 1 >= argc) return false;
+  const char *arg = argv[++i];
+  char *end;
+  const double v = std::strtod(arg, &end);
+  if (end == arg || *end != '\0') return false;
+  value = static_cast<Real>(v);
+  return true;
+}
+
 int main(int argc, char *argv[]) {
-  if (argc < 3) {
+  SP5::Compression::Options compression;
+  // derivative fields, rounded with -l unless -f says otherwise
+  std::vector<std::string> lossyFields = {"dpdrhoe", "dpderho", "dedt"};
+  Real YeMin = -1;
+  Real YeMax = -1;
+  std::vector<std::string> positional;
+  bool good = true;
+  for (int i = 1; i < argc; ++i) {
+    const bool has_value = (i + 1 < argc);
+    if (!std::strcmp(argv[i], "-z")) {
+      good = parseIntOption(argc, argv, i, 1, 9, compression.level) && good;
+    } else if (!std::strcmp(argv[i], "-l")) {
+      good = parseIntOption(argc, argv, i, 1, 51, compression.lossyBits) && good;
+    } else if (!std::strcmp(argv[i], "-f") && has_value) {
+      lossyFields.clear();
+      std::stringstream fields(argv[++i]);
+      std::string field;
+      while (std::getline(fields, field, ',')) {
+        if (!field.empty()) lossyFields.push_back(field);
+      }
+    } else if (!std::strcmp(argv[i], "-y")) {
+      good = parseRealOption(argc, argv, i, YeMin) && good;
+    } else if (!std::strcmp(argv[i], "-Y")) {
+      good = parseRealOption(argc, argv, i, YeMax) && good;
+    } else if (argv[i][0] == '-') {
+      good = false;
+    } else {
+      positional.push_back(argv[i]);
+    }
+  }
+  if (!good || positional.size() != 2) {
     std::cout << "Converts a Stellar Collapse EOS file into an SP5 file.\n"
               << "Performs relevant data cleanup for use in fluid codes.\n"
               << "Usage:\n"
-              << argv[0] << " input_filename ouutput_filename" << std::endl;
+              << argv[0] << " [options] input_filename output_filename\n"
+              << "\t-z level: compress datasets with this deflate level in [1, 9]\n"
+              << "\t-l bits: mantissa bits to keep in derivative fields,\n"
+              << "\t   in [1, 51]\n"
+              << "\t-f fields: comma separated fields to round with -l\n"
+              << "\t   (default dpdrhoe,dpderho,dedt)\n"
+              << "\t-y Ye: lowest electron fraction to keep\n"
+              << "\t-Y Ye: highest electron fraction to keep\n"
+              << "\tIf both -y and -Y are given and equal, the tables are\n"
+              << "\treduced to 2D slices at that electron fraction.\n"
+              << std::endl;
     return 1;
   }
 
-  const std::string input_name = argv[1];
-  const std::string output_name = argv[2];
-  StellarCollapse eos(input_name, false, true);
-  eos.Save(output_name);
+  compression.lossyFields = lossyFields;
+
+  const std::string input_name = positional[0];
+  const std::string output_name = positional[1];
+  if (YeMin < 0 && YeMax < 0) {
+    StellarCollapse eos(input_name, false, true);
+    eos.Save(output_name, compression);
+  } else {
+    // Fill in an unspecified bound from the full table
+    if (YeMin < 0 || YeMax < 0) {
+      StellarCollapse bounds(input_name, false, false);
+      if (YeMin < 0) YeMin = bounds.YeMin();
+      if (YeMax < 0) YeMax = bounds.YeMax();
+      bounds.Finalize();
+    }
+    StellarCollapse eos(input_name, false, true, YeMin, YeMax);
+    eos.Save(output_name, compression);
+  }
 
   return 0;
 }
@@ -143,6 +143,33 @@ inline void compare_two_eoss(const E1 &test_e, const E2 &ref_e) {
   return;
 }
 
+// SIMD packs for the models whose scalar calls are templated on the
+// value type. Only tested with std::experimental::simd on host.
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<experimental/simd>) && !defined(PORTABILITY_STRATEGY_KOKKOS)
+#include <experimental/simd>
+#define SINGULARITY_TEST_SIMD_PACKS
+using simd_pack_t = std::experimental::native_simd<Real>;
+
+// Checks that f(rho, x) called on packs agrees with f called on each lane
+template <typename F>
+inline void CheckPackLanes(F &&f, const simd_pack_t &rho, const simd_pack_t &x,
+                           const Real tol = 1e-14) {
+  const simd_pack_t out = f(rho, x);
+  for (std::size_t i = 0; i < simd_pack_t::size(); ++i) {
+    const Real r = rho[i];
+    const Real xi = x[i];
+    const Real expected = f(r, xi);
+    INFO("lane: " << i << " rho: " << r << " x: " << xi << " pack: " << out[i]
+                  << " scalar: " << expected);
+    CHECK(isClose(out[i], expected, tol));
+  }
+}
+#define CHECK_PACK_LANES(eos, func, rho, x)                                           \
+  CheckPackLanes([&](auto r_, auto x_) { return (eos).func(r_, x_); }, rho, x)
+#endif
+#endif // SIMD packs
+
 // Macro that checks for an exception or is a no-op depending on
 // whether or not a non-serial backend is supplied
 #ifdef PORTABILITY_STRATEGY_NONE
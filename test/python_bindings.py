@@ -744,5 +744,85 @@ class AluminumGruneisenEOS_SoundSpeedAndPressureComp(unittest.TestCase, EOSTestB
         pres = self.eos.PressureFromDensityInternalEnergy(density, energy)
         self.assertIsClose(pres, true_pres, 1e-12)
 
+@unittest.skipIf('closure' not in dir(singularity_eos), "No mixed cell closure support")
+class PTE_IdealGases(unittest.TestCase, EOSTestBase):
+    "[PTE][Python]"
+
+    def setUp(self):
+        from singularity_eos import IdealGas
+        self.eos = [IdealGas(0.4, 1.0), IdealGas(2. / 3., 2.0)]
+        self.ncell = 64
+        # the second slot is empty in the first cell, which is then pure
+        self.matids = np.tile(np.array([0, 1]), (self.ncell, 1))
+        self.matids[0, 1] = -1
+        self.rho = np.tile(np.array([1.0, 2.0]), (self.ncell, 1))
+        self.vfrac = np.full((self.ncell, 2), 0.5)
+        self.sie = np.tile(np.array([1.0, 2.5]), (self.ncell, 1))
+        self.sie[:, 1] += np.linspace(0, 1, self.ncell)
+
+    def check_equilibrium(self, result):
+        self.assertTrue(np.all(result["converged"]))
+        press = result["pressure"][1:]
+        assert_allclose(press[:, 0], press[:, 1], rtol=1e-5)
+        vfrac = result["volume_fraction"][1:]
+        assert_allclose(vfrac.sum(axis=1), 1.0, rtol=1e-10)
+        # mass in each material is conserved
+        assert_allclose(result["density"] * result["volume_fraction"],
+                        np.where(self.matids >= 0, self.rho * self.vfrac, 0.0), rtol=1e-10)
+
+    def test_rho_t(self):
+        "A batch of cells is brought into pressure-temperature equilibrium"
+        from singularity_eos.closure import PTESolverRhoT
+        result = PTESolverRhoT(self.eos, self.matids, self.rho, self.vfrac, self.sie, nthreads=4)
+        self.check_equilibrium(result)
+        temp = result["temperature"][1:]
+        assert_allclose(temp[:, 0], temp[:, 1], rtol=1e-3)
+        # total energy is conserved
+        mass = self.rho * self.vfrac
+        sie_tot = (mass * self.sie).sum(axis=1) / mass.sum(axis=1)
+        assert_allclose(result["cell_specific_internal_energy"][1:], sie_tot[1:], rtol=1e-8)
+        # the pure cell is just a lookup
+        self.assertEqual(result["iterations"][0], 0)
+        self.assertIsClose(result["cell_temperature"][0],
+                           self.eos[0].TemperatureFromDensityInternalEnergy(1.0, 1.0), 1e-12)
+
+    def test_rho_u(self):
+        "The density-energy solver agrees with the density-temperature solver"
+        from singularity_eos.closure import PTESolverRhoT, PTESolverRhoU
+        rho_t = PTESolverRhoT(self.eos, self.matids, self.rho, self.vfrac, self.sie)
+        rho_u = PTESolverRhoU(self.eos, self.matids, self.rho, self.vfrac, self.sie)
+        self.check_equilibrium(rho_u)
+        assert_allclose(rho_u["cell_pressure"], rho_t["cell_pressure"], rtol=1e-4)
+
+    def test_fixed_t(self):
+        "Cells are equilibrated at a given temperature"
+        from singularity_eos.closure import PTESolverFixedT
+        temperature = np.linspace(1.0, 2.0, self.ncell)
+        result = PTESolverFixedT(self.eos, self.matids, self.rho, self.vfrac, temperature)
+        self.check_equilibrium(result)
+        assert_allclose(result["cell_temperature"], temperature, rtol=1e-12)
+
+    def test_bad_matid(self):
+        "Material ids outside the list of EOS are rejected"
+        from singularity_eos.closure import PTESolverRhoT
+        self.matids[3, 1] = 2
+        with self.assertRaises(ValueError):
+            PTESolverRhoT(self.eos, self.matids, self.rho, self.vfrac, self.sie)
+
+    def test_lambdas(self):
+        "Per-slot lambdas are passed through and returned"
+        from singularity_eos.closure import PTESolverRhoT
+        lambdas = np.full((self.ncell, 2, 1), 3.0)
+        result = PTESolverRhoT(self.eos, self.matids, self.rho, self.vfrac, self.sie,
+                               lambdas=lambdas)
+        self.check_equilibrium(result)
+        # ideal gases don't use the lambdas, so they come back unchanged
+        assert_allclose(result["lambdas"], lambdas)
+        self.assertNotIn("lambdas", PTESolverRhoT(self.eos, self.matids, self.rho,
+                                                  self.vfrac, self.sie))
+        with self.assertRaises(ValueError):
+            PTESolverRhoT(self.eos, self.matids, self.rho, self.vfrac, self.sie,
+                          lambdas=lambdas[1:])
+
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,81 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+/*
+  Replays a trace recorded with SINGULARITY_ENABLE_QUERY_CAPTURE
+  against tabulated EOS data, and reports throughput and the
+  differences from the recorded results. Material tag i in the trace
+  is replayed with the i-th material id on the command line. Untagged
+  records use the first.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <singularity-eos/base/query_trace.hpp>
+#include <singularity-eos/eos/eos.hpp>
+
+using namespace singularity;
+
+constexpr Real REL_TOL = 1e-12;
+
+int main(int argc, char *argv[]) {
+#ifdef PORTABILITY_STRATEGY_KOKKOS
+  Kokkos::initialize(argc, argv);
+#endif
+  int ret = 0;
+  {
+    if (argc < 4) {
+      std::cerr << argv[0] << ": trace.sgtrace file.sp5 matid0 matid1 ..." << std::endl;
+      return 1;
+    }
+    const std::string tracename = argv[1];
+    const std::string sp5name = argv[2];
+    std::vector<SpinerEOSDependsRhoT> eoss;
+    eoss.reserve(argc - 3);
+    for (int i = 3; i < argc; ++i) {
+      eoss.emplace_back(sp5name, std::atoi(argv[i]));
+    }
+
+    query_trace::Reader reader(tracename);
+    if (!reader.IsOpen()) {
+      std::cerr << "Could not read trace " << tracename << std::endl;
+      ret = 1;
+    } else {
+      auto stats = query_trace::Replay(
+          reader,
+          [&](int material, int model) -> const SpinerEOSDependsRhoT * {
+            if (material < 0) material = 0;
+            return (material < static_cast<int>(eoss.size())) ? &eoss[material] : nullptr;
+          },
+          REL_TOL);
+      std::cout << "Replayed " << stats.nrecords << " calls (" << stats.npoints
+                << " points), skipped " << stats.nskipped << " calls.\n"
+                << "Time: " << stats.seconds << " s\n"
+                << "Throughput: " << stats.Throughput() << " points/s\n"
+                << "Max relative difference: " << stats.max_rel_diff << "\n"
+                << "Points differing by more than " << REL_TOL << ": "
+                << stats.nmismatch << std::endl;
+    }
+    for (auto &eos : eoss) {
+      eos.Finalize();
+    }
+  }
+#ifdef PORTABILITY_STRATEGY_KOKKOS
+  Kokkos::finalize();
+#endif
+  return ret;
+}
@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#include <cmath>
+#include <vector>
+
+#include <singularity-eos/base/accuracy.hpp>
+#include <singularity-eos/base/root-finding-1d/root_finding.hpp>
+#include <singularity-eos/eos/eos.hpp>
+#ifdef SINGULARITY_BUILD_CLOSURE
+#include <singularity-eos/closure/mixed_cell_models.hpp>
+#endif // SINGULARITY_BUILD_CLOSURE
+
+#ifndef CATCH_CONFIG_FAST_COMPILE
+#define CATCH_CONFIG_FAST_COMPILE
+#include <catch2/catch_test_macros.hpp>
+#endif
+
+using namespace singularity;
+
+SCENARIO("Accuracy tiers", "[Accuracy]") {
+  GIVEN("The three named tiers") {
+    const AccuracyParams fast(AccuracyTier::Fast);
+    const AccuracyParams standard(AccuracyTier::Default);
+    const AccuracyParams strict(AccuracyTier::Strict);
+    THEN("The default tier matches the compile-time defaults") {
+      REQUIRE(standard.root_thresh == AccuracyParams().root_thresh);
+      REQUIRE(standard.root_max_iter == RootFinding1D::SECANT_NITER_MAX);
+      REQUIRE(standard.newton_max_iter == RootFinding1D::NEWTON_RAPHSON_NITER_MAX);
+#ifdef SINGULARITY_BUILD_CLOSURE
+      REQUIRE(standard.pte_rel_tolerance_p == mix_params::pte_rel_tolerance_p);
+      REQUIRE(standard.pte_rel_tolerance_e == mix_params::pte_rel_tolerance_e);
+      REQUIRE(standard.pte_rel_tolerance_t == mix_params::pte_rel_tolerance_t);
+      REQUIRE(standard.pte_abs_tolerance_p == mix_params::pte_abs_tolerance_p);
+      REQUIRE(standard.pte_abs_tolerance_e == mix_params::pte_abs_tolerance_e);
+      REQUIRE(standard.pte_abs_tolerance_t == mix_params::pte_abs_tolerance_t);
+      REQUIRE(standard.pte_residual_tolerance == mix_params::pte_residual_tolerance);
+      REQUIRE(standard.pte_max_iter_per_mat == mix_params::pte_max_iter_per_mat);
+      REQUIRE(standard.line_search_alpha == mix_params::line_search_alpha);
+      REQUIRE(standard.line_search_max_iter == mix_params::line_search_max_iter);
+      REQUIRE(standard.line_search_fac == mix_params::line_search_fac);
+#endif // SINGULARITY_BUILD_CLOSURE
+    }
+    THEN("Fast is looser than default, which is looser than strict") {
+      REQUIRE(fast.root_thresh > standard.root_thresh);
+      REQUIRE(standard.root_thresh > strict.root_thresh);
+      REQUIRE(fast.root_max_iter < standard.root_max_iter);
+      REQUIRE(standard.root_max_iter < strict.root_max_iter);
+      REQUIRE(fast.pte_rel_tolerance_p > standard.pte_rel_tolerance_p);
+      REQUIRE(standard.pte_rel_tolerance_p > strict.pte_rel_tolerance_p);
+      REQUIRE(fast.pte_max_iter_per_mat < standard.pte_max_iter_per_mat);
+      REQUIRE(standard.pte_max_iter_per_mat < strict.pte_max_iter_per_mat);
+    }
+  }
+
+  GIVEN("A root find that needs many iterations") {
+    using RootFinding1D::Status;
+    auto f = [](const Real x) { return x * x * x; };
+    Real root;
+    THEN("It fails when the iteration limit is too small") {
+      REQUIRE(RootFinding1D::regula_falsi(f, 2, 9, 0, 10, 1e-14, 1e-14, root, nullptr,
+                                          false, 3) == Status::FAIL);
+      AND_THEN("It succeeds with the default limit") {
+        REQUIRE(RootFinding1D::regula_falsi(f, 2, 9, 0, 10, 1e-14, 1e-14, root) ==
+                Status::SUCCESS);
+        REQUIRE(std::abs(root - std::cbrt(2.0)) < 1e-12);
+      }
+    }
+  }
+
+  GIVEN("The default inversion in the log of the unknown") {
+    auto f = [](const Real x) { return x * x * x; };
+    const Real root = std::cbrt(2.0);
+    THEN("Its tolerance follows the accuracy") {
+      const AccuracyParams fast(AccuracyTier::Fast);
+      const AccuracyParams strict(AccuracyTier::Strict);
+      const Real x_fast = impl::InvertInLog(f, 2.0, 0, -10, 10, fast);
+      const Real x_strict = impl::InvertInLog(f, 2.0, 0, -10, 10, strict);
+      REQUIRE(std::abs(x_fast - root) < 1e-5);
+      REQUIRE(std::abs(x_strict - root) < 1e-12);
+    }
+    THEN("A target outside of the bracket gives NaN") {
+      REQUIRE(std::isnan(impl::InvertInLog(f, -2.0, 0, -10, 10, AccuracyParams())));
+    }
+  }
+
+  GIVEN("A modified EOS in a variant") {
+    EOS eos = ShiftedEOS<IdealGas>(IdealGas(0.4, 1.0), 0.1);
+    THEN("Setting the accuracy is forwarded to the underlying model") {
+      // The ideal gas has no inversions to tune, so it keeps the defaults
+      eos.SetAccuracy(AccuracyParams(AccuracyTier::Fast));
+      REQUIRE(eos.GetAccuracy().root_thresh == AccuracyParams().root_thresh);
+    }
+  }
+}
+
+#ifdef SINGULARITY_BUILD_CLOSURE
+SCENARIO("PTE solves with different accuracy tiers", "[Accuracy][PTE]") {
+  GIVEN("Two ideal gases out of pressure equilibrium") {
+    constexpr int nmat = 2;
+    std::vector<EOS> eos_vec = {IdealGas(0.4, 1.0), IdealGas(2. / 3., 2.0)};
+    EOS *eos = eos_vec.data();
+    const Real sie_tot = 2.0;
+    std::vector<Real> scratch_vec(PTESolverRhoTRequiredScratch(nmat));
+
+    // Returns the solver iteration count and the pressure mismatch
+    auto solve = [&](const AccuracyParams &params, int &niter, Real &dp) {
+      Real rho_arr[nmat] = {1.0, 2.0};
+      Real vfrac_arr[nmat] = {0.5, 0.5};
+      Real sie_arr[nmat] = {1.0, 2.5};
+      Real temp_arr[nmat], press_arr[nmat];
+      Real *rho = rho_arr;
+      Real *vfrac = vfrac_arr;
+      Real *sie = sie_arr;
+      Real *temp = temp_arr;
+      Real *press = press_arr;
+      Real *lambda[nmat] = {nullptr, nullptr};
+      Real **lambdas = lambda;
+      for (int m = 0; m < nmat; ++m) {
+        temp[m] = eos[m].TemperatureFromDensityInternalEnergy(rho[m], sie[m]);
+        press[m] = eos[m].PressureFromDensityInternalEnergy(rho[m], sie[m]);
+      }
+      PTESolverRhoT<EOS *, Real *, Real **> method(nmat, eos, 1.0, sie_tot, rho, vfrac,
+                                                   sie, temp, press, lambdas,
+                                                   scratch_vec.data(), 0.0, params);
+      const bool converged = PTESolver(method);
+      niter = method.Niter();
+      dp = std::abs(press[1] - press[0]) / std::abs(press[0]);
+      return converged;
+    };
+
+    WHEN("The same state is equilibrated at the fast and strict tiers") {
+      int niter_fast, niter_strict;
+      Real dp_fast, dp_strict;
+      const bool fast_ok = solve(AccuracyParams(AccuracyTier::Fast), niter_fast, dp_fast);
+      const bool strict_ok =
+          solve(AccuracyParams(AccuracyTier::Strict), niter_strict, dp_strict);
+      THEN("Both converge, the fast solve in fewer iterations") {
+        REQUIRE(fast_ok);
+        REQUIRE(strict_ok);
+        REQUIRE(niter_fast < niter_strict);
+        REQUIRE(dp_fast < 1e-3);
+        REQUIRE(dp_strict < 1e-7);
+      }
+    }
+  }
+}
+#endif // SINGULARITY_BUILD_CLOSURE
@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+// © 2021-2023. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#include <cmath>
+
+#ifndef CATCH_CONFIG_FAST_COMPILE
+#define CATCH_CONFIG_FAST_COMPILE
+#include <catch2/catch_test_macros.hpp>
+#endif
+
+#include <singularity-eos/base/constants.hpp>
+#include <singularity-eos/eos/eos.hpp>
+#include <test/eos_unit_test_helpers.hpp>
+
+using singularity::DavisProducts;
+using singularity::DavisReactants;
+
+#ifdef SINGULARITY_TEST_SIMD_PACKS
+SCENARIO("Davis EOS evaluated on SIMD packs", "[DavisEOS][SIMD]") {
+  // Reactants and products of PBX 9501
+  const DavisReactants reactants(1.890, 4.115e10, 1.0e6, 297.0, 1.8e5, 4.6, 0.34, 0.56,
+                                 0.0, 0.4265, 0.001074e10);
+  const DavisProducts products(0.798311, 0.58, 1.35, 2.66182, 0.75419, 3.2e10,
+                               0.001072e10);
+  GIVEN("Densities on both sides of the reference density") {
+    // Lanes alternate between expansion and compression
+    const simd_pack_t rho([](const int i) { return (i % 2 ? 2.2 : 1.5) + 0.01 * i; });
+    const simd_pack_t temp([](const int i) { return 300.0 + 50.0 * i; });
+    const simd_pack_t sie = reactants.InternalEnergyFromDensityTemperature(rho, temp);
+    THEN("The reactants agree with scalar calls in every lane") {
+      CHECK_PACK_LANES(reactants, PressureFromDensityInternalEnergy, rho, sie);
+      CHECK_PACK_LANES(reactants, TemperatureFromDensityInternalEnergy, rho, sie);
+      CHECK_PACK_LANES(reactants, SpecificHeatFromDensityInternalEnergy, rho, sie);
+      CHECK_PACK_LANES(reactants, BulkModulusFromDensityInternalEnergy, rho, sie);
+      CHECK_PACK_LANES(reactants, GruneisenParamFromDensityInternalEnergy, rho, sie);
+      CHECK_PACK_LANES(reactants, PressureFromDensityTemperature, rho, temp);
+    }
+    THEN("Energies below the zero temperature limit give zero temperature") {
+      const simd_pack_t e_min([&](const int i) {
+        return reactants.MinInternalEnergyFromDensity(Real(rho[i])) - 1.0e6 * (i % 2);
+      });
+      const simd_pack_t T = reactants.TemperatureFromDensityInternalEnergy(rho, e_min);
+      const simd_pack_t cv = reactants.SpecificHeatFromDensityInternalEnergy(rho, e_min);
+      for (std::size_t i = 1; i < simd_pack_t::size(); i += 2) {
+        CHECK(T[i] == 0.0);
+        CHECK(cv[i] == 0.0);
+      }
+    }
+    THEN("The products agree with scalar calls in every lane") {
+      CHECK_PACK_LANES(products, PressureFromDensityInternalEnergy, rho, sie);
+      CHECK_PACK_LANES(products, TemperatureFromDensityInternalEnergy, rho, sie);
+      CHECK_PACK_LANES(products, BulkModulusFromDensityInternalEnergy, rho, sie);
+      CHECK_PACK_LANES(products, InternalEnergyFromDensityTemperature, rho, temp);
+    }
+  }
+}
+#endif // SINGULARITY_TEST_SIMD_PACKS
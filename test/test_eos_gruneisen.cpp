@@ -699,3 +699,26 @@ SCENARIO("Gruneisen EOS density limit") {
     }
   }
 }
+
+#ifdef SINGULARITY_TEST_SIMD_PACKS
+SCENARIO("Gruneisen EOS evaluated on SIMD packs", "[GruneisenEOS][SIMD]") {
+  GIVEN("A Gruneisen EOS for copper and densities on both sides of rho0") {
+    constexpr Real rho0 = 8.93;
+    const Gruneisen eos(394000.0, 1.489, 0.0, 0.0, 2.02, 0.47, rho0, 297.0, 1.0e6,
+                        0.383e7);
+    // Lanes alternate between expansion and compression
+    const simd_pack_t rho(
+        [](const int i) { return rho0 * (i % 2 ? 1.2 : 0.9) + 0.01 * i; });
+    const simd_pack_t sie([](const int i) { return 1.0e9 * (1 + i); });
+    const simd_pack_t temp([](const int i) { return 300.0 + 100.0 * i; });
+    THEN("Each lane agrees with a scalar call") {
+      CHECK_PACK_LANES(eos, PressureFromDensityInternalEnergy, rho, sie);
+      CHECK_PACK_LANES(eos, TemperatureFromDensityInternalEnergy, rho, sie);
+      CHECK_PACK_LANES(eos, BulkModulusFromDensityInternalEnergy, rho, sie);
+      CHECK_PACK_LANES(eos, GruneisenParamFromDensityInternalEnergy, rho, sie);
+      CHECK_PACK_LANES(eos, PressureFromDensityTemperature, rho, temp);
+      CHECK_PACK_LANES(eos, BulkModulusFromDensityTemperature, rho, temp);
+    }
+  }
+}
+#endif // SINGULARITY_TEST_SIMD_PACKS
@@ -21,6 +21,7 @@
 #include <array>
 #include <limits>
 #include <string>
+#include <vector>
 
 #ifndef CATCH_CONFIG_FAST_COMPILE
 #define CATCH_CONFIG_FAST_COMPILE
@@ -201,4 +202,63 @@ SCENARIO("Helmholtz equation of state - Root finding (egiven)", "[HelmholtzEOS]"
   }
 }
 
+#ifdef SINGULARITY_ENABLE_TABLE_HEATMAP
+SCENARIO("Helmholtz equation of state - Table heatmap", "[HelmholtzEOS][TableHeatmap]") {
+  using singularity::TableHeatmap;
+  using singularity::TableStatus;
+  GIVEN("A Helmholtz EOS counting its electron table lookups") {
+    Helmholtz eos(filename, true, true, false, true, true);
+    TableHeatmap heatmap("helmholtz");
+    eos.SetHeatmap(&heatmap);
+    const int grid = heatmap.FindGrid("electrons_rhoYe_T");
+    REQUIRE(grid >= 0);
+    // abar = 4, zbar = 2, so Ye = 1/2
+    Real lambda[3] = {4.0, 2.0, -1.0};
+    const std::vector<Real> rhos = {1e1, 1e5};
+    const std::vector<Real> temps = {1e6, 1e8};
+    WHEN("It is evaluated on the table") {
+      for (const Real rho : rhos) {
+        for (const Real T : temps) {
+          eos.PressureFromDensityTemperature(rho, T, lambda);
+        }
+      }
+      THEN("Every lookup is counted on the table") {
+        const auto statuses = heatmap.StatusCounts(grid);
+        const auto on = statuses[static_cast<int>(TableStatus::OnTable)];
+        REQUIRE(on >= rhos.size() * temps.size());
+        REQUIRE(statuses[static_cast<int>(TableStatus::OffBottom)] == 0);
+        REQUIRE(statuses[static_cast<int>(TableStatus::OffTop)] == 0);
+        TableHeatmap::Count total = 0;
+        for (const auto c : heatmap.Counts(grid)) {
+          total += c;
+        }
+        REQUIRE(total == on);
+      }
+      AND_THEN("The visited cells bracket the electron density and temperature") {
+        Real xmin, xmax, ymin, ymax;
+        REQUIRE(heatmap.VisitedBounds(grid, xmin, xmax, ymin, ymax));
+        REQUIRE(xmin <= std::log10(0.5 * rhos.front()));
+        REQUIRE(xmax >= std::log10(0.5 * rhos.back()));
+        REQUIRE(ymin <= std::log10(temps.front()));
+        REQUIRE(ymax >= std::log10(temps.back()));
+      }
+      AND_THEN("Lookups stop being counted once the heatmap is removed") {
+        const auto before = heatmap.StatusCounts(grid);
+        eos.SetHeatmap(nullptr);
+        eos.PressureFromDensityTemperature(rhos.front(), temps.front(), lambda);
+        REQUIRE(heatmap.StatusCounts(grid) == before);
+      }
+    }
+    WHEN("It is evaluated below the table in temperature") {
+      eos.InternalEnergyFromDensityTemperature(rhos.front(), 1.0, lambda);
+      THEN("The lookup is counted as off the bottom of the table") {
+        const auto statuses = heatmap.StatusCounts(grid);
+        REQUIRE(statuses[static_cast<int>(TableStatus::OffBottom)] > 0);
+      }
+    }
+    eos.Finalize();
+  }
+}
+#endif // SINGULARITY_ENABLE_TABLE_HEATMAP
+
 #endif // SINGULARITY_TEST_HELMHOLTZ
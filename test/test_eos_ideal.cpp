@@ -137,3 +137,30 @@ SCENARIO("Ideal gas vector Evaluate call", "[IdealGas][Evaluate]") {
     PORTABLE_FREE(sie);
   }
 }
+
+#ifdef SINGULARITY_TEST_SIMD_PACKS
+SCENARIO("Ideal gas evaluated on SIMD packs", "[IdealGas][SIMD]") {
+  GIVEN("An ideal gas and a pack of densities and energies") {
+    using pack_t = simd_pack_t;
+    constexpr Real Cv = 2.0;
+    constexpr Real gm1 = 0.5;
+    IdealGas eos(gm1, Cv);
+    const pack_t rho([](const int i) { return 1.0 + 0.5 * i; });
+    const pack_t sie([](const int i) { return 3.0 + 2.0 * i; });
+    WHEN("The scalar API is called with the packs") {
+      const pack_t P = eos.PressureFromDensityInternalEnergy(rho, sie);
+      const pack_t T = eos.TemperatureFromDensityInternalEnergy(rho, sie);
+      const pack_t bmod = eos.BulkModulusFromDensityInternalEnergy(rho, sie);
+      THEN("Each lane agrees with a scalar call") {
+        for (std::size_t i = 0; i < pack_t::size(); ++i) {
+          const Real r = rho[i];
+          const Real e = sie[i];
+          CHECK(isClose(P[i], eos.PressureFromDensityInternalEnergy(r, e), 1e-14));
+          CHECK(isClose(T[i], eos.TemperatureFromDensityInternalEnergy(r, e), 1e-14));
+          CHECK(isClose(bmod[i], eos.BulkModulusFromDensityInternalEnergy(r, e), 1e-14));
+        }
+      }
+    }
+  }
+}
+#endif // SINGULARITY_TEST_SIMD_PACKS
@@ -0,0 +1,225 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#ifdef SINGULARITY_ENABLE_EOS_SERVICE
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <singularity-eos/base/eos_service.hpp>
+#include <singularity-eos/eos/eos.hpp>
+
+#ifndef CATCH_CONFIG_FAST_COMPILE
+#define CATCH_CONFIG_FAST_COMPILE
+#include <catch2/catch_test_macros.hpp>
+#endif
+
+using namespace singularity;
+using eos_service::Client;
+using eos_service::Query;
+using Server = eos_service::Server<EOS>;
+
+// Unique per process, so that concurrent test runs do not collide
+static std::string ServiceName() {
+  return "sg-eos-service-test-" + std::to_string(getpid());
+}
+
+SCENARIO("EOS service over shared memory", "[EOSService]") {
+  GIVEN("A server owning two ideal gases") {
+    const std::vector<EOS> materials = {IdealGas(0.4, 5.0), IdealGas(2. / 3., 2.0)};
+    Server server(materials);
+    eos_service::Options options;
+    options.nslots = 16;
+    options.slot_capacity = 100;
+    const std::string name = ServiceName();
+    REQUIRE(server.Start(name, options));
+
+    THEN("A second server cannot take the same name") {
+      Server other(materials);
+      REQUIRE(!other.Start(name, options));
+    }
+
+    WHEN("Several clients send requests while the server runs") {
+      std::atomic<bool> stop(false);
+      std::thread serving([&]() { server.Serve(stop); });
+      constexpr int nclients = 4;
+      constexpr int num = 250; // more than a slot holds
+      std::vector<int> nwrong(nclients, 0);
+      std::vector<int> nfailed(nclients, 0);
+      std::vector<std::thread> clients;
+      for (int c = 0; c < nclients; ++c) {
+        clients.emplace_back([&, c]() {
+          Client client(name);
+          const int m = c % 2;
+          std::vector<Real> rho(num), sie(num), P(num);
+          for (int k = 0; k < 10; ++k) {
+            for (int i = 0; i < num; ++i) {
+              rho[i] = 0.1 + 0.01 * i + c;
+              sie[i] = 1.0 + 0.1 * k + 0.02 * i;
+            }
+            if (!client.Evaluate(Query::PressureFromDensityInternalEnergy, m, rho.data(),
+                                 sie.data(), P.data(), num)) {
+              nfailed[c]++;
+              continue;
+            }
+            for (int i = 0; i < num; ++i) {
+              const Real expected =
+                  materials[m].PressureFromDensityInternalEnergy(rho[i], sie[i]);
+              nwrong[c] += (P[i] != expected);
+            }
+          }
+        });
+      }
+      for (auto &t : clients) {
+        t.join();
+      }
+      stop = true;
+      serving.join();
+      THEN("Every client gets the same results as a direct lookup") {
+        for (int c = 0; c < nclients; ++c) {
+          REQUIRE(nfailed[c] == 0);
+          REQUIRE(nwrong[c] == 0);
+        }
+        const auto stats = server.GetStats();
+        REQUIRE(stats.npoints == nclients * 10 * num);
+        REQUIRE(stats.nrequests == nclients * 10 * 3);
+      }
+    }
+
+    WHEN("Requests pile up before the server polls") {
+      constexpr int nclients = 8;
+      constexpr int num = 50;
+      std::vector<std::vector<Real>> T(nclients, std::vector<Real>(num));
+      std::vector<std::thread> clients;
+      for (int c = 0; c < nclients; ++c) {
+        clients.emplace_back([&, c]() {
+          Client client(name);
+          std::vector<Real> rho(num, 1.0 + c), sie(num, 3.0);
+          client.Evaluate(Query::TemperatureFromDensityInternalEnergy, 0, rho.data(),
+                          sie.data(), T[c].data(), num);
+        });
+      }
+      while (server.NumPending() < nclients) {
+        std::this_thread::yield();
+      }
+      const int nserved = server.Poll();
+      for (auto &t : clients) {
+        t.join();
+      }
+      THEN("They are served together in one vector call") {
+        REQUIRE(nserved == nclients);
+        const auto stats = server.GetStats();
+        REQUIRE(stats.nbatches == 1);
+        REQUIRE(stats.npoints == nclients * num);
+        for (int c = 0; c < nclients; ++c) {
+          const Real expected =
+              materials[0].TemperatureFromDensityInternalEnergy(1.0 + c, 3.0);
+          REQUIRE(T[c][0] == expected);
+        }
+      }
+    }
+
+    WHEN("A client asks for a material the server does not have") {
+      Client client(name);
+      Real rho = 1, sie = 1, P = 0;
+      THEN("The request is refused") {
+        REQUIRE(client.NumMaterials() == 2);
+        REQUIRE(!client.Evaluate(Query::PressureFromDensityInternalEnergy, 2, &rho, &sie,
+                                 &P, 1));
+      }
+    }
+
+    WHEN("A client sends lambdas with its request") {
+      std::atomic<bool> stop(false);
+      std::thread serving([&]() { server.Serve(stop); });
+      Client client(name);
+      constexpr int num = 150;
+      constexpr int nlambda = 2;
+      std::vector<Real> rho(num, 1.0), sie(num, 2.0), P(num);
+      std::vector<Real> lambdas(num * nlambda);
+      for (int i = 0; i < num * nlambda; ++i) {
+        lambdas[i] = i;
+      }
+      const bool ok =
+          client.Evaluate(Query::PressureFromDensityInternalEnergy, 0, rho.data(),
+                          sie.data(), P.data(), num, lambdas.data(), nlambda);
+      stop = true;
+      serving.join();
+      THEN("Each point gets its own lambdas back") {
+        REQUIRE(ok);
+        for (int i = 0; i < num * nlambda; ++i) {
+          REQUIRE(lambdas[i] == i);
+        }
+      }
+    }
+
+    WHEN("Requests claim more points or lambdas than a slot holds") {
+      // Written by hand, since Client never sends such requests
+      eos_service::impl::Segment segment;
+      REQUIRE(segment.Open(name));
+      const std::uint32_t capacity = segment.Header()->capacity;
+      auto submit = [&](const std::size_t s, const std::uint32_t num,
+                        const std::uint32_t nlambda) {
+        constexpr auto query = Query::PressureFromDensityInternalEnergy;
+        auto *slot = segment.Slot(s);
+        slot->query = static_cast<std::uint32_t>(query);
+        slot->material = 0;
+        slot->num = num;
+        slot->nlambda = nlambda;
+        for (std::uint32_t i = 0; i < std::min(num, capacity); ++i) {
+          segment.X(s)[i] = 1.0;
+          segment.Y(s)[i] = 2.0;
+        }
+        slot->state.store(static_cast<std::uint32_t>(eos_service::SlotState::Ready));
+      };
+      submit(0, capacity + 1, 0);
+      submit(1, 1, MAX_NUM_LAMBDAS + 1);
+      submit(2, capacity, MAX_NUM_LAMBDAS);
+      REQUIRE(server.Poll() == 3);
+      THEN("Those are refused and the rest of their group is served") {
+        auto state = [&](const std::size_t s) {
+          return static_cast<eos_service::SlotState>(segment.Slot(s)->state.load());
+        };
+        REQUIRE(state(0) == eos_service::SlotState::Failed);
+        REQUIRE(state(1) == eos_service::SlotState::Failed);
+        REQUIRE(state(2) == eos_service::SlotState::Done);
+        const Real P = materials[0].PressureFromDensityInternalEnergy(1, 2);
+        REQUIRE(segment.Out(2)[0] == P);
+        REQUIRE(server.GetStats().npoints == capacity);
+      }
+    }
+
+    WHEN("The server stops") {
+      Client client(name);
+      REQUIRE(client.Alive());
+      server.Stop();
+      THEN("Clients see it, and no new client can connect") {
+        Real rho = 1, sie = 1, P = 0;
+        REQUIRE(!client.Alive());
+        REQUIRE(!client.Evaluate(Query::PressureFromDensityInternalEnergy, 0, &rho, &sie,
+                                 &P, 1));
+        Client late;
+        REQUIRE(!late.Open(name));
+      }
+    }
+    server.Stop();
+  }
+}
+
+#endif // SINGULARITY_ENABLE_EOS_SERVICE
@@ -18,11 +18,14 @@
 #include <cstdlib>
 #include <iostream> // debug
 #include <limits>
+#include <string>
+#include <vector>
 
 #include <ports-of-call/portability.hpp>
 #include <ports-of-call/portable_arrays.hpp>
 #include <ports-of-call/portable_errors.hpp>
 #include <singularity-eos/eos/eos.hpp>
+#include <singularity-eos/eos/eos_builder.hpp>
 
 #ifdef SINGULARITY_BUILD_CLOSURE
 #include <singularity-eos/eos/singularity_eos.hpp>
@@ -145,6 +148,90 @@ SCENARIO("Stellar Collapse EOS", "[StellarCollapse]") {
           REQUIRE(isClose(sie, sc.InternalEnergyFromDensityTemperature(rho, t, lambda)));
         }
       }
+      AND_THEN("Baking modifiers into the tables reproduces the modified EOS") {
+        using singularity::ShiftedEOS;
+        using singularity::UnitSystem;
+        using Modified = UnitSystem<ShiftedEOS<StellarCollapse>>;
+        // Power-of-two units re-grid exactly with fast logs as well
+        constexpr Real rho_unit = 1 << 10;
+        constexpr Real sie_unit = 1 << 20;
+        constexpr Real temp_unit = 8;
+        constexpr Real shift = 1e17;
+        auto make = [&]() {
+          return Modified(ShiftedEOS<StellarCollapse>(
+                              StellarCollapse(filename, false, false), shift),
+                          singularity::eos_units_init::thermal_units_init_tag, rho_unit,
+                          sie_unit, temp_unit);
+        };
+        Modified modified = make();
+        StellarCollapse baked = singularity::EOSBuilder::BakeModifiers(make());
+        const Real Ye = 0.5 * (baked.YeMin() + baked.YeMax());
+        const Real lRhoMin = std::log10(baked.rhoMin());
+        const Real lRhoMax = std::log10(baked.rhoMax());
+        const Real lTMin = std::log10(baked.TMin());
+        const Real lTMax = std::log10(baked.TMax());
+        for (const Real x : {0.25, 0.5, 0.75}) {
+          for (const Real y : {0.25, 0.5, 0.75}) {
+            const Real rho = std::pow(10., lRhoMin + x * (lRhoMax - lRhoMin));
+            const Real T = std::pow(10., lTMin + y * (lTMax - lTMin));
+            Real lm[2] = {Ye, 0};
+            Real lb[2] = {Ye, 0};
+            const Real sie = modified.InternalEnergyFromDensityTemperature(rho, T, lm);
+            REQUIRE(isClose(baked.InternalEnergyFromDensityTemperature(rho, T, lb), sie,
+                            1e-10));
+            REQUIRE(isClose(baked.PressureFromDensityTemperature(rho, T, lb),
+                            modified.PressureFromDensityTemperature(rho, T, lm), 1e-10));
+            REQUIRE(isClose(baked.TemperatureFromDensityInternalEnergy(rho, sie, lb),
+                            modified.TemperatureFromDensityInternalEnergy(rho, sie, lm),
+                            1e-10));
+          }
+        }
+        modified.Finalize();
+        baked.Finalize();
+      }
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+      AND_THEN("Captured calls record the lambdas each point started from") {
+        namespace query_trace = singularity::query_trace;
+        if (query_trace::IsHostAccessible<Real *>::value) {
+          const std::string tracename = "stellar_collapse_capture.sgtrace";
+          singularity::Variant<StellarCollapse> eos = sc;
+          constexpr int num = 8;
+          const Real Ye = 0.5 * (sc.YeMin() + sc.YeMax());
+          const Real lR = 0.5 * (std::log10(sc.rhoMin()) + std::log10(sc.rhoMax()));
+          const Real lTMin = std::log10(sc.TMin());
+          const Real dlT = (std::log10(sc.TMax()) - lTMin) / (num + 1);
+          std::vector<Real> rhos(num), sies(num), temps(num);
+          std::vector<std::array<Real, 2>> lambda(num);
+          std::vector<Real *> lambdas(num);
+          for (int i = 0; i < num; ++i) {
+            rhos[i] = std::pow(10., lR);
+            // the temperature guesses are deliberately poor
+            lambda[i] = {Ye, lTMin};
+            lambdas[i] = lambda[i].data();
+            const Real T = std::pow(10., lTMin + (i + 1) * dlT);
+            sies[i] = sc.InternalEnergyFromDensityTemperature(rhos[i], T, lambda[i]);
+            lambda[i][StellarCollapse::Lambda::lT] = lTMin;
+          }
+          REQUIRE(query_trace::Start(tracename));
+          eos.TemperatureFromDensityInternalEnergy(rhos.data(), sies.data(), temps.data(),
+                                                   num, lambdas.data());
+          query_trace::Stop();
+          query_trace::Reader reader(tracename);
+          query_trace::Record r;
+          REQUIRE(reader.Next(r));
+          REQUIRE(r.nlambda == 2);
+          for (int i = 0; i < num; ++i) {
+            // the call has overwritten the cached temperatures
+            REQUIRE(lambda[i][StellarCollapse::Lambda::lT] != lTMin);
+            REQUIRE(r.lambdas[i * 2 + StellarCollapse::Lambda::Ye] == Ye);
+            REQUIRE(r.lambdas[i * 2 + StellarCollapse::Lambda::lT] == lTMin);
+            REQUIRE(r.out[i] == temps[i]);
+          }
+          reader.Close();
+          std::remove(tracename.c_str());
+        }
+      }
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
       GIVEN("An Ideal Gas equation of state") {
         constexpr Real gamma = 1.4;
         constexpr Real mp = 1.67262171e-24;
@@ -291,6 +378,95 @@ SCENARIO("Stellar Collapse EOS", "[StellarCollapse]") {
           sc2.Finalize();
         }
       }
+      AND_THEN("We can save a compressed SP5 file") {
+        const std::string zsavename = "stellar_collapse_ideal_z.sp5";
+        SP5::Compression::Options compression;
+        compression.level = 4;
+        compression.chunkElements = 128;
+        sc.Save(savename);
+        sc.Save(zsavename, compression);
+        AND_THEN("It loads to the same tables as the uncompressed file") {
+          StellarCollapse sc2(savename, true);
+          StellarCollapse scz(zsavename, true);
+          const int N = 17;
+          const Real dY = (sc.YeMax() - sc.YeMin()) / (N + 1);
+          const Real dlT = (std::log10(sc.TMax()) - std::log10(sc.TMin())) / (N + 1);
+          const Real dlR = (std::log10(sc.rhoMax()) - std::log10(sc.rhoMin())) / (N + 1);
+          int nwrong = 0;
+          for (int k = 1; k <= N; ++k) {
+            for (int j = 1; j <= N; ++j) {
+              for (int i = 1; i <= N; ++i) {
+                Real lambda[2] = {sc.YeMin() + k * dY, 0};
+                const Real T = std::pow(10., std::log10(sc.TMin()) + j * dlT);
+                const Real R = std::pow(10., std::log10(sc.rhoMin()) + i * dlR);
+                const Real p2 = sc2.PressureFromDensityTemperature(R, T, lambda);
+                const Real pz = scz.PressureFromDensityTemperature(R, T, lambda);
+                const Real e2 = sc2.InternalEnergyFromDensityTemperature(R, T, lambda);
+                const Real ez = scz.InternalEnergyFromDensityTemperature(R, T, lambda);
+                if (p2 != pz || e2 != ez) nwrong += 1;
+              }
+            }
+          }
+          REQUIRE(nwrong == 0);
+          sc2.Finalize();
+          scz.Finalize();
+        }
+        AND_THEN("Chunks inflated in parallel match the uncompressed datasets") {
+          hid_t file = H5Fopen(savename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+          hsize_t dims[3];
+          herr_t status = H5LTget_dataset_info(file, "logpress", dims, nullptr, nullptr);
+          std::vector<Real> lP(dims[0] * dims[1] * dims[2]);
+          status += H5LTread_dataset_double(file, "logpress", lP.data());
+          status += H5Fclose(file);
+          for (const int nthreads : {1, 4}) {
+            hid_t zfile = SP5::Compression::Open(zsavename, "", nthreads);
+            std::vector<Real> lPz(lP.size());
+            status += H5LTread_dataset_double(zfile, "logpress", lPz.data());
+            status += H5Fclose(zfile);
+            REQUIRE(lPz == lP);
+          }
+          REQUIRE(status == H5_SUCCESS);
+        }
+      }
+      AND_THEN("We can restrict the table in Ye or fix Ye") {
+        const Real yemid = 0.5 * (sc.YeMin() + sc.YeMax());
+        const Real yelo = sc.YeMin() + 0.3 * (sc.YeMax() - sc.YeMin());
+        StellarCollapse scc(filename, false, false, yelo, yemid);
+        StellarCollapse scf(filename, false, false, yemid, yemid);
+        REQUIRE(!scc.FixedYe());
+        REQUIRE(scc.YeMin() <= yelo);
+        REQUIRE(scc.YeMax() >= yemid);
+        REQUIRE(scc.YeMax() - scc.YeMin() < sc.YeMax() - sc.YeMin());
+        REQUIRE(scf.FixedYe());
+        REQUIRE(scf.YeMin() == yemid);
+        REQUIRE(scf.YeMax() == yemid);
+        AND_THEN("Lookups agree with the full table") {
+          const int N = 17;
+          const Real dlT = (std::log10(sc.TMax()) - std::log10(sc.TMin())) / (N + 1);
+          const Real dlR = (std::log10(sc.rhoMax()) - std::log10(sc.rhoMin())) / (N + 1);
+          int nwrong = 0;
+          for (int j = 1; j <= N; ++j) {
+            for (int i = 1; i <= N; ++i) {
+              // Ye in lambda is ignored in fixed-Ye mode
+              Real lambda[2] = {yemid, 0};
+              Real lambda_f[2] = {0, 0};
+              const Real T = std::pow(10., std::log10(sc.TMin()) + j * dlT);
+              const Real R = std::pow(10., std::log10(sc.rhoMin()) + i * dlR);
+              const Real p = sc.PressureFromDensityTemperature(R, T, lambda);
+              const Real e = sc.InternalEnergyFromDensityTemperature(R, T, lambda);
+              const Real pc = scc.PressureFromDensityTemperature(R, T, lambda);
+              const Real pf = scf.PressureFromDensityTemperature(R, T, lambda_f);
+              const Real Tf = scf.TemperatureFromDensityInternalEnergy(R, e, lambda_f);
+              if (!isClose(p, pc, 1e-12)) nwrong += 1;
+              if (!isClose(p, pf, 1e-12)) nwrong += 1;
+              if (!isClose(T, Tf, 1e-8)) nwrong += 1;
+            }
+          }
+          REQUIRE(nwrong == 0);
+        }
+        scc.Finalize();
+        scf.Finalize();
+      }
       sc.Finalize();
     }
   }
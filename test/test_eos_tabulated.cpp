@@ -23,6 +23,10 @@
 #include <ports-of-call/portable_errors.hpp>
 #include <singularity-eos/base/variadic_utils.hpp>
 #include <singularity-eos/eos/eos.hpp>
+#include <singularity-eos/eos/eos_builder.hpp>
+#ifdef SINGULARITY_BUILD_CLOSURE
+#include <singularity-eos/closure/mixed_cell_models.hpp>
+#endif // SINGULARITY_BUILD_CLOSURE
 
 #ifndef CATCH_CONFIG_FAST_COMPILE
 #define CATCH_CONFIG_FAST_COMPILE
@@ -34,6 +38,7 @@
 #ifdef SPINER_USE_HDF
 using singularity::SpinerEOSDependsRhoSie;
 using singularity::SpinerEOSDependsRhoT;
+using singularity::SpinerMaterialLibrary;
 #endif
 
 #ifdef SINGULARITY_USE_EOSPAC
@@ -41,9 +46,15 @@ using singularity::EOSPAC;
 #endif
 
 namespace thermalqs = singularity::thermalqs;
+using singularity::AccuracyParams;
+using singularity::AccuracyTier;
 using singularity::variadic_utils::np;
 
 const std::string eosName = "../materials.sp5";
+// Written by sesame2spiner -g before the tests run. See CMakeLists.txt
+const std::string sharedGridName = "../shared-grid-materials.sp5";
+// Steel written by sesame2spiner with patchTolerance set
+const std::string patchedName = "../patched-materials.sp5";
 const std::string airName = "air";
 const std::string steelName = "stainless steel 347";
 
@@ -217,6 +228,325 @@ SCENARIO("SpinerEOS depends on Rho and T", "[SpinerEOS],[DependsRhoT][EOSPAC]")
     }
     eos_spiner.Finalize();
   }
+
+  GIVEN("EOS initialized with matid and diagnostics disabled") {
+    SpinerEOSDependsRhoT eos_spiner = SpinerEOSDependsRhoT(eosName, steelID);
+    eos_spiner.SetDiagnostics(false);
+    REQUIRE(!eos_spiner.Diagnostics());
+    THEN("Lookups requiring root finds do not touch the diagnostic state") {
+      const Real rho = 8.0;
+      const Real sie = 1e12;
+      Real lambda[2];
+      const Real T = eos_spiner.TemperatureFromDensityInternalEnergy(rho, sie, lambda);
+      REQUIRE(T > 0);
+      REQUIRE(eos_spiner.counts.total() < 1);
+      AND_THEN("The results agree with the default mode") {
+        SpinerEOSDependsRhoT eos_default = SpinerEOSDependsRhoT(eosName, steelID);
+        Real lambda_default[2];
+        const Real T_default =
+            eos_default.TemperatureFromDensityInternalEnergy(rho, sie, lambda_default);
+        REQUIRE(isClose(T, T_default));
+        eos_default.Finalize();
+      }
+    }
+    eos_spiner.Finalize();
+  }
+
+  GIVEN("EOS initialized with matid and a copy at the fast accuracy tier") {
+    EOS eos_default = SpinerEOSDependsRhoT(eosName, steelID);
+    EOS eos_fast = eos_default;
+    eos_fast.SetAccuracy(AccuracyParams(AccuracyTier::Fast));
+    THEN("Only the copy changes its accuracy") {
+      REQUIRE(eos_fast.GetAccuracy().root_thresh ==
+              AccuracyParams(AccuracyTier::Fast).root_thresh);
+      REQUIRE(eos_default.GetAccuracy().root_thresh == AccuracyParams().root_thresh);
+      AND_THEN("Inversions at the fast tier agree to its tolerance") {
+        for (const Real rho : {1.0, 8.0}) {
+          for (const Real sie : {1e10, 1e12}) {
+            REQUIRE(isClose(eos_fast.TemperatureFromDensityInternalEnergy(rho, sie),
+                            eos_default.TemperatureFromDensityInternalEnergy(rho, sie),
+                            1e-6));
+          }
+        }
+      }
+    }
+    // The copy shares the tables
+    eos_default.Finalize();
+  }
+
+  GIVEN("EOS initialized with matid") {
+    SpinerEOSDependsRhoT eos_spiner = SpinerEOSDependsRhoT(eosName, steelID);
+    REQUIRE(eos_spiner.SharesTemperatureGrid(eos_spiner));
+    THEN("Lookups with a precomputed temperature index agree with regular lookups") {
+      const Real rho = 8.0;
+      for (const Real T : {1.0, 300.0, 1e4, 1e10}) {
+        const auto tidx = eos_spiner.GetTemperatureIndex(T);
+        REQUIRE(isClose(eos_spiner.PressureFromDensityTemperatureIndex(rho, tidx),
+                        eos_spiner.PressureFromDensityTemperature(rho, T)));
+        REQUIRE(isClose(eos_spiner.InternalEnergyFromDensityTemperatureIndex(rho, tidx),
+                        eos_spiner.InternalEnergyFromDensityTemperature(rho, T)));
+      }
+    }
+    eos_spiner.Finalize();
+  }
+
+  GIVEN("EOS initialized with matid") {
+    SpinerEOSDependsRhoT eos_spiner = SpinerEOSDependsRhoT(eosName, steelID);
+    THEN("Tabulated derivatives agree with the individual lookups") {
+      for (const Real rho : {2.0, 8.0}) {
+        for (const Real T : {1e3, 1e5}) {
+          const Real sie = eos_spiner.InternalEnergyFromDensityTemperature(rho, T);
+          const auto d = eos_spiner.DerivativesFromDensityInternalEnergy(rho, sie);
+          const Real cv = eos_spiner.SpecificHeatFromDensityInternalEnergy(rho, sie);
+          REQUIRE(isClose(d.cv, cv, 1e-12));
+          REQUIRE(isClose(d.gruneisen,
+                          eos_spiner.GruneisenParamFromDensityInternalEnergy(rho, sie),
+                          1e-12));
+          // dTdE and cv come from separate tables, so compare dTdE with
+          // the lookup at the same temperature instead of with 1/cv
+          const auto dT = eos_spiner.DerivativesFromDensityTemperature(rho, T);
+          REQUIRE(isClose(dT.dTdE, d.dTdE, 1e-6));
+          REQUIRE(isClose(dT.dPdE, d.dPdE, 1e-6));
+        }
+      }
+    }
+    eos_spiner.Finalize();
+  }
+
+  GIVEN("EOS initialized with matid") {
+    SpinerEOSDependsRhoT eos_spiner = SpinerEOSDependsRhoT(eosName, steelID);
+    THEN("Entropy is tabulated and consistent with the energy") {
+      Real rho0, T0, sie0, P0, cv0, bmod0, dpde0, dvdt0;
+      eos_spiner.ValuesAtReferenceState(rho0, T0, sie0, P0, cv0, bmod0, dpde0, dvdt0);
+      REQUIRE(std::abs(eos_spiner.EntropyFromDensityTemperature(rho0, T0)) < 1e-6 * cv0);
+      for (const Real rho : {2.0, 8.0}) {
+        for (const Real T : {1e3, 1e5}) {
+          // T dS = de at fixed density, with a slowly varying heat capacity
+          const Real T1 = 2 * T;
+          const Real S = eos_spiner.EntropyFromDensityTemperature(rho, T);
+          const Real S1 = eos_spiner.EntropyFromDensityTemperature(rho, T1);
+          const Real sie = eos_spiner.InternalEnergyFromDensityTemperature(rho, T);
+          const Real sie1 = eos_spiner.InternalEnergyFromDensityTemperature(rho, T1);
+          REQUIRE(S1 > S);
+          REQUIRE(isClose(S1 - S, (sie1 - sie) * std::log(T1 / T) / (T1 - T), 5e-2));
+          const Real cv = eos_spiner.SpecificHeatFromDensityTemperature(rho, T);
+          REQUIRE(std::abs(eos_spiner.EntropyFromDensityInternalEnergy(rho, sie) - S) <
+                  1e-4 * cv);
+        }
+      }
+      AND_THEN("The vector lookup agrees with the scalar one") {
+        constexpr int num = 4;
+        std::vector<Real> rhos = {2.0, 2.0, 8.0, 8.0};
+        std::vector<Real> temps = {1e3, 1e5, 1e3, 1e5};
+        std::vector<Real> entropies(num);
+        std::vector<Real *> lambdas(num, nullptr);
+        eos_spiner.EntropyFromDensityTemperature(rhos.data(), temps.data(),
+                                                 entropies.data(), num, lambdas.data());
+        for (int i = 0; i < num; ++i) {
+          REQUIRE(entropies[i] ==
+                  eos_spiner.EntropyFromDensityTemperature(rhos[i], temps[i]));
+        }
+      }
+    }
+    eos_spiner.Finalize();
+  }
+
+  GIVEN("A modified EOS and the same EOS with its modifiers baked in") {
+    using singularity::ShiftedEOS;
+    using singularity::UnitSystem;
+    using Modified = UnitSystem<ShiftedEOS<SpinerEOSDependsRhoT>>;
+    // Power-of-two units re-grid exactly with fast logs as well
+    constexpr Real rho_unit = 4;
+    constexpr Real sie_unit = 1 << 20;
+    constexpr Real temp_unit = 8;
+    constexpr Real shift = 1e10;
+    auto make = [&]() {
+      return Modified(ShiftedEOS<SpinerEOSDependsRhoT>(
+                          SpinerEOSDependsRhoT(eosName, steelID), shift),
+                      singularity::eos_units_init::thermal_units_init_tag, rho_unit,
+                      sie_unit, temp_unit);
+    };
+    Modified modified = make();
+    SpinerEOSDependsRhoT baked = singularity::EOSBuilder::BakeModifiers(make());
+    THEN("They agree to round-off") {
+      for (const Real rho : {0.5, 2.0, 8.0}) {
+        for (const Real T : {30.0, 1e3, 1e5}) {
+          const Real sie = modified.InternalEnergyFromDensityTemperature(rho, T);
+          REQUIRE(
+              isClose(baked.InternalEnergyFromDensityTemperature(rho, T), sie, 1e-10));
+          REQUIRE(isClose(baked.PressureFromDensityTemperature(rho, T),
+                          modified.PressureFromDensityTemperature(rho, T), 1e-10));
+          REQUIRE(isClose(baked.SpecificHeatFromDensityTemperature(rho, T),
+                          modified.SpecificHeatFromDensityTemperature(rho, T), 1e-10));
+          REQUIRE(isClose(baked.TemperatureFromDensityInternalEnergy(rho, sie),
+                          modified.TemperatureFromDensityInternalEnergy(rho, sie), 1e-8));
+        }
+      }
+    }
+    modified.Finalize();
+    baked.Finalize();
+  }
+
+  GIVEN("An EOS and the same EOS cropped to a window") {
+    singularity::TableWindow window;
+    window.rhoMin = 1.0;
+    window.rhoMax = 10.0;
+    window.TMin = 100.0;
+    window.TMax = 1e5;
+    SpinerEOSDependsRhoT full(eosName, steelID);
+    SpinerEOSDependsRhoT cropped(eosName, steelID, window);
+    THEN("The cropped EOS is smaller and agrees inside the window") {
+      REQUIRE(cropped.MinimumDensity() > full.MinimumDensity());
+      REQUIRE(cropped.MinimumTemperature() > full.MinimumTemperature());
+      for (const Real rho : {1.0, 3.0, 10.0}) {
+        for (const Real T : {100.0, 1e3, 1e5}) {
+          const Real sie = full.InternalEnergyFromDensityTemperature(rho, T);
+          REQUIRE(isClose(cropped.InternalEnergyFromDensityTemperature(rho, T), sie,
+                          1e-12));
+          REQUIRE(isClose(cropped.PressureFromDensityTemperature(rho, T),
+                          full.PressureFromDensityTemperature(rho, T), 1e-12));
+          REQUIRE(isClose(cropped.TemperatureFromDensityInternalEnergy(rho, sie),
+                          full.TemperatureFromDensityInternalEnergy(rho, sie), 1e-10));
+        }
+      }
+    }
+    full.Finalize();
+    cropped.Finalize();
+  }
+}
+
+SCENARIO("Spiner materials on a shared temperature grid",
+         "[SpinerEOS],[DependsRhoT],[SharedGrid]") {
+  GIVEN("Air and steel tabulated together by sesame2spiner -g") {
+    SpinerMaterialLibrary library(sharedGridName, {airID, steelID});
+    REQUIRE(library.size() == 2);
+    const SpinerEOSDependsRhoT &air = library[0];
+    const SpinerEOSDependsRhoT &steel = library[1];
+    THEN("Both tables span the same temperatures") {
+      REQUIRE(air.matid() == airID);
+      REQUIRE(steel.matid() == steelID);
+      REQUIRE(air.SharesTemperatureGrid(steel));
+      REQUIRE(air.TMin() == steel.TMin());
+      REQUIRE(air.TMax() == steel.TMax());
+    }
+    THEN("One temperature index serves both materials") {
+      for (const Real T : {1.0, 300.0, 1e4, 1e10}) {
+        const auto tidx = library.GetTemperatureIndex(T);
+        for (const Real rho : {1e-3, 1.0, 8.0}) {
+          for (std::size_t m = 0; m < library.size(); ++m) {
+            REQUIRE(isClose(library[m].PressureFromDensityTemperatureIndex(rho, tidx),
+                            library[m].PressureFromDensityTemperature(rho, T), 1e-12));
+            REQUIRE(
+                isClose(library[m].InternalEnergyFromDensityTemperatureIndex(rho, tidx),
+                        library[m].InternalEnergyFromDensityTemperature(rho, T), 1e-12));
+          }
+        }
+      }
+    }
+    THEN("An index from a table on another grid falls back to a regular lookup") {
+      // The same material in the file without -g has a grid of its own
+      SpinerEOSDependsRhoT steel_alone(eosName, steelID);
+      const Real rho = 1.0;
+      for (const Real T : {300.0, 1e4}) {
+        const auto tidx = steel_alone.GetTemperatureIndex(T);
+        REQUIRE(isClose(air.PressureFromDensityTemperatureIndex(rho, tidx),
+                        air.PressureFromDensityTemperature(rho, T), 1e-12));
+        REQUIRE(isClose(air.InternalEnergyFromDensityTemperatureIndex(rho, tidx),
+                        air.InternalEnergyFromDensityTemperature(rho, T), 1e-12));
+      }
+      steel_alone.Finalize();
+    }
+#ifdef SINGULARITY_BUILD_CLOSURE
+    WHEN("Hot steel and compressed air are brought into equilibrium") {
+      constexpr int nmat = 2;
+      std::vector<EOS> eos_vec = {air, steel};
+      EOS *eos = eos_vec.data();
+      Real rho_arr[nmat] = {0.1, 7.9};
+      Real vfrac_arr[nmat] = {0.5, 0.5};
+      Real sie_arr[nmat], temp_arr[nmat], press_arr[nmat];
+      Real *rho = rho_arr;
+      Real *vfrac = vfrac_arr;
+      Real *sie = sie_arr;
+      Real *temp = temp_arr;
+      Real *press = press_arr;
+      Real *lambda[nmat] = {nullptr, nullptr};
+      Real **lambdas = lambda;
+      Real rho_tot = 0;
+      Real sie_tot = 0;
+      for (int m = 0; m < nmat; ++m) {
+        temp[m] = 1000.0;
+        sie[m] = eos[m].InternalEnergyFromDensityTemperature(rho[m], temp[m]);
+        press[m] = eos[m].PressureFromDensityTemperature(rho[m], temp[m]);
+        rho_tot += rho[m] * vfrac[m];
+        sie_tot += rho[m] * vfrac[m] * sie[m];
+      }
+      sie_tot /= rho_tot;
+      std::vector<Real> scratch(singularity::PTESolverRhoTRequiredScratch(nmat));
+      singularity::PTESolverRhoT<EOS *, Real *, Real **> method(
+          nmat, eos, 1.0, sie_tot, rho, vfrac, sie, temp, press, lambdas, scratch.data(),
+          0.0);
+      const bool converged = singularity::PTESolver(method);
+      THEN("The solve converges to a common pressure and temperature") {
+        REQUIRE(converged);
+        REQUIRE(isClose(temp[0], temp[1], 1e-12));
+        REQUIRE(isClose(press[0], press[1], 1e-3));
+        for (int m = 0; m < nmat; ++m) {
+          const Real P = eos[m].PressureFromDensityTemperature(rho[m], temp[m]);
+          REQUIRE(isClose(press[m], P, 1e-10));
+        }
+      }
+    }
+#endif // SINGULARITY_BUILD_CLOSURE
+    library.Finalize();
+  }
+}
+
+SCENARIO("SpinerEOS with refined patches", "[SpinerEOS],[DependsRhoT],[TablePatches]") {
+  GIVEN("Steel tabulated by sesame2spiner with patchTolerance") {
+    hid_t file = H5Fopen(patchedName.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    const std::string lTName = std::to_string(steelID) + "/" + SP5::Depends::logRhoLogT;
+    hid_t lTGroup = H5Gopen(file, lTName.c_str(), H5P_DEFAULT);
+    const bool hasPatches = singularity::TablePatches::Exists(lTGroup);
+    H5Gclose(lTGroup);
+    H5Fclose(file);
+    SpinerEOSDependsRhoT steel(patchedName, steelID);
+    EOS eospac = EOSPAC(steelID);
+    THEN("The file holds patches and the reference state matches EOSPAC") {
+      REQUIRE(hasPatches);
+      Real rho, T, sie, P, cv, bmod, dpde, dvdt;
+      Real rho_pac, T_pac, sie_pac, P_pac, cv_pac, bmod_pac, dpde_pac, dvdt_pac;
+      steel.ValuesAtReferenceState(rho, T, sie, P, cv, bmod, dpde, dvdt);
+      eospac.ValuesAtReferenceState(rho_pac, T_pac, sie_pac, P_pac, cv_pac, bmod_pac,
+                                    dpde_pac, dvdt_pac);
+      REQUIRE(isClose(rho, rho_pac));
+      REQUIRE(isClose(T, T_pac));
+    }
+    THEN("Lookups and inversions over the patched table are consistent") {
+      const Real lRhoMin = std::log10(steel.rhoMin());
+      const Real lRhoMax = std::log10(steel.rhoMax());
+      const Real lTMin = std::log10(steel.TMin());
+      const Real lTMax = std::log10(steel.TMax());
+      constexpr int N = 23;
+      int nwrong = 0;
+      for (int j = 0; j <= N; ++j) {
+        for (int i = 0; i <= N; ++i) {
+          // away from the edges, where the energy is far from flat in T
+          const Real x = 0.1 + 0.8 * j / N;
+          const Real y = 0.3 + 0.4 * i / N;
+          const Real rho = std::pow(10., lRhoMin + x * (lRhoMax - lRhoMin));
+          const Real T = std::pow(10., lTMin + y * (lTMax - lTMin));
+          const Real sie = steel.InternalEnergyFromDensityTemperature(rho, T);
+          const Real P = steel.PressureFromDensityTemperature(rho, T);
+          const Real T_inv = steel.TemperatureFromDensityInternalEnergy(rho, sie);
+          const Real P_inv = steel.PressureFromDensityInternalEnergy(rho, sie);
+          if (!isClose(T_inv, T, 1e-6)) nwrong += 1;
+          if (!isClose(P_inv, P, 1e-6)) nwrong += 1;
+        }
+      }
+      REQUIRE(nwrong == 0);
+    }
+    steel.Finalize();
+  }
 }
 
 // Disabling these tests for now as the DependsRhoSie code is not well-maintained
@@ -256,6 +586,122 @@ SCENARIO("SpinerEOS depends on rho and sie", "[SpinerEOS],[DependsRhoSie]") {
     steelEOS_host.Finalize(); // cleans up host memory
     steelEOS.Finalize();      // cleans up device memory
   }
+
+  GIVEN("SpinerEOSes for steel depending on rho and T and on rho and sie") {
+    SpinerEOSDependsRhoSie eos_rhoSie(eosName, steelID);
+    SpinerEOSDependsRhoT eos_rhoT(eosName, steelID);
+    THEN("They agree on the entropy") {
+      for (const Real rho : {2.0, 8.0}) {
+        for (const Real T : {1e3, 1e5}) {
+          const Real S = eos_rhoT.EntropyFromDensityTemperature(rho, T);
+          const Real sie = eos_rhoT.InternalEnergyFromDensityTemperature(rho, T);
+          const Real cv = eos_rhoT.SpecificHeatFromDensityTemperature(rho, T);
+          REQUIRE(std::abs(eos_rhoSie.EntropyFromDensityTemperature(rho, T) - S) <
+                  1e-6 * cv);
+          // The rho-sie table interpolates in energy rather than temperature
+          REQUIRE(std::abs(eos_rhoSie.EntropyFromDensityInternalEnergy(rho, sie) - S) <
+                  5e-2 * cv);
+        }
+      }
+    }
+    eos_rhoSie.Finalize();
+    eos_rhoT.Finalize();
+  }
+
+  GIVEN("A SpinerEOSDependsRhoSie for steel") {
+    SpinerEOSDependsRhoSie eos(eosName, steelID);
+    THEN("Tabulated derivatives agree with the individual lookups") {
+      for (const Real rho : {2.0, 8.0}) {
+        for (const Real sie : {1e10, 1e12}) {
+          const auto d = eos.DerivativesFromDensityInternalEnergy(rho, sie);
+          const Real cv = eos.SpecificHeatFromDensityInternalEnergy(rho, sie);
+          REQUIRE(isClose(d.cv, cv, 1e-12));
+          REQUIRE(isClose(d.gruneisen,
+                          eos.GruneisenParamFromDensityInternalEnergy(rho, sie), 1e-12));
+        }
+      }
+    }
+    eos.Finalize();
+  }
+
+  GIVEN("A SpinerEOSDependsRhoSie and a copy at the fast accuracy tier") {
+    EOS eos_default = SpinerEOSDependsRhoSie(eosName, steelID);
+    EOS eos_fast = eos_default;
+    eos_fast.SetAccuracy(AccuracyParams(AccuracyTier::Fast));
+    THEN("Only the copy changes its accuracy") {
+      REQUIRE(eos_fast.GetAccuracy().root_max_iter ==
+              AccuracyParams(AccuracyTier::Fast).root_max_iter);
+      REQUIRE(eos_default.GetAccuracy().root_max_iter == AccuracyParams().root_max_iter);
+      AND_THEN("Inversions at the fast tier agree to its tolerance") {
+        for (const Real press : {1e10, 1e12}) {
+          for (const Real T : {1e3, 1e5}) {
+            Real rho_fast, sie_fast, rho, sie;
+            eos_fast.DensityEnergyFromPressureTemperature(press, T, np<Real>(),
+                                                          rho_fast, sie_fast);
+            eos_default.DensityEnergyFromPressureTemperature(press, T, np<Real>(), rho,
+                                                             sie);
+            REQUIRE(isClose(rho_fast, rho, 1e-6));
+            const Real T_fast = eos_fast.TemperatureFromDensityPressure(rho, press);
+            REQUIRE(isClose(T_fast, T, 1e-6));
+          }
+        }
+      }
+    }
+    // The copy shares the tables
+    eos_default.Finalize();
+  }
+
+  GIVEN("A modified EOS and the same EOS with its modifiers baked in") {
+    using singularity::ShiftedEOS;
+    using singularity::UnitSystem;
+    using Modified = UnitSystem<ShiftedEOS<SpinerEOSDependsRhoSie>>;
+    // Power-of-two units re-grid exactly with fast logs as well
+    constexpr Real rho_unit = 4;
+    constexpr Real sie_unit = 1 << 20;
+    constexpr Real temp_unit = 8;
+    constexpr Real shift = 1e10;
+    auto make = [&]() {
+      return Modified(ShiftedEOS<SpinerEOSDependsRhoSie>(
+                          SpinerEOSDependsRhoSie(eosName, steelID), shift),
+                      singularity::eos_units_init::thermal_units_init_tag, rho_unit,
+                      sie_unit, temp_unit);
+    };
+    Modified modified = make();
+    SpinerEOSDependsRhoSie baked = singularity::EOSBuilder::BakeModifiers(make());
+    THEN("They agree to round-off") {
+      for (const Real rho : {0.5, 2.0, 8.0}) {
+        for (const Real T : {30.0, 1e3, 1e5}) {
+          const Real sie = modified.InternalEnergyFromDensityTemperature(rho, T);
+          REQUIRE(
+              isClose(baked.InternalEnergyFromDensityTemperature(rho, T), sie, 1e-10));
+          REQUIRE(isClose(baked.PressureFromDensityTemperature(rho, T),
+                          modified.PressureFromDensityTemperature(rho, T), 1e-10));
+          const Real Te = modified.TemperatureFromDensityInternalEnergy(rho, sie);
+          REQUIRE(
+              isClose(baked.TemperatureFromDensityInternalEnergy(rho, sie), Te, 1e-10));
+          REQUIRE(isClose(baked.PressureFromDensityInternalEnergy(rho, sie),
+                          modified.PressureFromDensityInternalEnergy(rho, sie), 1e-10));
+        }
+      }
+    }
+    modified.Finalize();
+    baked.Finalize();
+  }
+}
+
+SCENARIO("Which modifier stacks can be baked", "[SpinerEOS],[BakeModifiers]") {
+  using singularity::ScaledEOS;
+  using singularity::ShiftedEOS;
+  using singularity::UnitSystem;
+  using singularity::EOSBuilder::CanBakeModifiers;
+  STATIC_REQUIRE(CanBakeModifiers<SpinerEOSDependsRhoT>);
+  STATIC_REQUIRE(CanBakeModifiers<UnitSystem<ShiftedEOS<SpinerEOSDependsRhoT>>>);
+  STATIC_REQUIRE(CanBakeModifiers<ShiftedEOS<SpinerEOSDependsRhoSie>>);
+  // ScaledEOS leaves the specific heat unscaled, which no table reproduces
+  STATIC_REQUIRE(!CanBakeModifiers<ScaledEOS<SpinerEOSDependsRhoT>>);
+  STATIC_REQUIRE(!CanBakeModifiers<UnitSystem<ScaledEOS<SpinerEOSDependsRhoSie>>>);
+  // Only tabulated models can absorb a transform
+  STATIC_REQUIRE(!CanBakeModifiers<ShiftedEOS<singularity::IdealGas>>);
 }
 #endif // SINGULARITY_USE_EOSPAC
 #endif // SINGULARITY_TEST_SESAME
@@ -13,6 +13,7 @@
 //------------------------------------------------------------------------------
 
 #include <array>
+#include <cmath>
 
 #include <ports-of-call/portability.hpp>
 #include <ports-of-call/portable_arrays.hpp>
@@ -380,3 +381,256 @@ SCENARIO("Vector EOS", "[VectorEOS][IdealGas]") {
     }
   }
 }
+
+// Runs a vector InvertState over host arrays and returns the results on the host
+template <typename EOS_t, std::size_t N>
+void InvertStates(const EOS_t &eos, const singularity::InputPair pair,
+                  const std::array<Real, N> &x, const std::array<Real, N> &y,
+                  std::array<Real, N> &rho, std::array<Real, N> &temp,
+                  std::array<Real, N> &sie, std::array<Real, N> &press,
+                  const unsigned long output) {
+#ifdef PORTABILITY_STRATEGY_KOKKOS
+  using HostView_t = Kokkos::View<Real *, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>;
+  Kokkos::View<Real *> v_x("x", N), v_y("y", N), v_rho("rho", N), v_temp("temp", N),
+      v_sie("sie", N), v_press("press", N), v_cv("cv", N), v_bmod("bmod", N);
+  Kokkos::deep_copy(v_x, HostView_t(const_cast<Real *>(x.data()), N));
+  Kokkos::deep_copy(v_y, HostView_t(const_cast<Real *>(y.data()), N));
+  eos.InvertState(pair, v_x, v_y, v_rho, v_temp, v_sie, v_press, v_cv, v_bmod, N,
+                  output);
+  Kokkos::fence();
+  Kokkos::deep_copy(HostView_t(rho.data(), N), v_rho);
+  Kokkos::deep_copy(HostView_t(temp.data(), N), v_temp);
+  Kokkos::deep_copy(HostView_t(sie.data(), N), v_sie);
+  Kokkos::deep_copy(HostView_t(press.data(), N), v_press);
+#else
+  std::array<Real, N> cv, bmod;
+  eos.InvertState(pair, x.data(), y.data(), rho.data(), temp.data(), sie.data(),
+                  press.data(), cv.data(), bmod.data(), N, output);
+#endif // PORTABILITY_STRATEGY_KOKKOS
+}
+
+SCENARIO("Vector EOS inversions", "[VectorEOS][InvertState]") {
+  using singularity::InputPair;
+  using singularity::ShiftedEOS;
+  namespace thermalqs = singularity::thermalqs;
+  constexpr int num = 3;
+  constexpr Real Cv = 5.0;
+  constexpr Real gm1 = 0.4;
+  constexpr Real tol = 1e-10;
+  const IdealGas gas(gm1, Cv);
+
+  // Consistent states of the ideal gas
+  constexpr std::array<Real, num> density{1.0, 2.0, 5.0};
+  constexpr std::array<Real, num> temperature{1.0, 2.0, 3.0};
+  constexpr std::array<Real, num> energy{5.0, 10.0, 15.0};
+  constexpr std::array<Real, num> pressure{2.0, 8.0, 30.0};
+  std::array<Real, num> entropy;
+  for (int i = 0; i < num; ++i) {
+    entropy[i] = gas.EntropyFromDensityTemperature(density[i], temperature[i]);
+  }
+  const std::array<Real, num> unset{-1, -1, -1};
+
+  auto check_state = [&](const std::array<Real, num> &rho,
+                         const std::array<Real, num> &temp,
+                         const std::array<Real, num> &sie,
+                         const std::array<Real, num> &press) {
+    for (int i = 0; i < num; ++i) {
+      INFO("i: " << i << " rho: " << rho[i] << " T: " << temp[i] << " sie: " << sie[i]
+                 << " P: " << press[i]);
+      CHECK(isClose(rho[i], density[i], tol));
+      CHECK(isClose(temp[i], temperature[i], tol));
+      CHECK(isClose(sie[i], energy[i], tol));
+      CHECK(isClose(press[i], pressure[i], tol));
+    }
+  };
+
+  // The ideal gas inverts in closed form. Shifting by zero gives the
+  // same gas, which instead goes through the root finder in EosBase.
+  auto check_eos = [&](const auto &eos) {
+    std::array<Real, num> rho, temp, sie, press;
+    WHEN("States are inverted from density and pressure") {
+      rho = density;
+      press = pressure;
+      InvertStates(eos, InputPair::DensityPressure, density, pressure, rho, temp, sie,
+                   press, thermalqs::temperature | thermalqs::specific_internal_energy);
+      THEN("The full state is recovered") { check_state(rho, temp, sie, press); }
+    }
+    WHEN("States are inverted from pressure and temperature") {
+      temp = temperature;
+      press = pressure;
+      InvertStates(eos, InputPair::PressureTemperature, pressure, temperature, rho, temp,
+                   sie, press, thermalqs::density | thermalqs::specific_internal_energy);
+      THEN("The full state is recovered") { check_state(rho, temp, sie, press); }
+    }
+    WHEN("States are inverted from pressure and energy") {
+      InvertStates(eos, InputPair::PressureEnergy, pressure, energy, rho, temp, sie,
+                   press, thermalqs::all_values);
+      THEN("The full state is recovered") { check_state(rho, temp, sie, press); }
+    }
+    WHEN("States are inverted from density and entropy") {
+      InvertStates(eos, InputPair::DensityEntropy, density, entropy, rho, temp, sie,
+                   press, thermalqs::all_values);
+      THEN("The full state is recovered") { check_state(rho, temp, sie, press); }
+    }
+    WHEN("Only some outputs are requested") {
+      rho = unset;
+      sie = unset;
+      press = unset;
+      InvertStates(eos, InputPair::DensityPressure, density, pressure, rho, temp, sie,
+                   press, thermalqs::temperature);
+      THEN("The others are left untouched") {
+        for (int i = 0; i < num; ++i) {
+          CHECK(isClose(temp[i], temperature[i], tol));
+          CHECK(rho[i] == unset[i]);
+          CHECK(sie[i] == unset[i]);
+          CHECK(press[i] == unset[i]);
+        }
+      }
+    }
+  };
+
+  GIVEN("An ideal gas in a variant") { check_eos(EOS(gas).GetOnDevice()); }
+  GIVEN("An ideal gas without closed-form inverses") {
+    using ShiftedGas = singularity::Variant<ShiftedEOS<IdealGas>>;
+    check_eos(ShiftedGas(ShiftedEOS<IdealGas>(IdealGas(gm1, Cv), 0)).GetOnDevice());
+  }
+  GIVEN("A batch with a dense state and a state with no solution") {
+    using ShiftedGas = singularity::Variant<ShiftedEOS<IdealGas>>;
+    const auto eos =
+        ShiftedGas(ShiftedEOS<IdealGas>(IdealGas(gm1, Cv), 0)).GetOnDevice();
+    // The ideal gas pressure is never negative
+    const std::array<Real, num> rho_in{1.0, 2.0, 1e10};
+    const std::array<Real, num> press_in{2.0, -1.0, 2e11};
+    std::array<Real, num> rho, temp, sie, press;
+    InvertStates(eos, InputPair::DensityPressure, rho_in, press_in, rho, temp, sie,
+                 press, thermalqs::all_values);
+    THEN("The failed state is NaN and the others are recovered") {
+      CHECK(isClose(temp[0], 1.0, tol));
+      CHECK(std::isnan(rho[1]));
+      CHECK(std::isnan(temp[1]));
+      CHECK(std::isnan(sie[1]));
+      CHECK(std::isnan(press[1]));
+      CHECK(isClose(temp[2], 10.0, tol));
+    }
+    WHEN("The dense state is inverted from pressure and energy") {
+      InvertStates(eos, InputPair::PressureEnergy, press_in, energy, rho, temp, sie,
+                   press, thermalqs::density);
+      THEN("Its density is found beyond the densities of solids") {
+        CHECK(isClose(rho[2], 2e11 / (gm1 * energy[2]), tol));
+      }
+    }
+  }
+  GIVEN("A Vinet solid, which has no inverse of its own for pressure and temperature") {
+    using VinetEOS = singularity::Variant<singularity::Vinet>;
+    constexpr Real Mbcc_per_g = 1e12;
+    const Real d2to40[39] = {};
+    const VinetEOS host_eos = singularity::Vinet(
+        8.93, 298.0, 1.3448466 * Mbcc_per_g, 4.956, 5.19245e-05, 0.383e-05 * Mbcc_per_g,
+        0.0, 5.05e-04 * Mbcc_per_g, d2to40);
+    const auto eos = host_eos.GetOnDevice();
+    // Compressed states, where P(rho, T) increases with density
+    const std::array<Real, num> rho_true{9.5, 10.0, 12.0};
+    const std::array<Real, num> temp_true{298.0, 500.0, 1000.0};
+    std::array<Real, num> rho, temp, sie, press, press_true;
+    for (int i = 0; i < num; ++i) {
+      press_true[i] = host_eos.PressureFromDensityTemperature(rho_true[i], temp_true[i]);
+    }
+    InvertStates(eos, InputPair::PressureTemperature, press_true, temp_true, rho, temp,
+                 sie, press, thermalqs::density);
+    THEN("The density is found by root finding P(rho, T)") {
+      for (int i = 0; i < num; ++i) {
+        CHECK(isClose(rho[i], rho_true[i], tol));
+      }
+    }
+  }
+}
+
+// Runs a vector derivative query over host arrays and returns the results on the host
+template <typename EOS_t, std::size_t N>
+void ComputeDerivatives(const EOS_t &eos, const bool from_temperature,
+                        const std::array<Real, N> &rho, const std::array<Real, N> &y,
+                        std::array<singularity::ThermoDerivatives, N> &derivs) {
+  using singularity::ThermoDerivatives;
+#ifdef PORTABILITY_STRATEGY_KOKKOS
+  using HostView_t = Kokkos::View<Real *, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>;
+  using HostDerivs_t =
+      Kokkos::View<ThermoDerivatives *, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>;
+  Kokkos::View<Real *> v_rho("rho", N), v_y("y", N);
+  Kokkos::View<ThermoDerivatives *> v_derivs("derivs", N);
+  Kokkos::deep_copy(v_rho, HostView_t(const_cast<Real *>(rho.data()), N));
+  Kokkos::deep_copy(v_y, HostView_t(const_cast<Real *>(y.data()), N));
+  if (from_temperature) {
+    eos.DerivativesFromDensityTemperature(v_rho, v_y, v_derivs, N);
+  } else {
+    eos.DerivativesFromDensityInternalEnergy(v_rho, v_y, v_derivs, N);
+  }
+  Kokkos::fence();
+  Kokkos::deep_copy(HostDerivs_t(derivs.data(), N), v_derivs);
+#else
+  if (from_temperature) {
+    eos.DerivativesFromDensityTemperature(rho.data(), y.data(), derivs.data(), N);
+  } else {
+    eos.DerivativesFromDensityInternalEnergy(rho.data(), y.data(), derivs.data(), N);
+  }
+#endif // PORTABILITY_STRATEGY_KOKKOS
+}
+
+SCENARIO("Vector EOS thermodynamic derivatives", "[VectorEOS][Derivatives]") {
+  using singularity::StiffGas;
+  using singularity::ThermoDerivatives;
+  constexpr int num = 3;
+  constexpr Real Cv = 5.0;
+  constexpr Real gm1 = 0.4;
+  constexpr Real tol = 1e-12;
+  constexpr std::array<Real, num> density{1.0, 2.0, 5.0};
+  constexpr std::array<Real, num> temperature{1.0, 2.0, 3.0};
+  constexpr std::array<Real, num> energy{5.0, 10.0, 15.0};
+
+  GIVEN("An ideal gas in a variant") {
+    EOS eos = EOS(IdealGas(gm1, Cv)).GetOnDevice();
+    std::array<ThermoDerivatives, num> derivs;
+    auto check_derivs = [&]() {
+      for (int i = 0; i < num; ++i) {
+        INFO("i: " << i << " rho: " << density[i] << " sie: " << energy[i]);
+        CHECK(isClose(derivs[i].dPdRho, gm1 * energy[i], tol));
+        CHECK(isClose(derivs[i].dPdE, gm1 * density[i], tol));
+        CHECK(derivs[i].dTdRho == 0);
+        CHECK(isClose(derivs[i].dTdE, 1.0 / Cv, tol));
+        CHECK(derivs[i].dEdRho == 0);
+        CHECK(isClose(derivs[i].cv, Cv, tol));
+        CHECK(isClose(derivs[i].gruneisen, gm1, tol));
+      }
+    };
+    WHEN("The derivatives are computed from density and energy") {
+      ComputeDerivatives(eos, false, density, energy, derivs);
+      THEN("They match the closed forms") { check_derivs(); }
+    }
+    WHEN("The derivatives are computed from density and temperature") {
+      ComputeDerivatives(eos, true, density, temperature, derivs);
+      THEN("They match the closed forms") { check_derivs(); }
+    }
+  }
+
+  GIVEN("A stiffened gas, which uses the finite-difference default") {
+    constexpr Real Pinf = 1.0;
+    constexpr Real qq = 0.5;
+    constexpr Real fd_tol = 1e-4;
+    const StiffGas eos(gm1, Cv, Pinf, qq);
+    THEN("The derivatives match the closed forms") {
+      for (int i = 0; i < num; ++i) {
+        const Real rho = density[i];
+        const Real sie = energy[i];
+        INFO("i: " << i << " rho: " << rho << " sie: " << sie);
+        const ThermoDerivatives d = eos.DerivativesFromDensityInternalEnergy(rho, sie);
+        const Real dTdRho = Pinf / (rho * rho * Cv);
+        CHECK(isClose(d.dPdRho, gm1 * (sie - qq), fd_tol));
+        CHECK(isClose(d.dPdE, gm1 * rho, tol));
+        CHECK(isClose(d.dTdRho, dTdRho, fd_tol));
+        CHECK(isClose(d.dTdE, 1.0 / Cv, tol));
+        CHECK(isClose(d.dEdRho, -Cv * dTdRho, fd_tol));
+        CHECK(isClose(d.cv, Cv, tol));
+        CHECK(isClose(d.gruneisen, gm1, tol));
+      }
+    }
+  }
+}
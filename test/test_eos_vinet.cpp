@@ -478,3 +478,30 @@ SCENARIO("Vinet EOS SetUp", "[VectorEOS][VinetEOS]") {
     }
   }
 }
+
+#ifdef SINGULARITY_TEST_SIMD_PACKS
+SCENARIO("Vinet EOS evaluated on SIMD packs", "[VinetEOS][SIMD]") {
+  GIVEN("A Vinet EOS for copper") {
+    constexpr Real Mbcc_per_g = 1e12;
+    constexpr Real rho0 = 8.93;
+    constexpr Real d2to40[39] = {0., 0., 0., 0., 0., 0., 0., 0., 0., 0., 0., 0., 0.,
+                                 0., 0., 0., 0., 0., 0., 0., 0., 0., 0., 0., 0., 0.,
+                                 0., 0., 0., 0., 0., 0., 0., 0., 0., 0., 0., 0., 0.};
+    const Vinet eos(rho0, 298.0, 1.3448466 * Mbcc_per_g, 4.956, 5.19245e-05,
+                    0.383e-05 * Mbcc_per_g, 0.0, 5.05e-04 * Mbcc_per_g, d2to40);
+    const simd_pack_t rho([](const int i) { return rho0 * (0.8 + 0.1 * i); });
+    const simd_pack_t temp([](const int i) { return 300.0 + 500.0 * i; });
+    const simd_pack_t sie = eos.InternalEnergyFromDensityTemperature(rho, temp);
+    THEN("Each lane agrees with a scalar call") {
+      CHECK_PACK_LANES(eos, PressureFromDensityTemperature, rho, temp);
+      CHECK_PACK_LANES(eos, EntropyFromDensityTemperature, rho, temp);
+      CHECK_PACK_LANES(eos, BulkModulusFromDensityTemperature, rho, temp);
+      CHECK_PACK_LANES(eos, TExpansionCoeffFromDensityTemperature, rho, temp);
+      CHECK_PACK_LANES(eos, PressureFromDensityInternalEnergy, rho, sie);
+      CHECK_PACK_LANES(eos, TemperatureFromDensityInternalEnergy, rho, sie);
+      CHECK_PACK_LANES(eos, EntropyFromDensityInternalEnergy, rho, sie);
+      CHECK_PACK_LANES(eos, GruneisenParamFromDensityInternalEnergy, rho, sie);
+    }
+  }
+}
+#endif // SINGULARITY_TEST_SIMD_PACKS
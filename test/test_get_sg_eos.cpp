@@ -58,7 +58,7 @@ int run_sg_get_eos_tests() {
   Real vfrac_true[NMAT], ie_true[NMAT];
   get_sg_eos(NMAT, 1, 1, -1, eos_offset, eoss, &cell_offset, &P_true, &pmax, &v_true,
              &spvol, &sie_tot_true, &T_true_ev, &bmod, &dpde, &cv, mfrac, vfrac_true,
-             ie_true, nullptr, nullptr, nullptr);
+             ie_true, nullptr, nullptr, nullptr, 1.e-12);
   Real sie_tot_check = 0.0;
   for (int m = 0; m < NMAT; ++m) {
     const Real r_m = mfrac[m] / vfrac_true[m];
@@ -85,7 +85,7 @@ int run_sg_get_eos_tests() {
   Real p_check, vfrac_check[NMAT], ie_check[NMAT];
   get_sg_eos(NMAT, 1, 1, -3, eos_offset, eoss, &cell_offset, &p_check, &pmax, &v_true,
              &spvol, &sie_tot_check, &T_true_ev, &bmod, &dpde, &cv, mfrac, vfrac_check,
-             ie_check, nullptr, nullptr, nullptr);
+             ie_check, nullptr, nullptr, nullptr, 1.e-12);
   // check output pressure and sie, indicate failure if relative err is too large
   if (std::abs(P_true - p_check) / std::abs(P_true) > 1.e-5 ||
       std::abs(sie_tot_true - sie_tot_check) / std::abs(sie_tot_true) > 1.e-5) {
@@ -109,7 +109,7 @@ int run_sg_get_eos_tests() {
   Real t_check;
   get_sg_eos(NMAT, 1, 1, -2, eos_offset, eoss, &cell_offset, &P_true, &pmax, &v_true,
              &spvol, &sie_tot_check, &t_check, &bmod, &dpde, &cv, mfrac, vfrac_check,
-             ie_check, nullptr, nullptr, nullptr);
+             ie_check, nullptr, nullptr, nullptr, 1.e-12);
   // check output temperature and sie, indicate failure if relative err is too large
   if (std::abs(T_true_ev - t_check) / std::abs(T_true_ev) > 1.e-5 ||
       std::abs(sie_tot_true - sie_tot_check) / std::abs(sie_tot_true) > 1.e-5) {
@@ -129,6 +129,83 @@ int run_sg_get_eos_tests() {
     printf("p-T: vr: %e | sr: %e\n", max_vfrac_resid, max_sie_resid);
     nfails += 1;
   }
+  // do rho-sie input solve
+  Real sie_tot_in = sie_tot_true;
+  get_sg_eos(NMAT, 1, 1, 1, eos_offset, eoss, &cell_offset, &p_check, &pmax, &v_true,
+             &spvol, &sie_tot_in, &t_check, &bmod, &dpde, &cv, mfrac, vfrac_check,
+             ie_check, nullptr, nullptr, nullptr, 1.e-12);
+  // check output pressure and temperature, indicate failure if relative err is too large
+  if (std::abs(P_true - p_check) / std::abs(P_true) > 1.e-5 ||
+      std::abs(T_true_ev - t_check) / std::abs(T_true_ev) > 1.e-5) {
+    printf("r-e: p_true: %e | p_check: %e\n", P_true, p_check);
+    printf("r-e: t_true: %e | t_check: %e\n", T_true_ev, t_check);
+    nfails += 1;
+  }
+  max_vfrac_resid = 0.0;
+  for (int m = 0; m < NMAT; ++m) {
+    max_vfrac_resid = std::max(max_vfrac_resid, std::abs(vfrac_true[m] - vfrac_check[m]) /
+                                                    std::abs(vfrac_true[m]));
+  }
+  if (max_vfrac_resid > 1.e-5) {
+    printf("r-e: vr: %e\n", max_vfrac_resid);
+    nfails += 1;
+  }
+  // do rho-sie input solve with the material energies held fixed at
+  // those of the P-T solve, which are already in equilibrium
+  Real ie_fixed[NMAT];
+  for (int m = 0; m < NMAT; ++m) {
+    ie_fixed[m] = ie_true[m];
+  }
+  sie_tot_in = sie_tot_true;
+  get_sg_eos(NMAT, 1, 1, 2, eos_offset, eoss, &cell_offset, &p_check, &pmax, &v_true,
+             &spvol, &sie_tot_in, &t_check, &bmod, &dpde, &cv, mfrac, vfrac_check,
+             ie_fixed, nullptr, nullptr, nullptr, 1.e-12);
+  // check output pressure and temperature, indicate failure if relative err is too large
+  if (std::abs(P_true - p_check) / std::abs(P_true) > 1.e-5 ||
+      std::abs(T_true_ev - t_check) / std::abs(T_true_ev) > 1.e-5) {
+    printf("r-e fixed sie: p_true: %e | p_check: %e\n", P_true, p_check);
+    printf("r-e fixed sie: t_true: %e | t_check: %e\n", T_true_ev, t_check);
+    nfails += 1;
+  }
+  max_vfrac_resid = 0.0;
+  max_sie_resid = 0.0;
+  for (int m = 0; m < NMAT; ++m) {
+    max_vfrac_resid = std::max(max_vfrac_resid, std::abs(vfrac_true[m] - vfrac_check[m]) /
+                                                    std::abs(vfrac_true[m]));
+    max_sie_resid = std::max(max_sie_resid,
+                             std::abs(ie_true[m] - ie_fixed[m]) / std::abs(ie_true[m]));
+  }
+  if (max_vfrac_resid > 1.e-5 || max_sie_resid > 1.e-12) {
+    printf("r-e fixed sie: vr: %e | sr: %e\n", max_vfrac_resid, max_sie_resid);
+    nfails += 1;
+  }
+  // repeat the rho-sie input solve, requesting the per cell cost
+  Real cost = -1.0;
+  sie_tot_in = sie_tot_true;
+  get_sg_eos_with_cost(NMAT, 1, 1, 1, eos_offset, eoss, &cell_offset, &p_check, &pmax,
+                       &v_true, &spvol, &sie_tot_in, &t_check, &bmod, &dpde, &cv, mfrac,
+                       vfrac_check, ie_check, nullptr, nullptr, nullptr, 1.e-12, &cost);
+  // a mixed cell costs at least one evaluation per material
+  if (cost < NMAT) {
+    printf("r-e: cost: %e\n", cost);
+    nfails += 1;
+  }
+  // repeat the rho-sie input solve asynchronously
+  Real p_async, t_async, vfrac_async[NMAT], ie_async[NMAT];
+  sie_tot_in = sie_tot_true;
+  sg_eos_request *request = nullptr;
+  get_sg_eos_async(NMAT, 1, 1, 1, eos_offset, eoss, &cell_offset, &p_async, &pmax,
+                   &v_true, &spvol, &sie_tot_in, &t_async, &bmod, &dpde, &cv, mfrac,
+                   vfrac_async, ie_async, nullptr, nullptr, nullptr, 1.e-12, nullptr,
+                   &request);
+  const int async_fails = get_sg_eos_wait(request);
+  if (async_fails != 0 || request != nullptr || get_sg_eos_test(request) != 1 ||
+      std::abs(p_async - p_check) > 1.e-12 * std::abs(p_check) ||
+      std::abs(t_async - t_check) > 1.e-12 * std::abs(t_check)) {
+    printf("r-e async: p_async: %e | p_check: %e\n", p_async, p_check);
+    printf("r-e async: t_async: %e | t_check: %e\n", t_async, t_check);
+    nfails += 1;
+  }
   return nfails;
 }
 #endif
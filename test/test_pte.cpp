@@ -12,6 +12,7 @@
 // publicly and display publicly, and to permit others to do so.
 //------------------------------------------------------------------------------
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <memory>
@@ -33,6 +34,7 @@ using DataBox = Spiner::DataBox<Real>;
 int main(int argc, char *argv[]) {
 
   int nsuccess = 0;
+  int nsuccess_sie = 0;
 #ifdef PORTABILITY_STRATEGY_KOKKOS
   Kokkos::initialize();
 #endif
@@ -57,8 +59,9 @@ int main(int argc, char *argv[]) {
     using EOSAccessor = LinearIndexer<decltype(eos_v)>;
     EOSAccessor eos(eos_v);
 
-    // scratch required for PTE solver
-    auto nscratch_vars = PTESolverRhoTRequiredScratch(NMAT);
+    // scratch required for the PTE solvers
+    auto nscratch_vars = std::max(PTESolverRhoTRequiredScratch(NMAT),
+                                  PTESolverFixedSieRequiredScratch(NMAT));
 
     // state vars
 #ifdef PORTABILITY_STRATEGY_KOKKOS
@@ -198,11 +201,71 @@ int main(int argc, char *argv[]) {
       std::cout << i << "\t" << hist_vh[i] << "\n";
     }
     std::cout << std::endl;
+
+    // The same kind of states, equilibrated in pressure with each
+    // material's energy held fixed
+    for (int n = 0; n < NTRIAL; n++) {
+      Indexer2D<decltype(rho_hm)> r(n, rho_hm);
+      Indexer2D<decltype(vfrac_hm)> vf(n, vfrac_hm);
+      Indexer2D<decltype(sie_hm)> e(n, sie_hm);
+      Indexer2D<decltype(temp_hm)> t(n, temp_hm);
+      set_state(r, vf, e, t, eos_h);
+    }
+#ifdef PORTABILITY_STRATEGY_KOKKOS
+    Kokkos::deep_copy(rho_v, rho_vh);
+    Kokkos::deep_copy(vfrac_v, vfrac_vh);
+    Kokkos::deep_copy(sie_v, sie_vh);
+    Kokkos::deep_copy(temp_v, temp_vh);
+    Kokkos::View<int, atomic_view> nsuccess_sie_d("n fixed sie successes");
+#else
+    PortableMDArray<int> nsuccess_sie_d(&nsuccess_sie, 1);
+#endif
+
+    std::cout << "Starting fixed energy PTE with " << NTRIAL << " trials." << std::endl;
+    portableFor(
+        "PTE fixed sie", 0, NTRIAL, PORTABLE_LAMBDA(const int &t) {
+          Real *lambda[NMAT];
+          Real sie0[NMAT];
+          Indexer2D<decltype(rho_d)> rho(t, rho_d);
+          Indexer2D<decltype(vfrac_d)> vfrac(t, vfrac_d);
+          Indexer2D<decltype(sie_d)> sie(t, sie_d);
+          Indexer2D<decltype(temp_d)> temp(t, temp_d);
+          Indexer2D<decltype(press_d)> press(t, press_d);
+          for (int i = 0; i < NMAT; i++) {
+            lambda[i] = nullptr;
+            sie0[i] = sie[i];
+          }
+
+          auto method =
+              PTESolverFixedSie<EOSAccessor, Indexer2D<decltype(rho_d)>,
+                                decltype(lambda)>(NMAT, eos, 1.0, rho, vfrac, sie, temp,
+                                                  press, lambda,
+                                                  &scratch_d(t * nscratch_vars));
+          bool success = PTESolver(method);
+          // Equal pressures, with every material at the temperature of
+          // its unchanged energy
+          for (int i = 0; i < NMAT; i++) {
+            const Real T = eos[i].TemperatureFromDensityInternalEnergy(rho[i], sie[i]);
+            success = success && (sie[i] == sie0[i]) &&
+                      (std::abs(press[i] - press[0]) <=
+                       1e-5 * (std::abs(press[i]) + std::abs(press[0]))) &&
+                      (std::abs(temp[i] - T) <= 1e-12 * T);
+          }
+          if (success) {
+            nsuccess_sie_d() += 1;
+          }
+        });
+#ifdef PORTABILITY_STRATEGY_KOKKOS
+    Kokkos::fence();
+    Kokkos::deep_copy(nsuccess_sie, nsuccess_sie_d);
+#endif
+    std::cout << "Fixed energy success: " << nsuccess_sie
+              << "   Failure: " << NTRIAL - nsuccess_sie << std::endl;
   }
 #ifdef PORTABILITY_STRATEGY_KOKKOS
   Kokkos::finalize();
 #endif
 
   // poor-man's ctest integration
-  return (nsuccess >= 0.5 * NTRIAL) ? 0 : 1;
+  return (nsuccess >= 0.5 * NTRIAL && nsuccess_sie >= 0.5 * NTRIAL) ? 0 : 1;
 }
@@ -0,0 +1,292 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#ifdef SINGULARITY_BUILD_CLOSURE
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <singularity-eos/closure/mixed_cell_models.hpp>
+#include <singularity-eos/eos/eos.hpp>
+
+#ifndef CATCH_CONFIG_FAST_COMPILE
+#define CATCH_CONFIG_FAST_COMPILE
+#include <catch2/catch_test_macros.hpp>
+#endif
+
+using singularity::EOS;
+using singularity::IdealGas;
+using singularity::mix_impl::solve_Ax_b_small;
+
+// A nonsymmetric system with a zero on the diagonal, so that the
+// elimination must pivot, and entries spanning the magnitudes of a
+// scaled PTE Jacobian
+template <int N>
+void FillSystem(Real A[N * N], Real b[N]) {
+  for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+      A[i * N + j] = std::sin(1.0 + 3 * i + 7 * j) * std::pow(10.0, (i + 2 * j) % 3);
+    }
+    A[i * N + i] += 4.0 * N;
+    b[i] = std::cos(2.0 + i);
+  }
+  A[0] = 0;
+}
+
+// Largest difference between the fixed-size solve in precision T and a
+// reference LU solve with partial pivoting, relative to the largest
+// component
+template <int N, typename T = Real>
+Real MaxDifferenceFromReference() {
+  Real A[N * N], b[N];
+  FillSystem<N>(A, b);
+  Real A_small[N * N], x_small[N];
+  for (int i = 0; i < N * N; ++i)
+    A_small[i] = A[i];
+  for (int i = 0; i < N; ++i)
+    x_small[i] = b[i];
+  solve_Ax_b_small<N, T>(A_small, x_small);
+
+  Real x_ref[N];
+#ifndef SINGULARITY_USE_KOKKOSKERNELS
+  // The Eigen path used for larger systems
+  Eigen::Map<Eigen::Matrix<Real, N, N, Eigen::RowMajor>> A_ref(A);
+  Eigen::Map<Eigen::Matrix<Real, N, 1>> b_ref(b);
+  Eigen::Map<Eigen::Matrix<Real, N, 1>> x(x_ref);
+  x = A_ref.partialPivLu().solve(b_ref);
+#else
+  // Without Eigen, Gaussian elimination with partial pivoting in full
+  // double precision
+  Real M[N][N + 1];
+  for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j)
+      M[i][j] = A[i * N + j];
+    M[i][N] = b[i];
+  }
+  for (int k = 0; k < N; ++k) {
+    int p = k;
+    for (int i = k + 1; i < N; ++i)
+      if (std::abs(M[i][k]) > std::abs(M[p][k])) p = i;
+    for (int j = 0; j <= N; ++j)
+      std::swap(M[k][j], M[p][j]);
+    for (int i = k + 1; i < N; ++i) {
+      const Real f = M[i][k] / M[k][k];
+      for (int j = k; j <= N; ++j)
+        M[i][j] -= f * M[k][j];
+    }
+  }
+  for (int i = N - 1; i >= 0; --i) {
+    x_ref[i] = M[i][N];
+    for (int j = i + 1; j < N; ++j)
+      x_ref[i] -= M[i][j] * x_ref[j];
+    x_ref[i] /= M[i][i];
+  }
+#endif // SINGULARITY_USE_KOKKOSKERNELS
+
+  Real xmax = 0;
+  Real diff = 0;
+  for (int i = 0; i < N; ++i) {
+    xmax = std::max(xmax, std::abs(x_ref[i]));
+    diff = std::max(diff, std::abs(x_small[i] - x_ref[i]));
+  }
+  return diff / xmax;
+}
+
+SCENARIO("Fixed-size solves of small PTE systems", "[PTE][LinearSolve]") {
+  constexpr Real tol = 1e-12;
+  GIVEN("Systems of two to five unknowns that require pivoting") {
+    THEN("The fixed-size solve agrees with a general LU solve") {
+      REQUIRE(MaxDifferenceFromReference<2>() < tol);
+      REQUIRE(MaxDifferenceFromReference<3>() < tol);
+      REQUIRE(MaxDifferenceFromReference<4>() < tol);
+      REQUIRE(MaxDifferenceFromReference<5>() < tol);
+    }
+    AND_THEN("A single precision solve agrees to single precision") {
+      constexpr Real single_tol = 1e-5;
+      REQUIRE(MaxDifferenceFromReference<2, float>() < single_tol);
+      REQUIRE(MaxDifferenceFromReference<3, float>() < single_tol);
+      REQUIRE(MaxDifferenceFromReference<4, float>() < single_tol);
+      REQUIRE(MaxDifferenceFromReference<5, float>() < single_tol);
+    }
+  }
+  GIVEN("A system with entries outside the range of float") {
+    Real A[4] = {1.e40, 1.0, 1.0, 2.0};
+    Real x_single[2] = {1.0, 1.0};
+    Real x_double[2] = {1.0, 1.0};
+    Real scr[4];
+    WHEN("It is solved with and without single precision requested") {
+      const bool ok_single =
+          singularity::mix_impl::solve_Ax_b_wscr(2, A, x_single, scr, true);
+      const bool ok_double = singularity::mix_impl::solve_Ax_b_wscr(2, A, x_double, scr);
+      THEN("The single precision request falls back to double precision") {
+        REQUIRE(ok_single);
+        REQUIRE(ok_double);
+        REQUIRE(x_single[0] == x_double[0]);
+        REQUIRE(x_single[1] == x_double[1]);
+      }
+    }
+  }
+  GIVEN("A system of four unknowns") {
+    Real A[16], b[4];
+    FillSystem<4>(A, b);
+    WHEN("It is solved through solve_Ax_b_wscr, as the PTE solvers do") {
+      Real A_copy[16], x[4], scr[8];
+      for (int i = 0; i < 16; ++i)
+        A_copy[i] = A[i];
+      for (int i = 0; i < 4; ++i)
+        x[i] = b[i];
+      const bool ok = singularity::mix_impl::solve_Ax_b_wscr(4, A_copy, x, scr);
+      THEN("The solution satisfies the original system") {
+        REQUIRE(ok);
+        for (int i = 0; i < 4; ++i) {
+          Real Ax = 0;
+          for (int j = 0; j < 4; ++j)
+            Ax += A[i * 4 + j] * x[j];
+          REQUIRE(std::abs(Ax - b[i]) < tol);
+        }
+      }
+    }
+  }
+}
+
+// The equilibrium of ideal gases is known in closed form, so the
+// solvers are checked against the exact answer.
+SCENARIO("PTE solves of small systems", "[PTE][LinearSolve]") {
+  GIVEN("Three ideal gases out of equilibrium") {
+    constexpr int nmat = 3;
+    const Real gm1[nmat] = {0.4, 2. / 3., 1.2};
+    const Real Cv[nmat] = {1.0, 2.0, 0.5};
+    std::vector<EOS> eos_vec;
+    for (int m = 0; m < nmat; ++m) {
+      eos_vec.push_back(IdealGas(gm1[m], Cv[m]));
+    }
+    EOS *eos = eos_vec.data();
+    Real rho_arr[nmat] = {1.0, 2.0, 0.5};
+    Real vfrac_arr[nmat] = {0.2, 0.5, 0.3};
+    Real sie_arr[nmat] = {1.0, 2.5, 0.3};
+    Real temp_arr[nmat], press_arr[nmat];
+    Real *rho = rho_arr;
+    Real *vfrac = vfrac_arr;
+    Real *sie = sie_arr;
+    Real *temp = temp_arr;
+    Real *press = press_arr;
+    Real *lambda[nmat] = {nullptr, nullptr, nullptr};
+    Real **lambdas = lambda;
+    // Sums over the partial densities rhobar = rho vfrac
+    Real rho_tot = 0;
+    Real usum = 0;
+    Real cvsum = 0;
+    Real psum = 0;
+    for (int m = 0; m < nmat; ++m) {
+      const Real rhobar = rho[m] * vfrac[m];
+      rho_tot += rhobar;
+      usum += rhobar * sie[m];
+      cvsum += rhobar * Cv[m];
+      psum += rhobar * gm1[m] * Cv[m];
+      temp[m] = eos[m].TemperatureFromDensityInternalEnergy(rho[m], sie[m]);
+      press[m] = eos[m].PressureFromDensityInternalEnergy(rho[m], sie[m]);
+    }
+    const auto params = singularity::AccuracyParams(singularity::AccuracyTier::Strict);
+    constexpr Real tol = 1e-8;
+
+    WHEN("Density and energy are held fixed") {
+      std::vector<Real> scratch(singularity::PTESolverRhoTRequiredScratch(nmat));
+      singularity::PTESolverRhoT<EOS *, Real *, Real **> method(
+          nmat, eos, 1.0, usum / rho_tot, rho, vfrac, sie, temp, press, lambdas,
+          scratch.data(), 0.0, params);
+      const bool converged = singularity::PTESolver(method);
+      THEN("The exact equilibrium is found") {
+        REQUIRE(converged);
+        const Real T = usum / cvsum;
+        const Real P = T * psum;
+        for (int m = 0; m < nmat; ++m) {
+          REQUIRE(std::abs(temp[m] - T) < tol * T);
+          REQUIRE(std::abs(press[m] - P) < tol * P);
+        }
+      }
+    }
+
+    WHEN("The solver is specialized on the number of materials") {
+      Real rho_dyn_arr[nmat], vfrac_dyn_arr[nmat], sie_dyn_arr[nmat];
+      Real temp_dyn_arr[nmat], press_dyn_arr[nmat];
+      for (int m = 0; m < nmat; ++m) {
+        rho_dyn_arr[m] = rho[m];
+        vfrac_dyn_arr[m] = vfrac[m];
+        sie_dyn_arr[m] = sie[m];
+        temp_dyn_arr[m] = temp[m];
+        press_dyn_arr[m] = press[m];
+      }
+      Real *rho_dyn = rho_dyn_arr;
+      Real *vfrac_dyn = vfrac_dyn_arr;
+      Real *sie_dyn = sie_dyn_arr;
+      Real *temp_dyn = temp_dyn_arr;
+      Real *press_dyn = press_dyn_arr;
+      std::vector<Real> scratch(singularity::PTESolverRhoTRequiredScratch(nmat));
+      singularity::PTESolverRhoT<EOS *, Real *, Real **> method_dyn(
+          nmat, eos, 1.0, usum / rho_tot, rho_dyn, vfrac_dyn, sie_dyn, temp_dyn,
+          press_dyn, lambdas, scratch.data(), 0.0, params);
+      const bool converged_dyn = singularity::PTESolver(method_dyn);
+      singularity::PTESolverRhoT<EOS *, Real *, Real **, nmat> method(
+          nmat, eos, 1.0, usum / rho_tot, rho, vfrac, sie, temp, press, lambdas,
+          scratch.data(), 0.0, params);
+      const bool converged = singularity::PTESolver(method);
+      THEN("It finds the same equilibrium as the general solver") {
+        REQUIRE(converged);
+        REQUIRE(converged_dyn);
+        for (int m = 0; m < nmat; ++m) {
+          REQUIRE(std::abs(temp[m] - temp_dyn[m]) < 1e-12 * temp_dyn[m]);
+          REQUIRE(std::abs(press[m] - press_dyn[m]) < 1e-12 * press_dyn[m]);
+          REQUIRE(std::abs(vfrac[m] - vfrac_dyn[m]) < 1e-12 * vfrac_dyn[m]);
+        }
+      }
+    }
+
+    WHEN("The Newton steps are solved in single precision until the residual is tiny") {
+      auto mixed = params;
+      mixed.pte_mixed_precision_residual = 1.e-14;
+      std::vector<Real> scratch(singularity::PTESolverRhoTRequiredScratch(nmat));
+      singularity::PTESolverRhoT<EOS *, Real *, Real **, nmat> method(
+          nmat, eos, 1.0, usum / rho_tot, rho, vfrac, sie, temp, press, lambdas,
+          scratch.data(), 0.0, mixed);
+      const bool converged = singularity::PTESolver(method);
+      THEN("The exact equilibrium is still found") {
+        REQUIRE(converged);
+        const Real T = usum / cvsum;
+        const Real P = T * psum;
+        for (int m = 0; m < nmat; ++m) {
+          REQUIRE(std::abs(temp[m] - T) < tol * T);
+          REQUIRE(std::abs(press[m] - P) < tol * P);
+        }
+      }
+    }
+
+    WHEN("Density and pressure are held fixed") {
+      const Real P = 2.0;
+      std::vector<Real> scratch(singularity::PTESolverFixedPRequiredScratch(nmat));
+      singularity::PTESolverFixedP<EOS *, Real *, Real **> method(
+          nmat, eos, 1.0, P, rho, vfrac, sie, temp, press, lambdas, scratch.data(),
+          params);
+      const bool converged = singularity::PTESolver(method);
+      THEN("The exact equilibrium is found") {
+        REQUIRE(converged);
+        const Real T = P / psum;
+        for (int m = 0; m < nmat; ++m) {
+          REQUIRE(std::abs(temp[m] - T) < tol * T);
+          REQUIRE(std::abs(press[m] - P) < tol * P);
+        }
+      }
+    }
+  }
+}
+#endif // SINGULARITY_BUILD_CLOSURE
@@ -0,0 +1,213 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <singularity-eos/base/query_trace.hpp>
+#include <singularity-eos/eos/eos.hpp>
+
+#ifndef CATCH_CONFIG_FAST_COMPILE
+#define CATCH_CONFIG_FAST_COMPILE
+#include <catch2/catch_test_macros.hpp>
+#endif
+
+using singularity::EOS;
+using singularity::IdealGas;
+namespace query_trace = singularity::query_trace;
+
+SCENARIO("EOS query traces can be written and replayed", "[QueryTrace]") {
+  // Capture reads the indexers on the host
+  if (!query_trace::IsHostAccessible<Real *>::value) return;
+
+  GIVEN("An ideal gas and a set of pressure calls") {
+    constexpr Real gm1 = 0.6;
+    constexpr Real Cv = 2.0;
+    IdealGas eos(gm1, Cv);
+    constexpr int num = 100;
+    std::vector<Real> rhos(num), sies(num), pressures(num);
+    for (int i = 0; i < num; ++i) {
+      rhos[i] = 1.0 + i;
+      sies[i] = 10.0 * (i + 1);
+      pressures[i] = eos.PressureFromDensityInternalEnergy(rhos[i], sies[i]);
+    }
+    const std::string filename = "query_trace_test.sgtrace";
+    WHEN("We record every other call, keeping at most 10 points per call") {
+      query_trace::Writer writer;
+      REQUIRE(writer.Start(filename, 2, 10));
+      query_trace::SetMaterial(3);
+      singularity::NullIndexer lambdas;
+      for (int call = 0; call < 4; ++call) {
+        writer.Capture(query_trace::Query::PressureFromDensityInternalEnergy, 0,
+                       rhos.data(), sies.data(), pressures.data(), num, lambdas, 0);
+      }
+      writer.Stop();
+      query_trace::SetMaterial(-1);
+      THEN("Two calls of 10 points each are in the trace") {
+        REQUIRE(writer.NumRecords() == 2);
+        query_trace::Reader reader(filename);
+        REQUIRE(reader.IsOpen());
+        query_trace::Record r;
+        REQUIRE(reader.Next(r));
+        REQUIRE(r.query == query_trace::Query::PressureFromDensityInternalEnergy);
+        REQUIRE(r.material == 3);
+        REQUIRE(r.num == 10);
+        REQUIRE(r.nlambda == 0);
+        REQUIRE(r.x[1] == rhos[10]);
+        REQUIRE(r.y[1] == sies[10]);
+        REQUIRE(r.out[1] == pressures[10]);
+        REQUIRE(reader.Next(r));
+        REQUIRE(!reader.Next(r));
+      }
+      AND_THEN("Replaying against the same EOS reproduces the trace") {
+        query_trace::Reader reader(filename);
+        auto stats = query_trace::Replay(
+            reader, [&](int material, int model) { return &eos; }, 1e-12);
+        REQUIRE(stats.nrecords == 2);
+        REQUIRE(stats.npoints == 20);
+        REQUIRE(stats.nmismatch == 0);
+      }
+      AND_THEN("Replaying against a different EOS reports the differences") {
+        IdealGas other(2 * gm1, Cv);
+        query_trace::Reader reader(filename);
+        auto stats = query_trace::Replay(
+            reader, [&](int material, int model) { return &other; }, 1e-12);
+        REQUIRE(stats.nmismatch == 20);
+        REQUIRE(stats.max_rel_diff > 0.5);
+      }
+    }
+    WHEN("The size limit is smaller than one record") {
+      query_trace::Writer writer;
+      REQUIRE(writer.Start(filename, 1, num, 64));
+      singularity::NullIndexer lambdas;
+      writer.Capture(query_trace::Query::PressureFromDensityInternalEnergy, 0,
+                     rhos.data(), sies.data(), pressures.data(), num, lambdas, 0);
+      THEN("Nothing is recorded and recording stops") {
+        REQUIRE(writer.NumRecords() == 0);
+        REQUIRE(!writer.Active());
+      }
+    }
+    WHEN("We record the cells of a get_sg_eos call, keeping at most 2 cells") {
+      constexpr int nmat = 2;
+      constexpr int cell_dim = 5;
+      const int eos_offsets[nmat] = {2, 1};
+      // the last three cells, 1-based
+      const int offsets[3] = {3, 4, 5};
+      std::vector<Real> spvol(cell_dim), csie(cell_dim), press(cell_dim),
+          temp(cell_dim), frac_mass(cell_dim * nmat), frac_vol(cell_dim * nmat),
+          frac_ie(cell_dim * nmat);
+      for (int j = 0; j < cell_dim; ++j) {
+        spvol[j] = 1.0 / rhos[j];
+        csie[j] = sies[j];
+        press[j] = pressures[j];
+        temp[j] = 100.0 * j;
+        for (int m = 0; m < nmat; ++m) {
+          frac_mass[j + m * cell_dim] = (m == 0) ? 0.25 : 0.75;
+          frac_vol[j + m * cell_dim] = 0.5;
+          frac_ie[j + m * cell_dim] = (m + 1) * sies[j];
+        }
+      }
+      query_trace::Writer writer;
+      REQUIRE(writer.Start(filename, 1, 2));
+      writer.CaptureGetSgEos(0, nmat, 3, cell_dim, eos_offsets, offsets, spvol.data(),
+                             csie.data(), press.data(), temp.data(), frac_mass.data(),
+                             frac_vol.data(), frac_ie.data(), 1e-12);
+      writer.Stop();
+      THEN("The sampled cells can be read back in get_sg_eos layout") {
+        query_trace::Reader reader(filename);
+        query_trace::Record r;
+        REQUIRE(reader.Next(r));
+        REQUIRE(r.query == query_trace::Query::GetSgEos);
+        REQUIRE(r.material == 0);
+        REQUIRE(r.model == nmat);
+        REQUIRE(r.num == 2);
+        REQUIRE(r.eos_offsets[0] == 2);
+        REQUIRE(r.eos_offsets[1] == 1);
+        REQUIRE(r.mass_frac_cutoff == 1e-12);
+        // cells 3 and 5, zero-based 2 and 4
+        REQUIRE(r.spvol[1] == spvol[4]);
+        REQUIRE(r.sie[0] == csie[2]);
+        REQUIRE(r.press[1] == press[4]);
+        REQUIRE(r.temp[0] == temp[2]);
+        REQUIRE(r.frac_mass[1 + 1 * r.num] == 0.75);
+        REQUIRE(r.frac_vol[0] == 0.5);
+        REQUIRE(r.frac_ie[1 + 1 * r.num] == 2 * sies[4]);
+        REQUIRE(!reader.Next(r));
+      }
+      AND_THEN("EOS replay skips the record") {
+        query_trace::Reader reader(filename);
+        auto stats = query_trace::Replay(
+            reader, [&](int material, int model) { return &eos; }, 1e-12);
+        REQUIRE(stats.nrecords == 0);
+        REQUIRE(stats.nskipped == 1);
+      }
+    }
+    std::remove(filename.c_str());
+  }
+}
+
+#ifdef SINGULARITY_ENABLE_QUERY_CAPTURE
+SCENARIO("EOS vector calls are captured by the global trace writer", "[QueryTrace]") {
+  if (!query_trace::IsHostAccessible<Real *>::value) return;
+
+  GIVEN("An ideal gas held by the EOS variant") {
+    constexpr Real gm1 = 0.6;
+    constexpr Real Cv = 2.0;
+    EOS eos = IdealGas(gm1, Cv);
+    constexpr int num = 10;
+    std::vector<Real> rhos(num), sies(num), temperatures(num);
+    for (int i = 0; i < num; ++i) {
+      rhos[i] = 1.0 + i;
+      sies[i] = 10.0 * (i + 1);
+    }
+    const std::string filename = "query_trace_variant_test.sgtrace";
+    WHEN("Capture is started and the EOS is called, once in place") {
+      REQUIRE(query_trace::Start(filename));
+      eos.TemperatureFromDensityInternalEnergy(rhos.data(), sies.data(),
+                                               temperatures.data(), num);
+      std::vector<Real> inplace = sies;
+      eos.TemperatureFromDensityInternalEnergy(rhos.data(), inplace.data(),
+                                               inplace.data(), num);
+      query_trace::Stop();
+      eos.TemperatureFromDensityInternalEnergy(rhos.data(), sies.data(),
+                                               temperatures.data(), num);
+      THEN("Both calls, and only those, are in the trace with their inputs") {
+        query_trace::Reader reader(filename);
+        REQUIRE(reader.IsOpen());
+        query_trace::Record r;
+        for (int call = 0; call < 2; ++call) {
+          REQUIRE(reader.Next(r));
+          REQUIRE(r.query == query_trace::Query::TemperatureFromDensityInternalEnergy);
+          REQUIRE(r.num == num);
+          for (int i = 0; i < num; ++i) {
+            REQUIRE(r.x[i] == rhos[i]);
+            REQUIRE(r.y[i] == sies[i]);
+            REQUIRE(r.out[i] == temperatures[i]);
+          }
+        }
+        REQUIRE(!reader.Next(r));
+      }
+      AND_THEN("Replaying against the variant reproduces the trace") {
+        query_trace::Reader reader(filename);
+        auto stats = query_trace::Replay(
+            reader, [&](int material, int model) { return &eos; }, 1e-12);
+        REQUIRE(stats.npoints == 2 * num);
+        REQUIRE(stats.nmismatch == 0);
+      }
+    }
+    std::remove(filename.c_str());
+  }
+}
+#endif // SINGULARITY_ENABLE_QUERY_CAPTURE
@@ -0,0 +1,176 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#ifdef SINGULARITY_USE_SPINER
+#include <cmath>
+
+#include <singularity-eos/base/fast-math/logs.hpp>
+#include <singularity-eos/base/table_entropy.hpp>
+#include <singularity-eos/eos/eos_ideal.hpp>
+#include <singularity-eos/eos/eos_stiff.hpp>
+#include <spiner/databox.hpp>
+
+#ifndef CATCH_CONFIG_FAST_COMPILE
+#define CATCH_CONFIG_FAST_COMPILE
+#include <catch2/catch_test_macros.hpp>
+#endif
+
+using singularity::IdealGas;
+using singularity::StiffGas;
+namespace table_entropy = singularity::table_entropy;
+using DataBox = Spiner::DataBox<Real>;
+
+// Table grids in log10, as written by sesame2spiner, with no offsets
+constexpr Real lRhoMin = -1;
+constexpr Real lRhoMax = 1;
+constexpr int nRho = 101;
+constexpr Real lTMin = 2;
+constexpr Real lTMax = 4;
+constexpr int nT = 101;
+constexpr Real rhoRef = 1;
+constexpr Real TRef = 300;
+
+static Real ToLog(const Real x) { return singularity::FastMath::log10(x); }
+static Real FromLog(const Real lx) { return singularity::FastMath::pow10(lx); }
+
+// P(rho, T) and sie(rho, T) of eos on the (rho, T) grid
+template <typename EOS>
+void TabulateRhoT(const EOS &eos, DataBox &P, DataBox &sie) {
+  P.resize(nRho, nT);
+  P.setRange(1, lRhoMin, lRhoMax, nRho);
+  P.setRange(0, lTMin, lTMax, nT);
+  sie.copyMetadata(P);
+  for (int j = 0; j < nRho; ++j) {
+    const Real rho = FromLog(P.range(1).x(j));
+    for (int i = 0; i < nT; ++i) {
+      const Real T = FromLog(P.range(0).x(i));
+      P(j, i) = eos.PressureFromDensityTemperature(rho, T);
+      sie(j, i) = eos.InternalEnergyFromDensityTemperature(rho, T);
+    }
+  }
+}
+
+// T(rho, sie) of eos on a (rho, sie) grid
+template <typename EOS>
+void TabulateRhoSie(const EOS &eos, const Real lEMin, const Real lEMax, DataBox &T) {
+  T.resize(nRho, nT);
+  T.setRange(1, lRhoMin, lRhoMax, nRho);
+  T.setRange(0, lEMin, lEMax, nT);
+  for (int j = 0; j < nRho; ++j) {
+    const Real rho = FromLog(T.range(1).x(j));
+    for (int i = 0; i < nT; ++i) {
+      T(j, i) = eos.TemperatureFromDensityInternalEnergy(rho, FromLog(T.range(0).x(i)));
+    }
+  }
+}
+
+// Largest deviation of S from the entropy of eos relative to the
+// reference state, over the (rho, T) grid, in units of Cv
+template <typename EOS>
+Real MaxErrorRhoT(const EOS &eos, const DataBox &S, const Real Cv) {
+  const Real SRef = eos.EntropyFromDensityTemperature(rhoRef, TRef);
+  Real err = 0;
+  for (int j = 0; j < nRho; ++j) {
+    const Real rho = FromLog(S.range(1).x(j));
+    for (int i = 0; i < nT; ++i) {
+      const Real T = FromLog(S.range(0).x(i));
+      const Real S_true = eos.EntropyFromDensityTemperature(rho, T) - SRef;
+      err = std::max(err, std::abs(S(j, i) - S_true) / Cv);
+    }
+  }
+  return err;
+}
+
+// Same as above over the (rho, sie) grid
+template <typename EOS>
+Real MaxErrorRhoSie(const EOS &eos, const DataBox &S, const Real Cv) {
+  const Real SRef = eos.EntropyFromDensityTemperature(rhoRef, TRef);
+  Real err = 0;
+  for (int j = 0; j < nRho; ++j) {
+    const Real rho = FromLog(S.range(1).x(j));
+    for (int i = 0; i < nT; ++i) {
+      const Real sie = FromLog(S.range(0).x(i));
+      const Real S_true = eos.EntropyFromDensityInternalEnergy(rho, sie) - SRef;
+      err = std::max(err, std::abs(S(j, i) - S_true) / Cv);
+    }
+  }
+  return err;
+}
+
+SCENARIO("Entropy tables built from pressure and energy tables", "[TableEntropy]") {
+  GIVEN("An ideal gas tabulated in density and temperature") {
+    constexpr Real gm1 = 0.4;
+    constexpr Real Cv = 7.18e6;
+    const IdealGas eos(gm1, Cv);
+    DataBox P, sie, S;
+    TabulateRhoT(eos, P, sie);
+    table_entropy::EntropyOfRhoT(P, sie, 0, 0, rhoRef, TRef, S);
+
+    THEN("The entropy vanishes at the reference state") {
+      const Real SRef = S.interpToReal(ToLog(rhoRef), ToLog(TRef));
+      REQUIRE(std::abs(SRef) < 1e-10 * Cv);
+    }
+    THEN("The entropy agrees with the analytic one") {
+      // Only the interpolation to the reference state is inexact
+      REQUIRE(MaxErrorRhoT(eos, S, Cv) < 1e-5);
+    }
+    WHEN("The entropy is mapped to a density-energy table reaching past the top "
+         "of the temperature table") {
+      const Real lEMin = ToLog(Cv * FromLog(lTMin));
+      const Real lEMax = ToLog(Cv * FromLog(lTMax + 1));
+      DataBox T, SRhoSie;
+      TabulateRhoSie(eos, lEMin, lEMax, T);
+      table_entropy::EntropyOfRhoSie(S, sie, 0, T, 0, SRhoSie);
+      THEN("It agrees with the analytic one") {
+        // Interpolation in ln(T) and the extrapolation are exact here
+        REQUIRE(MaxErrorRhoSie(eos, SRhoSie, Cv) < 1e-5);
+      }
+      T.finalize();
+      SRhoSie.finalize();
+    }
+    P.finalize();
+    sie.finalize();
+    S.finalize();
+  }
+
+  GIVEN("A stiff gas tabulated in density and temperature") {
+    constexpr Real gm1 = 1.35;
+    constexpr Real Cv = 1.816e7;
+    constexpr Real Pinf = 1e10;
+    constexpr Real qq = -1.167e10;
+    const StiffGas eos(gm1, Cv, Pinf, qq);
+    DataBox P, sie, S;
+    TabulateRhoT(eos, P, sie);
+    table_entropy::EntropyOfRhoT(P, sie, 0, 0, rhoRef, TRef, S);
+
+    THEN("The entropy agrees with the analytic one to the accuracy of the grid") {
+      REQUIRE(MaxErrorRhoT(eos, S, Cv) < 1e-2);
+    }
+    THEN("It is consistent with T dS = de + P dV within a cell") {
+      const int j = nRho / 2;
+      const int i = nT / 2;
+      const Real rho0 = FromLog(S.range(1).x(j));
+      const Real rho1 = FromLog(S.range(1).x(j + 1));
+      const Real T = FromLog(S.range(0).x(i));
+      const Real TdS = T * (S(j + 1, i) - S(j, i));
+      const Real PdV = 0.5 * (P(j, i) + P(j + 1, i)) * (1 / rho1 - 1 / rho0);
+      const Real de = sie(j + 1, i) - sie(j, i);
+      REQUIRE(std::abs(TdS - (de + PdV)) < 1e-2 * Cv * T * std::log(rho1 / rho0));
+    }
+    P.finalize();
+    sie.finalize();
+    S.finalize();
+  }
+}
+#endif // SINGULARITY_USE_SPINER
@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <singularity-eos/base/constants.hpp>
+#include <singularity-eos/base/table_heatmap.hpp>
+
+#ifndef CATCH_CONFIG_FAST_COMPILE
+#define CATCH_CONFIG_FAST_COMPILE
+#include <catch2/catch_test_macros.hpp>
+#endif
+
+using singularity::TableHeatmap;
+using singularity::TableStatus;
+
+SCENARIO("Table heatmaps count visits per cell and per status", "[TableHeatmap]") {
+  GIVEN("A heatmap with a 5 x 3 node grid") {
+    TableHeatmap heatmap("test");
+    // 4 x 2 cells of unit size
+    const int grid = heatmap.AddGrid("rho_T", "log(rho)", 0, 4, 5, "log(T)", 0, 2, 3);
+    REQUIRE(heatmap.AddGrid("rho_T", "log(rho)", 0, 4, 5, "log(T)", 0, 2, 3) == grid);
+    WHEN("Several threads record lookups") {
+      constexpr int nthreads = 4;
+      constexpr int nper = 100;
+      std::vector<std::thread> threads;
+      for (int t = 0; t < nthreads; ++t) {
+        threads.emplace_back([&]() {
+          for (int i = 0; i < nper; ++i) {
+            heatmap.Record(grid, 2.5, 0.5, TableStatus::OnTable);
+          }
+          heatmap.Record(grid, 10, 0.5, TableStatus::OnTable);
+          heatmap.Record(grid, 1, -1, TableStatus::OffBottom);
+          heatmap.Record(grid, 1, 3, TableStatus::OffTop);
+        });
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      THEN("The merged counts include every thread") {
+        const auto counts = heatmap.Counts(grid);
+        REQUIRE(counts.size() == 8);
+        REQUIRE(counts[2 * 2 + 0] == nthreads * nper);
+        // clamped to the last cell in x
+        REQUIRE(counts[3 * 2 + 0] == nthreads);
+        REQUIRE(heatmap.OutsideCount(grid) == nthreads);
+        const auto statuses = heatmap.StatusCounts(grid);
+        REQUIRE(statuses[static_cast<int>(TableStatus::OnTable)] == nthreads * (nper + 1));
+        REQUIRE(statuses[static_cast<int>(TableStatus::OffBottom)] == nthreads);
+        REQUIRE(statuses[static_cast<int>(TableStatus::OffTop)] == nthreads);
+      }
+      AND_THEN("They can be exported to JSON") {
+        std::stringstream ss;
+        heatmap.WriteJSON(ss);
+        const std::string json = ss.str();
+        REQUIRE(json.find("\"name\": \"test\"") != std::string::npos);
+        REQUIRE(json.find("\"off_bottom\": 4") != std::string::npos);
+        REQUIRE(json.find("[0, 0], [0, 0], [400, 0], [4, 0]") != std::string::npos);
+      }
+      AND_THEN("The visited bounds include the off-table lookups") {
+        Real xmin, xmax, ymin, ymax;
+        REQUIRE(heatmap.VisitedBounds(grid, xmin, xmax, ymin, ymax));
+        REQUIRE(xmin == 1);
+        REQUIRE(xmax == 4);
+        REQUIRE(ymin == 0);
+        REQUIRE(ymax == 2);
+      }
+      AND_THEN("They can be reset") {
+        heatmap.Reset();
+        const auto counts = heatmap.Counts(grid);
+        for (const auto c : counts) {
+          REQUIRE(c == 0);
+        }
+        Real xmin, xmax, ymin, ymax;
+        REQUIRE(!heatmap.VisitedBounds(grid, xmin, xmax, ymin, ymax));
+      }
+    }
+    WHEN("Only on-table lookups are recorded") {
+      heatmap.Record(grid, 1.5, 0.5, TableStatus::OnTable);
+      heatmap.Record(grid, 2.5, 0.5, TableStatus::OnTable);
+      THEN("The visited bounds are the bounds of the visited cells") {
+        Real xmin, xmax, ymin, ymax;
+        REQUIRE(heatmap.VisitedBounds(grid, xmin, xmax, ymin, ymax));
+        REQUIRE(xmin == 1);
+        REQUIRE(xmax == 3);
+        REQUIRE(ymin == 0);
+        REQUIRE(ymax == 1);
+      }
+    }
+  }
+}
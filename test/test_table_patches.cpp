@@ -0,0 +1,182 @@
+//------------------------------------------------------------------------------
+// © 2021-2024. Triad National Security, LLC. All rights reserved.  This
+// program was produced under U.S. Government contract 89233218CNA000001
+// for Los Alamos National Laboratory (LANL), which is operated by Triad
+// National Security, LLC for the U.S.  Department of Energy/National
+// Nuclear Security Administration. All rights in the program are
+// reserved by Triad National Security, LLC, and the U.S. Department of
+// Energy/National Nuclear Security Administration. The Government is
+// granted for itself and others acting on its behalf a nonexclusive,
+// paid-up, irrevocable worldwide license in this material to reproduce,
+// prepare derivative works, distribute copies to the public, perform
+// publicly and display publicly, and to permit others to do so.
+//------------------------------------------------------------------------------
+
+#ifdef SINGULARITY_USE_SPINER
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <singularity-eos/base/table_patches.hpp>
+#include <spiner/databox.hpp>
+
+#ifndef CATCH_CONFIG_FAST_COMPILE
+#define CATCH_CONFIG_FAST_COMPILE
+#include <catch2/catch_test_macros.hpp>
+#endif
+
+using singularity::TablePatches;
+using DataBox = Spiner::DataBox<Real>;
+
+// A front in x1 on a linear background
+static Real Front(const Real x1, const Real x0) {
+  return std::tanh(8 * (x1 - 0.45)) + x0;
+}
+
+static DataBox Tabulate(const Real x1lo, const Real x1hi, const int n1, const Real x0lo,
+                        const Real x0hi, const int n0) {
+  DataBox db(n1, n0);
+  db.setRange(1, x1lo, x1hi, n1);
+  db.setRange(0, x0lo, x0hi, n0);
+  for (int j = 0; j < n1; ++j) {
+    for (int i = 0; i < n0; ++i) {
+      db(j, i) = Front(db.range(1).x(j), db.range(0).x(i));
+    }
+  }
+  return db;
+}
+
+// Patches over layout holding Front, conformed to base
+static TablePatches MakePatches(const DataBox &base,
+                                const std::vector<TablePatches::Patch> &layout,
+                                const int refine) {
+  TablePatches patches(base, layout, refine, 1);
+  for (int p = 0; p < patches.NumPatches(); ++p) {
+    Real x1lo, x1hi, x0lo, x0hi;
+    int n1, n0;
+    patches.PatchBounds(p, x1lo, x1hi, x0lo, x0hi);
+    patches.PatchShape(p, n1, n0);
+    DataBox data = Tabulate(x1lo, x1hi, n1, x0lo, x0hi, n0);
+    patches.SetPatchData(0, p, data);
+    data.finalize();
+  }
+  patches.Conform(0, base);
+  return patches;
+}
+
+SCENARIO("Patch-refined tables", "[TablePatches]") {
+  GIVEN("A coarse table of a function with a sharp front") {
+    constexpr int n = 11;
+    constexpr int ncells = n - 1;
+    constexpr int refine = 4;
+    DataBox base = Tabulate(0, 1, n, 0, 1, n);
+    DataBox fine = Tabulate(0, 1, 2 * n - 1, 0, 1, 2 * n - 1);
+    const auto flags = TablePatches::FlagCells(base, fine, 1e-3);
+    const auto layout = TablePatches::Cover(flags, ncells, ncells);
+    fine.finalize();
+    WHEN("The flagged cells are covered by patches") {
+      TablePatches patches = MakePatches(base, layout, refine);
+
+      THEN("Exactly the flagged cells are patched") {
+        int nflagged = 0;
+        for (int j = 0; j < ncells; ++j) {
+          for (int i = 0; i < ncells; ++i) {
+            const Real x1 = (j + 0.5) / ncells;
+            const Real x0 = (i + 0.5) / ncells;
+            const bool flagged = flags[j * ncells + i];
+            nflagged += flagged;
+            REQUIRE(patches.Covers(x1, x0) == flagged);
+          }
+        }
+        REQUIRE(nflagged > 0);
+        REQUIRE(nflagged < ncells * ncells);
+        REQUIRE(patches.NumNodes() < (refine * ncells + 1) * (refine * ncells + 1));
+      }
+
+      AND_THEN("The patches reduce the interpolation error across the front") {
+        Real errBase = 0;
+        Real errPatched = 0;
+        for (int k = 0; k <= 100; ++k) {
+          const Real x1 = 0.3 + 0.003 * k;
+          const Real x0 = 0.37;
+          const Real exact = Front(x1, x0);
+          errBase = std::max(errBase, std::abs(base.interpToReal(x1, x0) - exact));
+          const Real patched = patches.Interp(0, base, x1, x0);
+          errPatched = std::max(errPatched, std::abs(patched - exact));
+        }
+        REQUIRE(errPatched < 0.2 * errBase);
+      }
+
+      AND_THEN("Lookups are continuous where patched and unpatched cells meet") {
+        constexpr Real eps = 1e-9;
+        for (int j = 0; j < ncells - 1; ++j) {
+          for (int i = 0; i < ncells; ++i) {
+            // the face between cells (j, i) and (j + 1, i)
+            if (flags[j * ncells + i] == flags[(j + 1) * ncells + i]) continue;
+            const Real x1 = static_cast<Real>(j + 1) / ncells;
+            for (int s = 0; s <= 8; ++s) {
+              const Real x0 = (i + s / 8.) / ncells;
+              const Real below = patches.Interp(0, base, x1 - eps, x0);
+              const Real above = patches.Interp(0, base, x1 + eps, x0);
+              REQUIRE(std::abs(below - above) < 1e-6);
+            }
+          }
+        }
+      }
+
+      AND_THEN("Cropping keeps the lookups inside the cropped table") {
+        const int lo[] = {2, 3};
+        const int hi[] = {8, 7};
+        TablePatches cropped = MakePatches(base, layout, refine);
+        cropped.Crop(lo, hi);
+        DataBox croppedBase = Tabulate(0.3, 0.7, 5, 0.2, 0.8, 7);
+        REQUIRE(cropped.NumPatches() > 0);
+        for (int k = 0; k <= 40; ++k) {
+          const Real x1 = 0.3 + 0.01 * k;
+          const Real x0 = 0.2 + 0.015 * k;
+          REQUIRE(std::abs(cropped.Interp(0, croppedBase, x1, x0) -
+                           patches.Interp(0, base, x1, x0)) < 1e-12);
+        }
+        croppedBase.finalize();
+        cropped.Finalize();
+      }
+
+#ifdef SINGULARITY_USE_SPINER_WITH_HDF5
+      AND_THEN("The patches can be saved to and loaded from HDF5") {
+        const std::string filename = "table_patches_test.h5";
+        const std::vector<std::string> names = {"front"};
+        hid_t file =
+            H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+        REQUIRE(!TablePatches::Exists(file));
+        REQUIRE(patches.saveHDF(file, names) == H5_SUCCESS);
+        REQUIRE(H5Fclose(file) == H5_SUCCESS);
+
+        file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        REQUIRE(TablePatches::Exists(file));
+        TablePatches loaded;
+        REQUIRE(loaded.loadHDF(file, base, names) == H5_SUCCESS);
+        REQUIRE(H5Fclose(file) == H5_SUCCESS);
+        REQUIRE(loaded.NumPatches() == patches.NumPatches());
+        REQUIRE(loaded.NumNodes() == patches.NumNodes());
+        REQUIRE(loaded.Refinement() == refine);
+        for (int k = 0; k < patches.NumNodes(); ++k) {
+          REQUIRE(loaded.Value(0, k) == patches.Value(0, k));
+        }
+        for (int k = 0; k <= 50; ++k) {
+          const Real x1 = 0.02 * k;
+          const Real x0 = 0.37;
+          REQUIRE(loaded.Covers(x1, x0) == patches.Covers(x1, x0));
+          REQUIRE(loaded.Interp(0, base, x1, x0) == patches.Interp(0, base, x1, x0));
+        }
+        loaded.Finalize();
+        std::remove(filename.c_str());
+      }
+#endif // SINGULARITY_USE_SPINER_WITH_HDF5
+      patches.Finalize();
+    }
+    base.finalize();
+  }
+}
+
+#endif // SINGULARITY_USE_SPINER